@@ -24,6 +24,7 @@ import com.google.zetasql.ZetaSQLOptions.ErrorMessageMode;
 import com.google.zetasql.ZetaSQLOptions.ParameterMode;
 import com.google.zetasql.ZetaSQLOptions.ParseLocationRecordType;
 import com.google.zetasql.ZetaSQLOptions.ResolvedASTRewrite;
+import com.google.zetasql.ZetaSQLOptions.ResolvedASTValidationMode;
 import com.google.zetasql.ZetaSQLOptions.StatementContext;
 import com.google.zetasql.ZetaSQLOptionsProto.AnalyzerOptionsProto;
 import com.google.zetasql.ZetaSQLOptionsProto.AnalyzerOptionsProto.QueryParameterProto;
@@ -348,6 +349,32 @@ public class AnalyzerOptions implements Serializable {
     return builder.getPreserveUnnecessaryCast();
   }
 
+  public void setValidationMode(ResolvedASTValidationMode validationMode) {
+    builder.setValidationMode(validationMode);
+  }
+
+  public ResolvedASTValidationMode getValidationMode() {
+    return builder.getValidationMode();
+  }
+
+  public void setValidationSamplingInterval(long validationSamplingInterval) {
+    Preconditions.checkArgument(
+        validationSamplingInterval > 0, "validationSamplingInterval must be positive");
+    builder.setValidationSamplingInterval(validationSamplingInterval);
+  }
+
+  public long getValidationSamplingInterval() {
+    return builder.getValidationSamplingInterval();
+  }
+
+  public void setCollectRuntimeInfo(boolean collectRuntimeInfo) {
+    builder.setCollectRuntimeInfo(collectRuntimeInfo);
+  }
+
+  public boolean getCollectRuntimeInfo() {
+    return builder.getCollectRuntimeInfo();
+  }
+
   static AnalyzerOptions deserialize(
       AnalyzerOptionsProto proto, List<? extends DescriptorPool> pools, TypeFactory factory) {
     AnalyzerOptions options = new AnalyzerOptions();
@@ -368,6 +395,9 @@ public class AnalyzerOptions implements Serializable {
     setParameterMode(proto.getParameterMode());
     setPreserveColumnAliases(proto.getPreserveColumnAliases());
     setPreserveUnnecessaryCast(proto.getPreserveUnnecessaryCast());
+    setValidationMode(proto.getValidationMode());
+    setValidationSamplingInterval(proto.getValidationSamplingInterval());
+    setCollectRuntimeInfo(proto.getCollectRuntimeInfo());
 
     if (proto.hasInScopeExpressionColumn()) {
       setInScopeExpressionColumn(
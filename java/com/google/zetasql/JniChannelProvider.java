@@ -18,9 +18,13 @@
 package com.google.zetasql;
 
 import com.google.auto.service.AutoService;
+import com.google.protobuf.CodedOutputStream;
+import com.google.protobuf.MessageLite;
+import com.google.protobuf.Parser;
 import io.grpc.Channel;
 import io.grpc.LoadBalancerProvider;
 import io.grpc.LoadBalancerRegistry;
+import io.grpc.Status;
 import io.grpc.netty.NettyChannelBuilder;
 import io.netty.channel.ChannelException;
 import io.netty.channel.nio.NioEventLoopGroup;
@@ -29,6 +33,7 @@ import io.netty.util.concurrent.DefaultThreadFactory;
 import java.io.IOException;
 import java.net.InetSocketAddress;
 import java.net.SocketAddress;
+import java.nio.ByteBuffer;
 import java.nio.channels.SocketChannel;
 
 /** Controller class of the ZetaSQL JniChannelProvider. */
@@ -83,6 +88,64 @@ public class JniChannelProvider implements ClientChannelProvider {
   /** Returns a SocketChannel connected to the server. */
   private static native SocketChannel getSocketChannel() throws IOException;
 
+  /** Thrown by callDirect() with the code and message of the failed call. */
+  private static class DirectCallException extends RuntimeException {
+    private final int code;
+
+    DirectCallException(int code, String message) {
+      super(message);
+      this.code = code;
+    }
+  }
+
+  /**
+   * Calls the local service method named {@code method} with the first {@code requestLength}
+   * bytes of the direct buffer {@code request}. Returns the serialized response in {@code
+   * response} if it is large enough, otherwise in a newly allocated direct buffer.
+   */
+  private static native ByteBuffer callDirect(
+      String method, ByteBuffer request, int requestLength, ByteBuffer response);
+
+  private static final int INITIAL_DIRECT_BUFFER_SIZE = 4096;
+
+  /** Direct buffers for the request and response of each thread, reused across calls. */
+  private static final ThreadLocal<ByteBuffer[]> directBuffers =
+      ThreadLocal.withInitial(
+          () ->
+              new ByteBuffer[] {
+                ByteBuffer.allocateDirect(INITIAL_DIRECT_BUFFER_SIZE),
+                ByteBuffer.allocateDirect(INITIAL_DIRECT_BUFFER_SIZE)
+              });
+
+  /**
+   * Calls the unary ZetaSqlLocalService rpc named {@code method} (e.g. "Analyze") in process,
+   * passing the serialized request and response in direct buffers instead of going through a gRPC
+   * channel. This shares the registered catalogs and prepared expressions of the channels returned
+   * by newChannel(), and fails with the same StatusRuntimeException as the rpc would. Throws
+   * UnsupportedOperationException if the native library could not set up this path when it was
+   * loaded; channels returned by newChannel() still work in that case.
+   */
+  public static <ResponseT extends MessageLite> ResponseT callDirect(
+      String method, MessageLite request, Parser<ResponseT> responseParser) {
+    ByteBuffer[] buffers = directBuffers.get();
+    int requestLength = request.getSerializedSize();
+    if (buffers[0].capacity() < requestLength) {
+      buffers[0] = ByteBuffer.allocateDirect(requestLength);
+    }
+    buffers[0].clear();
+    try {
+      CodedOutputStream output = CodedOutputStream.newInstance(buffers[0]);
+      request.writeTo(output);
+      output.flush();
+      buffers[1] = callDirect(method, buffers[0], requestLength, buffers[1]);
+      return responseParser.parseFrom(buffers[1]);
+    } catch (DirectCallException e) {
+      throw Status.fromCodeValue(e.code).withDescription(e.getMessage()).asRuntimeException();
+    } catch (IOException e) {
+      throw Status.INTERNAL.withDescription(e.getMessage()).withCause(e).asRuntimeException();
+    }
+  }
+
   /** Wraps one end of a socketpair for NioSocketChannel. */
   protected static class SocketPairChannel extends NioSocketChannel {
 
@@ -25,6 +25,7 @@ import com.google.zetasql.ZetaSQLOptions.ErrorMessageMode;
 import com.google.zetasql.ZetaSQLOptions.ParameterMode;
 import com.google.zetasql.ZetaSQLOptions.ParseLocationRecordType;
 import com.google.zetasql.ZetaSQLOptions.ResolvedASTRewrite;
+import com.google.zetasql.ZetaSQLOptions.ResolvedASTValidationMode;
 import com.google.zetasql.ZetaSQLOptionsProto.AnalyzerOptionsProto;
 import com.google.zetasql.ZetaSQLType.TypeKind;
 import com.google.zetasql.ZetaSQLType.TypeProto;
@@ -133,6 +134,38 @@ public class AnalyzerOptionsTest {
     checkDeserialize(proto, builder.getDescriptorPools());
   }
 
+  @Test
+  public void testValidationMode() {
+    FileDescriptorSetsBuilder builder = new FileDescriptorSetsBuilder();
+    AnalyzerOptions options = new AnalyzerOptions();
+    assertThat(options.getValidationMode())
+        .isEqualTo(ResolvedASTValidationMode.RESOLVED_AST_VALIDATION_DEFAULT);
+    assertThat(options.getValidationSamplingInterval()).isEqualTo(100);
+    options.setValidationMode(ResolvedASTValidationMode.RESOLVED_AST_VALIDATION_SAMPLED);
+    options.setValidationSamplingInterval(1000);
+    AnalyzerOptionsProto proto = options.serialize(builder);
+    assertThat(proto.getValidationMode())
+        .isEqualTo(ResolvedASTValidationMode.RESOLVED_AST_VALIDATION_SAMPLED);
+    assertThat(proto.getValidationSamplingInterval()).isEqualTo(1000);
+    checkDeserialize(proto, builder.getDescriptorPools());
+    try {
+      options.setValidationSamplingInterval(0);
+      fail();
+    } catch (IllegalArgumentException expected) {
+    }
+  }
+
+  @Test
+  public void testCollectRuntimeInfo() {
+    FileDescriptorSetsBuilder builder = new FileDescriptorSetsBuilder();
+    AnalyzerOptions options = new AnalyzerOptions();
+    assertThat(options.getCollectRuntimeInfo()).isFalse();
+    options.setCollectRuntimeInfo(true);
+    AnalyzerOptionsProto proto = options.serialize(builder);
+    assertThat(proto.getCollectRuntimeInfo()).isTrue();
+    checkDeserialize(proto, builder.getDescriptorPools());
+  }
+
   @Test
   public void testSetLanguageOptions() {
     AnalyzerOptions options = new AnalyzerOptions();
@@ -356,7 +389,7 @@ public class AnalyzerOptionsTest {
             "The number of fields of AnalyzerOptionsProto has changed, please also update the "
                 + "serialization code accordingly.")
         .that(AnalyzerOptionsProto.getDescriptor().getFields())
-        .hasSize(21);
+        .hasSize(24);
     assertWithMessage(
             "The number of fields in AnalyzerOptions class has changed, please also update the "
                 + "proto and serialization code accordingly.")
@@ -18,12 +18,16 @@
 
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
 #include <thread>
 
 #include "zetasql/base/logging.h"
+#include "zetasql/analyzer/analyzer_output_mutator.h"
+#include "zetasql/analyzer/find_counting_catalog.h"
+#include "zetasql/analyzer/resolved_ast_validation.h"
 #include "zetasql/analyzer/resolver.h"
 #include "zetasql/analyzer/rewrite_resolved_ast.h"
 #include "zetasql/analyzer/rewriters/rewriter_interface.h"
@@ -32,12 +36,12 @@
 #include "zetasql/parser/parser.h"
 #include "zetasql/public/analyzer_options.h"
 #include "zetasql/public/analyzer_output.h"
+#include "zetasql/public/analyzer_runtime_info.h"
 #include "zetasql/public/catalog.h"
 #include "zetasql/public/language_options.h"
 #include "zetasql/public/types/type.h"
 #include "zetasql/public/types/type_factory.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
-#include "zetasql/resolved_ast/validator.h"
 #include "absl/flags/flag.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
@@ -69,15 +73,24 @@ absl::Status AnalyzeExpressionImpl(
   const AnalyzerOptions& options = GetOptionsWithArenas(&options_in, &copy);
   ZETASQL_RETURN_IF_ERROR(ValidateAnalyzerOptions(options));
 
+  std::unique_ptr<AnalyzerRuntimeInfo> runtime_info;
+  if (options.collect_runtime_info()) {
+    runtime_info = std::make_unique<AnalyzerRuntimeInfo>();
+  }
   std::unique_ptr<ParserOutput> parser_output;
   ParserOptions parser_options = options.GetParserOptions();
-  ZETASQL_RETURN_IF_ERROR(ParseExpression(sql, parser_options, &parser_output));
+  {
+    ScopedAnalyzerPhaseTimer timer(
+        runtime_info == nullptr ? nullptr : &runtime_info->parser,
+        options.arena().get());
+    ZETASQL_RETURN_IF_ERROR(ParseExpression(sql, parser_options, &parser_output));
+  }
   const ASTExpression* expression = parser_output->expression();
   ZETASQL_VLOG(5) << "Parsed AST:\n" << expression->DebugString();
 
   return InternalAnalyzeExpressionFromParserAST(
       *expression, std::move(parser_output), sql, options, catalog,
-      type_factory, target_type, output);
+      type_factory, target_type, output, std::move(runtime_info));
 }
 
 }  // namespace
@@ -108,23 +121,42 @@ absl::Status InternalAnalyzeExpressionFromParserAST(
     const ASTExpression& ast_expression,
     std::unique_ptr<ParserOutput> parser_output, absl::string_view sql,
     const AnalyzerOptions& options, Catalog* catalog, TypeFactory* type_factory,
-    const Type* target_type, std::unique_ptr<const AnalyzerOutput>* output) {
+    const Type* target_type, std::unique_ptr<const AnalyzerOutput>* output,
+    std::unique_ptr<AnalyzerRuntimeInfo> runtime_info) {
+  if (runtime_info == nullptr && options.collect_runtime_info()) {
+    runtime_info = std::make_unique<AnalyzerRuntimeInfo>();
+  }
+  std::optional<FindCountingCatalog> counting_catalog;
+  if (runtime_info != nullptr) {
+    counting_catalog.emplace(catalog);
+    catalog = &*counting_catalog;
+  }
   std::unique_ptr<const ResolvedExpr> resolved_expr;
   Resolver resolver(catalog, type_factory, &options);
-  ZETASQL_RETURN_IF_ERROR(
-      resolver.ResolveStandaloneExpr(sql, &ast_expression, &resolved_expr));
-  ZETASQL_VLOG(3) << "Resolved AST:\n" << resolved_expr->DebugString();
-
-  if (target_type != nullptr) {
-    ZETASQL_RETURN_IF_ERROR(ConvertExprToTargetType(ast_expression, sql, options,
-                                            catalog, type_factory, target_type,
-                                            &resolved_expr));
+  {
+    ScopedAnalyzerPhaseTimer timer(
+        runtime_info == nullptr ? nullptr : &runtime_info->resolver,
+        options.arena().get());
+    ZETASQL_RETURN_IF_ERROR(
+        resolver.ResolveStandaloneExpr(sql, &ast_expression, &resolved_expr));
+    ZETASQL_VLOG(3) << "Resolved AST:\n" << resolved_expr->DebugString();
+
+    if (target_type != nullptr) {
+      ZETASQL_RETURN_IF_ERROR(ConvertExprToTargetType(ast_expression, sql, options,
+                                              catalog, type_factory,
+                                              target_type, &resolved_expr));
+    }
   }
 
-  if (absl::GetFlag(FLAGS_zetasql_validate_resolved_ast)) {
-    Validator validator(options.language());
-    ZETASQL_RETURN_IF_ERROR(
-        validator.ValidateStandaloneResolvedExpr(resolved_expr.get()));
+  {
+    ScopedAnalyzerPhaseTimer timer(
+        runtime_info == nullptr ? nullptr : &runtime_info->validator,
+        options.arena().get());
+    ZETASQL_RETURN_IF_ERROR(MaybeValidateStandaloneResolvedExpr(
+        options,
+        ShouldValidateAnalysis(
+            options, absl::GetFlag(FLAGS_zetasql_validate_resolved_ast)),
+        resolved_expr.get()));
   }
 
   if (absl::GetFlag(FLAGS_zetasql_print_resolved_ast)) {
@@ -149,8 +181,16 @@ absl::Status InternalAnalyzeExpressionFromParserAST(
           options.error_message_mode(), sql, resolver.deprecation_warnings()),
       resolver.undeclared_parameters(),
       resolver.undeclared_positional_parameters(), resolver.max_column_id());
-  ZETASQL_RETURN_IF_ERROR(InternalRewriteResolvedAst(options, sql, catalog,
-                                             type_factory, *original_output));
+  AnalyzerOutputMutator output_mutator(original_output.get());
+  output_mutator.set_runtime_info(std::move(runtime_info));
+  // <original_output> is discarded on error, so rewriters can take its tree.
+  ZETASQL_RETURN_IF_ERROR(InternalRewriteResolvedAst(
+      options, sql, catalog, type_factory, *original_output,
+      /*keep_output_on_error=*/false));
+  if (counting_catalog.has_value()) {
+    output_mutator.mutable_runtime_info()->catalog_find_calls =
+        counting_catalog->num_find_calls();
+  }
   *output = std::move(original_output);
   return absl::OkStatus();
 }
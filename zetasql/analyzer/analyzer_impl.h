@@ -28,6 +28,7 @@
 #include "zetasql/parser/parser.h"
 #include "zetasql/public/analyzer_options.h"
 #include "zetasql/public/analyzer_output.h"
+#include "zetasql/public/analyzer_runtime_info.h"
 #include "zetasql/public/catalog.h"
 #include "zetasql/public/types/type.h"
 #include "zetasql/public/types/type_factory.h"
@@ -61,11 +62,14 @@ absl::Status ConvertExprToTargetType(
     TypeFactory* type_factory, const Type* target_type,
     std::unique_ptr<const ResolvedExpr>* resolved_expr);
 
+// Analyzes an expression that was already parsed. <runtime_info> holds the
+// parser time when runtime info is collected, and is otherwise null.
 absl::Status InternalAnalyzeExpressionFromParserAST(
     const ASTExpression& ast_expression,
     std::unique_ptr<ParserOutput> parser_output, absl::string_view sql,
     const AnalyzerOptions& options, Catalog* catalog, TypeFactory* type_factory,
-    const Type* target_type, std::unique_ptr<const AnalyzerOutput>* output);
+    const Type* target_type, std::unique_ptr<const AnalyzerOutput>* output,
+    std::unique_ptr<AnalyzerRuntimeInfo> runtime_info = nullptr);
 }  // namespace zetasql
 
 #endif  // ZETASQL_ANALYZER_ANALYZER_IMPL_H_
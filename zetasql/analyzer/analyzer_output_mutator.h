@@ -0,0 +1,88 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_ANALYZER_ANALYZER_OUTPUT_MUTATOR_H_
+#define ZETASQL_ANALYZER_ANALYZER_OUTPUT_MUTATOR_H_
+
+#include <memory>
+#include <utility>
+
+#include "zetasql/base/atomic_sequence_num.h"
+#include "zetasql/public/analyzer_output.h"
+#include "zetasql/public/analyzer_output_properties.h"
+#include "zetasql/public/analyzer_runtime_info.h"
+#include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_node.h"
+#include "absl/status/status.h"
+#include "zetasql/base/ret_check.h"
+
+namespace zetasql {
+
+// Helper to allow the analyzer to mutate an AnalyzerOutput after building it.
+class AnalyzerOutputMutator {
+ public:
+  // 'output' must outlive AnalyzerOutputMutator.
+  explicit AnalyzerOutputMutator(AnalyzerOutput* output) : output_(*output) {}
+
+  // Replaces the resolved statement or expression of the output with 'node'.
+  // The output must not switch between a statement and an expression.
+  absl::Status UpdateOutputNode(std::unique_ptr<const ResolvedNode> node) {
+    if (node->IsStatement()) {
+      ZETASQL_RET_CHECK(output_.expr_ == nullptr);
+      output_.statement_.reset(node.release()->GetAs<ResolvedStatement>());
+    } else {
+      ZETASQL_RET_CHECK(node->IsExpression());
+      ZETASQL_RET_CHECK(output_.statement_ == nullptr);
+      output_.expr_.reset(node.release()->GetAs<ResolvedExpr>());
+    }
+    return absl::OkStatus();
+  }
+
+  // Updates the max column id of the output after new columns were allocated
+  // from 'column_id_seq_num'.
+  void UpdateMaxColumnId(zetasql_base::SequenceNumber& column_id_seq_num) {
+    output_.max_column_id_ = static_cast<int>(column_id_seq_num.GetNext() - 1);
+  }
+
+  // Transfers the resolved statement or expression to the caller, who is
+  // expected to give it back, possibly rewritten, with UpdateOutputNode().
+  std::unique_ptr<const ResolvedNode> release_output_node() {
+    if (output_.statement_ != nullptr) {
+      return std::move(output_.statement_);
+    }
+    return std::move(output_.expr_);
+  }
+
+  AnalyzerOutputProperties& mutable_output_properties() {
+    return output_.analyzer_output_properties_;
+  }
+
+  void set_runtime_info(std::unique_ptr<AnalyzerRuntimeInfo> runtime_info) {
+    output_.runtime_info_ = std::move(runtime_info);
+  }
+
+  // Returns null if runtime info is not collected.
+  AnalyzerRuntimeInfo* mutable_runtime_info() {
+    return output_.runtime_info_.get();
+  }
+
+ private:
+  AnalyzerOutput& output_;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_ANALYZER_ANALYZER_OUTPUT_MUTATOR_H_
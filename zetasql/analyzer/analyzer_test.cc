@@ -25,6 +25,7 @@
 #include <vector>
 
 #include "zetasql/base/logging.h"
+#include "zetasql/analyzer/resolved_ast_validation.h"
 #include "google/protobuf/compiler/importer.h"
 #include "google/protobuf/descriptor.h"
 #include "zetasql/common/status_payload_utils.h"
@@ -36,6 +37,7 @@
 #include "zetasql/public/analyzer_options.h"
 #include "zetasql/public/analyzer_output.h"
 #include "zetasql/public/analyzer_output_properties.h"
+#include "zetasql/public/analyzer_runtime_info.h"
 #include "zetasql/public/catalog.h"
 #include "zetasql/public/function.h"
 #include "zetasql/public/function.pb.h"
@@ -46,6 +48,7 @@
 #include "zetasql/public/parse_resume_location.h"
 #include "zetasql/public/simple_catalog.h"
 #include "zetasql/public/sql_formatter.h"
+#include "zetasql/public/templated_sql_function.h"
 #include "zetasql/public/type.h"
 #include "zetasql/public/type.pb.h"
 #include "zetasql/public/types/array_type.h"
@@ -54,6 +57,7 @@
 #include "zetasql/public/types/struct_type.h"
 #include "zetasql/public/value.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
 #include "zetasql/resolved_ast/resolved_column.h"
 #include "zetasql/resolved_ast/resolved_node_kind.pb.h"
 #include "zetasql/resolved_ast/sql_builder.h"
@@ -1027,7 +1031,7 @@ TEST_F(AnalyzerOptionsTest, Deserialize) {
 }
 
 TEST_F(AnalyzerOptionsTest, ClassAndProtoSize) {
-  EXPECT_EQ(240, sizeof(AnalyzerOptions) - sizeof(LanguageOptions) -
+  EXPECT_EQ(256, sizeof(AnalyzerOptions) - sizeof(LanguageOptions) -
                      sizeof(AllowedHintsAndOptions) -
                      sizeof(Catalog::FindOptions) - sizeof(SystemVariablesMap) -
                      2 * sizeof(QueryParametersMap) - 2 * sizeof(std::string) -
@@ -1035,11 +1039,113 @@ TEST_F(AnalyzerOptionsTest, ClassAndProtoSize) {
                      sizeof(absl::btree_set<ResolvedASTRewrite>))
       << "The size of AnalyzerOptions class has changed, please also update "
       << "the proto and serialization code if you added/removed fields in it.";
-  EXPECT_EQ(21, AnalyzerOptionsProto::descriptor()->field_count())
+  EXPECT_EQ(24, AnalyzerOptionsProto::descriptor()->field_count())
       << "The number of fields in AnalyzerOptionsProto has changed, please "
       << "also update the serialization code accordingly.";
 }
 
+TEST_F(AnalyzerOptionsTest, ValidationMode) {
+  auto analyze_ten_statements = [this]() {
+    for (int i = 0; i < 10; ++i) {
+      std::unique_ptr<const AnalyzerOutput> output;
+      ZETASQL_ASSERT_OK(AnalyzeStatement("SELECT 1", options_, catalog(),
+                                 &type_factory_, &output));
+    }
+  };
+  EXPECT_EQ(options_.validation_mode(), RESOLVED_AST_VALIDATION_DEFAULT);
+  ResetResolvedASTValidationStats();
+  analyze_ten_statements();
+  EXPECT_EQ(GetResolvedASTValidationStats().num_validations, 10);
+  EXPECT_EQ(GetResolvedASTValidationStats().num_skipped_validations, 0);
+  EXPECT_GT(GetResolvedASTValidationStats().validation_time,
+            absl::ZeroDuration());
+
+  options_.set_validation_mode(RESOLVED_AST_VALIDATION_OFF);
+  ResetResolvedASTValidationStats();
+  analyze_ten_statements();
+  EXPECT_EQ(GetResolvedASTValidationStats().num_validations, 0);
+  EXPECT_EQ(GetResolvedASTValidationStats().num_skipped_validations, 10);
+  EXPECT_EQ(GetResolvedASTValidationStats().validation_time,
+            absl::ZeroDuration());
+
+  options_.set_validation_mode(RESOLVED_AST_VALIDATION_SAMPLED);
+  options_.set_validation_sampling_interval(5);
+  ResetResolvedASTValidationStats();
+  analyze_ten_statements();
+  EXPECT_EQ(GetResolvedASTValidationStats().num_validations, 2);
+  EXPECT_EQ(GetResolvedASTValidationStats().num_skipped_validations, 8);
+
+  // Resetting also restarts the sampling, so the first analysis after it is
+  // validated.
+  options_.set_validation_sampling_interval(3);
+  ResetResolvedASTValidationStats();
+  {
+    std::unique_ptr<const AnalyzerOutput> output;
+    ZETASQL_ASSERT_OK(AnalyzeStatement("SELECT 1", options_, catalog(),
+                               &type_factory_, &output));
+  }
+  EXPECT_EQ(GetResolvedASTValidationStats().num_validations, 1);
+  EXPECT_EQ(GetResolvedASTValidationStats().num_skipped_validations, 0);
+
+  EXPECT_DEATH(options_.set_validation_sampling_interval(0),
+               "validation_sampling_interval must be positive");
+
+  FileDescriptorSetMap file_descriptor_set_map;
+  AnalyzerOptionsProto proto;
+  options_.set_validation_sampling_interval(1000);
+  ZETASQL_ASSERT_OK(options_.Serialize(&file_descriptor_set_map, &proto));
+  EXPECT_EQ(proto.validation_mode(), RESOLVED_AST_VALIDATION_SAMPLED);
+  EXPECT_EQ(proto.validation_sampling_interval(), 1000);
+  AnalyzerOptions deserialized_options;
+  ZETASQL_ASSERT_OK(AnalyzerOptions::Deserialize(proto, /*pools=*/{},
+                                         &type_factory_,
+                                         &deserialized_options));
+  EXPECT_EQ(deserialized_options.validation_mode(),
+            RESOLVED_AST_VALIDATION_SAMPLED);
+  EXPECT_EQ(deserialized_options.validation_sampling_interval(), 1000);
+
+  proto.set_validation_sampling_interval(0);
+  EXPECT_THAT(AnalyzerOptions::Deserialize(proto, /*pools=*/{},
+                                           &type_factory_,
+                                           &deserialized_options),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
+TEST_F(AnalyzerOptionsTest, ValidationModeWithRewriters) {
+  // TYPEOF() is rewritten, so each analysis of the query has a resolved AST
+  // to validate before and after the rewriters.
+  options_.mutable_language()->EnableLanguageFeature(
+      FEATURE_V_1_3_TYPEOF_FUNCTION);
+  SimpleCatalog catalog("catalog", &type_factory_);
+  catalog.AddZetaSQLFunctions(options_.language());
+  auto analyze_ten_statements = [this, &catalog]() {
+    for (int i = 0; i < 10; ++i) {
+      std::unique_ptr<const AnalyzerOutput> output;
+      ZETASQL_ASSERT_OK(AnalyzeStatement("SELECT TYPEOF(1)", options_, &catalog,
+                                 &type_factory_, &output));
+    }
+  };
+
+  ResetResolvedASTValidationStats();
+  analyze_ten_statements();
+  EXPECT_EQ(GetResolvedASTValidationStats().num_validations, 20);
+
+  // Only the analyses are sampled, one in five, and the output of the
+  // rewriters is still validated.
+  options_.set_validation_mode(RESOLVED_AST_VALIDATION_SAMPLED);
+  options_.set_validation_sampling_interval(5);
+  ResetResolvedASTValidationStats();
+  analyze_ten_statements();
+  EXPECT_EQ(GetResolvedASTValidationStats().num_validations, 12);
+  EXPECT_EQ(GetResolvedASTValidationStats().num_skipped_validations, 8);
+
+  options_.set_validation_mode(RESOLVED_AST_VALIDATION_OFF);
+  ResetResolvedASTValidationStats();
+  analyze_ten_statements();
+  EXPECT_EQ(GetResolvedASTValidationStats().num_validations, 0);
+  EXPECT_EQ(GetResolvedASTValidationStats().num_skipped_validations, 20);
+}
+
 TEST_F(AnalyzerOptionsTest, AllowedHintsAndOptionsSerializeAndDeserialize) {
   TypeFactory factory;
 
@@ -1506,6 +1612,123 @@ TEST(AnalyzerTest, AstRewriting) {
   }
 }
 
+TEST(AnalyzerTest, RewriteResolvedAstKeepsOutputOnError) {
+  AnalyzerOptions options;
+  options.mutable_language()->EnableLanguageFeature(
+      FEATURE_V_1_3_TYPEOF_FUNCTION);
+  options.enable_rewrite(REWRITE_TYPEOF_FUNCTION, false);
+  SampleCatalog catalog(options.language());
+  TypeFactory type_factory;
+  const std::string sql = "SELECT TYPEOF(1) @{int64_hint=1}";
+  std::unique_ptr<const AnalyzerOutput> output;
+  ZETASQL_ASSERT_OK(AnalyzeStatement(sql, options, catalog.catalog(),
+                             &type_factory, &output));
+
+  ResolvedASTDeepCopyVisitor visitor;
+  ZETASQL_ASSERT_OK(output->resolved_statement()->Accept(&visitor));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ResolvedStatement> statement,
+                       visitor.ConsumeRootNode<ResolvedStatement>());
+  AnalyzerOutput rewrite_output(
+      output->id_string_pool(), output->arena(), std::move(statement),
+      output->analyzer_output_properties(), /*parser_output=*/nullptr,
+      output->deprecation_warnings(), output->undeclared_parameters(),
+      output->undeclared_positional_parameters(), output->max_column_id());
+
+  // The TYPEOF() rewriter rejects hints, and the resolved statement that it
+  // failed to rewrite is left in the output.
+  options.enable_rewrite(REWRITE_TYPEOF_FUNCTION);
+  EXPECT_THAT(RewriteResolvedAst(options, sql, catalog.catalog(),
+                                 &type_factory, rewrite_output),
+              StatusIs(absl::StatusCode::kUnimplemented,
+                       HasSubstr("does not support hints")));
+  ASSERT_NE(rewrite_output.resolved_statement(), nullptr);
+  EXPECT_EQ(rewrite_output.resolved_statement()->DebugString(),
+            output->resolved_statement()->DebugString());
+}
+
+TEST(AnalyzerTest, RuntimeInfo) {
+  AnalyzerOptions options;
+  options.mutable_language()->EnableLanguageFeature(
+      FEATURE_V_1_3_UNNEST_AND_FLATTEN_ARRAYS);
+  SampleCatalog catalog(options.language());
+  TypeFactory type_factory;
+  std::unique_ptr<const AnalyzerOutput> output;
+
+  const std::string sql =
+      "SELECT FLATTEN([STRUCT([key] AS x)].x) FROM KeyValue WHERE key > 1";
+  ZETASQL_ASSERT_OK(AnalyzeStatement(sql, options, catalog.catalog(),
+                             &type_factory, &output));
+  EXPECT_EQ(output->runtime_info(), nullptr);
+
+  options.set_collect_runtime_info(true);
+  ZETASQL_ASSERT_OK(AnalyzeStatement(sql, options, catalog.catalog(),
+                             &type_factory, &output));
+  const AnalyzerRuntimeInfo* runtime_info = output->runtime_info();
+  ASSERT_NE(runtime_info, nullptr);
+  EXPECT_GT(runtime_info->parser.wall_time, absl::ZeroDuration());
+  EXPECT_GT(runtime_info->parser.arena_bytes_allocated, 0);
+  EXPECT_GT(runtime_info->resolver.wall_time, absl::ZeroDuration());
+  EXPECT_GT(runtime_info->resolver.arena_bytes_allocated, 0);
+  EXPECT_GT(runtime_info->validator.wall_time, absl::ZeroDuration());
+  EXPECT_GT(runtime_info->rewriters.wall_time, absl::ZeroDuration());
+  EXPECT_EQ(runtime_info->rewriter_iterations, 1);
+  ASSERT_EQ(runtime_info->rewriter_stats.size(), 1);
+  EXPECT_EQ(runtime_info->rewriter_stats.begin()->first, "FlattenRewriter");
+  EXPECT_LE(runtime_info->rewriter_stats.begin()->second.wall_time,
+            runtime_info->rewriters.wall_time);
+  // At least the table and the functions.
+  EXPECT_GE(runtime_info->catalog_find_calls, 3);
+  EXPECT_THAT(runtime_info->DebugString(), HasSubstr("FlattenRewriter"));
+
+  // Analyzing from a parse tree has no parser phase.
+  std::unique_ptr<ParserOutput> parser_output;
+  ZETASQL_ASSERT_OK(ParseStatement(sql, ParserOptions(), &parser_output));
+  ZETASQL_ASSERT_OK(AnalyzeStatementFromParserAST(*parser_output->statement(),
+                                          options, sql, catalog.catalog(),
+                                          &type_factory, &output));
+  ASSERT_NE(output->runtime_info(), nullptr);
+  EXPECT_EQ(output->runtime_info()->parser.wall_time, absl::ZeroDuration());
+  EXPECT_GT(output->runtime_info()->resolver.wall_time, absl::ZeroDuration());
+
+  ZETASQL_ASSERT_OK(AnalyzeExpression("1 + 2", options, catalog.catalog(),
+                              &type_factory, &output));
+  ASSERT_NE(output->runtime_info(), nullptr);
+  EXPECT_GT(output->runtime_info()->parser.wall_time, absl::ZeroDuration());
+  EXPECT_EQ(output->runtime_info()->rewriter_iterations, 0);
+}
+
+TEST(AnalyzerTest, TemplatedSQLFunctionCallsWithSameTypesShareBody) {
+  AnalyzerOptions options;
+  SampleCatalog catalog(options.language());
+  TypeFactory type_factory;
+  std::unique_ptr<const AnalyzerOutput> output;
+
+  ZETASQL_ASSERT_OK(AnalyzeStatement(
+      "SELECT udf_templated_return_any_scalar_arg(key), "
+      "       udf_templated_return_any_scalar_arg(key + 1), "
+      "       udf_templated_return_any_scalar_arg(value) "
+      "FROM KeyValue",
+      options, catalog.catalog(), &type_factory, &output));
+  std::vector<const ResolvedNode*> calls;
+  output->resolved_statement()->GetDescendantsWithKinds(
+      {RESOLVED_FUNCTION_CALL}, &calls);
+  std::vector<const ResolvedFunctionCall*> templated_calls;
+  for (const ResolvedNode* node : calls) {
+    const ResolvedFunctionCall* call = node->GetAs<ResolvedFunctionCall>();
+    if (call->function()->Is<TemplatedSQLFunction>()) {
+      templated_calls.push_back(call);
+    }
+  }
+  ASSERT_EQ(templated_calls.size(), 3);
+  ASSERT_NE(templated_calls[0]->function_call_info(), nullptr);
+  EXPECT_EQ(templated_calls[0]->function_call_info(),
+            templated_calls[1]->function_call_info());
+  // A STRING argument needs its own body.
+  EXPECT_NE(templated_calls[0]->function_call_info(),
+            templated_calls[2]->function_call_info());
+  EXPECT_EQ(templated_calls[2]->type(), types::StringType());
+}
+
 // Test that the language_options setters and getters on AnalyzerOptions work
 // correctly and don't overwrite the options outside LanguageOptions.
 TEST(AnalyzerTest, LanguageOptions) {
@@ -0,0 +1,87 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/analyzer/find_counting_catalog.h"
+
+#include <string>
+
+namespace zetasql {
+
+absl::Status FindCountingCatalog::FindTable(
+    const absl::Span<const std::string>& path, const Table** table,
+    const FindOptions& options) {
+  ++num_find_calls_;
+  return catalog_->FindTable(path, table, options);
+}
+
+absl::Status FindCountingCatalog::FindModel(
+    const absl::Span<const std::string>& path, const Model** model,
+    const FindOptions& options) {
+  ++num_find_calls_;
+  return catalog_->FindModel(path, model, options);
+}
+
+absl::Status FindCountingCatalog::FindConnection(
+    const absl::Span<const std::string>& path, const Connection** connection,
+    const FindOptions& options) {
+  ++num_find_calls_;
+  return catalog_->FindConnection(path, connection, options);
+}
+
+absl::Status FindCountingCatalog::FindFunction(
+    const absl::Span<const std::string>& path, const Function** function,
+    const FindOptions& options) {
+  ++num_find_calls_;
+  return catalog_->FindFunction(path, function, options);
+}
+
+absl::Status FindCountingCatalog::FindTableValuedFunction(
+    const absl::Span<const std::string>& path,
+    const TableValuedFunction** function, const FindOptions& options) {
+  ++num_find_calls_;
+  return catalog_->FindTableValuedFunction(path, function, options);
+}
+
+absl::Status FindCountingCatalog::FindProcedure(
+    const absl::Span<const std::string>& path, const Procedure** procedure,
+    const FindOptions& options) {
+  ++num_find_calls_;
+  return catalog_->FindProcedure(path, procedure, options);
+}
+
+absl::Status FindCountingCatalog::FindType(
+    const absl::Span<const std::string>& path, const Type** type,
+    const FindOptions& options) {
+  ++num_find_calls_;
+  return catalog_->FindType(path, type, options);
+}
+
+absl::Status FindCountingCatalog::FindConstantWithPathPrefix(
+    const absl::Span<const std::string> path, int* num_names_consumed,
+    const Constant** constant, const FindOptions& options) {
+  ++num_find_calls_;
+  return catalog_->FindConstantWithPathPrefix(path, num_names_consumed,
+                                              constant, options);
+}
+
+absl::Status FindCountingCatalog::FindConversion(
+    const Type* from_type, const Type* to_type,
+    const FindConversionOptions& options, Conversion* conversion) {
+  ++num_find_calls_;
+  return catalog_->FindConversion(from_type, to_type, options, conversion);
+}
+
+}  // namespace zetasql
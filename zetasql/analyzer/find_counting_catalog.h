@@ -0,0 +1,108 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_ANALYZER_FIND_COUNTING_CATALOG_H_
+#define ZETASQL_ANALYZER_FIND_COUNTING_CATALOG_H_
+
+#include <cstdint>
+#include <string>
+
+#include "zetasql/public/catalog.h"
+#include "zetasql/public/types/type.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+
+namespace zetasql {
+
+// A Catalog that forwards all lookups to another Catalog and counts the
+// Find*() calls, for AnalyzerRuntimeInfo::catalog_find_calls. Not thread-safe,
+// like a single analysis.
+class FindCountingCatalog : public Catalog {
+ public:
+  // Does not take ownership of <catalog>, which must outlive this object.
+  explicit FindCountingCatalog(Catalog* catalog) : catalog_(catalog) {}
+  FindCountingCatalog(const FindCountingCatalog&) = delete;
+  FindCountingCatalog& operator=(const FindCountingCatalog&) = delete;
+
+  int64_t num_find_calls() const { return num_find_calls_; }
+
+  std::string FullName() const override { return catalog_->FullName(); }
+
+  absl::Status FindTable(const absl::Span<const std::string>& path,
+                         const Table** table,
+                         const FindOptions& options = FindOptions()) override;
+  absl::Status FindModel(const absl::Span<const std::string>& path,
+                         const Model** model,
+                         const FindOptions& options = FindOptions()) override;
+  absl::Status FindConnection(const absl::Span<const std::string>& path,
+                              const Connection** connection,
+                              const FindOptions& options) override;
+  absl::Status FindFunction(
+      const absl::Span<const std::string>& path, const Function** function,
+      const FindOptions& options = FindOptions()) override;
+  absl::Status FindTableValuedFunction(
+      const absl::Span<const std::string>& path,
+      const TableValuedFunction** function,
+      const FindOptions& options = FindOptions()) override;
+  absl::Status FindProcedure(
+      const absl::Span<const std::string>& path, const Procedure** procedure,
+      const FindOptions& options = FindOptions()) override;
+  absl::Status FindType(const absl::Span<const std::string>& path,
+                        const Type** type,
+                        const FindOptions& options = FindOptions()) override;
+  absl::Status FindConstantWithPathPrefix(
+      const absl::Span<const std::string> path, int* num_names_consumed,
+      const Constant** constant,
+      const FindOptions& options = FindOptions()) override;
+  absl::Status FindConversion(const Type* from_type, const Type* to_type,
+                              const FindConversionOptions& options,
+                              Conversion* conversion) override;
+
+  absl::StatusOr<TypeListView> GetExtendedTypeSuperTypes(
+      const Type* type) override {
+    return catalog_->GetExtendedTypeSuperTypes(type);
+  }
+
+  std::string SuggestTable(
+      const absl::Span<const std::string>& mistyped_path) override {
+    return catalog_->SuggestTable(mistyped_path);
+  }
+  std::string SuggestModel(
+      const absl::Span<const std::string>& mistyped_path) override {
+    return catalog_->SuggestModel(mistyped_path);
+  }
+  std::string SuggestFunction(
+      const absl::Span<const std::string>& mistyped_path) override {
+    return catalog_->SuggestFunction(mistyped_path);
+  }
+  std::string SuggestTableValuedFunction(
+      const absl::Span<const std::string>& mistyped_path) override {
+    return catalog_->SuggestTableValuedFunction(mistyped_path);
+  }
+  std::string SuggestConstant(
+      const absl::Span<const std::string>& mistyped_path) override {
+    return catalog_->SuggestConstant(mistyped_path);
+  }
+
+ private:
+  Catalog* catalog_;  // Not owned.
+  int64_t num_find_calls_ = 0;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_ANALYZER_FIND_COUNTING_CATALOG_H_
@@ -705,6 +705,47 @@ FunctionResolver::FindMatchingSignature(
           << InputArgumentType::ArgumentsToString(
                  *input_arguments, ProductMode::PRODUCT_INTERNAL);
 
+  // Calls whose argument types exactly match a signature with fixed simple
+  // argument types resolve to that signature, since no other signature can be
+  // a closer match. Try it alone before trying every signature.
+  if (named_arguments.empty()) {
+    const FunctionSignature* exact_signature =
+        function->GetExactMatchSignature(*input_arguments);
+    if (exact_signature != nullptr) {
+      std::unique_ptr<FunctionSignature> result_signature;
+      SignatureMatchResult signature_match_result;
+      std::vector<FunctionArgumentOverride> sig_arg_overrides;
+      ZETASQL_ASSIGN_OR_RETURN(
+          bool is_match,
+          SignatureMatches(arg_locations_in, *input_arguments, *exact_signature,
+                           function->ArgumentsAreCoercible(), name_scope,
+                           &result_signature, &signature_match_result,
+                           &sig_arg_overrides));
+      if (is_match) {
+        ZETASQL_RET_CHECK(result_signature != nullptr);
+        ZETASQL_ASSIGN_OR_RETURN(
+            is_match,
+            result_signature->CheckArgumentConstraints(*input_arguments));
+      }
+      if (is_match) {
+        ZETASQL_RET_CHECK(sig_arg_overrides.empty());
+        // All the arguments are positional and required, so they map to the
+        // signature arguments one to one.
+        arg_index_mapping->clear();
+        for (int i = 0; i < input_arguments->size(); ++i) {
+          arg_index_mapping->push_back(
+              {.signature_arg_index = i, .call_arg_index = i});
+        }
+        if (arg_overrides != nullptr) {
+          arg_overrides->clear();
+        }
+        return result_signature.release();
+      }
+      // Otherwise the signature is not available for this call, and another
+      // one may match with coercion.
+    }
+  }
+
   ZETASQL_RET_CHECK_LE(arg_locations_in.size(), std::numeric_limits<int32_t>::max());
   const int num_provided_args = static_cast<int>(arg_locations_in.size());
   const int num_signatures = function->NumSignatures();
@@ -1806,6 +1847,22 @@ absl::Status FunctionResolver::ResolveTemplatedSQLFunctionCall(
     const AnalyzerOptions& analyzer_options,
     const std::vector<InputArgumentType>& actual_arguments,
     std::shared_ptr<ResolvedFunctionCallInfo>* function_call_info_out) {
+  // Aggregate calls are not shared, since the aggregate columns in their
+  // bodies are computed separately for each call.
+  std::pair<const TemplatedSQLFunction*, std::vector<const Type*>> cache_key;
+  if (!function.IsAggregate()) {
+    cache_key.first = &function;
+    cache_key.second.reserve(actual_arguments.size());
+    for (const InputArgumentType& argument : actual_arguments) {
+      cache_key.second.push_back(argument.type());
+    }
+    auto it = templated_sql_function_calls_.find(cache_key);
+    if (it != templated_sql_function_calls_.end()) {
+      *function_call_info_out = it->second;
+      return absl::OkStatus();
+    }
+  }
+
   // Check if this function calls itself. If so, return an error. Otherwise, add
   // a pointer to this class to the cycle detector in the analyzer options.
   CycleDetector::ObjectInfo object(
@@ -1925,6 +1982,10 @@ absl::Status FunctionResolver::ResolveTemplatedSQLFunctionCall(
   function_call_info_out->reset(new TemplatedSQLFunctionCall(
       std::move(resolved_sql_body),
       query_resolution_info.release_aggregate_columns_to_compute()));
+  if (cache_key.first != nullptr) {
+    templated_sql_function_calls_.emplace(std::move(cache_key),
+                                          *function_call_info_out);
+  }
 
   return absl::OkStatus();
 }
@@ -20,6 +20,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "zetasql/analyzer/expr_resolver_helper.h"
@@ -37,6 +38,7 @@
 #include "zetasql/public/types/type_parameters.h"
 #include "zetasql/public/value.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -123,6 +125,11 @@ class FunctionResolver {
   //
   // Finally, once this check is complete, this method returns the result type
   // of this function call in <function_call_info>.
+  //
+  // The resolved body only depends on <function> and the types of
+  // <actual_arguments>, so for a non-aggregate function it is computed once
+  // per FunctionResolver and shared by all the calls with the same argument
+  // types.
   absl::Status ResolveTemplatedSQLFunctionCall(
       const ASTNode* ast_location, const TemplatedSQLFunction& function,
       const AnalyzerOptions& analyzer_options,
@@ -350,6 +357,15 @@ class FunctionResolver {
   TypeFactory* type_factory_;  // Not owned.
   Resolver* resolver_;         // Not owned.
 
+  // The TemplatedSQLFunctionCalls computed by ResolveTemplatedSQLFunctionCall
+  // for non-aggregate functions, keyed by the function and the argument types.
+  // They refer to the types and IdStrings of the current analysis, so they
+  // cannot outlive it.
+  absl::flat_hash_map<
+      std::pair<const TemplatedSQLFunction*, std::vector<const Type*>>,
+      std::shared_ptr<ResolvedFunctionCallInfo>>
+      templated_sql_function_calls_;
+
   // Returns a signature that matches the argument type list, returning
   // a concrete FunctionSignature if found.  If not found, returns NULL.
   // The caller takes ownership of the returned FunctionSignature.
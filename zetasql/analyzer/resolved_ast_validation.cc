@@ -0,0 +1,112 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/analyzer/resolved_ast_validation.h"
+
+#include <atomic>
+#include <cstdint>
+
+#include "zetasql/public/analyzer_options.h"
+#include "zetasql/public/options.pb.h"
+#include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/validator.h"
+#include "absl/base/attributes.h"
+#include "absl/status/status.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+
+namespace zetasql {
+
+namespace {
+
+ABSL_CONST_INIT std::atomic<int64_t> num_validations{0};
+ABSL_CONST_INIT std::atomic<int64_t> num_skipped_validations{0};
+ABSL_CONST_INIT std::atomic<int64_t> validation_time_nanos{0};
+// Counts the analyses with RESOLVED_AST_VALIDATION_SAMPLED.
+ABSL_CONST_INIT std::atomic<int64_t> num_sampled_analyses{0};
+
+template <typename ValidateFn>
+absl::Status MaybeValidate(const AnalyzerOptions& options, bool validate,
+                           const ValidateFn& validate_fn) {
+  if (!validate) {
+    num_skipped_validations.fetch_add(1, std::memory_order_relaxed);
+    return absl::OkStatus();
+  }
+  const absl::Time start = absl::Now();
+  Validator validator(options.language());
+  const absl::Status status = validate_fn(&validator);
+  validation_time_nanos.fetch_add(absl::ToInt64Nanoseconds(absl::Now() - start),
+                                  std::memory_order_relaxed);
+  num_validations.fetch_add(1, std::memory_order_relaxed);
+  return status;
+}
+
+}  // namespace
+
+ResolvedASTValidationStats GetResolvedASTValidationStats() {
+  ResolvedASTValidationStats stats;
+  stats.num_validations = num_validations.load(std::memory_order_relaxed);
+  stats.num_skipped_validations =
+      num_skipped_validations.load(std::memory_order_relaxed);
+  stats.validation_time =
+      absl::Nanoseconds(validation_time_nanos.load(std::memory_order_relaxed));
+  return stats;
+}
+
+bool ShouldValidateAnalysis(const AnalyzerOptions& options,
+                            bool validate_by_default) {
+  switch (options.validation_mode()) {
+    case RESOLVED_AST_VALIDATION_ALWAYS:
+      return true;
+    case RESOLVED_AST_VALIDATION_SAMPLED:
+      return num_sampled_analyses.fetch_add(1, std::memory_order_relaxed) %
+                 options.validation_sampling_interval() ==
+             0;
+    case RESOLVED_AST_VALIDATION_OFF:
+      return false;
+    default:
+      return validate_by_default;
+  }
+}
+
+bool ShouldValidateRewriterOutput(const AnalyzerOptions& options) {
+  return options.validation_mode() != RESOLVED_AST_VALIDATION_OFF;
+}
+
+void ResetResolvedASTValidationStats() {
+  num_validations.store(0, std::memory_order_relaxed);
+  num_skipped_validations.store(0, std::memory_order_relaxed);
+  validation_time_nanos.store(0, std::memory_order_relaxed);
+  num_sampled_analyses.store(0, std::memory_order_relaxed);
+}
+
+absl::Status MaybeValidateResolvedStatement(
+    const AnalyzerOptions& options, bool validate,
+    const ResolvedStatement* statement) {
+  return MaybeValidate(options, validate, [statement](Validator* v) {
+    return v->ValidateResolvedStatement(statement);
+  });
+}
+
+absl::Status MaybeValidateStandaloneResolvedExpr(const AnalyzerOptions& options,
+                                                 bool validate,
+                                                 const ResolvedExpr* expr) {
+  return MaybeValidate(options, validate, [expr](Validator* v) {
+    return v->ValidateStandaloneResolvedExpr(expr);
+  });
+}
+
+}  // namespace zetasql
@@ -0,0 +1,67 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_ANALYZER_RESOLVED_AST_VALIDATION_H_
+#define ZETASQL_ANALYZER_RESOLVED_AST_VALIDATION_H_
+
+#include <cstdint>
+
+#include "zetasql/public/analyzer_options.h"
+#include "zetasql/resolved_ast/resolved_ast.h"
+#include "absl/status/status.h"
+#include "absl/time/time.h"
+
+namespace zetasql {
+
+// Counters for the resolved AST validation done by the analyzer, accumulated
+// over the whole process.
+struct ResolvedASTValidationStats {
+  // Number of resolved ASTs that were validated.
+  int64_t num_validations = 0;
+  // Number of resolved ASTs that were not validated because of
+  // AnalyzerOptions::validation_mode().
+  int64_t num_skipped_validations = 0;
+  // Total wall time spent in the validator.
+  absl::Duration validation_time;
+};
+
+ResolvedASTValidationStats GetResolvedASTValidationStats();
+void ResetResolvedASTValidationStats();
+
+// Returns whether to validate the resolved AST of an analysis with <options>,
+// before any rewrite. Call it once per analysis: with
+// RESOLVED_AST_VALIDATION_SAMPLED, each call counts as one analysis. With
+// RESOLVED_AST_VALIDATION_DEFAULT, returns <validate_by_default>.
+bool ShouldValidateAnalysis(const AnalyzerOptions& options,
+                            bool validate_by_default);
+
+// Returns whether to validate the output of the rewriters. Rewriters are less
+// tested than the resolver, so their output is validated in every mode but
+// RESOLVED_AST_VALIDATION_OFF, regardless of sampling.
+bool ShouldValidateRewriterOutput(const AnalyzerOptions& options);
+
+// Runs the validator on <statement> or <expr> if <validate> is true, and
+// updates the counters above.
+absl::Status MaybeValidateResolvedStatement(const AnalyzerOptions& options,
+                                            bool validate,
+                                            const ResolvedStatement* statement);
+absl::Status MaybeValidateStandaloneResolvedExpr(const AnalyzerOptions& options,
+                                                 bool validate,
+                                                 const ResolvedExpr* expr);
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_ANALYZER_RESOLVED_AST_VALIDATION_H_
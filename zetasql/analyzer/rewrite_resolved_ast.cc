@@ -17,11 +17,14 @@
 #include "zetasql/analyzer/rewrite_resolved_ast.h"
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 
 #include "zetasql/base/atomic_sequence_num.h"
 #include "zetasql/base/logging.h"
+#include "zetasql/analyzer/analyzer_output_mutator.h"
+#include "zetasql/analyzer/resolved_ast_validation.h"
 #include "zetasql/analyzer/rewriters/registration.h"
 #include "zetasql/analyzer/rewriters/rewriter_interface.h"
 #include "zetasql/analyzer/rewriters/rewriter_relevance_checker.h"
@@ -29,13 +32,13 @@
 #include "zetasql/public/analyzer_options.h"
 #include "zetasql/public/analyzer_output.h"
 #include "zetasql/public/analyzer_output_properties.h"
+#include "zetasql/public/analyzer_runtime_info.h"
 #include "zetasql/public/catalog.h"
 #include "zetasql/public/language_options.h"
 #include "zetasql/public/options.pb.h"
 #include "zetasql/public/types/type_factory.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "zetasql/resolved_ast/resolved_node.h"
-#include "zetasql/resolved_ast/validator.h"
 #include "absl/algorithm/container.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
@@ -88,6 +91,10 @@ AnalyzerOptions AnalyzerOptionsForRewrite(
   options_for_rewrite.set_parameter_mode(ParameterMode::PARAMETER_NAMED);
   options_for_rewrite.set_statement_context(StatementContext::CONTEXT_DEFAULT);
 
+  // Analyses of substitution fragments are accounted to the rewriter that
+  // runs them, so they need no runtime info of their own.
+  options_for_rewrite.set_collect_runtime_info(false);
+
   // Arenas are set to match those in <analyzer_output>, overriding any arenas
   // previously used by the AnalyzerOptions.
   options_for_rewrite.set_arena(analyzer_output.arena());
@@ -110,45 +117,17 @@ AnalyzerOptions AnalyzerOptionsForRewrite(
   return options_for_rewrite;
 }
 
-}  // namespace
-
-// Helper to allow mutating AnalyzerOutput.
-class AnalyzerOutputMutator {
- public:
-  // 'column_factory' and 'output' must outlive AnalyzerOutputMutator.
-  explicit AnalyzerOutputMutator(AnalyzerOutput* output) : output_(*output) {}
-
-  // Updates the output with the new ResolvedNode (and new max column id).
-  absl::Status Update(std::unique_ptr<const ResolvedNode> node,
-                      zetasql_base::SequenceNumber& column_id_seq_num) {
-    output_.max_column_id_ = static_cast<int>(column_id_seq_num.GetNext() - 1);
-    if (output_.statement_ != nullptr) {
-      ZETASQL_RET_CHECK(node->IsStatement());
-      output_.statement_.reset(node.release()->GetAs<ResolvedStatement>());
-    } else {
-      ZETASQL_RET_CHECK(node->IsExpression());
-      output_.expr_.reset(node.release()->GetAs<ResolvedExpr>());
-    }
-    return absl::OkStatus();
-  }
-
-  AnalyzerOutputProperties& mutable_output_properties() {
-    return output_.analyzer_output_properties_;
-  }
-
- private:
-  AnalyzerOutput& output_;
-};
-
-namespace {
 absl::Status InternalRewriteResolvedAstNoConvertErrorLocation(
     const AnalyzerOptions& analyzer_options, Catalog* catalog,
-    TypeFactory* type_factory, AnalyzerOutput& analyzer_output) {
+    TypeFactory* type_factory, AnalyzerOutput& analyzer_output,
+    bool keep_output_on_error) {
   zetasql_base::SequenceNumber fallback_sequence_number;
   AnalyzerOptions options_for_rewrite = AnalyzerOptionsForRewrite(
       analyzer_options, analyzer_output, fallback_sequence_number);
   bool rewrite_activated = false;
   AnalyzerOutputMutator output_mutator(&analyzer_output);
+  AnalyzerRuntimeInfo* runtime_info = output_mutator.mutable_runtime_info();
+  const zetasql_base::UnsafeArena* arena = analyzer_output.arena().get();
 
   ZETASQL_VLOG(3) << "Enabled rewriters: "
           << absl::StrJoin(analyzer_options.enabled_rewrites(), " ",
@@ -156,8 +135,15 @@ absl::Status InternalRewriteResolvedAstNoConvertErrorLocation(
                              absl::StrAppend(s, ResolvedASTRewrite_Name(r));
                            });
 
-  std::unique_ptr<const ResolvedNode> last_rewrite_result;
+  // The output of each rewriter replaces the tree in <analyzer_output> as soon
+  // as it succeeds. Unless <keep_output_on_error>, rewriters take the tree out
+  // of <analyzer_output>, so that the parts of the tree that a rewriter does
+  // not change are reused rather than copied, and a failed rewriter leaves
+  // <analyzer_output> without a tree.
   const ResolvedNode* rewrite_input = NodeFromAnalyzerOutput(analyzer_output);
+  std::optional<ScopedAnalyzerPhaseTimer> rewriters_timer;
+  rewriters_timer.emplace(
+      runtime_info == nullptr ? nullptr : &runtime_info->rewriters, arena);
 
   // TODO: Make this a const reference and remove the modification when
   //     we support multiple rewrite passes. (broken link)
@@ -197,6 +183,7 @@ absl::Status InternalRewriteResolvedAstNoConvertErrorLocation(
   //     in_development from inlining rules.
   static const int64_t kMaxIterations = 25;
   do {
+    if (runtime_info != nullptr) ++runtime_info->rewriter_iterations;
     if (++iterations > kMaxIterations) {
       // The maximum number of iterations is controlled by a flag that engines
       // can set
@@ -216,12 +203,32 @@ absl::Status InternalRewriteResolvedAstNoConvertErrorLocation(
           << ResolvedASTRewrite_Name(ast_rewrite);
 
       ZETASQL_VLOG(2) << "Running rewriter " << rewriter->Name();
-      ZETASQL_ASSIGN_OR_RETURN(
-          last_rewrite_result,
-          rewriter->Rewrite(options_for_rewrite, *rewrite_input, *catalog,
-                            *type_factory,
-                            output_mutator.mutable_output_properties()));
-      rewrite_input = last_rewrite_result.get();
+      {
+        ScopedAnalyzerPhaseTimer rewriter_timer(
+            runtime_info == nullptr
+                ? nullptr
+                : &runtime_info->rewriter_stats[rewriter->Name()],
+            arena);
+        std::unique_ptr<const ResolvedNode> rewrite_result;
+        if (keep_output_on_error) {
+          ZETASQL_ASSIGN_OR_RETURN(
+              rewrite_result,
+              rewriter->Rewrite(options_for_rewrite, *rewrite_input, *catalog,
+                                *type_factory,
+                                output_mutator.mutable_output_properties()));
+        } else {
+          ZETASQL_ASSIGN_OR_RETURN(
+              rewrite_result,
+              rewriter->RewriteOwned(
+                  options_for_rewrite, output_mutator.release_output_node(),
+                  *catalog, *type_factory,
+                  output_mutator.mutable_output_properties()));
+        }
+        ZETASQL_RET_CHECK(rewrite_result != nullptr);
+        rewrite_input = rewrite_result.get();
+        ZETASQL_RETURN_IF_ERROR(
+            output_mutator.UpdateOutputNode(std::move(rewrite_result)));
+      }
       // For the time being, any rewriter that we call Rewrite on is making
       // meaningful changes to the ResolvedAST tree, so we unconditionally
       // record that it activates. When rewriters are cheaper on no-op, that
@@ -244,35 +251,42 @@ absl::Status InternalRewriteResolvedAstNoConvertErrorLocation(
     // TODO: Improve the checker to avoid false positives.
     rewrites_to_apply.erase(REWRITE_ANONYMIZATION);
   } while (!rewrites_to_apply.empty());
+  rewriters_timer.reset();
 
   if (rewrite_activated) {
-    ZETASQL_RETURN_IF_ERROR(output_mutator.Update(
-        std::move(last_rewrite_result),
-        *options_for_rewrite.column_id_sequence_number()));
+    output_mutator.UpdateMaxColumnId(
+        *options_for_rewrite.column_id_sequence_number());
 
     // Make sure the generated ResolvedAST is valid.
-    Validator validator(analyzer_options.language());
+    ScopedAnalyzerPhaseTimer validator_timer(
+        runtime_info == nullptr ? nullptr : &runtime_info->validator, arena);
+    const bool validate = ShouldValidateRewriterOutput(analyzer_options);
     if (analyzer_output.resolved_statement() != nullptr) {
-      ZETASQL_RETURN_IF_ERROR(validator.ValidateResolvedStatement(
-          analyzer_output.resolved_statement()));
+      ZETASQL_RETURN_IF_ERROR(MaybeValidateResolvedStatement(
+          analyzer_options, validate, analyzer_output.resolved_statement()));
     } else {
       ZETASQL_RET_CHECK(analyzer_output.resolved_expr() != nullptr);
-      ZETASQL_RETURN_IF_ERROR(validator.ValidateStandaloneResolvedExpr(
-          analyzer_output.resolved_expr()));
+      ZETASQL_RETURN_IF_ERROR(MaybeValidateStandaloneResolvedExpr(
+          analyzer_options, validate, analyzer_output.resolved_expr()));
     }
+    // Rewriters and the validator read fields of the nodes that are reused
+    // from the input, so start from a clean state for CheckFieldsAccessed, as
+    // after resolution.
+    NodeFromAnalyzerOutput(analyzer_output)->ClearFieldsAccessed();
   }
   return absl::OkStatus();
 }
 
 }  // namespace
 
-// For now each rewrite that activates requires copying the AST. As we add more
-// we'll likely want to improve the rewrite capactiy of the resolved AST so we
-// can do this efficiently without needing unnecessary copies / allocations.
+// Rewriters that override Rewriter::RewriteOwned() rewrite the AST in place
+// unless <keep_output_on_error>; the others copy the whole AST on each rewrite
+// that activates.
 absl::Status InternalRewriteResolvedAst(const AnalyzerOptions& analyzer_options,
                                         absl::string_view sql, Catalog* catalog,
                                         TypeFactory* type_factory,
-                                        AnalyzerOutput& analyzer_output) {
+                                        AnalyzerOutput& analyzer_output,
+                                        bool keep_output_on_error) {
   if (analyzer_output.resolved_statement() == nullptr &&
       analyzer_output.resolved_expr() == nullptr) {
     return absl::OkStatus();
@@ -280,7 +294,8 @@ absl::Status InternalRewriteResolvedAst(const AnalyzerOptions& analyzer_options,
   return ConvertInternalErrorLocationAndAdjustErrorString(
       analyzer_options.error_message_mode(), sql,
       InternalRewriteResolvedAstNoConvertErrorLocation(
-          analyzer_options, catalog, type_factory, analyzer_output));
+          analyzer_options, catalog, type_factory, analyzer_output,
+          keep_output_on_error));
 }
 
 }  // namespace zetasql
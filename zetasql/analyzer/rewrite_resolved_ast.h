@@ -33,10 +33,18 @@ namespace zetasql {
 //
 // (some rewriter class) -> internal analyzer -> InternalRewriteResolvedAst ->
 // RegisterAllRewriters -> (some rewriter class)
+//
+// If <keep_output_on_error> is true, <analyzer_output> holds the output of the
+// last rewriter that succeeded if a later one fails, as RewriteResolvedAst()
+// guarantees. Otherwise, rewriters take ownership of the tree so that they can
+// rewrite it in place, and a failed rewriter leaves <analyzer_output> without
+// a resolved statement or expression. Callers that discard <analyzer_output>
+// on error should pass false.
 absl::Status InternalRewriteResolvedAst(const AnalyzerOptions& analyzer_options,
                                         absl::string_view sql, Catalog* catalog,
                                         TypeFactory* type_factory,
-                                        AnalyzerOutput& analyzer_output);
+                                        AnalyzerOutput& analyzer_output,
+                                        bool keep_output_on_error);
 }  // namespace zetasql
 
 #endif  // ZETASQL_ANALYZER_REWRITE_RESOLVED_AST_H_
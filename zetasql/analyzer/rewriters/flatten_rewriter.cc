@@ -30,11 +30,14 @@
 #include "zetasql/public/types/type_factory.h"
 #include "zetasql/public/value.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_ast_builder.h"
 #include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
 #include "zetasql/resolved_ast/resolved_ast_enums.pb.h"
+#include "zetasql/resolved_ast/resolved_ast_rewrite_visitor.h"
 #include "zetasql/resolved_ast/resolved_column.h"
 #include "zetasql/resolved_ast/resolved_node.h"
 #include "zetasql/resolved_ast/rewrite_utils.h"
+#include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/types/span.h"
@@ -44,8 +47,9 @@
 namespace zetasql {
 namespace {
 
-// A visitor that rewrites ResolvedFlatten nodes into standard UNNESTs.
-class FlattenRewriterVisitor : public ResolvedASTDeepCopyVisitor {
+// A visitor that rewrites ResolvedFlatten nodes into standard UNNESTs. The
+// rest of the tree is reused, not copied.
+class FlattenRewriterVisitor : public ResolvedASTRewriteVisitor {
  public:
   explicit FlattenRewriterVisitor(const AnalyzerOptions* options,
                                   Catalog* catalog,
@@ -53,13 +57,17 @@ class FlattenRewriterVisitor : public ResolvedASTDeepCopyVisitor {
       : fn_builder_(*options, *catalog), column_factory_(column_factory) {}
 
  private:
-  absl::Status VisitResolvedArrayScan(const ResolvedArrayScan* node) override;
+  // An array scan over a flatten is rewritten as a whole, so the flatten is
+  // not visited on its own.
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> VisitResolvedArrayScan(
+      std::unique_ptr<const ResolvedArrayScan> node) override;
 
-  absl::Status VisitResolvedFlatten(const ResolvedFlatten* node) override;
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> PostVisitResolvedFlatten(
+      std::unique_ptr<const ResolvedFlatten> node) override;
 
   // Takes the components of a ResolvedFlatten (its expr, 'flatten_expr' and its
-  // 'get_field_list' and converts it into a resulting ResolvedScan that is
-  // functionally equivalent.
+  // 'get_field_list', both already rewritten) and converts it into a resulting
+  // ResolvedScan that is functionally equivalent.
   //
   // When 'flatten_expr' uses ColumnRefs from a scan, 'input_scan' must be
   // provided to be that input scan.
@@ -78,27 +86,39 @@ class FlattenRewriterVisitor : public ResolvedASTDeepCopyVisitor {
   //
   // The result is the last column in the output scan's column list.
   absl::StatusOr<std::unique_ptr<ResolvedScan>> FlattenToScan(
-      std::unique_ptr<ResolvedExpr> flatten_expr,
-      const std::vector<std::unique_ptr<const ResolvedExpr>>& get_field_list,
-      std::unique_ptr<ResolvedScan> input_scan, bool order_results,
+      std::unique_ptr<const ResolvedExpr> flatten_expr,
+      std::vector<std::unique_ptr<const ResolvedExpr>> get_field_list,
+      std::unique_ptr<const ResolvedScan> input_scan, bool order_results,
       bool in_subquery);
 
   FunctionCallBuilder fn_builder_;
   ColumnFactory* column_factory_;
 };
 
-absl::Status FlattenRewriterVisitor::VisitResolvedArrayScan(
-    const ResolvedArrayScan* node) {
+absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+FlattenRewriterVisitor::VisitResolvedArrayScan(
+    std::unique_ptr<const ResolvedArrayScan> node) {
   if (!node->array_expr()->Is<ResolvedFlatten>()) {
-    return CopyVisitResolvedArrayScan(node);
+    return ResolvedASTRewriteVisitor::VisitResolvedArrayScan(std::move(node));
   }
-  const ResolvedFlatten* flatten = node->array_expr()->GetAs<ResolvedFlatten>();
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedScan> input_scan,
-                   ProcessNode(node->input_scan()));
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedExpr> join_expr,
-                   ProcessNode(node->join_expr()));
-
-  bool need_offset_column = node->array_offset_column() != nullptr;
+  std::vector<std::unique_ptr<const ResolvedColumnRef>> column_refs;
+  ZETASQL_RETURN_IF_ERROR(CollectColumnRefs(*node->array_expr(), &column_refs));
+
+  ResolvedArrayScanBuilder array_scan = ToBuilder(std::move(node));
+  ResolvedFlattenBuilder flatten = ToBuilder(absl::WrapUnique(
+      array_scan.release_array_expr().release()->GetAs<ResolvedFlatten>()));
+  const Type* flatten_type = flatten.type();
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedScan> input_scan,
+                   ProcessNode(array_scan.release_input_scan()));
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedExpr> join_expr,
+                   ProcessNode(array_scan.release_join_expr()));
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedExpr> flatten_expr,
+                   ProcessNode(flatten.release_expr()));
+  std::vector<std::unique_ptr<const ResolvedExpr>> get_field_list =
+      flatten.release_get_field_list();
+  ZETASQL_RETURN_IF_ERROR(ProcessNodeList(get_field_list));
+
+  bool need_offset_column = array_scan.array_offset_column() != nullptr;
   if (need_offset_column || join_expr != nullptr) {
     // If we need an offset column, we rewrite each row to a subquery to
     // generate a single array and then do an array scan over that. This allows
@@ -114,17 +134,13 @@ absl::Status FlattenRewriterVisitor::VisitResolvedArrayScan(
     // column references to the output to do the Get*Field there instead. This
     // is a significantly more complex change but would avoid needing the
     // subquery.
-    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedExpr> flatten_expr,
-                     ProcessNode(flatten->expr()));
     ZETASQL_ASSIGN_OR_RETURN(flatten_expr, CorrelateColumnRefs(*flatten_expr));
     ZETASQL_ASSIGN_OR_RETURN(
         std::unique_ptr<ResolvedScan> scan,
-        FlattenToScan(std::move(flatten_expr), flatten->get_field_list(),
+        FlattenToScan(std::move(flatten_expr), std::move(get_field_list),
                       MakeResolvedSingleRowScan(), need_offset_column,
                       /*in_subquery=*/true));
 
-    std::vector<std::unique_ptr<const ResolvedColumnRef>> column_refs;
-    ZETASQL_RETURN_IF_ERROR(CollectColumnRefs(*flatten, &column_refs));
     if (scan->column_list_size() > 1) {
       // Subquery must produce one value. Remove unneeded intermediary columns.
       // TODO: This can be removed if we avoid using subquery for joins.
@@ -133,44 +149,42 @@ absl::Status FlattenRewriterVisitor::VisitResolvedArrayScan(
       scan->set_column_list(std::move(column_list));
     }
     std::unique_ptr<ResolvedSubqueryExpr> subquery = MakeResolvedSubqueryExpr(
-        flatten->type(), ResolvedSubqueryExpr::ARRAY, std::move(column_refs),
+        flatten_type, ResolvedSubqueryExpr::ARRAY, std::move(column_refs),
         /*in_expr=*/nullptr, std::move(scan));
-    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedColumnHolder> offset_column,
-                     ProcessNode(node->array_offset_column()));
-    PushNodeToStack(MakeResolvedArrayScan(
-        node->column_list(), std::move(input_scan), std::move(subquery),
-        node->element_column(), std::move(offset_column), std::move(join_expr),
-        node->is_outer()));
-    return absl::OkStatus();
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedColumnHolder> offset_column,
+                     ProcessNode(array_scan.release_array_offset_column()));
+    return MakeResolvedArrayScan(
+        array_scan.column_list(), std::move(input_scan), std::move(subquery),
+        array_scan.element_column(), std::move(offset_column),
+        std::move(join_expr), array_scan.is_outer());
   }
 
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedExpr> flatten_expr,
-                   ProcessNode(flatten->expr()));
   ZETASQL_ASSIGN_OR_RETURN(
       std::unique_ptr<ResolvedScan> scan,
-      FlattenToScan(std::move(flatten_expr), flatten->get_field_list(),
+      FlattenToScan(std::move(flatten_expr), std::move(get_field_list),
                     std::move(input_scan), /*order_results=*/false,
                     /*in_subquery=*/false));
 
   // Project the flatten result back to the expected output column.
   std::vector<std::unique_ptr<const ResolvedComputedColumn>> expr_list;
   expr_list.push_back(MakeResolvedComputedColumn(
-      node->element_column(),
+      array_scan.element_column(),
       MakeResolvedColumnRef(scan->column_list().back().type(),
                             scan->column_list().back(),
                             /*is_correlated=*/false)));
-  PushNodeToStack(MakeResolvedProjectScan(
-      node->column_list(), std::move(expr_list), std::move(scan)));
-  return absl::OkStatus();
+  return MakeResolvedProjectScan(array_scan.column_list(), std::move(expr_list),
+                                 std::move(scan));
 }
 
-absl::Status FlattenRewriterVisitor::VisitResolvedFlatten(
-    const ResolvedFlatten* node) {
+absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+FlattenRewriterVisitor::PostVisitResolvedFlatten(
+    std::unique_ptr<const ResolvedFlatten> node) {
   // Define a column to represent the result of evaluating the input. We want
   // the input value referenced both by null checking and flattening, so we use
   // a column to ensure it is only evaluated once.
   ResolvedColumn flatten_expr_column = column_factory_->MakeCol(
       "$flatten_input", "injected", node->expr()->type());
+  const Type* flatten_type = node->type();
 
   // To avoid returning an empty array if the input is NULL, we rewrite to
   // explicitly return NULL in that case. The flatten rewrite would return an
@@ -186,7 +200,7 @@ absl::Status FlattenRewriterVisitor::VisitResolvedFlatten(
                    fn_builder_.IsNull(std::move(input_col)));
   // If so, we return NULL.
   std::unique_ptr<ResolvedExpr> if_then =
-      MakeResolvedLiteral(Value::Null(node->type()));
+      MakeResolvedLiteral(Value::Null(flatten_type));
   // Otherwise, return the flattened result.
   std::vector<std::unique_ptr<const ResolvedColumnRef>> column_refs;
   column_refs.push_back(MakeResolvedColumnRef(flatten_expr_column.type(),
@@ -195,15 +209,16 @@ absl::Status FlattenRewriterVisitor::VisitResolvedFlatten(
   for (const auto& get_field : node->get_field_list()) {
     ZETASQL_RETURN_IF_ERROR(CollectColumnRefs(*get_field, &column_refs));
   }
+  ResolvedFlattenBuilder flatten = ToBuilder(std::move(node));
   ZETASQL_ASSIGN_OR_RETURN(
       std::unique_ptr<ResolvedScan> rewritten_flatten,
       FlattenToScan(
           MakeResolvedColumnRef(flatten_expr_column.type(), flatten_expr_column,
                                 /*is_correlated=*/true),
-          node->get_field_list(), /*input_scan=*/nullptr,
+          flatten.release_get_field_list(), /*input_scan=*/nullptr,
           /*order_results=*/true, /*in_subquery=*/true));
   std::unique_ptr<ResolvedExpr> if_else = MakeResolvedSubqueryExpr(
-      node->type(), ResolvedSubqueryExpr::ARRAY, std::move(column_refs),
+      flatten_type, ResolvedSubqueryExpr::ARRAY, std::move(column_refs),
       /*in_expr=*/nullptr, std::move(rewritten_flatten));
 
   ZETASQL_ASSIGN_OR_RETURN(auto resolved_if,
@@ -211,21 +226,18 @@ absl::Status FlattenRewriterVisitor::VisitResolvedFlatten(
                                   std::move(if_else)));
 
   // Use a ResolvedLetExpr to populate the input variable.
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedExpr> flatten_expr,
-                   ProcessNode(node->expr()));
   std::vector<std::unique_ptr<const ResolvedComputedColumn>> let_assignments;
   let_assignments.push_back(
-      MakeResolvedComputedColumn(flatten_expr_column, std::move(flatten_expr)));
-  PushNodeToStack(MakeResolvedLetExpr(node->type(), std::move(let_assignments),
-                                      std::move(resolved_if)));
-  return absl::OkStatus();
+      MakeResolvedComputedColumn(flatten_expr_column, flatten.release_expr()));
+  return MakeResolvedLetExpr(flatten_type, std::move(let_assignments),
+                             std::move(resolved_if));
 }
 
 absl::StatusOr<std::unique_ptr<ResolvedScan>>
 FlattenRewriterVisitor::FlattenToScan(
-    std::unique_ptr<ResolvedExpr> flatten_expr,
-    const std::vector<std::unique_ptr<const ResolvedExpr>>& get_field_list,
-    std::unique_ptr<ResolvedScan> input_scan, bool order_results,
+    std::unique_ptr<const ResolvedExpr> flatten_expr,
+    std::vector<std::unique_ptr<const ResolvedExpr>> get_field_list,
+    std::unique_ptr<const ResolvedScan> input_scan, bool order_results,
     bool in_subquery) {
   std::vector<ResolvedColumn> column_list;
   if (input_scan != nullptr) column_list = input_scan->column_list();
@@ -250,9 +262,11 @@ FlattenRewriterVisitor::FlattenToScan(
   // Keep track of pending Get*Field on non-array fields.
   std::unique_ptr<const ResolvedExpr> input;
 
-  for (const auto& const_get_field : get_field_list) {
-    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedExpr> get_field,
-                     ProcessNode(const_get_field.get()));
+  for (std::unique_ptr<const ResolvedExpr>& const_get_field : get_field_list) {
+    // This visitor owns the get_field nodes, so their input can be set in
+    // place.
+    std::unique_ptr<ResolvedExpr> get_field = absl::WrapUnique(
+        const_cast<ResolvedExpr*>(const_get_field.release()));
     // Change the input from the FlattenedArg to instead be a ColumnRef or the
     // built-up non-array expression.
     if (input == nullptr) {
@@ -339,14 +353,23 @@ class FlattenRewriter : public Rewriter {
       const AnalyzerOptions& options, const ResolvedNode& input,
       Catalog& catalog, TypeFactory& type_factory,
       AnalyzerOutputProperties& output_properties) const override {
+    ResolvedASTDeepCopyVisitor copier;
+    ZETASQL_RETURN_IF_ERROR(input.Accept(&copier));
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> copy,
+                     copier.ConsumeRootNode<ResolvedNode>());
+    return RewriteOwned(options, std::move(copy), catalog, type_factory,
+                        output_properties);
+  }
+
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> RewriteOwned(
+      const AnalyzerOptions& options, std::unique_ptr<const ResolvedNode> input,
+      Catalog& catalog, TypeFactory& type_factory,
+      AnalyzerOutputProperties& output_properties) const override {
     ZETASQL_RET_CHECK(options.column_id_sequence_number() != nullptr);
     ColumnFactory column_factory(0, options.id_string_pool().get(),
                                  options.column_id_sequence_number());
     FlattenRewriterVisitor rewriter(&options, &catalog, &column_factory);
-    ZETASQL_RETURN_IF_ERROR(input.Accept(&rewriter));
-    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> result,
-                     rewriter.ConsumeRootNode<ResolvedNode>());
-    return result;
+    return rewriter.VisitAll(std::move(input));
   }
 
   std::string Name() const override { return "FlattenRewriter"; }
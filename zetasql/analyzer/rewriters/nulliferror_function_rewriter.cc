@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "zetasql/analyzer/rewriters/rewriter_interface.h"
 #include "zetasql/public/analyzer_options.h"
@@ -35,6 +36,7 @@
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "zetasql/resolved_ast/resolved_ast_builder.h"
 #include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
+#include "zetasql/resolved_ast/resolved_ast_rewrite_visitor.h"
 #include "zetasql/resolved_ast/resolved_node.h"
 #include "zetasql/resolved_ast/rewrite_utils.h"
 #include "absl/types/span.h"
@@ -44,40 +46,48 @@
 namespace zetasql {
 namespace {
 
-// A visitor that rewrites NULLIFERROR(expr) to IFERROR(expr, NULL).
-class NullIfErrorFunctionRewriteVisitor : public ResolvedASTDeepCopyVisitor {
+// A visitor that rewrites NULLIFERROR(expr) to IFERROR(expr, NULL). The rest
+// of the tree is reused, not copied.
+class NullIfErrorFunctionRewriteVisitor : public ResolvedASTRewriteVisitor {
  public:
   NullIfErrorFunctionRewriteVisitor(const AnalyzerOptions& analyzer_options,
                                     Catalog& catalog)
       : fn_builder_(analyzer_options, catalog) {}
 
  private:
-  absl::Status VisitResolvedFunctionCall(
-      const ResolvedFunctionCall* node) override;
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  PostVisitResolvedFunctionCall(
+      std::unique_ptr<const ResolvedFunctionCall> node) override;
 
-  absl::Status RewriteNullIfError(const ResolvedFunctionCall* node);
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> RewriteNullIfError(
+      std::unique_ptr<const ResolvedFunctionCall> node);
 
   FunctionCallBuilder fn_builder_;
 };
 
-absl::Status NullIfErrorFunctionRewriteVisitor::VisitResolvedFunctionCall(
-    const ResolvedFunctionCall* node) {
-  if (IsBuiltInFunctionIdEq(node, FN_NULLIFERROR)) {
+absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+NullIfErrorFunctionRewriteVisitor::PostVisitResolvedFunctionCall(
+    std::unique_ptr<const ResolvedFunctionCall> node) {
+  if (IsBuiltInFunctionIdEq(node.get(), FN_NULLIFERROR)) {
     if (node->hint_list_size() > 0) {
       return ::zetasql_base::UnimplementedErrorBuilder()
              << "The NULLIFERROR() operator does not support hints.";
     }
-    return RewriteNullIfError(node);
+    return RewriteNullIfError(std::move(node));
   }
-  return CopyVisitResolvedFunctionCall(node);
+  return node;
 }
 
-absl::Status NullIfErrorFunctionRewriteVisitor::RewriteNullIfError(
-    const ResolvedFunctionCall* node) {
+absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+NullIfErrorFunctionRewriteVisitor::RewriteNullIfError(
+    std::unique_ptr<const ResolvedFunctionCall> node) {
   ZETASQL_RET_CHECK_EQ(node->argument_list_size(), 1)
       << "NULLIFERROR has 1 expression argument. Got: " << node->DebugString();
-  const ResolvedExpr* try_expr = node->argument_list(0);
-  ZETASQL_RET_CHECK_NE(try_expr, nullptr);
+  // Nested NULLIFERROR calls in the argument have already been rewritten.
+  std::vector<std::unique_ptr<const ResolvedExpr>> arguments =
+      ToBuilder(std::move(node)).release_argument_list();
+  std::unique_ptr<const ResolvedExpr> try_expr = std::move(arguments[0]);
+  ZETASQL_RET_CHECK(try_expr != nullptr);
 
   ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedExpr> null_literal,
                    ResolvedLiteralBuilder()
@@ -86,15 +96,7 @@ absl::Status NullIfErrorFunctionRewriteVisitor::RewriteNullIfError(
                        .set_has_explicit_type(true)
                        .Build());
 
-  // Recurse on the try_expr itself, to rewrite any nested NULLIFERROR calls.
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedExpr> source_processed,
-                   ProcessNode(try_expr));
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedExpr> if_error_call,
-                   fn_builder_.IfError(std::move(source_processed),
-                                       std::move(null_literal)));
-  PushNodeToStack(
-      absl::WrapUnique(const_cast<ResolvedExpr*>(if_error_call.release())));
-  return absl::OkStatus();
+  return fn_builder_.IfError(std::move(try_expr), std::move(null_literal));
 }
 
 }  // namespace
@@ -107,12 +109,23 @@ class NullIfErrorFunctionRewriter : public Rewriter {
       const AnalyzerOptions& options, const ResolvedNode& input,
       Catalog& catalog, TypeFactory& type_factory,
       AnalyzerOutputProperties& output_properties) const override {
+    ResolvedASTDeepCopyVisitor copier;
+    ZETASQL_RETURN_IF_ERROR(input.Accept(&copier));
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> copy,
+                     copier.ConsumeRootNode<ResolvedNode>());
+    return RewriteOwned(options, std::move(copy), catalog, type_factory,
+                        output_properties);
+  };
+
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> RewriteOwned(
+      const AnalyzerOptions& options, std::unique_ptr<const ResolvedNode> input,
+      Catalog& catalog, TypeFactory& type_factory,
+      AnalyzerOutputProperties& output_properties) const override {
     ZETASQL_RET_CHECK(options.id_string_pool() != nullptr);
     ZETASQL_RET_CHECK(options.column_id_sequence_number() != nullptr);
     NullIfErrorFunctionRewriteVisitor rewriter(options, catalog);
-    ZETASQL_RETURN_IF_ERROR(input.Accept(&rewriter));
-    return rewriter.ConsumeRootNode<ResolvedNode>();
-  };
+    return rewriter.VisitAll(std::move(input));
+  }
 };
 
 const Rewriter* GetNullIfErrorFunctionRewriter() {
@@ -41,8 +41,10 @@
 #include "zetasql/public/types/type_factory.h"
 #include "zetasql/public/value.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_ast_builder.h"
 #include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
 #include "zetasql/resolved_ast/resolved_ast_enums.pb.h"
+#include "zetasql/resolved_ast/resolved_ast_rewrite_visitor.h"
 #include "zetasql/resolved_ast/resolved_column.h"
 #include "zetasql/resolved_ast/resolved_node.h"
 #include "zetasql/resolved_ast/resolved_node_kind.pb.h"
@@ -62,7 +64,7 @@ constexpr char kPivot[] = "$pivot";
 constexpr char kPivotExprArg[] = "$pivot_expr_arg";
 constexpr char kPivotAggResult[] = "$pivot_agg_result";
 
-class PivotRewriterVisitor : public ResolvedASTDeepCopyVisitor {
+class PivotRewriterVisitor : public ResolvedASTRewriteVisitor {
  public:
   explicit PivotRewriterVisitor(Catalog* catalog, TypeFactory* type_factory,
                                 ColumnFactory* column_factory,
@@ -88,7 +90,20 @@ class PivotRewriterVisitor : public ResolvedASTDeepCopyVisitor {
     return "EXISTS(SELECT pivot_column INTERSECT ALL SELECT pivot_value)";
   }
 
-  absl::Status VisitResolvedPivotScan(const ResolvedPivotScan* node) override;
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  PostVisitResolvedPivotScan(
+      std::unique_ptr<const ResolvedPivotScan> node) override;
+
+  // Returns a deep copy of <node>. The pivot expressions and pivot values are
+  // referenced once per pivot column, so they are copied rather than moved
+  // into the rewritten tree.
+  template <typename NodeType>
+  static absl::StatusOr<std::unique_ptr<NodeType>> CopyNode(
+      const NodeType* node) {
+    ResolvedASTDeepCopyVisitor copier;
+    ZETASQL_RETURN_IF_ERROR(node->Accept(&copier));
+    return copier.ConsumeRootNode<NodeType>();
+  }
 
   // Returns an aggregate function call representing a single pivot expression
   // over a subset of input where <pivot_value_expr> matches <pivot_column>.
@@ -122,6 +137,9 @@ class PivotRewriterVisitor : public ResolvedASTDeepCopyVisitor {
   // used as the input to the AggregateScan used to represent the rewritten
   // PivotScan.
   //
+  // <input_scan> and <for_expr> are the input scan and FOR expression of
+  // <pivot_scan>, which have been moved out of it.
+  //
   // <pivot_expr_arg_columns> is an output parameter, which is modified to hold
   // the argument columns to each pivot expression.
   // On output, the i'th element is the single argument to the i'th pivot
@@ -129,6 +147,8 @@ class PivotRewriterVisitor : public ResolvedASTDeepCopyVisitor {
   // is "COUNT(*)"), the ResolvedColumn is blank.
   absl::StatusOr<std::unique_ptr<ResolvedScan>> AddExprColumnsToPivotInput(
       const ResolvedPivotScan* pivot_scan,
+      std::unique_ptr<const ResolvedScan> input_scan,
+      std::unique_ptr<const ResolvedExpr> for_expr,
       const ResolvedColumn& for_expr_column,
       std::vector<std::vector<ResolvedColumn>>& pivot_expr_arg_columns);
 
@@ -196,28 +216,25 @@ class PivotRewriterVisitor : public ResolvedASTDeepCopyVisitor {
 
 absl::StatusOr<std::unique_ptr<ResolvedScan>>
 PivotRewriterVisitor::AddExprColumnsToPivotInput(
-    const ResolvedPivotScan* pivot_scan, const ResolvedColumn& for_expr_column,
+    const ResolvedPivotScan* pivot_scan,
+    std::unique_ptr<const ResolvedScan> input_scan,
+    std::unique_ptr<const ResolvedExpr> for_expr,
+    const ResolvedColumn& for_expr_column,
     std::vector<std::vector<ResolvedColumn>>& pivot_expr_arg_columns) {
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedScan> input_scan_copy,
-                   ProcessNode(pivot_scan->input_scan()));
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedExpr> for_expr_copy,
-                   ProcessNode(pivot_scan->for_expr()));
-  if (CollationAnnotation::ExistsIn(
-          pivot_scan->for_expr()->type_annotation_map())) {
+  if (CollationAnnotation::ExistsIn(for_expr->type_annotation_map())) {
     // TODO: support collation on FOR expression.
     return MakeUnimplementedErrorAtPoint(
-               pivot_scan->for_expr()->GetParseLocationOrNULL()->start())
+               for_expr->GetParseLocationOrNULL()->start())
            << "Collation is not supported in a PIVOT clause yet";
   }
 
-  std::vector<ResolvedColumn> column_list(
-      pivot_scan->input_scan()->column_list().begin(),
-      pivot_scan->input_scan()->column_list().end());
+  std::vector<ResolvedColumn> column_list(input_scan->column_list().begin(),
+                                          input_scan->column_list().end());
   column_list.push_back(for_expr_column);
 
   std::vector<std::unique_ptr<ResolvedComputedColumn>> expr_list;
   expr_list.push_back(
-      MakeResolvedComputedColumn(for_expr_column, std::move(for_expr_copy)));
+      MakeResolvedComputedColumn(for_expr_column, std::move(for_expr)));
 
   for (const auto& pivot_expr : pivot_scan->pivot_expr_list()) {
     const ResolvedAggregateFunctionCall* call =
@@ -249,7 +266,7 @@ PivotRewriterVisitor::AddExprColumnsToPivotInput(
         continue;
       }
       ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedExpr> argument_copy,
-                       ProcessNode(arg.get()));
+                       CopyNode(arg.get()));
 
       ResolvedColumn projected_arg_col = column_factory_->MakeCol(
           kPivot, kPivotExprArg, argument_copy->type());
@@ -261,19 +278,31 @@ PivotRewriterVisitor::AddExprColumnsToPivotInput(
   }
 
   return MakeResolvedProjectScan(column_list, std::move(expr_list),
-                                 std::move(input_scan_copy));
+                                 std::move(input_scan));
 }
 
-absl::Status PivotRewriterVisitor::VisitResolvedPivotScan(
-    const ResolvedPivotScan* node) {
-  ResolvedColumn pivot_col = column_factory_->MakeCol("$pivot", "$pivot_value",
-                                                      node->for_expr()->type());
+absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+PivotRewriterVisitor::PostVisitResolvedPivotScan(
+    std::unique_ptr<const ResolvedPivotScan> node) {
+  // The input scan, FOR expression and GROUP BY list each appear once in the
+  // rewritten tree, so they are moved. The rest of <node> is only read.
+  ResolvedPivotScanBuilder builder = ToBuilder(std::move(node));
+  std::unique_ptr<const ResolvedScan> input_scan = builder.release_input_scan();
+  std::unique_ptr<const ResolvedExpr> for_expr = builder.release_for_expr();
+  std::vector<std::unique_ptr<const ResolvedComputedColumn>> group_by_list =
+      builder.release_group_by_list();
+  ZETASQL_ASSIGN_OR_RETURN(node, std::move(builder).Build());
+
+  ResolvedColumn pivot_col =
+      column_factory_->MakeCol("$pivot", "$pivot_value", for_expr->type());
 
   std::vector<std::vector<ResolvedColumn>> agg_fn_argument_columns;
 
   ZETASQL_ASSIGN_OR_RETURN(
       std::unique_ptr<const ResolvedScan> input_with_pivot_column,
-      AddExprColumnsToPivotInput(node, pivot_col, agg_fn_argument_columns));
+      AddExprColumnsToPivotInput(node.get(), std::move(input_scan),
+                                 std::move(for_expr), pivot_col,
+                                 agg_fn_argument_columns));
 
   std::vector<std::unique_ptr<ResolvedComputedColumn>> aggregate_list;
   std::vector<ResolvedColumn> aggregate_scan_column_list;
@@ -285,12 +314,7 @@ absl::Status PivotRewriterVisitor::VisitResolvedPivotScan(
 
   // Insert GROUP BY columns into the aggregate scan's column list, before
   // the pivot columns, to match the column order of the PIVOT clause.
-  std::vector<std::unique_ptr<ResolvedComputedColumn>> group_by_list;
-  group_by_list.reserve(node->group_by_list_size());
-  for (const auto& group_by : node->group_by_list()) {
-    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedComputedColumn> group_by_item,
-                     ProcessNode(group_by.get()));
-    group_by_list.push_back(std::move(group_by_item));
+  for (const auto& group_by : group_by_list) {
     aggregate_scan_column_list.push_back(group_by->column());
   }
 
@@ -353,8 +377,7 @@ absl::Status PivotRewriterVisitor::VisitResolvedPivotScan(
     result = std::move(aggregate_result);
   }
 
-  PushNodeToStack(std::move(result));
-  return absl::OkStatus();
+  return result;
 }
 
 absl::StatusOr<std::unique_ptr<ResolvedScan>>
@@ -588,10 +611,10 @@ PivotRewriterVisitor::MakeAggregateExpr(
   ZETASQL_RETURN_IF_ERROR(VerifyAggregateFunctionIsSupported(call));
 
   ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedExpr> pivot_expr_copy,
-                   ProcessNode(pivot_expr));
+                   CopyNode(pivot_expr));
 
   ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedExpr> pivot_value_expr_copy,
-                   ProcessNode(pivot_value_expr));
+                   CopyNode(pivot_value_expr));
 
   ResolvedAggregateFunctionCall* call_copy =
       pivot_expr_copy->GetAs<ResolvedAggregateFunctionCall>();
@@ -620,7 +643,7 @@ PivotRewriterVisitor::MakeAggregateExpr(
                                        agg_fn_arg_columns[0],
                                        /*is_correlated=*/false);
     } else {
-      ZETASQL_ASSIGN_OR_RETURN(orig_arg, ProcessNode(call->argument_list(0)));
+      ZETASQL_ASSIGN_OR_RETURN(orig_arg, CopyNode(call->argument_list(0)));
     }
     ZETASQL_ASSIGN_OR_RETURN(
         std::unique_ptr<ResolvedExpr> agg_fn_arg,
@@ -641,7 +664,7 @@ PivotRewriterVisitor::MakeAggregateExpr(
             /*is_correlated=*/false));
       } else {
         ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedExpr> arg_copy,
-                         ProcessNode(call->argument_list(i)));
+                         CopyNode(call->argument_list(i)));
         agg_fn_args.push_back(std::move(arg_copy));
       }
     }
@@ -673,12 +696,25 @@ class PivotRewriter : public Rewriter {
     ColumnFactory column_factory(0, options.id_string_pool().get(),
                                  options.column_id_sequence_number());
 
+    ResolvedASTDeepCopyVisitor copier;
+    ZETASQL_RETURN_IF_ERROR(input.Accept(&copier));
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> copy,
+                     copier.ConsumeRootNode<ResolvedNode>());
+    return RewriteOwned(options, std::move(copy), catalog, type_factory,
+                        output_properties);
+  }
+
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> RewriteOwned(
+      const AnalyzerOptions& options, std::unique_ptr<const ResolvedNode> input,
+      Catalog& catalog, TypeFactory& type_factory,
+      AnalyzerOutputProperties& output_properties) const override {
+    ZETASQL_RET_CHECK(options.column_id_sequence_number() != nullptr);
+    ColumnFactory column_factory(0, options.id_string_pool().get(),
+                                 options.column_id_sequence_number());
+
     PivotRewriterVisitor visitor(&catalog, &type_factory, &column_factory,
                                  &options);
-    ZETASQL_RETURN_IF_ERROR(input.Accept(&visitor));
-    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> result,
-                     visitor.ConsumeRootNode<ResolvedStatement>());
-    return result;
+    return visitor.VisitAll(std::move(input));
   }
 };
 
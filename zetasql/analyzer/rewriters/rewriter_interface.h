@@ -20,6 +20,7 @@
 #include <memory>
 #include <string>
 
+#include "zetasql/resolved_ast/resolved_node.h"
 #include "absl/status/statusor.h"
 
 namespace zetasql {
@@ -28,7 +29,6 @@ class AnalyzerOptions;
 class AnalyzerOutput;
 class AnalyzerOutputProperties;
 class Catalog;
-class ResolvedNode;
 class TypeFactory;
 
 // A Rewriter rewrites known patterns in a ResolvedAST, typically to simpler or
@@ -54,6 +54,19 @@ class Rewriter {
       Catalog& catalog, TypeFactory& type_factory,
       AnalyzerOutputProperties& output_properties) const = 0;
 
+  // Like Rewrite(), but takes ownership of 'input'. This is what the rewrite
+  // driver calls. Rewriters that change only a small part of the tree should
+  // override this to reuse the unchanged parts of 'input' rather than copy
+  // them; see ResolvedASTRewriteVisitor.
+  //
+  // The default implementation calls Rewrite() and destroys 'input'.
+  virtual absl::StatusOr<std::unique_ptr<const ResolvedNode>> RewriteOwned(
+      const AnalyzerOptions& options, std::unique_ptr<const ResolvedNode> input,
+      Catalog& catalog, TypeFactory& type_factory,
+      AnalyzerOutputProperties& output_properties) const {
+    return Rewrite(options, *input, catalog, type_factory, output_properties);
+  }
+
   virtual std::string Name() const = 0;
 };
 
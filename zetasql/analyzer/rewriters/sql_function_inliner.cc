@@ -37,6 +37,7 @@
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "zetasql/resolved_ast/resolved_ast_builder.h"
 #include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
+#include "zetasql/resolved_ast/resolved_ast_rewrite_visitor.h"
 #include "zetasql/resolved_ast/resolved_node.h"
 #include "zetasql/resolved_ast/rewrite_utils.h"
 #include "absl/cleanup/cleanup.h"
@@ -231,7 +232,7 @@ static absl::StatusOr<bool> IsCallInlinableAndCollectInfo(
 }
 
 // A visitor that replaces calls to SQL UDFs with the resolved function body.
-class SqlFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
+class SqlFunctionInlineVistor : public ResolvedASTRewriteVisitor {
  public:
   SqlFunctionInlineVistor(const AnalyzerOptions& analyzer_options,
                           Catalog& catalog, ColumnFactory* column_factory)
@@ -239,19 +240,21 @@ class SqlFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
         fn_builder_(analyzer_options, catalog) {}
 
  private:
-  absl::Status VisitResolvedFunctionCall(
-      const ResolvedFunctionCall* node) override {
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  PostVisitResolvedFunctionCall(
+      std::unique_ptr<const ResolvedFunctionCall> node) override {
     std::vector<std::string> arg_names;
     const ResolvedExpr* fn_expression;
-    ZETASQL_ASSIGN_OR_RETURN(bool is_inlinable, IsCallInlinableAndCollectInfo(
-                                            node, arg_names, fn_expression));
+    ZETASQL_ASSIGN_OR_RETURN(
+        bool is_inlinable,
+        IsCallInlinableAndCollectInfo(node.get(), arg_names, fn_expression));
     if (is_inlinable) {
       ZETASQL_RET_CHECK_NE(fn_expression, nullptr)
           << "No function expression supplied with resolved call to SQL "
           << "function " << node->DebugString();
-      return InlineSqlFunction(node, arg_names, fn_expression);
+      return InlineSqlFunction(std::move(node), arg_names, fn_expression);
     }
-    return CopyVisitResolvedFunctionCall(node);
+    return node;
   }
 
   // This function replaces a ResolvedFunctionCall that invokes a SQL function
@@ -266,9 +269,13 @@ class SqlFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
   //   arg1 AS Expr1,
   //   FunctionBodyExpr
   // )
-  absl::Status InlineSqlFunction(const ResolvedFunctionCall* call,
-                                 absl::Span<const std::string> argument_names,
-                                 const ResolvedExpr* fn_expression) {
+  //
+  // The arguments of 'call' have already been rewritten and are moved into the
+  // result.
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> InlineSqlFunction(
+      std::unique_ptr<const ResolvedFunctionCall> call,
+      absl::Span<const std::string> argument_names,
+      const ResolvedExpr* fn_expression) {
     ZETASQL_RET_CHECK_EQ(call->argument_list_size(), argument_names.size());
     ZETASQL_RET_CHECK_EQ(call->generic_argument_list_size(), 0);
     ZETASQL_RET_CHECK_NE(column_factory_, nullptr);
@@ -293,16 +300,18 @@ class SqlFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
     // Nullary functions get special treatment because we don't have to do any
     // special argument processing.
     if (argument_names.empty()) {
-      PushNodeToStack(std::move(body_expr));
-      return absl::OkStatus();
+      return body_expr;
     }
 
+    ResolvedFunctionCallBuilder call_builder = ToBuilder(std::move(call));
+    std::vector<std::unique_ptr<const ResolvedExpr>> arguments =
+        call_builder.release_argument_list();
+    ZETASQL_ASSIGN_OR_RETURN(call, std::move(call_builder).Build());
+
     std::vector<std::unique_ptr<const ResolvedComputedColumn>> arg_exprs;
     ArgNameToColumnMap args = ArgNameToColumnMap{};
-    for (int i = 0; i < call->argument_list_size(); ++i) {
-      // Copy the reference expression.
-      ZETASQL_RETURN_IF_ERROR(call->argument_list(i)->Accept(this));
-      auto arg_expr = ConsumeTopOfStack<ResolvedExpr>();
+    for (int i = 0; i < arguments.size(); ++i) {
+      std::unique_ptr<const ResolvedExpr> arg_expr = std::move(arguments[i]);
       ResolvedColumn arg_column = column_factory_->MakeCol(
           absl::StrCat("$inlined_", call->function()->Name()),
           argument_names[i], arg_expr->type());
@@ -319,9 +328,8 @@ class SqlFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
     ZETASQL_ASSIGN_OR_RETURN(body_expr, ResolvedArgumentRefReplacer::ReplaceArgs(
                                     std::move(body_expr), args));
 
-    PushNodeToStack(MakeResolvedLetExpr(call->type(), std::move(arg_exprs),
-                                        std::move(body_expr)));
-    return absl::OkStatus();
+    return MakeResolvedLetExpr(call->type(), std::move(arg_exprs),
+                               std::move(body_expr));
   }
 
   ColumnFactory* column_factory_;
@@ -334,20 +342,31 @@ class SqlFunctionInliner : public Rewriter {
       const AnalyzerOptions& options, const ResolvedNode& input,
       Catalog& catalog, TypeFactory& type_factory,
       AnalyzerOutputProperties& output_properties) const override {
+    ResolvedASTDeepCopyVisitor copier;
+    ZETASQL_RETURN_IF_ERROR(input.Accept(&copier));
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> copy,
+                     copier.ConsumeRootNode<ResolvedNode>());
+    return RewriteOwned(options, std::move(copy), catalog, type_factory,
+                        output_properties);
+  }
+
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> RewriteOwned(
+      const AnalyzerOptions& options, std::unique_ptr<const ResolvedNode> input,
+      Catalog& catalog, TypeFactory& type_factory,
+      AnalyzerOutputProperties& output_properties) const override {
     ZETASQL_RET_CHECK(options.column_id_sequence_number() != nullptr);
     ColumnFactory column_factory(0, options.id_string_pool().get(),
                                  options.column_id_sequence_number());
 
     SqlFunctionInlineVistor rewriter(options, catalog, &column_factory);
-    ZETASQL_RETURN_IF_ERROR(input.Accept(&rewriter));
-    return rewriter.ConsumeRootNode<ResolvedNode>();
+    return rewriter.VisitAll(std::move(input));
   }
 
   std::string Name() const override { return "SqlFunctionInliner"; }
 };
 
 // A visitor that replaces calls to SQL TDFs with the resolved function body.
-class SqlTableFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
+class SqlTableFunctionInlineVistor : public ResolvedASTRewriteVisitor {
  public:
   explicit SqlTableFunctionInlineVistor(ColumnFactory* column_factory)
       : column_factory_(column_factory) {}
@@ -366,12 +385,13 @@ class SqlTableFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
     return function->Is<SQLTableValuedFunction>();
   }
 
-  absl::Status VisitResolvedTVFScan(const ResolvedTVFScan* tvf_scan) override {
-    ZETASQL_ASSIGN_OR_RETURN(bool inlinable, IsCallInlinable(tvf_scan));
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> PostVisitResolvedTVFScan(
+      std::unique_ptr<const ResolvedTVFScan> tvf_scan) override {
+    ZETASQL_ASSIGN_OR_RETURN(bool inlinable, IsCallInlinable(tvf_scan.get()));
     if (inlinable) {
-      return InlineTVF(tvf_scan);
+      return InlineTVF(std::move(tvf_scan));
     }
-    return CopyVisitResolvedTVFScan(tvf_scan);
+    return tvf_scan;
   }
 
   // This function replaces a ResolvedTVFScan that invokes a SQL table function
@@ -381,8 +401,12 @@ class SqlTableFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
   // SELECT ... FROM MyTvf() AS t;
   // ~~>
   // (SELECT ... FROM (tvf_query) AS t
-  absl::Status InlineTVF(const ResolvedTVFScan* scan) {
-    ZETASQL_RET_CHECK_NE(scan, nullptr);
+  //
+  // The arguments of 'scan' have already been rewritten and are moved into the
+  // result.
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> InlineTVF(
+      std::unique_ptr<const ResolvedTVFScan> scan) {
+    ZETASQL_RET_CHECK(scan != nullptr);
     ZETASQL_RET_CHECK_NE(column_factory_, nullptr);
     const SQLTableValuedFunction* sql_tvf =
         scan->tvf()->GetAs<SQLTableValuedFunction>();
@@ -405,14 +429,18 @@ class SqlTableFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
     // Nullary functions get special treatment because we don't have to do any
     // special argument processing.
     if (scan->argument_list_size() == 0) {
-      PushNodeToStack(std::move(body_scan));
-      return absl::OkStatus();
+      return body_scan;
     }
 
     const std::vector<std::string>& argument_names =
         sql_tvf->GetArgumentNames();
     ZETASQL_RET_CHECK_EQ(argument_names.size(), scan->argument_list_size());
 
+    ResolvedTVFScanBuilder scan_builder = ToBuilder(std::move(scan));
+    std::vector<std::unique_ptr<const ResolvedFunctionArgument>> arguments =
+        scan_builder.release_argument_list();
+    ZETASQL_ASSIGN_OR_RETURN(scan, std::move(scan_builder).Build());
+
     // The inlined TVF will become a subquery that contains one CTE query per
     // table argument and one CTE query that computes all scalar arguments with
     // as-if-once semantics.
@@ -423,14 +451,16 @@ class SqlTableFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
     std::vector<std::unique_ptr<const ResolvedComputedColumn>> scalar_arg_exprs;
     std::vector<ResolvedColumn> arg_columns;
     ArgNameToColumnMap args = ArgNameToColumnMap{};
-    std::string cte_name =
-        absl::StrCat("$inlined_", scan->tvf()->Name(), "_scalar_args");
-    for (int i = 0; i < scan->argument_list_size(); ++i) {
-      if (scan->argument_list(i)->scan() != nullptr) {
+    std::string scan_name = absl::StrCat("$inlined_", scan->tvf()->Name());
+    std::string cte_name = absl::StrCat(scan_name, "_scalar_args");
+    for (int i = 0; i < arguments.size(); ++i) {
+      if (arguments[i]->scan() != nullptr) {
         return absl::UnimplementedError(
             "Inlining TVFs with table arguments is not yet supported.");
       }
-      const ResolvedExpr* argument = scan->argument_list(i)->expr();
+      std::unique_ptr<const ResolvedExpr> arg_expr =
+          ToBuilder(std::move(arguments[i])).release_expr();
+      const ResolvedExpr* argument = arg_expr.get();
       std::string arg_name = argument_names[i];
       if (argument == nullptr) {
         return absl::UnimplementedError(
@@ -446,14 +476,11 @@ class SqlTableFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
             "Arg #", i + 1, " ('", arg_name, "') references column '",
             free_vars[0]->column().name(), "'."));
       }
-      ZETASQL_RETURN_IF_ERROR(argument->Accept(this));
-      auto arg_expr = ConsumeTopOfStack<ResolvedExpr>();
-      args[argument_names[i]] = [scan, &arg_columns,
+      args[argument_names[i]] = [scan_name, &arg_columns,
                                  projected_col_index = arg_columns.size(),
                                  cte_name, this](bool is_correlated)
           -> absl::StatusOr<std::unique_ptr<const ResolvedExpr>> {
         ZETASQL_RET_CHECK_LT(projected_col_index, arg_columns.size());
-        std::string scan_name = absl::StrCat("$inlined_", scan->tvf()->Name());
         auto with_ref =
             ResolvedWithRefScanBuilder().set_with_query_name(cte_name);
         ResolvedProjectScanBuilder project;
@@ -475,9 +502,8 @@ class SqlTableFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
                 std::move(project).set_input_scan(std::move(with_ref)))
             .Build();
       };
-      ResolvedColumn arg_column = column_factory_->MakeCol(
-          absl::StrCat("$inlined_", scan->tvf()->Name()), arg_name,
-          arg_expr->type());
+      ResolvedColumn arg_column =
+          column_factory_->MakeCol(scan_name, arg_name, arg_expr->type());
       scalar_arg_exprs.push_back(
           MakeResolvedComputedColumn(arg_column, std::move(arg_expr)));
       arg_columns.push_back(arg_column);
@@ -497,10 +523,8 @@ class SqlTableFunctionInlineVistor : public ResolvedASTDeepCopyVisitor {
     ZETASQL_RET_CHECK(!with_entry_list.empty());
     // This variable prevents use-after move ambiguity in the following stmt.
     const std::vector<ResolvedColumn>& columns = body_scan->column_list();
-    PushNodeToStack(MakeResolvedWithScan(columns, std::move(with_entry_list),
-                                         std::move(body_scan),
-                                         /*recursive=*/false));
-    return absl::OkStatus();
+    return MakeResolvedWithScan(columns, std::move(with_entry_list),
+                                std::move(body_scan), /*recursive=*/false);
   }
 
  private:
@@ -513,12 +537,23 @@ class SqlTvfInliner : public Rewriter {
       const AnalyzerOptions& options, const ResolvedNode& input,
       Catalog& catalog, TypeFactory& type_factory,
       AnalyzerOutputProperties& output_properties) const override {
+    ResolvedASTDeepCopyVisitor copier;
+    ZETASQL_RETURN_IF_ERROR(input.Accept(&copier));
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> copy,
+                     copier.ConsumeRootNode<ResolvedNode>());
+    return RewriteOwned(options, std::move(copy), catalog, type_factory,
+                        output_properties);
+  }
+
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> RewriteOwned(
+      const AnalyzerOptions& options, std::unique_ptr<const ResolvedNode> input,
+      Catalog& catalog, TypeFactory& type_factory,
+      AnalyzerOutputProperties& output_properties) const override {
     ZETASQL_RET_CHECK(options.column_id_sequence_number() != nullptr);
     ColumnFactory column_factory(0, options.id_string_pool().get(),
                                  options.column_id_sequence_number());
     SqlTableFunctionInlineVistor rewriter(&column_factory);
-    ZETASQL_RETURN_IF_ERROR(input.Accept(&rewriter));
-    return rewriter.ConsumeRootNode<ResolvedNode>();
+    return rewriter.VisitAll(std::move(input));
   }
 
   std::string Name() const override { return "SqlTvfInliner"; }
@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "zetasql/analyzer/rewriters/rewriter_interface.h"
 #include "zetasql/public/analyzer_options.h"
@@ -33,7 +34,9 @@
 #include "zetasql/public/types/type_factory.h"
 #include "zetasql/public/value.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_ast_builder.h"
 #include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
+#include "zetasql/resolved_ast/resolved_ast_rewrite_visitor.h"
 #include "zetasql/resolved_ast/resolved_node.h"
 #include "zetasql/resolved_ast/rewrite_utils.h"
 #include "absl/status/status.h"
@@ -53,7 +56,9 @@ namespace {
 // 2) Engines will see the original source expression in case it needs to track
 //    object access for permission checks or expression sorts for supported-ness
 //    checks.
-class TypeofFunctionRewriteVisitor : public ResolvedASTDeepCopyVisitor {
+//
+// The rest of the tree is reused, not copied.
+class TypeofFunctionRewriteVisitor : public ResolvedASTRewriteVisitor {
  public:
   TypeofFunctionRewriteVisitor(const AnalyzerOptions& analyzer_options,
                                Catalog* catalog, TypeFactory* type_factory)
@@ -62,34 +67,42 @@ class TypeofFunctionRewriteVisitor : public ResolvedASTDeepCopyVisitor {
         type_factory_(type_factory) {}
 
  private:
-  absl::Status VisitResolvedFunctionCall(
-      const ResolvedFunctionCall* node) override;
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  PostVisitResolvedFunctionCall(
+      std::unique_ptr<const ResolvedFunctionCall> node) override;
 
-  absl::Status RewriteTypeof(const ResolvedFunctionCall* node);
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> RewriteTypeof(
+      std::unique_ptr<const ResolvedFunctionCall> node);
 
   const AnalyzerOptions& analyzer_options_;
   FunctionCallBuilder fn_builder_;
   TypeFactory* type_factory_;
 };
 
-absl::Status TypeofFunctionRewriteVisitor::VisitResolvedFunctionCall(
-    const ResolvedFunctionCall* node) {
-  if (IsBuiltInFunctionIdEq(node, FN_TYPEOF)) {
+absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+TypeofFunctionRewriteVisitor::PostVisitResolvedFunctionCall(
+    std::unique_ptr<const ResolvedFunctionCall> node) {
+  if (IsBuiltInFunctionIdEq(node.get(), FN_TYPEOF)) {
     if (node->hint_list_size() > 0) {
       return ::zetasql_base::UnimplementedErrorBuilder()
              << "The TYPEOF() operator does not support hints.";
     }
-    return RewriteTypeof(node);
+    return RewriteTypeof(std::move(node));
   }
-  return CopyVisitResolvedFunctionCall(node);
+  return node;
 }
 
-absl::Status TypeofFunctionRewriteVisitor::RewriteTypeof(
-    const ResolvedFunctionCall* node) {
+absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+TypeofFunctionRewriteVisitor::RewriteTypeof(
+    std::unique_ptr<const ResolvedFunctionCall> node) {
   ZETASQL_RET_CHECK_EQ(node->argument_list_size(), 1)
       << "TYPEOF has 1 expression argument. Got: " << node->DebugString();
-  const ResolvedExpr* original_expr = node->argument_list(0);
-  ZETASQL_RET_CHECK_NE(original_expr, nullptr);
+  // The argument has already been rewritten, so it can be moved as-is into
+  // the replacement.
+  std::vector<std::unique_ptr<const ResolvedExpr>> arguments =
+      ToBuilder(std::move(node)).release_argument_list();
+  std::unique_ptr<const ResolvedExpr> original_expr = std::move(arguments[0]);
+  ZETASQL_RET_CHECK(original_expr != nullptr);
 
   std::unique_ptr<ResolvedExpr> true_literal =
       MakeResolvedLiteral(type_factory_->get_bool(), Value::Bool(true),
@@ -100,20 +113,14 @@ absl::Status TypeofFunctionRewriteVisitor::RewriteTypeof(
                               analyzer_options_.language().product_mode())),
                           /*has_explicit_type=*/true);
 
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedExpr> source_processed,
-                   ProcessNode(original_expr));
   ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedExpr> source_is_null,
-                   fn_builder_.IsNull(std::move(source_processed)));
+                   fn_builder_.IsNull(std::move(original_expr)));
   std::unique_ptr<ResolvedExpr> souce_cast_as_string =
       MakeResolvedCast(types::StringType(), std::move(source_is_null),
                        /*return_null_on_error=*/false);
 
-  ZETASQL_ASSIGN_OR_RETURN(
-      auto resolved_if,
-      fn_builder_.If(std::move(true_literal), std::move(typename_literal),
-                     std::move(souce_cast_as_string)));
-  PushNodeToStack(std::move(resolved_if));
-  return absl::OkStatus();
+  return fn_builder_.If(std::move(true_literal), std::move(typename_literal),
+                        std::move(souce_cast_as_string));
 }
 
 }  // namespace
@@ -124,11 +131,22 @@ class TypeofFunctionRewriter : public Rewriter {
       const AnalyzerOptions& options, const ResolvedNode& input,
       Catalog& catalog, TypeFactory& type_factory,
       AnalyzerOutputProperties& output_properties) const override {
+    ResolvedASTDeepCopyVisitor copier;
+    ZETASQL_RETURN_IF_ERROR(input.Accept(&copier));
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> copy,
+                     copier.ConsumeRootNode<ResolvedNode>());
+    return RewriteOwned(options, std::move(copy), catalog, type_factory,
+                        output_properties);
+  }
+
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> RewriteOwned(
+      const AnalyzerOptions& options, std::unique_ptr<const ResolvedNode> input,
+      Catalog& catalog, TypeFactory& type_factory,
+      AnalyzerOutputProperties& output_properties) const override {
     ZETASQL_RET_CHECK(options.id_string_pool() != nullptr);
     ZETASQL_RET_CHECK(options.column_id_sequence_number() != nullptr);
     TypeofFunctionRewriteVisitor rewriter(options, &catalog, &type_factory);
-    ZETASQL_RETURN_IF_ERROR(input.Accept(&rewriter));
-    return rewriter.ConsumeRootNode<ResolvedNode>();
+    return rewriter.VisitAll(std::move(input));
   }
 
   std::string Name() const override { return "TypeofFunctionRewriter"; }
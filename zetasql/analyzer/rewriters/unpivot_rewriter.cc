@@ -33,7 +33,9 @@
 #include "zetasql/public/types/struct_type.h"
 #include "zetasql/public/types/type_factory.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_ast_builder.h"
 #include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
+#include "zetasql/resolved_ast/resolved_ast_rewrite_visitor.h"
 #include "zetasql/resolved_ast/resolved_column.h"
 #include "zetasql/resolved_ast/resolved_node.h"
 #include "zetasql/resolved_ast/rewrite_utils.h"
@@ -61,7 +63,7 @@ namespace {
 //      CROSS JOIN UNNEST (
 //            [ struct ( input_col1 AS value_col, 'label1' AS label_col ) ,
 //              struct ( input_col2 AS value_col, 'label2' AS label_col ) ] ) ;
-class UnpivotRewriterVisitor : public ResolvedASTDeepCopyVisitor {
+class UnpivotRewriterVisitor : public ResolvedASTRewriteVisitor {
  public:
   UnpivotRewriterVisitor(const AnalyzerOptions* analyzer_options,
                          Catalog* catalog, TypeFactory* type_factory)
@@ -74,8 +76,9 @@ class UnpivotRewriterVisitor : public ResolvedASTDeepCopyVisitor {
   UnpivotRewriterVisitor& operator=(const UnpivotRewriterVisitor&) = delete;
 
  private:
-  absl::Status VisitResolvedUnpivotScan(
-      const ResolvedUnpivotScan* node) override;
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  PostVisitResolvedUnpivotScan(
+      std::unique_ptr<const ResolvedUnpivotScan> node) override;
 
   // Creates an ArrayScan from struct elements which outputs a row for each
   // struct element into the new element_column of the ArrayScan.
@@ -86,9 +89,12 @@ class UnpivotRewriterVisitor : public ResolvedASTDeepCopyVisitor {
   // struct_type : STRUCT <a type, b type, c type>
   // vector of struct elements :
   // { <w , x, label_list[0]>, <y , z , label_list[1]> }
+  // 'input_scan' is the input scan of 'node', which has been moved out of it.
   absl::StatusOr<std::unique_ptr<ResolvedArrayScan>>
-  CreateArrayScanWithStructElements(const ResolvedUnpivotScan* node,
-                                    const StructType** struct_type);
+  CreateArrayScanWithStructElements(
+      const ResolvedUnpivotScan* node,
+      std::unique_ptr<const ResolvedScan> input_scan,
+      const StructType** struct_type);
 
   const AnalyzerOptions& analyzer_options_;
   Catalog* const catalog_;
@@ -114,71 +120,64 @@ static void FilterNonProjectedColumns(
   candidates.swap(filtered);
 }
 
-absl::Status UnpivotRewriterVisitor::VisitResolvedUnpivotScan(
-    const ResolvedUnpivotScan* node) {
+absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+UnpivotRewriterVisitor::PostVisitResolvedUnpivotScan(
+    std::unique_ptr<const ResolvedUnpivotScan> node) {
+  // The input scan and the projected input columns are moved into the
+  // rewritten tree. The rest of 'node' is only read.
+  ResolvedUnpivotScanBuilder builder = ToBuilder(std::move(node));
+  std::unique_ptr<const ResolvedScan> input_scan = builder.release_input_scan();
+  std::vector<std::unique_ptr<const ResolvedComputedColumn>>
+      projected_input_column_list =
+          builder.release_projected_input_column_list();
+  ZETASQL_ASSIGN_OR_RETURN(node, std::move(builder).Build());
+
   const StructType* struct_type;
-  ZETASQL_ASSIGN_OR_RETURN(
-      std::unique_ptr<ResolvedArrayScan> struct_elements_array_scan,
-      CreateArrayScanWithStructElements(node, &struct_type));
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedArrayScan> struct_elements_array_scan,
+                   CreateArrayScanWithStructElements(
+                       node.get(), std::move(input_scan), &struct_type));
 
   // Create a ResolvedProjectScan that gets the individual struct fields from
   // the element_column of the ArrayScan and puts their values into the new
   // unpivot value and name columns, in that order.
-  std::vector<std::unique_ptr<const ResolvedComputedColumn>> expr_list;
-  for (const std::unique_ptr<const ResolvedComputedColumn>&
-           input_projected_column : node->projected_input_column_list()) {
-    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedExpr> column_ref_exp,
-                     ProcessNode(input_projected_column->expr()));
-    std::unique_ptr<ResolvedComputedColumn> computed_projected_column =
-        MakeResolvedComputedColumn(input_projected_column->column(),
-                                   std::move(column_ref_exp));
-    expr_list.push_back(std::move(computed_projected_column));
-  }
-  std::vector<const ResolvedGetStructField*> value_column_struct_fields;
+  std::vector<std::unique_ptr<const ResolvedComputedColumn>> expr_list =
+      std::move(projected_input_column_list);
   ResolvedColumn unnest_column = struct_elements_array_scan->element_column();
-  ZETASQL_RET_CHECK(struct_type->fields().size() ==
-            node->value_column_list_size() + 1 /*for label column*/);
-  for (int i = 0; i <= node->value_column_list_size(); ++i) {
-    std::unique_ptr<ResolvedExpr> column_expr = MakeResolvedGetStructField(
+  auto make_struct_field = [&struct_type, &unnest_column](int i) {
+    return MakeResolvedGetStructField(
         struct_type->field(i).type,
         MakeResolvedColumnRef(unnest_column.type(), unnest_column,
                               /*is_correlated=*/false),
         i);
-    std::unique_ptr<ResolvedComputedColumn> col = MakeResolvedComputedColumn(
+  };
+  ZETASQL_RET_CHECK(struct_type->fields().size() ==
+            node->value_column_list_size() + 1 /*for label column*/);
+  for (int i = 0; i <= node->value_column_list_size(); ++i) {
+    expr_list.push_back(MakeResolvedComputedColumn(
         i < node->value_column_list_size() ? node->value_column_list(i)
                                            : node->label_column(),
-        std::move(column_expr));
-    // Only struct fields for value-columns are included for EXCLUDE NULLS
-    // filter as the label column value is not checked for this filter.
-    if (i < node->value_column_list_size()) {
-      value_column_struct_fields.push_back(
-          col->expr()->GetAs<ResolvedGetStructField>());
-    }
-    expr_list.push_back(std::move(col));
+        make_struct_field(i)));
   }
 
   if (node->include_nulls()) {
     FilterNonProjectedColumns(node->column_list(), expr_list);
-    PushNodeToStack(
-        MakeResolvedProjectScan(node->column_list(), std::move(expr_list),
-                                std::move(struct_elements_array_scan)));
-    return absl::OkStatus();
+    return MakeResolvedProjectScan(node->column_list(), std::move(expr_list),
+                                   std::move(struct_elements_array_scan));
   }
 
   // If INCLUDE NULLS is not explicitly specified, add filter to only include
   // the rows in the output where at least one unpivot value columns is
   // "not null". We do this by concatenating the checks for struct fields (that
   // result in output value columns) with "or" function.
+  // Only struct fields for value-columns are included for EXCLUDE NULLS
+  // filter as the label column value is not checked for this filter.
   std::vector<std::unique_ptr<ResolvedExpr>> or_function_args;
-  for (const zetasql::ResolvedExpr* value_column_struct_field :
-       value_column_struct_fields) {
-    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedExpr> value_struct_expr,
-                     ProcessNode(value_column_struct_field));
+  for (int i = 0; i < node->value_column_list_size(); ++i) {
     // The null function checks that the struct field that holds the values for
     // the unpivot value columns is null. We then use a not function since we
     // want to add a filter for this value to not be null.
     ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ResolvedExpr> is_null_function_expr,
-                     fn_builder_.IsNull(std::move(value_struct_expr)));
+                     fn_builder_.IsNull(make_struct_field(i)));
 
     const Function* is_not_function;
     ZETASQL_RET_CHECK_OK(catalog_->FindFunction({"$not"}, &is_not_function,
@@ -227,18 +226,15 @@ absl::Status UnpivotRewriterVisitor::VisitResolvedUnpivotScan(
                              std::move(filter_expression));
 
   FilterNonProjectedColumns(node->column_list(), expr_list);
-  PushNodeToStack(
-      MakeResolvedProjectScan(node->column_list(), std::move(expr_list),
-                              std::move(exclude_nulls_filter_scan)));
-  return absl::OkStatus();
+  return MakeResolvedProjectScan(node->column_list(), std::move(expr_list),
+                                 std::move(exclude_nulls_filter_scan));
 }
 
 absl::StatusOr<std::unique_ptr<ResolvedArrayScan>>
 UnpivotRewriterVisitor::CreateArrayScanWithStructElements(
-    const ResolvedUnpivotScan* node, const StructType** struct_type) {
-  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedScan> input_scan,
-                   ProcessNode(node->input_scan()));
-
+    const ResolvedUnpivotScan* node,
+    std::unique_ptr<const ResolvedScan> input_scan,
+    const StructType** struct_type) {
   // Struct type is created using names and datatypes from the unpivot value
   // columns and label column, in that order.
   std::vector<StructField> struct_fields;
@@ -323,11 +319,20 @@ class UnpivotRewriter : public Rewriter {
       const AnalyzerOptions& options, const ResolvedNode& input,
       Catalog& catalog, TypeFactory& type_factory,
       AnalyzerOutputProperties& output_properties) const override {
+    ResolvedASTDeepCopyVisitor copier;
+    ZETASQL_RETURN_IF_ERROR(input.Accept(&copier));
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> copy,
+                     copier.ConsumeRootNode<ResolvedNode>());
+    return RewriteOwned(options, std::move(copy), catalog, type_factory,
+                        output_properties);
+  }
+
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> RewriteOwned(
+      const AnalyzerOptions& options, std::unique_ptr<const ResolvedNode> input,
+      Catalog& catalog, TypeFactory& type_factory,
+      AnalyzerOutputProperties& output_properties) const override {
     UnpivotRewriterVisitor visitor(&options, &catalog, &type_factory);
-    ZETASQL_RETURN_IF_ERROR(input.Accept(&visitor));
-    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedNode> result,
-                     visitor.ConsumeRootNode<ResolvedStatement>());
-    return result;
+    return visitor.VisitAll(std::move(input));
   }
   std::string Name() const override { return "UnpivotRewriter"; }
 };
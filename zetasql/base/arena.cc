@@ -127,6 +127,7 @@ BaseArena::~BaseArena() {
   // The first X blocks stay allocated always by default.  Delete them now.
   for (int i = first_block_externally_owned_ ? 1 : 0; i < blocks_alloced_; ++i)
     free(first_blocks_[i].mem);
+  for (char* mem : retained_blocks_) free(mem);
 }
 
 // ----------------------------------------------------------------------
@@ -171,6 +172,7 @@ void BaseArena::Reset() {
 #endif
 
   ARENASET(status_.bytes_allocated_ = block_size_);
+  reused_block_count_ = 0;
 
   // There is no guarantee the first block is properly aligned, so
   // enforce that now.
@@ -179,6 +181,18 @@ void BaseArena::Reset() {
   freestart_when_empty_ = freestart_;
 }
 
+// ----------------------------------------------------------------------
+// BaseArena::ResetAndRetainBlocks()
+//    Resets the arena, keeping up to max_retained_blocks blocks of the
+//    standard size for AllocNewBlock() to reuse rather than freeing them.
+// ----------------------------------------------------------------------
+
+void BaseArena::ResetAndRetainBlocks(int max_retained_blocks) {
+  max_retained_blocks_ = max_retained_blocks;
+  Reset();
+  max_retained_blocks_ = 0;
+}
+
 // ----------------------------------------------------------------------
 // BaseArena::MakeNewBlock()
 //    Our sbrk() equivalent.  We always make blocks of the same size
@@ -269,6 +283,16 @@ BaseArena::AllocatedBlock* BaseArena::AllocNewBlock(const size_t block_size,
       size_t num_pages = ((adjusted_block_size - 1)/kPageSize) + 1;
       adjusted_block_size = num_pages * kPageSize;
     }
+  }
+  if (adjusted_block_size == block_size_ && !retained_blocks_.empty() &&
+      reinterpret_cast<uintptr_t>(retained_blocks_.back()) %
+              adjusted_alignment ==
+          0) {
+    // Reuse a block retained by ResetAndRetainBlocks().
+    block->mem = retained_blocks_.back();
+    retained_blocks_.pop_back();
+    ++reused_block_count_;
+  } else if (adjusted_alignment > 1) {
     block->mem = reinterpret_cast<char*>(aligned_malloc(adjusted_block_size,
                                                         adjusted_alignment));
   } else {
@@ -371,7 +395,7 @@ void* BaseArena::GetMemoryFallback(const size_t size, const int alignment) {
 
 void BaseArena::FreeBlocks() {
   for ( int i = 1; i < blocks_alloced_; ++i ) {  // keep first block alloced
-    free(first_blocks_[i].mem);
+    FreeBlock(first_blocks_[i]);
     first_blocks_[i].mem = nullptr;
     first_blocks_[i].size = 0;
   }
@@ -379,11 +403,28 @@ void BaseArena::FreeBlocks() {
   if (overflow_blocks_ != nullptr) {
     std::vector<AllocatedBlock>::iterator it;
     for (it = overflow_blocks_->begin(); it != overflow_blocks_->end(); ++it) {
-      free(it->mem);
+      FreeBlock(*it);
     }
     delete overflow_blocks_;             // These should be used very rarely
     overflow_blocks_ = nullptr;
   }
+  // Drops the retained blocks that were not reused beyond the new limit.
+  while (retained_blocks_.size() > static_cast<size_t>(max_retained_blocks_)) {
+    free(retained_blocks_.back());
+    retained_blocks_.pop_back();
+  }
+}
+
+void BaseArena::FreeBlock(const AllocatedBlock& block) {
+  if (block.size == block_size_ &&
+      retained_blocks_.size() < static_cast<size_t>(max_retained_blocks_)) {
+#ifdef ADDRESS_SANITIZER
+    ASAN_POISON_MEMORY_REGION(block.mem, block.size);
+#endif
+    retained_blocks_.push_back(block.mem);
+  } else {
+    free(block.mem);
+  }
 }
 
 // ----------------------------------------------------------------------
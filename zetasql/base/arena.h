@@ -280,6 +280,16 @@ class BaseArena {
 
   virtual void Reset();
 
+  // Like Reset(), but instead of freeing the blocks of the standard block
+  // size, keeps up to <max_retained_blocks> of them in total to serve the
+  // allocations of new blocks after the reset. For arenas that are reset and
+  // reused many times, this saves allocating and freeing the same blocks.
+  void ResetAndRetainBlocks(int max_retained_blocks);
+
+  // The number of blocks added since the last reset that were taken from the
+  // retained blocks rather than allocated.
+  int reused_block_count() const { return reused_block_count_; }
+
   // they're "slow" only 'cause they're virtual (subclasses define "fast" ones)
   virtual char* SlowAlloc(size_t size) = 0;
   virtual void  SlowFree(void* memory, size_t size) = 0;
@@ -375,8 +385,13 @@ class BaseArena {
   const bool page_aligned_;  // when true, all blocks need to be page aligned
   int8_t blocks_alloced_;    // how many of the first_blocks_ have been alloced
   AllocatedBlock first_blocks_[16];   // the length of this array is arbitrary
+  // Freed blocks of block_size_ kept by ResetAndRetainBlocks() for reuse.
+  std::vector<char*> retained_blocks_;
+  int max_retained_blocks_ = 0;  // only non-zero in ResetAndRetainBlocks()
+  int reused_block_count_ = 0;
 
   void FreeBlocks();         // Frees all except first block
+  void FreeBlock(const AllocatedBlock& block);  // Frees or retains <block>
 
   BaseArena(const BaseArena&) = delete;
   BaseArena& operator=(const BaseArena&) = delete;
@@ -0,0 +1,85 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/base/arena_pool.h"
+
+#include <memory>
+
+#include "absl/synchronization/mutex.h"
+#include "zetasql/base/arena.h"
+
+namespace zetasql_base {
+
+ArenaPool::ArenaPool(size_t block_size, int max_idle_arenas,
+                     int max_retained_blocks)
+    : block_size_(block_size),
+      max_idle_arenas_(max_idle_arenas),
+      max_retained_blocks_(max_retained_blocks) {}
+
+ArenaPool::~ArenaPool() {
+  for (UnsafeArena* arena : idle_arenas_) delete arena;
+}
+
+std::shared_ptr<UnsafeArena> ArenaPool::GetArena() {
+  UnsafeArena* arena = nullptr;
+  {
+    absl::MutexLock lock(&mutex_);
+    if (!idle_arenas_.empty()) {
+      arena = idle_arenas_.back();
+      idle_arenas_.pop_back();
+      ++stats_.arenas_reused;
+    } else {
+      ++stats_.arenas_created;
+      ++stats_.blocks_allocated;
+    }
+  }
+  if (arena == nullptr) {
+    arena = new UnsafeArena(block_size_);
+  }
+  return std::shared_ptr<UnsafeArena>(
+      arena, [this](UnsafeArena* arena) { Release(arena); });
+}
+
+void ArenaPool::Release(UnsafeArena* arena) {
+  const int reused_blocks = arena->reused_block_count();
+  const int allocated_blocks = arena->block_count() - 1 - reused_blocks;
+  // Resetting outside of the lock, as it frees the blocks that are not kept.
+  arena->ResetAndRetainBlocks(max_retained_blocks_);
+  {
+    absl::MutexLock lock(&mutex_);
+    stats_.blocks_allocated += allocated_blocks;
+    stats_.blocks_reused += reused_blocks;
+    if (idle_arenas_.size() < static_cast<size_t>(max_idle_arenas_)) {
+      idle_arenas_.push_back(arena);
+      return;
+    }
+  }
+  delete arena;
+}
+
+ArenaPool::Stats ArenaPool::GetStats() const {
+  absl::MutexLock lock(&mutex_);
+  return stats_;
+}
+
+ArenaPool& ArenaPool::GetDefault() {
+  static ArenaPool* pool =
+      new ArenaPool(/*block_size=*/4096, /*max_idle_arenas=*/32,
+                    /*max_retained_blocks=*/16);
+  return *pool;
+}
+
+}  // namespace zetasql_base
@@ -0,0 +1,85 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_ZETASQL_ZETASQL_BASE_ARENA_POOL_H_
+#define THIRD_PARTY_ZETASQL_ZETASQL_BASE_ARENA_POOL_H_
+
+// ArenaPool recycles UnsafeArenas that are created and destroyed at a high
+// rate, such as the arena of each parse or analysis. Instead of freeing an
+// arena once its last reference goes away, the pool resets it, keeping some of
+// its blocks (see BaseArena::ResetAndRetainBlocks()), and hands it out again.
+//
+//   std::shared_ptr<UnsafeArena> arena = ArenaPool::GetDefault().GetArena();
+//   ... allocate from *arena, share it like any other arena ...
+//   // The arena goes back to the pool when the last shared_ptr is destroyed.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "zetasql/base/arena.h"
+
+namespace zetasql_base {
+
+class ArenaPool {
+ public:
+  // Counters of the work saved by the pool since it was created.
+  struct Stats {
+    int64_t arenas_created = 0;
+    int64_t arenas_reused = 0;
+    // Blocks that were allocated, including the first block of each arena
+    // created, and blocks that were taken from those retained by an arena.
+    int64_t blocks_allocated = 0;
+    int64_t blocks_reused = 0;
+  };
+
+  // Arenas from this pool have blocks of <block_size>. At most
+  // <max_idle_arenas> arenas are kept while not in use, each keeping at most
+  // <max_retained_blocks> blocks besides its first.
+  ArenaPool(size_t block_size, int max_idle_arenas, int max_retained_blocks);
+  ArenaPool(const ArenaPool&) = delete;
+  ArenaPool& operator=(const ArenaPool&) = delete;
+  ~ArenaPool();
+
+  // Returns an empty arena, reused if one is idle. The arena returns to the
+  // pool when the last copy of the returned pointer is destroyed, which must
+  // happen before the pool is destroyed.
+  std::shared_ptr<UnsafeArena> GetArena();
+
+  Stats GetStats() const;
+
+  // The process-wide pool of arenas with 4096-byte blocks used for parsing and
+  // analysis. Never destroyed.
+  static ArenaPool& GetDefault();
+
+ private:
+  void Release(UnsafeArena* arena);
+
+  const size_t block_size_;
+  const int max_idle_arenas_;
+  const int max_retained_blocks_;
+
+  mutable absl::Mutex mutex_;
+  std::vector<UnsafeArena*> idle_arenas_ ABSL_GUARDED_BY(mutex_);
+  Stats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace zetasql_base
+
+#endif  // THIRD_PARTY_ZETASQL_ZETASQL_BASE_ARENA_POOL_H_
@@ -0,0 +1,81 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/base/arena_pool.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+#include "zetasql/base/arena.h"
+
+namespace zetasql_base {
+namespace {
+
+// Allocates from <arena> until it has <num_blocks> blocks. Allocations much
+// smaller than the block size come from blocks of the standard size.
+void FillBlocks(UnsafeArena* arena, int num_blocks) {
+  while (arena->block_count() < num_blocks) {
+    arena->Alloc(200);
+  }
+}
+
+TEST(ArenaPoolTest, ReusesArenasAndBlocks) {
+  ArenaPool pool(/*block_size=*/1024, /*max_idle_arenas=*/1,
+                 /*max_retained_blocks=*/2);
+  UnsafeArena* first_arena;
+  {
+    std::shared_ptr<UnsafeArena> arena = pool.GetArena();
+    first_arena = arena.get();
+    FillBlocks(arena.get(), 4);
+  }
+  ArenaPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(stats.arenas_created, 1);
+  EXPECT_EQ(stats.arenas_reused, 0);
+  EXPECT_EQ(stats.blocks_allocated, 4);
+  EXPECT_EQ(stats.blocks_reused, 0);
+
+  {
+    std::shared_ptr<UnsafeArena> arena = pool.GetArena();
+    EXPECT_EQ(arena.get(), first_arena);
+    EXPECT_TRUE(arena->is_empty());
+    FillBlocks(arena.get(), 4);
+    EXPECT_EQ(arena->reused_block_count(), 2);
+  }
+  stats = pool.GetStats();
+  EXPECT_EQ(stats.arenas_created, 1);
+  EXPECT_EQ(stats.arenas_reused, 1);
+  EXPECT_EQ(stats.blocks_allocated, 5);
+  EXPECT_EQ(stats.blocks_reused, 2);
+}
+
+TEST(ArenaPoolTest, LimitsIdleArenas) {
+  ArenaPool pool(/*block_size=*/1024, /*max_idle_arenas=*/1,
+                 /*max_retained_blocks=*/2);
+  {
+    std::shared_ptr<UnsafeArena> arena1 = pool.GetArena();
+    std::shared_ptr<UnsafeArena> arena2 = pool.GetArena();
+    EXPECT_NE(arena1.get(), arena2.get());
+  }
+  // Only one of the two arenas was kept.
+  std::shared_ptr<UnsafeArena> arena1 = pool.GetArena();
+  std::shared_ptr<UnsafeArena> arena2 = pool.GetArena();
+  ArenaPool::Stats stats = pool.GetStats();
+  EXPECT_EQ(stats.arenas_created, 3);
+  EXPECT_EQ(stats.arenas_reused, 1);
+}
+
+}  // namespace
+}  // namespace zetasql_base
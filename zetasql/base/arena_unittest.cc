@@ -910,6 +910,47 @@ TEST(ArenaTest, TestPoison) {
   delete[] buffer;
 }
 
+TEST(ArenaTest, ResetAndRetainBlocks) {
+  UnsafeArena arena(1024);
+  // Fills five blocks, plus one separate block for a large allocation.
+  std::vector<char*> allocs;
+  for (int i = 0; i < 18; ++i) {
+    allocs.push_back(arena.Alloc(250));
+  }
+  arena.Alloc(600);
+  EXPECT_EQ(arena.block_count(), 6);
+  EXPECT_EQ(arena.reused_block_count(), 0);
+
+  // Keeps three of the four extra blocks of the standard size.
+  arena.ResetAndRetainBlocks(3);
+  EXPECT_EQ(arena.block_count(), 1);
+  EXPECT_EQ(arena.reused_block_count(), 0);
+  EXPECT_TRUE(arena.is_empty());
+
+  for (int i = 0; i < 18; ++i) {
+    char* alloc = arena.Alloc(250);
+    memset(alloc, i, 250);
+  }
+  EXPECT_EQ(arena.block_count(), 5);
+  EXPECT_EQ(arena.reused_block_count(), 3);
+
+  // Aligned allocations can only use retained blocks that are aligned enough.
+  arena.ResetAndRetainBlocks(4);
+  for (int i = 0; i < 20; ++i) {
+    void* alloc = arena.AllocAligned(200, 64);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(alloc) % 64, 0);
+  }
+  EXPECT_LE(arena.reused_block_count(), 4);
+
+  // A plain Reset() frees the blocks that were not reused.
+  arena.Reset();
+  EXPECT_EQ(arena.block_count(), 1);
+  for (int i = 0; i < 18; ++i) {
+    arena.Alloc(250);
+  }
+  EXPECT_EQ(arena.reused_block_count(), 0);
+}
+
 //------------------------------------------------------------------------
 
 template<class A>
@@ -0,0 +1,117 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/base/thread_pool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+
+#include "zetasql/base/logging.h"
+#include "absl/functional/function_ref.h"
+#include "absl/synchronization/mutex.h"
+
+namespace zetasql_base {
+
+ThreadPool::ThreadPool(int num_threads) {
+  threads_.reserve(std::max(num_threads, 1));
+  for (int i = 0; i < std::max(num_threads, 1); ++i) {
+    threads_.emplace_back([this] { Run(); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    absl::MutexLock lock(&mutex_);
+    stopping_ = true;
+  }
+  for (std::thread& thread : threads_) {
+    thread.join();
+  }
+}
+
+ThreadPool* ThreadPool::DefaultPool() {
+  static ThreadPool* pool = new ThreadPool(
+      std::max(1, static_cast<int>(std::thread::hardware_concurrency())));
+  return pool;
+}
+
+void ThreadPool::Schedule(std::function<void()> closure) {
+  ZETASQL_DCHECK(closure != nullptr);
+  absl::MutexLock lock(&mutex_);
+  ZETASQL_DCHECK(!stopping_);
+  closures_.push_back(std::move(closure));
+}
+
+void ThreadPool::Run() {
+  while (true) {
+    std::function<void()> closure;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(
+          +[](ThreadPool* pool) ABSL_EXCLUSIVE_LOCKS_REQUIRED(pool->mutex_) {
+            return pool->stopping_ || !pool->closures_.empty();
+          },
+          this));
+      if (closures_.empty()) return;
+      closure = std::move(closures_.front());
+      closures_.pop_front();
+    }
+    closure();
+  }
+}
+
+void ThreadPool::ParallelFor(int n, absl::FunctionRef<void(int)> fn) {
+  if (n <= 0) return;
+  if (n == 1) {
+    fn(0);
+    return;
+  }
+  // Closures that start after all of the calls have been claimed return
+  // without calling 'fn', so they may outlive this call, but not 'state'.
+  struct State {
+    explicit State(int n) : n(n) {}
+    bool AllDone() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex) {
+      return num_done == n;
+    }
+
+    const int n;
+    std::atomic<int> next{0};
+    absl::Mutex mutex;
+    int num_done ABSL_GUARDED_BY(mutex) = 0;
+  };
+  auto state = std::make_shared<State>(n);
+  auto run_calls = [state, fn] {
+    for (int i = state->next.fetch_add(1); i < state->n;
+         i = state->next.fetch_add(1)) {
+      fn(i);
+      absl::MutexLock lock(&state->mutex);
+      ++state->num_done;
+    }
+  };
+  const int num_helpers = std::min(n - 1, num_threads());
+  for (int i = 0; i < num_helpers; ++i) {
+    Schedule(run_calls);
+  }
+  run_calls();
+  absl::MutexLock lock(&state->mutex);
+  state->mutex.Await(absl::Condition(state.get(), &State::AllDone));
+}
+
+}  // namespace zetasql_base
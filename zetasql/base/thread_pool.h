@@ -0,0 +1,78 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef THIRD_PARTY_ZETASQL_ZETASQL_BASE_THREAD_POOL_H_
+#define THIRD_PARTY_ZETASQL_ZETASQL_BASE_THREAD_POOL_H_
+
+#include <deque>
+#include <functional>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/function_ref.h"
+#include "absl/synchronization/mutex.h"
+
+namespace zetasql_base {
+
+// A fixed number of threads that run scheduled closures in FIFO order.
+//
+// Example:
+//   ThreadPool* pool = ThreadPool::DefaultPool();
+//   std::vector<int> results(inputs.size());
+//   pool->ParallelFor(inputs.size(),
+//                     [&](int i) { results[i] = Compute(inputs[i]); });
+//
+// This class is thread-safe.
+class ThreadPool {
+ public:
+  // Starts 'num_threads' threads, at least one.
+  explicit ThreadPool(int num_threads);
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // Runs the closures that were already scheduled, then joins the threads.
+  ~ThreadPool();
+
+  // Returns a pool with one thread per hardware thread, shared by the whole
+  // process. It is created on first use and never destroyed.
+  static ThreadPool* DefaultPool();
+
+  int num_threads() const { return static_cast<int>(threads_.size()); }
+
+  // Runs 'closure' on one of the threads of the pool.
+  void Schedule(std::function<void()> closure);
+
+  // Calls 'fn(0)', ..., 'fn(n - 1)' on the calling thread and up to
+  // num_threads() threads of the pool, and returns once all of the calls have
+  // returned. The calling thread runs the calls that the pool threads have not
+  // started, so this makes progress even if all of the pool threads are busy,
+  // including when it is called from a closure running on the pool.
+  void ParallelFor(int n, absl::FunctionRef<void(int)> fn);
+
+ private:
+  void Run();
+
+  absl::Mutex mutex_;
+  std::deque<std::function<void()>> closures_ ABSL_GUARDED_BY(mutex_);
+  bool stopping_ ABSL_GUARDED_BY(mutex_) = false;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace zetasql_base
+
+#endif  // THIRD_PARTY_ZETASQL_ZETASQL_BASE_THREAD_POOL_H_
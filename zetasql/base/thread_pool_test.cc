@@ -0,0 +1,69 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/base/thread_pool.h"
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "absl/synchronization/blocking_counter.h"
+
+namespace zetasql_base {
+namespace {
+
+TEST(ThreadPoolTest, ScheduledClosuresRunBeforeDestruction) {
+  std::atomic<int> num_runs{0};
+  {
+    ThreadPool pool(4);
+    EXPECT_EQ(pool.num_threads(), 4);
+    for (int i = 0; i < 100; ++i) {
+      pool.Schedule([&num_runs] { ++num_runs; });
+    }
+  }
+  EXPECT_EQ(num_runs, 100);
+}
+
+TEST(ThreadPoolTest, AtLeastOneThread) {
+  ThreadPool pool(0);
+  EXPECT_EQ(pool.num_threads(), 1);
+  absl::BlockingCounter done(1);
+  pool.Schedule([&done] { done.DecrementCount(); });
+  done.Wait();
+}
+
+TEST(ThreadPoolTest, ParallelForCallsEachIndexOnce) {
+  ThreadPool pool(3);
+  for (const int n : {0, 1, 2, 3, 4, 100}) {
+    std::vector<int> num_calls(n);
+    pool.ParallelFor(n, [&num_calls](int i) { ++num_calls[i]; });
+    EXPECT_EQ(num_calls, std::vector<int>(n, 1)) << n;
+  }
+}
+
+TEST(ThreadPoolTest, ParallelForFromPoolThreads) {
+  // Every pool thread blocks in a nested ParallelFor, which must still finish
+  // by running the calls on the calling threads.
+  ThreadPool pool(2);
+  std::atomic<int> num_calls{0};
+  pool.ParallelFor(4, [&](int) {
+    pool.ParallelFor(8, [&num_calls](int) { ++num_calls; });
+  });
+  EXPECT_EQ(num_calls, 32);
+}
+
+}  // namespace
+}  // namespace zetasql_base
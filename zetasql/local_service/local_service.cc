@@ -19,7 +19,9 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -31,6 +33,7 @@
 #include "zetasql/common/proto_helper.h"
 #include "zetasql/local_service/local_service.pb.h"
 #include "zetasql/local_service/state.h"
+#include "zetasql/parser/parser.h"
 #include "zetasql/parser/parse_tree.pb.h"
 #include "zetasql/parser/parse_tree_serializer.h"
 #include "zetasql/proto/simple_catalog.pb.h"
@@ -59,6 +62,7 @@
 #include "zetasql/base/source_location.h"
 #include "zetasql/base/ret_check.h"
 #include "zetasql/base/status_macros.h"
+#include "zetasql/base/thread_pool.h"
 
 namespace zetasql {
 namespace local_service {
@@ -150,6 +154,41 @@ absl::StatusOr<EvaluateModifyResponse::Row::Operation> SerializeModifyOperation(
   }
 }
 
+// The fewest requests of a batch that are worth handing to another thread.
+constexpr int kMinBatchRequestsPerThread = 8;
+
+// Splits [0, size) into consecutive ranges, and calls process_request(i) for
+// each i of each range, in parallel on the default thread pool, which is
+// shared by all requests, and on the calling thread. There are at most as many
+// ranges as pool threads. Returns the status of each request; a request that
+// fails does not stop the others.
+std::vector<absl::Status> ProcessBatchInParallel(
+    int size, const std::function<absl::Status(int)>& process_request) {
+  zetasql_base::ThreadPool* pool = zetasql_base::ThreadPool::DefaultPool();
+  const int num_ranges = std::clamp(
+      (size + kMinBatchRequestsPerThread - 1) / kMinBatchRequestsPerThread, 1,
+      pool->num_threads());
+  auto range_begin = [size, num_ranges](int range) {
+    return static_cast<int>(static_cast<int64_t>(size) * range / num_ranges);
+  };
+
+  std::vector<absl::Status> statuses(size);
+  pool->ParallelFor(num_ranges, [&](int range) {
+    for (int i = range_begin(range); i < range_begin(range + 1); ++i) {
+      statuses[i] = process_request(i);
+    }
+  });
+  return statuses;
+}
+
+// Sets 'proto' to the outcome of a single request of a batch.
+void SetBatchItemStatus(const absl::Status& status, BatchItemStatus* proto) {
+  proto->set_code(static_cast<int>(status.code()));
+  if (!status.ok()) {
+    proto->set_message(std::string(status.message()));
+  }
+}
+
 }  // namespace
 
 class RegisteredDescriptorPoolState : public GenericState {
@@ -1400,6 +1439,25 @@ absl::Status ZetaSqlLocalServiceImpl::FormatSql(
   return ::zetasql::FormatSql(request.sql(), response->mutable_sql());
 }
 
+absl::Status ZetaSqlLocalServiceImpl::FormatSqlBatch(
+    const FormatSqlBatchRequest& request, FormatSqlBatchResponse* response) {
+  response->Clear();
+  for (int i = 0; i < request.request_size(); ++i) {
+    response->add_response();
+  }
+  const std::vector<absl::Status> statuses =
+      ProcessBatchInParallel(request.request_size(), [&](int i) {
+        return FormatSql(request.request(i), response->mutable_response(i));
+      });
+  for (int i = 0; i < request.request_size(); ++i) {
+    if (!statuses[i].ok()) {
+      response->mutable_response(i)->Clear();
+    }
+    SetBatchItemStatus(statuses[i], response->add_status());
+  }
+  return absl::OkStatus();
+}
+
 absl::Status ZetaSqlLocalServiceImpl::RegisterCatalog(
     const RegisterCatalogRequest& request, RegisterResponse* response) {
   std::vector<std::shared_ptr<RegisteredDescriptorPoolState>>
@@ -1499,24 +1557,40 @@ absl::Status ZetaSqlLocalServiceImpl::GetAnalyzerOptions(
 
 absl::Status ZetaSqlLocalServiceImpl::Parse(const ParseRequest& request,
     ParseResponse* response) {
-  const std::string& sql = request.sql_statement();
-  auto language_options =
-      request.has_options()
-          ? std::make_unique<LanguageOptions>(request.options())
-          : std::make_unique<LanguageOptions>();
-
-  ParserOptions parser_options =
-      ParserOptions(/*id_string_pool=*/nullptr,
-                    /*arena=*/nullptr, language_options.get());
+  const LanguageOptions language_options =
+      request.has_options() ? LanguageOptions(request.options())
+                            : LanguageOptions();
+  // The arena of the parse comes from the default ArenaPool, and is recycled
+  // once the parse tree is serialized.
+  ParserOptions parser_options(language_options);
   std::unique_ptr<ParserOutput> parser_output;
-  ZETASQL_RETURN_IF_ERROR(ParseStatement(sql, parser_options, &parser_output));
-
-  const zetasql::ASTStatement* statement = parser_output->statement();
-  zetasql::AnyASTStatementProto proto;
-  return ParseTreeSerializer::Serialize(statement,
+  ZETASQL_RETURN_IF_ERROR(
+      ParseStatement(request.sql_statement(), parser_options, &parser_output));
+  return ParseTreeSerializer::Serialize(parser_output->statement(),
                                         response->mutable_parsed_statement());
 }
 
+absl::Status ZetaSqlLocalServiceImpl::ParseBatch(
+    const ParseBatchRequest& request, ParseBatchResponse* response) {
+  response->Clear();
+  for (int i = 0; i < request.request_size(); ++i) {
+    response->add_response();
+  }
+  // Each parse takes a recycled arena from the default ArenaPool, so memory
+  // stays bounded however many statements a thread parses.
+  const std::vector<absl::Status> statuses =
+      ProcessBatchInParallel(request.request_size(), [&](int i) {
+        return Parse(request.request(i), response->mutable_response(i));
+      });
+  for (int i = 0; i < request.request_size(); ++i) {
+    if (!statuses[i].ok()) {
+      response->mutable_response(i)->Clear();
+    }
+    SetBatchItemStatus(statuses[i], response->add_status());
+  }
+  return absl::OkStatus();
+}
+
 size_t ZetaSqlLocalServiceImpl::NumRegisteredDescriptorPools() const {
   return registered_descriptor_pools_->NumSavedStates();
 }
@@ -128,6 +128,12 @@ class ZetaSqlLocalServiceImpl {
   absl::Status FormatSql(const FormatSqlRequest& request,
                          FormatSqlResponse* response);
 
+  // Formats the requests of the batch in parallel. The outcome of each
+  // request is returned in response->status(); a request that fails does not
+  // fail the batch.
+  absl::Status FormatSqlBatch(const FormatSqlBatchRequest& request,
+                              FormatSqlBatchResponse* response);
+
   absl::Status RegisterCatalog(const RegisterCatalogRequest& request,
                                RegisterResponse* response);
 
@@ -141,6 +147,12 @@ class ZetaSqlLocalServiceImpl {
 
   absl::Status Parse(const ParseRequest& request, ParseResponse* response);
 
+  // Parses the requests of the batch in parallel. The outcome of each request
+  // is returned in response->status(); a request that fails does not fail the
+  // batch.
+  absl::Status ParseBatch(const ParseBatchRequest& request,
+                          ParseBatchResponse* response);
+
  private:
   // Fetches the descriptor pools for the given descriptor_pool_list.
   // descriptor_pools is a view into pool_states_out, and is returned as a
@@ -14,12 +14,28 @@
 // limitations under the License.
 //
 
+// Besides the service itself, compares calling it through gRPC over a
+// socketpair, as JniChannelProvider does, against passing serialized requests
+// and responses directly, as JniChannelProvider.callDirect() does.
+
+#include <grpcpp/create_channel_posix.h>
+#include <grpcpp/server.h>
+#include <grpcpp/server_builder.h>
+#include <grpcpp/server_posix.h>
+#include <sys/socket.h>
+
 #include <cstdint>
+#include <memory>
+#include <string>
 
 #include "zetasql/base/logging.h"
 #include "zetasql/base/testing/status_matchers.h"
+#include "google/protobuf/message.h"
+#include "zetasql/local_service/local_service.grpc.pb.h"
 #include "zetasql/local_service/local_service.h"
 #include "zetasql/local_service/local_service.pb.h"
+#include "zetasql/local_service/local_service_direct.h"
+#include "zetasql/local_service/local_service_grpc.h"
 #include "benchmark/benchmark.h"
 #include "gtest/gtest.h"
 #include "absl/base/internal/sysinfo.h"
@@ -54,5 +70,96 @@ static void BM_EvaluatePrepared(::benchmark::State& state) {
 }
 BENCHMARK(BM_EvaluatePrepared)->ThreadRange(1, NumCPUs());
 
+// A gRPC server for the service, and a stub connected to it over a socketpair.
+class SocketPairGrpcService {
+ public:
+  SocketPairGrpcService() {
+    grpc::ServerBuilder builder;
+    builder.RegisterService(&service_);
+    server_ = builder.BuildAndStart();
+    int sv[2];
+    ZETASQL_CHECK_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, sv), 0);
+    grpc::AddInsecureChannelFromFd(server_.get(), sv[0]);
+    stub_ = ZetaSqlLocalService::NewStub(
+        grpc::CreateInsecureChannelFromFd("socketpair", sv[1]));
+  }
+
+  ZetaSqlLocalServiceGrpcImpl& service() { return service_; }
+  ZetaSqlLocalService::Stub& stub() { return *stub_; }
+
+ private:
+  ZetaSqlLocalServiceGrpcImpl service_;
+  std::unique_ptr<grpc::Server> server_;
+  std::unique_ptr<ZetaSqlLocalService::Stub> stub_;
+};
+
+SocketPairGrpcService& GetSocketPairGrpcService() {
+  static SocketPairGrpcService* service = new SocketPairGrpcService();
+  return *service;
+}
+
+// The request for the prepared expression 'sql', prepared once per process.
+EvaluateRequest MakePreparedEvaluateRequest(const char* sql) {
+  PrepareRequest prepare_request;
+  prepare_request.set_sql(sql);
+  PrepareResponse prepare_response;
+  ZETASQL_CHECK_OK(GetSocketPairGrpcService().service().service()->Prepare(
+      prepare_request, &prepare_response));
+  EvaluateRequest evaluate_request;
+  evaluate_request.set_prepared_expression_id(
+      prepare_response.prepared().prepared_expression_id());
+  return evaluate_request;
+}
+
+// A small result, where the cost of the call dominates, and a larger one.
+const char* const kEvaluateSqls[] = {
+    "1",
+    "ARRAY(SELECT AS STRUCT x, CAST(x AS STRING) FROM UNNEST("
+    "GENERATE_ARRAY(1, 1000)) AS x)",
+};
+
+const EvaluateRequest& GetPreparedEvaluateRequest(int index) {
+  static const EvaluateRequest* requests = new EvaluateRequest[2]{
+      MakePreparedEvaluateRequest(kEvaluateSqls[0]),
+      MakePreparedEvaluateRequest(kEvaluateSqls[1])};
+  return requests[index];
+}
+
+void BM_EvaluatePreparedGrpcSocketPair(::benchmark::State& state) {
+  const EvaluateRequest& request = GetPreparedEvaluateRequest(state.range(0));
+  ZetaSqlLocalService::Stub& stub = GetSocketPairGrpcService().stub();
+  for (auto s : state) {
+    grpc::ClientContext context;
+    EvaluateResponse response;
+    ZETASQL_CHECK(stub.Evaluate(&context, request, &response).ok());
+    benchmark::DoNotOptimize(response);
+  }
+}
+BENCHMARK(BM_EvaluatePreparedGrpcSocketPair)
+    ->DenseRange(0, 1)
+    ->ThreadRange(1, NumCPUs());
+
+// Includes serializing the request and parsing the response, as the gRPC
+// client and server do.
+void BM_EvaluatePreparedDirect(::benchmark::State& state) {
+  const EvaluateRequest& request = GetPreparedEvaluateRequest(state.range(0));
+  ZetaSqlLocalServiceImpl* service =
+      GetSocketPairGrpcService().service().service();
+  std::string request_bytes;
+  std::string response_bytes;
+  for (auto s : state) {
+    request.SerializeToString(&request_bytes);
+    std::unique_ptr<google::protobuf::Message> response_message =
+        CallLocalServiceMethod(service, "Evaluate", request_bytes).value();
+    response_message->SerializeToString(&response_bytes);
+    EvaluateResponse response;
+    ZETASQL_CHECK(response.ParseFromString(response_bytes));
+    benchmark::DoNotOptimize(response);
+  }
+}
+BENCHMARK(BM_EvaluatePreparedDirect)
+    ->DenseRange(0, 1)
+    ->ThreadRange(1, NumCPUs());
+
 }  // namespace local_service
 }  // namespace zetasql
@@ -0,0 +1,169 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/local_service/local_service_direct.h"
+
+#include <cstdint>
+#include <memory>
+
+#include "google/protobuf/empty.pb.h"
+#include "google/protobuf/message.h"
+#include "zetasql/local_service/local_service.h"
+#include "zetasql/local_service/local_service.pb.h"
+#include "zetasql/proto/options.pb.h"
+#include "zetasql/public/simple_table.pb.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+namespace local_service {
+namespace {
+
+using MethodResult = absl::StatusOr<std::unique_ptr<google::protobuf::Message>>;
+using MethodHandler = MethodResult (*)(ZetaSqlLocalServiceImpl* service,
+                                       absl::string_view request);
+
+template <typename RequestT>
+absl::Status ParseSerializedRequest(absl::string_view bytes,
+                                    RequestT* request) {
+  if (!request->ParseFromArray(bytes.data(), static_cast<int>(bytes.size()))) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Failed to parse ", request->GetTypeName()));
+  }
+  return absl::OkStatus();
+}
+
+template <typename RequestT, typename ResponseT,
+          absl::Status (ZetaSqlLocalServiceImpl::*kMethod)(const RequestT&,
+                                                             ResponseT*)>
+MethodResult CallMethod(ZetaSqlLocalServiceImpl* service,
+                        absl::string_view bytes) {
+  RequestT request;
+  ZETASQL_RETURN_IF_ERROR(ParseSerializedRequest(bytes, &request));
+  auto response = std::make_unique<ResponseT>();
+  ZETASQL_RETURN_IF_ERROR((service->*kMethod)(request, response.get()));
+  return response;
+}
+
+// The Unprepare* and UnregisterCatalog methods take just the id from their
+// request and respond with Empty.
+template <typename RequestT, int64_t (RequestT::*kGetId)() const,
+          absl::Status (ZetaSqlLocalServiceImpl::*kMethod)(int64_t)>
+MethodResult CallIdMethod(ZetaSqlLocalServiceImpl* service,
+                                 absl::string_view bytes) {
+  RequestT request;
+  ZETASQL_RETURN_IF_ERROR(ParseSerializedRequest(bytes, &request));
+  ZETASQL_RETURN_IF_ERROR((service->*kMethod)((request.*kGetId)()));
+  return std::make_unique<google::protobuf::Empty>();
+}
+
+using Impl = ZetaSqlLocalServiceImpl;
+
+const absl::flat_hash_map<absl::string_view, MethodHandler>& GetHandlers() {
+  static const auto* handlers =
+      new absl::flat_hash_map<absl::string_view, MethodHandler>({
+          {"Prepare",
+           &CallMethod<PrepareRequest, PrepareResponse, &Impl::Prepare>},
+          {"Unprepare",
+           &CallIdMethod<UnprepareRequest,
+                                &UnprepareRequest::prepared_expression_id,
+                                &Impl::Unprepare>},
+          {"Evaluate",
+           &CallMethod<EvaluateRequest, EvaluateResponse, &Impl::Evaluate>},
+          {"PrepareQuery", &CallMethod<PrepareQueryRequest,
+                                       PrepareQueryResponse,
+                                       &Impl::PrepareQuery>},
+          {"UnprepareQuery",
+           &CallIdMethod<UnprepareQueryRequest,
+                                &UnprepareQueryRequest::prepared_query_id,
+                                &Impl::UnprepareQuery>},
+          {"EvaluateQuery", &CallMethod<EvaluateQueryRequest,
+                                        EvaluateQueryResponse,
+                                        &Impl::EvaluateQuery>},
+          {"PrepareModify", &CallMethod<PrepareModifyRequest,
+                                        PrepareModifyResponse,
+                                        &Impl::PrepareModify>},
+          {"UnprepareModify",
+           &CallIdMethod<UnprepareModifyRequest,
+                                &UnprepareModifyRequest::prepared_modify_id,
+                                &Impl::UnprepareModify>},
+          {"EvaluateModify", &CallMethod<EvaluateModifyRequest,
+                                         EvaluateModifyResponse,
+                                         &Impl::EvaluateModify>},
+          {"GetTableFromProto", &CallMethod<TableFromProtoRequest,
+                                            SimpleTableProto,
+                                            &Impl::GetTableFromProto>},
+          {"RegisterCatalog", &CallMethod<RegisterCatalogRequest,
+                                          RegisterResponse,
+                                          &Impl::RegisterCatalog>},
+          {"Analyze",
+           &CallMethod<AnalyzeRequest, AnalyzeResponse, &Impl::Analyze>},
+          {"BuildSql",
+           &CallMethod<BuildSqlRequest, BuildSqlResponse, &Impl::BuildSql>},
+          {"ExtractTableNamesFromStatement",
+           &CallMethod<ExtractTableNamesFromStatementRequest,
+                       ExtractTableNamesFromStatementResponse,
+                       &Impl::ExtractTableNamesFromStatement>},
+          {"ExtractTableNamesFromNextStatement",
+           &CallMethod<ExtractTableNamesFromNextStatementRequest,
+                       ExtractTableNamesFromNextStatementResponse,
+                       &Impl::ExtractTableNamesFromNextStatement>},
+          {"FormatSql",
+           &CallMethod<FormatSqlRequest, FormatSqlResponse, &Impl::FormatSql>},
+          {"FormatSqlBatch", &CallMethod<FormatSqlBatchRequest,
+                                         FormatSqlBatchResponse,
+                                         &Impl::FormatSqlBatch>},
+          {"UnregisterCatalog",
+           &CallIdMethod<UnregisterRequest,
+                                &UnregisterRequest::registered_id,
+                                &Impl::UnregisterCatalog>},
+          {"GetBuiltinFunctions",
+           &CallMethod<ZetaSQLBuiltinFunctionOptionsProto,
+                       GetBuiltinFunctionsResponse,
+                       &Impl::GetBuiltinFunctions>},
+          {"GetLanguageOptions", &CallMethod<LanguageOptionsRequest,
+                                             LanguageOptionsProto,
+                                             &Impl::GetLanguageOptions>},
+          {"GetAnalyzerOptions", &CallMethod<AnalyzerOptionsRequest,
+                                             AnalyzerOptionsProto,
+                                             &Impl::GetAnalyzerOptions>},
+          {"Parse", &CallMethod<ParseRequest, ParseResponse, &Impl::Parse>},
+          {"ParseBatch", &CallMethod<ParseBatchRequest, ParseBatchResponse,
+                                     &Impl::ParseBatch>},
+      });
+  return *handlers;
+}
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<google::protobuf::Message>>
+CallLocalServiceMethod(ZetaSqlLocalServiceImpl* service,
+                       absl::string_view method, absl::string_view request) {
+  const auto& handlers = GetHandlers();
+  auto it = handlers.find(method);
+  if (it == handlers.end()) {
+    return absl::UnimplementedError(
+        absl::StrCat("Unsupported ZetaSqlLocalService method: ", method));
+  }
+  return it->second(service, request);
+}
+
+}  // namespace local_service
+}  // namespace zetasql
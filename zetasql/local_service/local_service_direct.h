@@ -0,0 +1,43 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_LOCAL_SERVICE_LOCAL_SERVICE_DIRECT_H_
+#define ZETASQL_LOCAL_SERVICE_LOCAL_SERVICE_DIRECT_H_
+
+#include <memory>
+
+#include "google/protobuf/message.h"
+#include "zetasql/local_service/local_service.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+namespace local_service {
+
+// Calls the unary ZetaSqlLocalService method named 'method' (the name of the
+// rpc in local_service.proto, e.g. "Analyze") on 'service' with a serialized
+// request, and returns its response. This is how in-process clients call the
+// service without the framing and threading of a gRPC channel. The streaming
+// methods are not supported, their batches are only useful to amortize the
+// cost of a gRPC call.
+absl::StatusOr<std::unique_ptr<google::protobuf::Message>>
+CallLocalServiceMethod(ZetaSqlLocalServiceImpl* service,
+                       absl::string_view method, absl::string_view request);
+
+}  // namespace local_service
+}  // namespace zetasql
+
+#endif  // ZETASQL_LOCAL_SERVICE_LOCAL_SERVICE_DIRECT_H_
@@ -0,0 +1,107 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/local_service/local_service_direct.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "google/protobuf/empty.pb.h"
+#include "google/protobuf/message.h"
+#include "zetasql/local_service/local_service.h"
+#include "zetasql/local_service/local_service.pb.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+
+namespace zetasql::local_service {
+
+namespace {
+
+using ::testing::HasSubstr;
+using ::zetasql_base::testing::StatusIs;
+
+TEST(CallLocalServiceMethodTest, PrepareEvaluateUnprepare) {
+  ZetaSqlLocalServiceImpl service;
+
+  PrepareRequest prepare_request;
+  prepare_request.set_sql("1 + 2");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<google::protobuf::Message> prepare_response,
+      CallLocalServiceMethod(&service, "Prepare",
+                             prepare_request.SerializeAsString()));
+  const int64_t id = dynamic_cast<PrepareResponse&>(*prepare_response)
+                         .prepared()
+                         .prepared_expression_id();
+
+  // The id is valid for the service as called directly.
+  EvaluateRequest evaluate_request;
+  evaluate_request.set_prepared_expression_id(id);
+  EvaluateResponse expected_response;
+  ZETASQL_ASSERT_OK(service.Evaluate(evaluate_request, &expected_response));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<google::protobuf::Message> evaluate_response,
+      CallLocalServiceMethod(&service, "Evaluate",
+                             evaluate_request.SerializeAsString()));
+  EXPECT_EQ(evaluate_response->SerializeAsString(),
+            expected_response.SerializeAsString());
+  EXPECT_EQ(dynamic_cast<EvaluateResponse&>(*evaluate_response)
+                .value()
+                .int64_value(),
+            3);
+
+  UnprepareRequest unprepare_request;
+  unprepare_request.set_prepared_expression_id(id);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<google::protobuf::Message> unprepare_response,
+      CallLocalServiceMethod(&service, "Unprepare",
+                             unprepare_request.SerializeAsString()));
+  EXPECT_NE(dynamic_cast<google::protobuf::Empty*>(unprepare_response.get()),
+            nullptr);
+  EXPECT_THAT(CallLocalServiceMethod(&service, "Unprepare",
+                                     unprepare_request.SerializeAsString()),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(CallLocalServiceMethodTest, Errors) {
+  ZetaSqlLocalServiceImpl service;
+
+  EXPECT_THAT(CallLocalServiceMethod(&service, "EvaluateStream", ""),
+              StatusIs(absl::StatusCode::kUnimplemented,
+                       HasSubstr("EvaluateStream")));
+  EXPECT_THAT(
+      CallLocalServiceMethod(&service, "Evaluate", "\xff"),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               "Failed to parse zetasql.local_service.EvaluateRequest"));
+
+  // Errors of the method itself are returned as is.
+  AnalyzeRequest analyze_request;
+  analyze_request.set_sql_statement("SELECT 1 +");
+  AnalyzeResponse analyze_response;
+  const absl::Status expected_status =
+      service.Analyze(analyze_request, &analyze_response);
+  ASSERT_FALSE(expected_status.ok());
+  EXPECT_EQ(CallLocalServiceMethod(&service, "Analyze",
+                                   analyze_request.SerializeAsString())
+                .status(),
+            expected_status);
+}
+
+}  // namespace
+
+}  // namespace zetasql::local_service
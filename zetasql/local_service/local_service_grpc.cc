@@ -16,6 +16,9 @@
 
 #include "zetasql/local_service/local_service_grpc.h"
 
+#include <cstddef>
+#include <functional>
+
 #include "zetasql/base/status.h"
 
 namespace zetasql {
@@ -80,6 +83,48 @@ grpc::Status ToGrpcStatus(absl::Status status) {
   return grpc::Status(grpc_code, std::string(status.message()), "");
 }
 
+// Calls 'process_batch' for each batch of requests read from 'stream', and
+// writes its responses and their statuses, repacked into batches under the
+// maximum message size.
+template <typename RequestBatchT, typename ResponseBatchT>
+grpc::Status ProcessBatchStream(
+    grpc::ServerReaderWriter<ResponseBatchT, RequestBatchT>* stream,
+    const std::function<absl::Status(const RequestBatchT&, ResponseBatchT*)>&
+        process_batch) {
+  // An upper bound on the tag and length prefix of a response or a status in
+  // a batch.
+  constexpr size_t kMaxResponseOverhead = 6;
+  RequestBatchT reqb;
+  while (stream->Read(&reqb)) {
+    ResponseBatchT respb;
+    auto status = process_batch(reqb, &respb);
+    if (!status.ok()) {
+      return ToGrpcStatus(status);
+    }
+    ResponseBatchT out;
+    size_t out_size = 0;
+    for (int i = 0; i < respb.response_size(); ++i) {
+      auto* resp = respb.mutable_response(i);
+      auto* resp_status = respb.mutable_status(i);
+      const size_t size = resp->ByteSizeLong() + resp_status->ByteSizeLong() +
+                          2 * kMaxResponseOverhead;
+      if (out.response_size() > 0 &&
+          out_size + size > GRPC_DEFAULT_MAX_RECV_MESSAGE_LENGTH) {
+        // Adding the response would push us over the max message size. Send
+        // prior responses first.
+        stream->Write(out, grpc::WriteOptions().set_corked());
+        out.Clear();
+        out_size = 0;
+      }
+      out.add_response()->Swap(resp);
+      out.add_status()->Swap(resp_status);
+      out_size += size;
+    }
+    stream->Write(out);
+  }
+  return grpc::Status();
+}
+
 }  // namespace
 
 grpc::Status ZetaSqlLocalServiceGrpcImpl::Prepare(
@@ -258,6 +303,23 @@ grpc::Status ZetaSqlLocalServiceGrpcImpl::FormatSql(
   return ToGrpcStatus(service_.FormatSql(*req, resp));
 }
 
+grpc::Status ZetaSqlLocalServiceGrpcImpl::FormatSqlBatch(
+    grpc::ServerContext* context, const FormatSqlBatchRequest* req,
+    FormatSqlBatchResponse* resp) {
+  return ToGrpcStatus(service_.FormatSqlBatch(*req, resp));
+}
+
+grpc::Status ZetaSqlLocalServiceGrpcImpl::FormatSqlStream(
+    grpc::ServerContext* context,
+    grpc::ServerReaderWriter<FormatSqlBatchResponse, FormatSqlBatchRequest>*
+        stream) {
+  return ProcessBatchStream<FormatSqlBatchRequest, FormatSqlBatchResponse>(
+      stream, [this](const FormatSqlBatchRequest& reqb,
+                     FormatSqlBatchResponse* respb) {
+        return service_.FormatSqlBatch(reqb, respb);
+      });
+}
+
 grpc::Status ZetaSqlLocalServiceGrpcImpl::RegisterCatalog(
     grpc::ServerContext* context, const RegisterCatalogRequest* req,
     RegisterResponse* resp) {
@@ -295,5 +357,20 @@ grpc::Status ZetaSqlLocalServiceGrpcImpl::Parse(
   return ToGrpcStatus(service_.Parse(*req, resp));
 }
 
+grpc::Status ZetaSqlLocalServiceGrpcImpl::ParseBatch(
+    grpc::ServerContext* context, const ParseBatchRequest* req,
+    ParseBatchResponse* resp) {
+  return ToGrpcStatus(service_.ParseBatch(*req, resp));
+}
+
+grpc::Status ZetaSqlLocalServiceGrpcImpl::ParseStream(
+    grpc::ServerContext* context,
+    grpc::ServerReaderWriter<ParseBatchResponse, ParseBatchRequest>* stream) {
+  return ProcessBatchStream<ParseBatchRequest, ParseBatchResponse>(
+      stream, [this](const ParseBatchRequest& reqb, ParseBatchResponse* respb) {
+        return service_.ParseBatch(reqb, respb);
+      });
+}
+
 }  // namespace local_service
 }  // namespace zetasql
@@ -106,6 +106,15 @@ class ZetaSqlLocalServiceGrpcImpl
                          const FormatSqlRequest* req,
                          FormatSqlResponse* resp) override;
 
+  grpc::Status FormatSqlBatch(grpc::ServerContext* context,
+                              const FormatSqlBatchRequest* req,
+                              FormatSqlBatchResponse* resp) override;
+
+  grpc::Status FormatSqlStream(
+      grpc::ServerContext* context,
+      grpc::ServerReaderWriter<FormatSqlBatchResponse, FormatSqlBatchRequest>*
+          stream) override;
+
   grpc::Status RegisterCatalog(grpc::ServerContext* context,
                                const RegisterCatalogRequest* req,
                                RegisterResponse* resp) override;
@@ -131,6 +140,19 @@ class ZetaSqlLocalServiceGrpcImpl
                      const ParseRequest* req,
                      ParseResponse* resp) override;
 
+  grpc::Status ParseBatch(grpc::ServerContext* context,
+                          const ParseBatchRequest* req,
+                          ParseBatchResponse* resp) override;
+
+  grpc::Status ParseStream(
+      grpc::ServerContext* context,
+      grpc::ServerReaderWriter<ParseBatchResponse, ParseBatchRequest>* stream)
+      override;
+
+  // The service implementing the rpcs, for in-process callers that bypass
+  // gRPC but share its registered catalogs and prepared expressions.
+  ZetaSqlLocalServiceImpl* service() { return &service_; }
+
  private:
   ZetaSqlLocalServiceImpl service_;
 };
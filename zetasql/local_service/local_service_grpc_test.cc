@@ -30,6 +30,7 @@
 #include "zetasql/public/value.pb.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/status/status.h"
 
 namespace zetasql::local_service {
 
@@ -86,6 +87,58 @@ TEST_F(ZetaSqlLocalServiceGrpcImplTest, EvaluateStreamPrepared) {
   EXPECT_OK_GRPC(stream->Finish());
 }
 
+TEST_F(ZetaSqlLocalServiceGrpcImplTest, FormatSqlStream) {
+  grpc::ChannelArguments channel_args;
+  std::unique_ptr<ZetaSqlLocalService::Stub> stub(
+      ZetaSqlLocalService::NewStub(
+          server_->InProcessChannel(channel_args)));
+
+  grpc::ClientContext context;
+  std::unique_ptr<
+      grpc::ClientReaderWriter<FormatSqlBatchRequest, FormatSqlBatchResponse>>
+      stream = stub->FormatSqlStream(&context);
+
+  FormatSqlBatchRequest batch_request;
+  batch_request.add_request()->set_sql("select 1");
+  batch_request.add_request()->set_sql("select 2 from t");
+  ASSERT_TRUE(stream->Write(batch_request));
+
+  FormatSqlBatchResponse batch_response;
+  ASSERT_TRUE(stream->Read(&batch_response));
+  ASSERT_EQ(batch_response.response_size(), 2);
+  ASSERT_EQ(batch_response.status_size(), 2);
+  EXPECT_EQ(batch_response.response(0).sql(), "SELECT\n  1;");
+  EXPECT_EQ(batch_response.response(1).sql(), "SELECT\n  2\nFROM\n  t;");
+
+  EXPECT_TRUE(stream->WritesDone());
+  EXPECT_FALSE(stream->Read(&batch_response));
+  EXPECT_OK_GRPC(stream->Finish());
+}
+
+TEST_F(ZetaSqlLocalServiceGrpcImplTest, ParseBatch) {
+  grpc::ChannelArguments channel_args;
+  std::unique_ptr<ZetaSqlLocalService::Stub> stub(
+      ZetaSqlLocalService::NewStub(
+          server_->InProcessChannel(channel_args)));
+
+  ParseBatchRequest batch_request;
+  batch_request.add_request()->set_sql_statement("select 1");
+  batch_request.add_request()->set_sql_statement("select (");
+  batch_request.add_request()->set_sql_statement("select 3");
+  grpc::ClientContext context;
+  ParseBatchResponse batch_response;
+  EXPECT_OK_GRPC(stub->ParseBatch(&context, batch_request, &batch_response));
+  ASSERT_EQ(batch_response.response_size(), 3);
+  ASSERT_EQ(batch_response.status_size(), 3);
+  EXPECT_EQ(batch_response.status(0).code(), 0);
+  EXPECT_TRUE(batch_response.response(0).has_parsed_statement());
+  EXPECT_EQ(batch_response.status(1).code(),
+            static_cast<int>(absl::StatusCode::kInvalidArgument));
+  EXPECT_FALSE(batch_response.response(1).has_parsed_statement());
+  EXPECT_EQ(batch_response.status(2).code(), 0);
+  EXPECT_TRUE(batch_response.response(2).has_parsed_statement());
+}
+
 TEST_F(ZetaSqlLocalServiceGrpcImplTest, EvaluateStreamPreparedBigResponse) {
   grpc::ChannelArguments channel_args;
   channel_args.SetMaxReceiveMessageSize(GRPC_DEFAULT_MAX_RECV_MESSAGE_LENGTH);
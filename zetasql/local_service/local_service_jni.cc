@@ -25,26 +25,107 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <string>
 
+#include "zetasql/base/logging.h"
+#include "google/protobuf/message.h"
+#include "zetasql/local_service/local_service_direct.h"
 #include "zetasql/local_service/local_service_grpc.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 
 namespace zetasql {
 namespace local_service {
 namespace {
 
+static ZetaSqlLocalServiceGrpcImpl* GetService() {
+  // The service must remain for the lifetime of the server.
+  static ZetaSqlLocalServiceGrpcImpl* service =
+      new ZetaSqlLocalServiceGrpcImpl();
+  return service;
+}
+
 static grpc::Server* GetServer() {
   static grpc::Server* server = []() {
-    // The service must remain for the lifetime of the server.
-    static ZetaSqlLocalServiceGrpcImpl* service =
-        new ZetaSqlLocalServiceGrpcImpl();
     grpc::ServerBuilder builder;
-    builder.RegisterService(service);
+    builder.RegisterService(GetService());
     return builder.BuildAndStart().release();
   }();
   return server;
 }
 
+// The JNI signature of JniChannelProvider.callDirect().
+constexpr char kCallDirectSignature[] =
+    "(Ljava/lang/String;Ljava/nio/ByteBuffer;ILjava/nio/ByteBuffer;)"
+    "Ljava/nio/ByteBuffer;";
+
+// Whether JNI_OnLoad found the classes and methods below. If not, CallDirect()
+// throws and only the gRPC channel can be used.
+static bool direct_call_available = false;
+
+// Classes and methods used by CallDirect(), looked up once in JNI_OnLoad.
+static jclass direct_call_exception_class = nullptr;
+static jmethodID direct_call_exception_constructor = nullptr;
+static jclass byte_buffer_class = nullptr;
+static jmethodID byte_buffer_allocate_direct = nullptr;
+static jmethodID buffer_clear = nullptr;
+static jmethodID buffer_limit = nullptr;
+
+static bool InitDirectCall(JNIEnv* env, const char* classname) {
+  jclass exception_class = env->FindClass(
+      absl::StrCat(classname, "$DirectCallException").c_str());
+  if (exception_class == nullptr) {
+    return false;
+  }
+  direct_call_exception_class =
+      static_cast<jclass>(env->NewGlobalRef(exception_class));
+  direct_call_exception_constructor = env->GetMethodID(
+      exception_class, "<init>", "(ILjava/lang/String;)V");
+  if (direct_call_exception_constructor == nullptr) {
+    return false;
+  }
+
+  jclass byte_buffer = env->FindClass("java/nio/ByteBuffer");
+  if (byte_buffer == nullptr) {
+    return false;
+  }
+  byte_buffer_class = static_cast<jclass>(env->NewGlobalRef(byte_buffer));
+  byte_buffer_allocate_direct = env->GetStaticMethodID(
+      byte_buffer, "allocateDirect", "(I)Ljava/nio/ByteBuffer;");
+  if (byte_buffer_allocate_direct == nullptr) {
+    return false;
+  }
+
+  jclass buffer = env->FindClass("java/nio/Buffer");
+  if (buffer == nullptr) {
+    return false;
+  }
+  buffer_clear = env->GetMethodID(buffer, "clear", "()Ljava/nio/Buffer;");
+  buffer_limit = env->GetMethodID(buffer, "limit", "(I)Ljava/nio/Buffer;");
+  return buffer_clear != nullptr && buffer_limit != nullptr;
+}
+
+static void ThrowDirectCallException(JNIEnv* env, const absl::Status& status) {
+  jstring message = env->NewStringUTF(std::string(status.message()).c_str());
+  if (message == nullptr) {
+    return;
+  }
+  jobject exception =
+      env->NewObject(direct_call_exception_class,
+                     direct_call_exception_constructor,
+                     static_cast<jint>(status.code()), message);
+  if (exception == nullptr) {
+    return;
+  }
+  env->Throw(static_cast<jthrowable>(exception));
+}
+
 static void ErrnoSocketException(JNIEnv* env) {
   char buf[128];
 #if __USE_GNU
@@ -107,6 +188,70 @@ static jobject WrapFileDescriptor(JNIEnv* env, const int fd) {
 
 }  // namespace
 
+jobject CallDirect(JNIEnv* env, jclass clazz, jstring method, jobject request,
+                   jint request_length, jobject response) {
+  if (!direct_call_available) {
+    jclass e = env->FindClass("java/lang/UnsupportedOperationException");
+    if (e != nullptr) {
+      env->ThrowNew(e, "callDirect() failed to initialize, see the log");
+    }
+    return nullptr;
+  }
+  const char* request_data =
+      static_cast<const char*>(env->GetDirectBufferAddress(request));
+  if (request_data == nullptr || request_length < 0 ||
+      request_length > env->GetDirectBufferCapacity(request)) {
+    ThrowDirectCallException(
+        env, absl::InvalidArgumentError(
+                 "The request must be in a direct ByteBuffer"));
+    return nullptr;
+  }
+
+  const char* method_chars = env->GetStringUTFChars(method, nullptr);
+  if (method_chars == nullptr) {
+    return nullptr;
+  }
+  absl::StatusOr<std::unique_ptr<google::protobuf::Message>> result =
+      CallLocalServiceMethod(GetService()->service(), method_chars,
+                             absl::string_view(request_data, request_length));
+  env->ReleaseStringUTFChars(method, method_chars);
+  if (!result.ok()) {
+    ThrowDirectCallException(env, result.status());
+    return nullptr;
+  }
+
+  const size_t size = (*result)->ByteSizeLong();
+  if (size > std::numeric_limits<jint>::max()) {
+    ThrowDirectCallException(
+        env, absl::ResourceExhaustedError("The response is too large"));
+    return nullptr;
+  }
+  // Serializes straight into the caller's buffer when it is large enough,
+  // otherwise into a new one that the caller can keep for the next call.
+  uint8_t* out = nullptr;
+  if (response != nullptr &&
+      env->GetDirectBufferCapacity(response) >= static_cast<jlong>(size)) {
+    out = static_cast<uint8_t*>(env->GetDirectBufferAddress(response));
+  }
+  if (out == nullptr) {
+    response = env->CallStaticObjectMethod(
+        byte_buffer_class, byte_buffer_allocate_direct,
+        static_cast<jint>(std::max<size_t>(size, 1)));
+    if (response == nullptr) {
+      return nullptr;
+    }
+    out = static_cast<uint8_t*>(env->GetDirectBufferAddress(response));
+  }
+  (*result)->SerializeWithCachedSizesToArray(out);
+
+  env->CallObjectMethod(response, buffer_clear);
+  env->CallObjectMethod(response, buffer_limit, static_cast<jint>(size));
+  if (env->ExceptionCheck()) {
+    return nullptr;
+  }
+  return response;
+}
+
 jobject GetSocketChannel(JNIEnv* env) {
   jclass impl = env->FindClass("sun/nio/ch/SocketChannelImpl");
   if (impl == nullptr) {
@@ -200,6 +345,15 @@ extern "C" JNIEXPORT jint JNICALL JNI_OnLoad_zetasql_local_service(JavaVM* vm,
 
   const char* classnamestr = env->GetStringUTFChars(classname, nullptr);
   jclass clazz = env->FindClass(classnamestr);
+  if (clazz != nullptr) {
+    direct_call_available = InitDirectCall(env, classnamestr);
+    if (!direct_call_available) {
+      // The gRPC channel does not need these classes, so keep loading.
+      env->ExceptionClear();
+      ZETASQL_LOG(WARNING) << "Disabling callDirect() of " << classnamestr
+                   << ": a class or method that it uses was not found";
+    }
+  }
   env->ReleaseStringUTFChars(classname, classnamestr);
   classnamestr = nullptr;
   if (clazz == nullptr) {
@@ -209,6 +363,7 @@ extern "C" JNIEXPORT jint JNICALL JNI_OnLoad_zetasql_local_service(JavaVM* vm,
   static JNINativeMethod methods[] = {
       {(char*)"getSocketChannel", (char*)"()Ljava/nio/channels/SocketChannel;",
        (void*)GetSocketChannel},
+      {(char*)"callDirect", (char*)kCallDirectSignature, (void*)CallDirect},
   };
   if (env->RegisterNatives(clazz, methods,
                            sizeof(methods) / sizeof(JNINativeMethod)) !=
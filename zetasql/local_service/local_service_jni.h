@@ -26,6 +26,16 @@ namespace local_service {
 // and connects the other end to the local_service gRPC server.
 jobject GetSocketChannel(JNIEnv* env);
 
+// Calls the unary local_service method named 'method' in process, without
+// going through gRPC. The serialized request is read from the first
+// 'request_length' bytes of the direct ByteBuffer 'request'. Returns a direct
+// ByteBuffer holding the serialized response between position 0 and its limit:
+// 'response' if it has the capacity for it, otherwise a newly allocated one.
+// Errors are thrown as a DirectCallException, nested in the class that
+// registered the native methods, with the code and message of the status.
+jobject CallDirect(JNIEnv* env, jclass clazz, jstring method, jobject request,
+                   jint request_length, jobject response);
+
 }  // namespace local_service
 }  // namespace zetasql
 
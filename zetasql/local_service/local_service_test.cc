@@ -133,6 +133,11 @@ class ZetaSqlLocalServiceImplTest : public ::testing::Test {
     return service_.Parse(request, response);
   }
 
+  absl::Status ParseBatch(const ParseBatchRequest& request,
+                          ParseBatchResponse* response) {
+    return service_.ParseBatch(request, response);
+  }
+
   absl::Status BuildSql(const BuildSqlRequest& request,
                         BuildSqlResponse* response) {
     return service_.BuildSql(request, response);
@@ -155,6 +160,11 @@ class ZetaSqlLocalServiceImplTest : public ::testing::Test {
     return service_.FormatSql(request, response);
   }
 
+  absl::Status FormatSqlBatch(const FormatSqlBatchRequest& request,
+                              FormatSqlBatchResponse* response) {
+    return service_.FormatSqlBatch(request, response);
+  }
+
   absl::Status RegisterCatalog(const RegisterCatalogRequest& request,
                                RegisterResponse* response) {
     return service_.RegisterCatalog(request, response);
@@ -695,6 +705,58 @@ TEST_F(ZetaSqlLocalServiceImplTest, ExtractTableNamesWithNoSemicolon) {
   EXPECT_THAT(response, EqualsProto(expectedResponse));
 }
 
+TEST_F(ZetaSqlLocalServiceImplTest, ParseBatch) {
+  // Enough requests to be split across threads.
+  ParseBatchRequest request;
+  for (int i = 0; i < 100; ++i) {
+    ParseRequest* parse_request = request.add_request();
+    parse_request->set_sql_statement(
+        absl::StrCat("select a", i, ", b from t", i % 7));
+    if (i % 2 == 0) {
+      parse_request->mutable_options()->add_enabled_language_features(
+          FEATURE_V_1_3_QUALIFY);
+    }
+  }
+  ParseBatchResponse response;
+  ZETASQL_ASSERT_OK(ParseBatch(request, &response));
+  ASSERT_EQ(response.response_size(), request.request_size());
+  ASSERT_EQ(response.status_size(), request.request_size());
+  for (int i = 0; i < request.request_size(); ++i) {
+    ParseResponse expected_response;
+    ZETASQL_ASSERT_OK(Parse(request.request(i), &expected_response));
+    EXPECT_THAT(response.response(i), EqualsProto(expected_response));
+    EXPECT_THAT(response.status(i), EqualsProto("code: 0"));
+  }
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, ParseBatchWithInvalidRequest) {
+  ParseBatchRequest request;
+  request.add_request()->set_sql_statement("select 1");
+  request.add_request()->set_sql_statement("select (");
+  request.add_request()->set_sql_statement("select 3");
+
+  ParseBatchResponse response;
+  ZETASQL_ASSERT_OK(ParseBatch(request, &response));
+  ASSERT_EQ(response.response_size(), 3);
+  ASSERT_EQ(response.status_size(), 3);
+
+  ParseResponse unused_response;
+  const absl::Status expected_status =
+      Parse(request.request(1), &unused_response);
+  ASSERT_FALSE(expected_status.ok());
+  EXPECT_EQ(response.status(1).code(),
+            static_cast<int>(expected_status.code()));
+  EXPECT_EQ(response.status(1).message(), expected_status.message());
+  EXPECT_THAT(response.response(1), EqualsProto(""));
+
+  for (int i : {0, 2}) {
+    ParseResponse expected_response;
+    ZETASQL_ASSERT_OK(Parse(request.request(i), &expected_response));
+    EXPECT_THAT(response.response(i), EqualsProto(expected_response));
+    EXPECT_THAT(response.status(i), EqualsProto("code: 0"));
+  }
+}
+
 TEST_F(ZetaSqlLocalServiceImplTest, UnregisterWrongCatalogId) {
   absl::Status status = UnregisterCatalog(12345);
   EXPECT_FALSE(status.ok());
@@ -2091,6 +2153,59 @@ TEST_F(ZetaSqlLocalServiceImplTest, FormatSql) {
       response.sql());
 }
 
+TEST_F(ZetaSqlLocalServiceImplTest, FormatSqlBatch) {
+  // Enough requests to be split across threads.
+  FormatSqlBatchRequest request;
+  for (int i = 0; i < 100; ++i) {
+    request.add_request()->set_sql(absl::StrCat("select ", i, " from t"));
+  }
+  FormatSqlBatchResponse response;
+  ZETASQL_ASSERT_OK(FormatSqlBatch(request, &response));
+  ASSERT_EQ(response.response_size(), request.request_size());
+  ASSERT_EQ(response.status_size(), request.request_size());
+  for (int i = 0; i < request.request_size(); ++i) {
+    FormatSqlResponse expected_response;
+    ZETASQL_ASSERT_OK(FormatSql(request.request(i), &expected_response));
+    EXPECT_THAT(response.response(i), EqualsProto(expected_response));
+    EXPECT_THAT(response.status(i), EqualsProto("code: 0"));
+  }
+
+  ZETASQL_EXPECT_OK(FormatSqlBatch(FormatSqlBatchRequest(), &response));
+  EXPECT_EQ(response.response_size(), 0);
+  EXPECT_EQ(response.status_size(), 0);
+}
+
+TEST_F(ZetaSqlLocalServiceImplTest, FormatSqlBatchWithInvalidRequest) {
+  // Enough requests to be split across threads, with the invalid one in the
+  // middle of a range.
+  FormatSqlBatchRequest request;
+  for (int i = 0; i < 100; ++i) {
+    request.add_request()->set_sql(absl::StrCat("select ", i, " from t"));
+  }
+  request.mutable_request(50)->set_sql("select (");
+
+  FormatSqlBatchResponse response;
+  ZETASQL_ASSERT_OK(FormatSqlBatch(request, &response));
+  ASSERT_EQ(response.response_size(), request.request_size());
+  ASSERT_EQ(response.status_size(), request.request_size());
+  for (int i = 0; i < request.request_size(); ++i) {
+    FormatSqlResponse expected_response;
+    const absl::Status expected_status =
+        FormatSql(request.request(i), &expected_response);
+    if (i == 50) {
+      ASSERT_FALSE(expected_status.ok());
+      EXPECT_EQ(response.status(i).code(),
+                static_cast<int>(expected_status.code()));
+      EXPECT_EQ(response.status(i).message(), expected_status.message());
+      EXPECT_THAT(response.response(i), EqualsProto(""));
+    } else {
+      ZETASQL_ASSERT_OK(expected_status);
+      EXPECT_THAT(response.response(i), EqualsProto(expected_response));
+      EXPECT_THAT(response.status(i), EqualsProto("code: 0"));
+    }
+  }
+}
+
 TEST_F(ZetaSqlLocalServiceImplTest, GetBuiltinFunctions) {
   ZetaSQLBuiltinFunctionOptionsProto proto;
   GetBuiltinFunctionsResponse response;
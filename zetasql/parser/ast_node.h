@@ -19,6 +19,9 @@
 
 #include <stddef.h>
 
+#include <type_traits>
+
+#include "zetasql/base/arena.h"
 #include "zetasql/base/arena_allocator.h"
 #include "zetasql/parser/ast_enums.pb.h"
 #include "zetasql/parser/ast_node_kind.h"
@@ -29,10 +32,14 @@
 // AST classes. It should not be included directly. Include parse_tree.h.
 //
 // During the AST construction process, AddChild / AddChildren() add to the
-// children_ vector.  In InitFields(), we store pointers to children into named
+// children_ array.  In InitFields(), we store pointers to children into named
 // member fields with more specific types.  This allows users to navigate to
 // specific child objects directly.
 //
+// ASTNodes are created with ASTNode::Create() in an arena, which also holds
+// their child arrays and strings. They are trivially destructible and never
+// destroyed: a parse tree goes away with its arena.
+//
 // The AST can be used in two forms -
 //   * using standard accessors like child() and parent() and
 //     the visitor interface,
@@ -62,7 +69,20 @@ class ASTNode : public zetasql_base::ArenaOnlyGladiator {
   ASTNode(const ASTNode&) = delete;
   ASTNode& operator=(const ASTNode&) = delete;
 
-  virtual ~ASTNode();
+  // Not virtual: ASTNodes are never deleted, see Create().
+  ~ASTNode() = default;
+
+  // Creates a node of type T in 'arena'. Its children and strings are
+  // allocated from 'arena' as well, so the node owns no other memory and is
+  // never destroyed; it is valid for as long as 'arena' is.
+  template <typename T>
+  static T* Create(zetasql_base::UnsafeArena* arena) {
+    static_assert(std::is_trivially_destructible<T>::value,
+                  "ASTNodes must not own memory outside of their arena");
+    T* node = zetasql_base::NewInArena<T>(arena);
+    node->arena_ = arena;
+    return node;
+  }
 
   // Returns this node's kind. DEPRECATED.
   ASTNodeKind getId() const { return node_kind_; }
@@ -94,14 +114,14 @@ class ASTNode : public zetasql_base::ArenaOnlyGladiator {
 
   // Access to child nodes with generic types.
   int num_children() const {
-    return children_.size();
+    return num_children_;
   }
   const ASTNode* child(int i) const { return children_[i]; }
   ASTNode* mutable_child(int i) { return children_[i]; }
 
   // Returns the index of the first child of a node kind or -1 if not found.
   int find_child_index(ASTNodeKind kind) const {
-    for (int i = 0; i < children_.size(); i++) {
+    for (int i = 0; i < num_children_; i++) {
       if (children_[i]->node_kind_ == kind) {
         return i;
       }
@@ -267,6 +287,17 @@ class ASTNode : public zetasql_base::ArenaOnlyGladiator {
   static std::string NodeKindToString(ASTNodeKind node_kind);
 
  protected:
+  // Returns a copy of 'str' in the arena of this node, for string fields.
+  absl::string_view CopyToArena(absl::string_view str);
+
+  // An empty string that is never destroyed. This is the default value of
+  // string fields that are owned by an IdStringPool.
+  static const std::string& EmptyString();
+
+  // The arena this node was created in by Create(), or NULL for nodes that
+  // were not, which cannot have children.
+  zetasql_base::UnsafeArena* arena() const { return arena_; }
+
   // Dispatches to non-recursive visitor implementation.
   // Used by TraverseNonRecursive().
   ABSL_MUST_USE_RESULT virtual absl::StatusOr<VisitResult> Accept(
@@ -469,14 +500,23 @@ class ASTNode : public zetasql_base::ArenaOnlyGladiator {
       const VisitResult& result, NonRecursiveParseTreeVisitor* visitor,
       std::vector<std::function<absl::Status()>>* stack);
 
+  // Makes room in children_ for at least 'capacity' children.
+  void ReserveChildren(int capacity);
+
   ASTNodeKind node_kind_;
 
   ASTNode* parent_ = nullptr;
 
   ParseLocationRange parse_location_range_;
 
-  // Many nodes have one to two children, so InlinedVector saves allocations.
-  absl::InlinedVector<ASTNode*, 4> children_;
+  zetasql_base::UnsafeArena* arena_ = nullptr;
+
+  // An array in arena_ holding num_children_ children, with room for
+  // children_capacity_. Most nodes get all of their children at once from
+  // AddChildren(), which allocates exactly the room needed.
+  ASTNode** children_ = nullptr;
+  int num_children_ = 0;
+  int children_capacity_ = 0;
 };
 
 }  // namespace zetasql
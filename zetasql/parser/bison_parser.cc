@@ -28,6 +28,7 @@
 #include "zetasql/parser/keywords.h"
 #include "zetasql/public/id_string.h"
 #include <cstdint>
+#include "absl/algorithm/container.h"
 #include "absl/cleanup/cleanup.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
@@ -330,17 +331,17 @@ static absl::StatusOr<std::string> GenerateImprovedBisonSyntaxError(
 absl::Status BisonParser::Parse(
     BisonParserMode mode, absl::string_view filename, absl::string_view input,
     int start_byte_offset, IdStringPool* id_string_pool, zetasql_base::UnsafeArena* arena,
-    const LanguageOptions& language_options, std::unique_ptr<ASTNode>* output,
-    std::vector<std::unique_ptr<ASTNode>>* other_allocated_ast_nodes,
+    const LanguageOptions& language_options, ASTNode** output,
     ASTStatementProperties* ast_statement_properties,
     int* statement_end_byte_offset) {
   id_string_pool_ = id_string_pool;
   arena_ = arena;
   language_options_ = &language_options;
-  allocated_ast_nodes_ =
-      std::make_unique<std::vector<std::unique_ptr<ASTNode>>>();
-  auto clean_up_allocated_ast_nodes =
-      absl::MakeCleanup([&] { allocated_ast_nodes_.reset(); });
+  allocated_ast_nodes_ = std::make_unique<std::vector<ASTNode*>>();
+  auto clean_up_allocated_ast_nodes = absl::MakeCleanup([&] {
+    allocated_ast_nodes_.reset();
+    temporary_ast_nodes_.clear();
+  });
   // We must have the filename outlive the <resume_location>, since the
   // parse tree ASTNodes will reference it in their ParseLocationRanges.
   // So we allocate a new filename from the ParserOptions IdStringPool,
@@ -366,24 +367,19 @@ absl::Status BisonParser::Parse(
     // Make sure InitFields() is called for all ASTNodes that were created.
     // We don't use the result of InitFields() in the grammar itself, so we
     // don't need to do this during parsing.
-    for (const auto& ast_node : *allocated_ast_nodes_) {
+    for (ASTNode* ast_node : *allocated_ast_nodes_) {
       ZETASQL_RETURN_IF_ERROR(ast_node->InitFields());
+      if (collected_nodes_ != nullptr &&
+          absl::c_linear_search(node_kinds_to_collect_,
+                                ast_node->node_kind())) {
+        collected_nodes_->push_back(ast_node);
+      }
     }
 
     if (mode != BisonParserMode::kNextStatementKind) {
       ZETASQL_RET_CHECK(output_node != nullptr);
-      *output = nullptr;
-      // Move 'output_node' out of 'allocated_ast_nodes_' and into '*output'.
-      for (int i = allocated_ast_nodes_->size() - 1; i >= 0; --i) {
-        if ((*allocated_ast_nodes_)[i].get() == output_node) {
-          *output = std::move((*allocated_ast_nodes_)[i]);
-          // There's no need to erase the entry in allocated_ast_nodes_.
-          break;
-        }
-      }
-      ZETASQL_RET_CHECK_EQ(output->get(), output_node);
+      *output = output_node;
     }
-    *other_allocated_ast_nodes = std::move(*allocated_ast_nodes_);
     return absl::OkStatus();
   }
   // The tokenizer's error overrides the parser's error.
@@ -60,8 +60,7 @@ class BisonParser {
   // if you have a different parser implementation than the default ZetaSQL
   // parser.
   BisonParser(zetasql_base::UnsafeArena* arena,
-              std::unique_ptr<std::vector<std::unique_ptr<ASTNode>>>
-                  allocated_ast_nodes,
+              std::unique_ptr<std::vector<ASTNode*>> allocated_ast_nodes,
               zetasql::IdStringPool* id_string_pool, absl::string_view input,
               const LanguageOptions& language_options)
       : id_string_pool_(id_string_pool),
@@ -72,6 +71,15 @@ class BisonParser {
 
   ~BisonParser();
 
+  // Makes the next call to Parse() add the nodes it creates of kinds
+  // 'node_kinds' to 'collected_nodes', if it succeeds. 'node_kinds' and
+  // 'collected_nodes' must outlive that call.
+  void CollectNodes(absl::Span<const ASTNodeKind> node_kinds,
+                    std::vector<const ASTNode*>* collected_nodes) {
+    node_kinds_to_collect_ = node_kinds;
+    collected_nodes_ = collected_nodes;
+  }
+
   // Parses 'input' in mode 'mode', starting at byte offset 'start_byte_offset'.
   // Returns the output tree in 'output', or returns an annotated error.
   // Neither this object nor the returned output retain any pointers to
@@ -80,19 +88,17 @@ class BisonParser {
   // Memory allocation:
   // - The 'filename' is copied into 'id_string_pool' for reference by the AST.
   // - Identifiers are allocated from 'id_string_pool'.
-  // - ASTNodes are allocated from 'arena'.
-  // - ASTNodes still need to be deleted before the memory pools are destroyed.
-  //   Ownership of all allocated ASTNodes except for the root output is
-  //   returned in 'other_allocated_ast_nodes'.
-  // The caller should keep 'id_string_pool' and 'arena' alive until all the
-  // returned ASTNodes have been deallocated.
+  // - ASTNodes, their children and their strings are allocated from 'arena'.
+  //   They are never deleted, and live as long as 'arena'.
+  // The caller should keep 'id_string_pool' and 'arena' alive for as long as
+  // the returned ASTNodes are used.
   //
   // If mode is kNextStatementKind, then the next statement kind is returned in
   // 'ast_statement_properties', and no parse tree is returned. This may still
   // allocate into 'id_string_pool' if the prefix of the statement that needs to
-  // be parsed includes identifiers, and may allocate ASTNodes into
-  // 'other_allocated_ast_nodes' if statement level hints are present. In this
-  // mode, 'statement_end_byte_offset' is *not* set.
+  // be parsed includes identifiers, and may allocate ASTNodes into 'arena' if
+  // statement level hints are present. In this mode,
+  // 'statement_end_byte_offset' is *not* set.
   //
   // If mode is kNextStatement, the byte offset past the current statement's
   // closing semicolon is returned in 'statement_end_byte_offset'. If the
@@ -104,8 +110,7 @@ class BisonParser {
       BisonParserMode mode, absl::string_view filename, absl::string_view input,
       int start_byte_offset, IdStringPool* id_string_pool, zetasql_base::UnsafeArena* arena,
       const LanguageOptions& language_options,
-      std::unique_ptr<zetasql::ASTNode>* output,
-      std::vector<std::unique_ptr<ASTNode>>* other_allocated_ast_nodes,
+      zetasql::ASTNode** output,
       ASTStatementProperties* ast_statement_properties,
       int* statement_end_byte_offset);
 
@@ -119,27 +124,28 @@ class BisonParser {
         bison_location.end.column - bison_location.begin.column);
   }
 
-  // Creates an ASTNode of type T with a unique id. Sets its location to
-  // the ZetaSQL location equivalent of 'bison_location'. Stores the returned
-  // pointer in allocated_ast_nodes_.
+  // Creates an ASTNode of type T in arena_. Sets its location to the ZetaSQL
+  // location equivalent of 'bison_location'. Stores the returned pointer in
+  // allocated_ast_nodes_.
   template <typename T>
   T* CreateASTNode(const zetasql_bison_parser::location& bison_location) {
-    T* result = new (zetasql_base::AllocateInArena, arena_) T;
+    T* result = ASTNode::Create<T>(arena_);
     SetNodeLocation(bison_location, result);
-    allocated_ast_nodes_->push_back(std::unique_ptr<ASTNode>(result));
+    allocated_ast_nodes_->push_back(result);
     return result;
   }
 
   // Creates an ASTNode of type T. Sets its location to the ZetaSQL location
   // equivalent of 'bison_location'. Then adds 'children' to the node, without
-  // calling InitFields(). Stores the returned pointer in ast_node_pool_.
+  // calling InitFields(). Stores the returned pointer in
+  // allocated_ast_nodes_.
   template <typename T>
   T* CreateASTNode(
       const zetasql_bison_parser::location& bison_location,
       absl::Span<ASTNode* const> children) {
-    T* result = new (zetasql_base::AllocateInArena, arena_) T;
+    T* result = ASTNode::Create<T>(arena_);
     SetNodeLocation(bison_location, result);
-    allocated_ast_nodes_->push_back(std::unique_ptr<ASTNode>(result));
+    allocated_ast_nodes_->push_back(result);
     result->AddChildren(children);
     return result;
   }
@@ -152,13 +158,26 @@ class BisonParser {
       const zetasql_bison_parser::location& bison_location_start,
       const zetasql_bison_parser::location& bison_location_end,
       absl::Span<ASTNode* const> children) {
-    T* result = new (zetasql_base::AllocateInArena, arena_) T;
+    T* result = ASTNode::Create<T>(arena_);
     SetNodeLocation(bison_location_start, bison_location_end, result);
-    allocated_ast_nodes_->push_back(std::unique_ptr<ASTNode>(result));
+    allocated_ast_nodes_->push_back(result);
     result->AddChildren(children);
     return result;
   }
 
+  // Creates a node of type T that is only used while parsing and never becomes
+  // part of the returned tree. Unlike other ASTNodes, T may own memory outside
+  // of the arena: these nodes are destroyed at the end of Parse(), or with the
+  // parser when it is used without Parse().
+  template <typename T>
+  T* CreateTemporaryASTNode(
+      const zetasql_bison_parser::location& bison_location) {
+    std::shared_ptr<T> result = std::make_shared<T>();
+    SetNodeLocation(bison_location, result.get());
+    temporary_ast_nodes_.push_back(result);
+    return result.get();
+  }
+
   // Creates an ASTIdentifier with text 'name' and location 'location'.
   ASTIdentifier* MakeIdentifier(
       const zetasql_bison_parser::location& location,
@@ -243,14 +262,13 @@ class BisonParser {
     return ++previous_positional_parameter_position_;
   }
 
-  // Move allocated_ast_nodes_ into ast_nodes and reset it. This releases
-  // ownership of allocated_ast_nodes_ so the AST can live beyond the lifetime
-  // of the parser. This is only intended to be used by a BisonParser that calls
+  // Move allocated_ast_nodes_ into ast_nodes and reset it, so that the caller
+  // can call InitFields() on them. The nodes themselves live in the arena.
+  // This is only intended to be used by a BisonParser that calls
   // CreateASTNode directly instead of using the provided Parse() function. This
   // situation should be rare and only relevant if you have a different parser
   // implementation than the default ZetaSQL parser.
-  void ReleaseAllocatedASTNodes(
-      std::vector<std::unique_ptr<ASTNode>>* ast_nodes) {
+  void ReleaseAllocatedASTNodes(std::vector<ASTNode*>* ast_nodes) {
     *ast_nodes = std::move(*allocated_ast_nodes_);
   }
 
@@ -277,9 +295,18 @@ class BisonParser {
   const LanguageOptions* language_options_ = nullptr;
 
   // ASTNodes that are allocated by the parser are added to this vector during
-  // parsing. The root node itself is added when it is allocated, but it is then
-  // taken out of the vector again in Parse(). Only valid during Parse().
-  std::unique_ptr<std::vector<std::unique_ptr<ASTNode>>> allocated_ast_nodes_;
+  // parsing, so that Parse() can call InitFields() on all of them. The nodes
+  // are owned by arena_. Only valid during Parse().
+  std::unique_ptr<std::vector<ASTNode*>> allocated_ast_nodes_;
+
+  // Nodes created by CreateTemporaryASTNode(). These are held by shared_ptrs
+  // because ASTNode does not have a virtual destructor, so they must be
+  // destroyed through their concrete type. Only valid during Parse().
+  std::vector<std::shared_ptr<ASTNode>> temporary_ast_nodes_;
+
+  // Set by CollectNodes(). Not owned.
+  absl::Span<const ASTNodeKind> node_kinds_to_collect_;
+  std::vector<const ASTNode*>* collected_nodes_ = nullptr;
 
   // The Flex tokenizer to use.  Only valid during Parse().
   std::unique_ptr<ZetaSqlFlexTokenizer> tokenizer_;
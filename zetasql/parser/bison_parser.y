@@ -115,10 +115,8 @@ class SeparatedIdentifierTmpNode final : public zetasql::ASTNode {
 
   // In order to save memory, these all contain string_view entries (backed by
   // the parser's copy of the input sql).
-  // This also uses inlined vectors, because we rarely expect more than a few
-  // entries at either level.
-  // Note, in the event the size is large, this will allocate directly to the
-  // heap, rather than into the arena.
+  // The vectors allocate on the heap rather than into the arena, which is why
+  // this node is created with BisonParser::CreateTemporaryASTNode().
   using IdParts = std::vector<absl::string_view>;
   using PathParts = std::vector<IdParts>;
 
@@ -6425,7 +6423,8 @@ dashed_identifier:
         if (id1[0] == '`' || id2[0] == '`') {
           YYERROR_AND_ABORT_AT(@2, "Syntax error: Unexpected \"-\"");
         }
-        auto out = parser->CreateASTNode<SeparatedIdentifierTmpNode>(@1);
+        auto out =
+            parser->CreateTemporaryASTNode<SeparatedIdentifierTmpNode>(@1);
         out->set_path_parts({{id1, "-", id2}});
         $$ = out;
       }
@@ -6443,7 +6442,8 @@ dashed_identifier:
         // Add an extra sub-part to the ending dashed identifier.
         prev.back().push_back("-");
         prev.back().push_back(id2);
-        auto out = parser->CreateASTNode<SeparatedIdentifierTmpNode>(@1);
+        auto out =
+            parser->CreateTemporaryASTNode<SeparatedIdentifierTmpNode>(@1);
         out->set_path_parts(std::move(prev));
         $$ = out;
       }
@@ -6458,7 +6458,8 @@ dashed_identifier:
         if (id1[0] == '`') {
           YYERROR_AND_ABORT_AT(@2, "Syntax error: Unexpected \"-\"");
         }
-        auto out = parser->CreateASTNode<SeparatedIdentifierTmpNode>(@1);
+        auto out =
+            parser->CreateTemporaryASTNode<SeparatedIdentifierTmpNode>(@1);
         out->set_path_parts({{id1, "-", id2}});
         $$ = out;
       }
@@ -6472,7 +6473,8 @@ dashed_identifier:
         absl::string_view id2 = parser->GetInputText(@3);
         prev.back().push_back("-");
         prev.back().push_back(id2);
-        auto out = parser->CreateASTNode<SeparatedIdentifierTmpNode>(@1);
+        auto out =
+            parser->CreateTemporaryASTNode<SeparatedIdentifierTmpNode>(@1);
         out->set_path_parts(std::move(prev));
         $$ = out;
       }
@@ -6488,7 +6490,8 @@ dashed_identifier:
         if (id1[0] == '`') {
           YYERROR_AND_ABORT_AT(@2, "Syntax error: Unexpected \"-\"");
         }
-        auto out = parser->CreateASTNode<SeparatedIdentifierTmpNode>(@1);
+        auto out =
+            parser->CreateTemporaryASTNode<SeparatedIdentifierTmpNode>(@1);
         // Here (and below) we need to handle the case where dot is lex'ed as
         // part of floating number as opposed to path delimiter. To parse it
         // correctly, we push the components separately (as string_view).
@@ -6514,7 +6517,8 @@ dashed_identifier:
         prev.back().push_back("-");
         prev.back().push_back(id1);
         prev.push_back({id2});
-        auto out = parser->CreateASTNode<SeparatedIdentifierTmpNode>(@1);
+        auto out =
+            parser->CreateTemporaryASTNode<SeparatedIdentifierTmpNode>(@1);
         out->set_path_parts(std::move(prev));
         $$ = out;
       }
@@ -6594,7 +6598,8 @@ slashed_identifier:
         if (id[0] == '`') {
           YYERROR_AND_ABORT_AT(@1, "Syntax error: Unexpected \"/\"");
         }
-        auto out = parser->CreateASTNode<SeparatedIdentifierTmpNode>(@1);
+        auto out =
+            parser->CreateTemporaryASTNode<SeparatedIdentifierTmpNode>(@1);
         out->set_path_parts({{"/", id}});
         $$ = out;
       }
@@ -6618,7 +6623,8 @@ slashed_identifier:
         // identifier: {"a", "-", "b"} -> {"a", "-", "b", ":", "c"}
         prev.back().push_back(separator);
         prev.back().push_back(id);
-        auto out = parser->CreateASTNode<SeparatedIdentifierTmpNode>(@1);
+        auto out =
+            parser->CreateTemporaryASTNode<SeparatedIdentifierTmpNode>(@1);
         out->set_path_parts(std::move(prev));
         $$ = out;
       }
@@ -6664,7 +6670,8 @@ slashed_identifier:
         prev.back().push_back(float_literal);
         prev.back().push_back(separator2);
         prev.back().push_back(id);
-        auto out = parser->CreateASTNode<SeparatedIdentifierTmpNode>(@1);
+        auto out =
+            parser->CreateTemporaryASTNode<SeparatedIdentifierTmpNode>(@1);
         out->set_path_parts(std::move(prev));
         $$ = out;
       }
@@ -7829,7 +7836,8 @@ string_literal:
         }
 
         auto* literal = MAKE_NODE(ASTStringLiteral, @1);
-        literal->set_string_value(std::move(str));
+        literal->set_string_value(
+            parser->id_string_pool()->MakeStdString(std::move(str)));
         // TODO: Migrate to absl::string_view or avoid having to
         // set this at all if the client isn't interested.
         literal->set_image(std::string(input_text));
@@ -7863,7 +7871,8 @@ bytes_literal:
         // parser maintains the original image.
         // TODO: Fix this wasted work when the JavaCC parser is gone.
         auto* literal = MAKE_NODE(ASTBytesLiteral, @1);
-        literal->set_bytes_value(std::move(bytes));
+        literal->set_bytes_value(
+            parser->id_string_pool()->MakeStdString(std::move(bytes)));
         // TODO: Migrate to absl::string_view or avoid having to
         // set this at all if the client isn't interested.
         literal->set_image(std::string(input_text));
@@ -0,0 +1,379 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/parser/flat_parse_tree.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/endian.h"
+#include "zetasql/parser/parse_tree.h"
+#include "zetasql/public/parse_location.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "zetasql/base/ret_check.h"
+#include "zetasql/base/status_macros.h"
+
+namespace zetasql {
+
+namespace {
+
+constexpr uint32_t kMagic = 0x5453415a;  // "ZAST"
+constexpr uint32_t kVersion = 2;
+
+// Words of the header.
+enum HeaderWord {
+  kMagicWord = 0,
+  kVersionWord,
+  kSchemaHashWord,
+  kNumNodesWord,
+  kNumChildrenWord,
+  kNumScalarsWord,
+  kNumStringsWord,
+  kNumStringBytesWord,
+  kFilenameWord,
+  kNumHeaderWords
+};
+
+// Words of each node.
+enum NodeWord {
+  kKindWord = 0,
+  kStartWord,
+  kEndWord,
+  kFirstChildWord,
+  kNumChildWordsWord,
+  kFirstScalarWord,
+  kNumNodeWords
+};
+
+void AppendWord(uint32_t word, std::string* output) {
+  char bytes[sizeof(word)];
+  zetasql_base::LittleEndian::Store32(bytes, word);
+  output->append(bytes, sizeof(bytes));
+}
+
+absl::Status MakeCorruptError(absl::string_view message) {
+  return absl::InvalidArgumentError(
+      absl::StrCat("Invalid flat parse tree: ", message));
+}
+
+}  // namespace
+
+uint32_t FlatParseTreeFields::Writer::GetStringIndex(absl::string_view value) {
+  auto [it, inserted] = string_indexes_.try_emplace(
+      value, static_cast<uint32_t>(strings_->size()));
+  if (inserted) {
+    strings_->push_back(value);
+  }
+  return it->second;
+}
+
+absl::string_view FlatParseTreeFields::Reader::NextString() {
+  const uint32_t index = NextScalar();
+  if (index >= static_cast<uint32_t>(tree_.num_strings())) {
+    bad_string_index_ = true;
+    return absl::string_view();
+  }
+  return tree_.string(index);
+}
+
+absl::Status FlatParseTreeFields::Reader::Finish() const {
+  if (next_scalar_ != num_scalars_) {
+    return MakeCorruptError(absl::StrCat("node ", node_, " has ", num_scalars_,
+                                         " fields, expected ", next_scalar_));
+  }
+  if (bad_string_index_) {
+    return MakeCorruptError(
+        absl::StrCat("node ", node_, " has an invalid string index"));
+  }
+  return absl::OkStatus();
+}
+
+absl::Status FlatParseTree::Serialize(const ASTNode* root,
+                                      std::string* output) {
+  ZETASQL_RET_CHECK(root != nullptr);
+  std::vector<uint32_t> node_words;
+  std::vector<uint32_t> children;
+  std::vector<uint32_t> scalars;
+  std::vector<absl::string_view> strings;
+  FlatParseTreeFields::Writer writer(&scalars, &strings);
+  const uint32_t filename_index = writer.GetStringIndex(
+      root->GetParseLocationRange().start().filename());
+
+  // Number the nodes in pre-order.
+  std::vector<const ASTNode*> nodes;
+  std::vector<const ASTNode*> stack = {root};
+  while (!stack.empty()) {
+    const ASTNode* node = stack.back();
+    stack.pop_back();
+    nodes.push_back(node);
+    for (int i = node->num_children() - 1; i >= 0; --i) {
+      stack.push_back(node->child(i));
+    }
+  }
+  absl::flat_hash_map<const ASTNode*, uint32_t> node_indexes;
+  node_indexes.reserve(nodes.size());
+  for (uint32_t i = 0; i < nodes.size(); ++i) {
+    node_indexes[nodes[i]] = i;
+  }
+
+  node_words.reserve(nodes.size() * kNumNodeWords);
+  for (const ASTNode* node : nodes) {
+    const ParseLocationRange& location = node->GetParseLocationRange();
+    node_words.push_back(node->node_kind());
+    node_words.push_back(location.start().GetByteOffset());
+    node_words.push_back(location.end().GetByteOffset());
+    node_words.push_back(children.size());
+    node_words.push_back(node->num_children());
+    node_words.push_back(scalars.size());
+    for (int i = 0; i < node->num_children(); ++i) {
+      children.push_back(node_indexes.at(node->child(i)));
+    }
+    ZETASQL_RETURN_IF_ERROR(FlatParseTreeFields::Write(node, &writer));
+  }
+
+  size_t num_string_bytes = 0;
+  for (absl::string_view str : strings) {
+    num_string_bytes += str.size();
+  }
+  ZETASQL_RET_CHECK_LE(num_string_bytes, UINT32_MAX);
+
+  output->clear();
+  output->reserve(
+      sizeof(uint32_t) * (kNumHeaderWords + node_words.size() +
+                          children.size() + scalars.size() + strings.size() +
+                          1) +
+      num_string_bytes);
+  AppendWord(kMagic, output);
+  AppendWord(kVersion, output);
+  AppendWord(FlatParseTreeFields::SchemaHash(), output);
+  AppendWord(nodes.size(), output);
+  AppendWord(children.size(), output);
+  AppendWord(scalars.size(), output);
+  AppendWord(strings.size(), output);
+  AppendWord(num_string_bytes, output);
+  AppendWord(filename_index, output);
+  for (uint32_t word : node_words) AppendWord(word, output);
+  for (uint32_t word : children) AppendWord(word, output);
+  for (uint32_t word : scalars) AppendWord(word, output);
+  uint32_t offset = 0;
+  for (absl::string_view str : strings) {
+    AppendWord(offset, output);
+    offset += str.size();
+  }
+  AppendWord(offset, output);
+  for (absl::string_view str : strings) {
+    output->append(str.data(), str.size());
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<FlatParseTree> FlatParseTree::Create(absl::string_view data) {
+  FlatParseTree tree(data);
+  const size_t num_words = data.size() / sizeof(uint32_t);
+  if (num_words < kNumHeaderWords) {
+    return MakeCorruptError("too short");
+  }
+  if (tree.Word(kMagicWord) != kMagic) {
+    return MakeCorruptError("bad magic number");
+  }
+  if (tree.Word(kVersionWord) != kVersion) {
+    return MakeCorruptError(
+        absl::StrCat("unsupported version ", tree.Word(kVersionWord)));
+  }
+  if (tree.Word(kSchemaHashWord) != FlatParseTreeFields::SchemaHash()) {
+    return MakeCorruptError("written with other node definitions");
+  }
+  // Check the section sizes in 64 bits, so that they cannot overflow.
+  const uint64_t num_nodes = tree.Word(kNumNodesWord);
+  const uint64_t num_children = tree.Word(kNumChildrenWord);
+  const uint64_t num_scalars = tree.Word(kNumScalarsWord);
+  const uint64_t num_strings = tree.Word(kNumStringsWord);
+  const uint64_t num_string_bytes = tree.Word(kNumStringBytesWord);
+  const uint64_t num_section_words = kNumHeaderWords +
+                                     num_nodes * kNumNodeWords + num_children +
+                                     num_scalars + num_strings + 1;
+  if (num_nodes == 0 || num_section_words > num_words ||
+      num_section_words * sizeof(uint32_t) + num_string_bytes != data.size()) {
+    return MakeCorruptError("section sizes do not match the data size");
+  }
+  tree.num_nodes_ = num_nodes;
+  tree.num_children_ = num_children;
+  tree.num_scalars_ = num_scalars;
+  tree.num_strings_ = num_strings;
+  tree.nodes_word_ = kNumHeaderWords;
+  tree.children_word_ = tree.nodes_word_ + num_nodes * kNumNodeWords;
+  tree.scalars_word_ = tree.children_word_ + num_children;
+  tree.string_offsets_word_ = tree.scalars_word_ + num_scalars;
+  tree.string_bytes_ = (tree.string_offsets_word_ + num_strings + 1) *
+                       static_cast<int>(sizeof(uint32_t));
+
+  tree.filename_index_ = tree.Word(kFilenameWord);
+  if (tree.filename_index_ >= num_strings) {
+    return MakeCorruptError("invalid filename");
+  }
+  for (uint64_t i = 0; i < num_strings; ++i) {
+    const uint32_t begin = tree.Word(tree.string_offsets_word_ + i);
+    const uint32_t end = tree.Word(tree.string_offsets_word_ + i + 1);
+    if (begin > end || end > num_string_bytes) {
+      return MakeCorruptError(absl::StrCat("invalid string ", i));
+    }
+  }
+  uint64_t previous_first_scalar = 0;
+  for (uint64_t node = 0; node < num_nodes; ++node) {
+    const uint64_t first_child = tree.NodeWord(node, kFirstChildWord);
+    const uint64_t node_children = tree.NodeWord(node, kNumChildWordsWord);
+    const uint64_t first_scalar = tree.NodeWord(node, kFirstScalarWord);
+    if (first_child + node_children > num_children ||
+        first_scalar < previous_first_scalar || first_scalar > num_scalars) {
+      return MakeCorruptError(absl::StrCat("invalid node ", node));
+    }
+    const int64_t node_kind = tree.NodeWord(node, kKindWord);
+    if (node_kind < kFirstASTNodeKind || node_kind > kLastASTNodeKind) {
+      return MakeCorruptError(
+          absl::StrCat("invalid kind ", node_kind, " of node ", node));
+    }
+    // Children come after their parent in pre-order, which rules out cycles.
+    for (uint64_t i = 0; i < node_children; ++i) {
+      const uint32_t child = tree.Word(tree.children_word_ + first_child + i);
+      if (child <= node || child >= num_nodes) {
+        return MakeCorruptError(
+            absl::StrCat("invalid child ", i, " of node ", node));
+      }
+    }
+    previous_first_scalar = first_scalar;
+  }
+  return tree;
+}
+
+absl::StatusOr<std::unique_ptr<ParserOutput>> FlatParseTree::Deserialize(
+    const ParserOptions& parser_options_in) const {
+  ParserOptions parser_options = parser_options_in;
+  parser_options.CreateDefaultArenasIfNotSet();
+  zetasql_base::UnsafeArena* arena = parser_options.arena().get();
+  IdStringPool* id_string_pool = parser_options.id_string_pool().get();
+  const absl::string_view filename =
+      id_string_pool->Make(this->filename()).ToStringView();
+
+  std::vector<ASTNode*> nodes(num_nodes_);
+  for (int i = 0; i < num_nodes_; ++i) {
+    FlatParseTreeFields::Reader reader(*this, i);
+    ZETASQL_ASSIGN_OR_RETURN(
+        nodes[i], FlatParseTreeFields::Create(node_kind(i), arena,
+                                              id_string_pool, &reader));
+    ZETASQL_RETURN_IF_ERROR(reader.Finish());
+    nodes[i]->set_start_location(
+        ParseLocationPoint::FromByteOffset(filename, start_byte_offset(i)));
+    nodes[i]->set_end_location(
+        ParseLocationPoint::FromByteOffset(filename, end_byte_offset(i)));
+  }
+  std::vector<bool> has_parent(num_nodes_);
+  std::vector<ASTNode*> children;
+  for (int i = 0; i < num_nodes_; ++i) {
+    children.clear();
+    for (int j = 0; j < num_children(i); ++j) {
+      const int child = this->child(i, j);
+      if (has_parent[child]) {
+        return MakeCorruptError(
+            absl::StrCat("node ", child, " has several parents"));
+      }
+      has_parent[child] = true;
+      children.push_back(nodes[child]);
+    }
+    nodes[i]->AddChildren(children);
+    ZETASQL_RETURN_IF_ERROR(FlatParseTreeFields::CheckChildren(nodes[i]));
+  }
+  for (int i = num_nodes_ - 1; i >= 0; --i) {
+    ZETASQL_RETURN_IF_ERROR(nodes[i]->InitFields());
+  }
+
+  ASTNode* root = nodes[0];
+  if (root->IsStatement()) {
+    return std::make_unique<ParserOutput>(
+        parser_options.id_string_pool(), parser_options.arena(),
+        root->GetAsOrDie<ASTStatement>());
+  }
+  if (root->node_kind() == AST_SCRIPT) {
+    return std::make_unique<ParserOutput>(parser_options.id_string_pool(),
+                                          parser_options.arena(),
+                                          root->GetAsOrDie<ASTScript>());
+  }
+  if (root->IsType()) {
+    return std::make_unique<ParserOutput>(parser_options.id_string_pool(),
+                                          parser_options.arena(),
+                                          root->GetAsOrDie<ASTType>());
+  }
+  if (root->IsExpression()) {
+    return std::make_unique<ParserOutput>(
+        parser_options.id_string_pool(), parser_options.arena(),
+        root->GetAsOrDie<ASTExpression>());
+  }
+  return absl::InvalidArgumentError(absl::StrCat(
+      "Cannot deserialize a flat parse tree rooted at ",
+      root->GetNodeKindString()));
+}
+
+uint32_t FlatParseTree::Word(int word) const {
+  return zetasql_base::LittleEndian::Load32(data_.data() +
+                                            word * sizeof(uint32_t));
+}
+
+uint32_t FlatParseTree::NodeWord(int node, int field) const {
+  return Word(nodes_word_ + node * kNumNodeWords + field);
+}
+
+ASTNodeKind FlatParseTree::node_kind(int node) const {
+  return static_cast<ASTNodeKind>(NodeWord(node, kKindWord));
+}
+
+int FlatParseTree::start_byte_offset(int node) const {
+  return static_cast<int32_t>(NodeWord(node, kStartWord));
+}
+
+int FlatParseTree::end_byte_offset(int node) const {
+  return static_cast<int32_t>(NodeWord(node, kEndWord));
+}
+
+int FlatParseTree::num_children(int node) const {
+  return NodeWord(node, kNumChildWordsWord);
+}
+
+int FlatParseTree::child(int node, int i) const {
+  return Word(children_word_ + NodeWord(node, kFirstChildWord) + i);
+}
+
+int FlatParseTree::num_scalars(int node) const {
+  const uint32_t end = node + 1 < num_nodes_
+                           ? NodeWord(node + 1, kFirstScalarWord)
+                           : num_scalars_;
+  return end - NodeWord(node, kFirstScalarWord);
+}
+
+uint32_t FlatParseTree::scalar(int node, int i) const {
+  return Word(scalars_word_ + NodeWord(node, kFirstScalarWord) + i);
+}
+
+absl::string_view FlatParseTree::string(uint32_t index) const {
+  const uint32_t begin = Word(string_offsets_word_ + index);
+  const uint32_t end = Word(string_offsets_word_ + index + 1);
+  return data_.substr(string_bytes_ + begin, end - begin);
+}
+
+}  // namespace zetasql
@@ -0,0 +1,201 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_PARSER_FLAT_PARSE_TREE_H_
+#define ZETASQL_PARSER_FLAT_PARSE_TREE_H_
+
+// FlatParseTree is a compact binary encoding of a parse tree, meant for
+// caching parsed SQL, e.g. in files shared between processes. Unlike an
+// AnyASTStatementProto from ParseTreeSerializer, it can be read in place,
+// e.g. from a memory-mapped file, and turning it back into ASTNodes takes a
+// single pass that allocates nothing but the nodes themselves.
+//
+//   std::string data;
+//   ZETASQL_RETURN_IF_ERROR(FlatParseTree::Serialize(statement, &data));
+//   ...
+//   ZETASQL_ASSIGN_OR_RETURN(FlatParseTree tree, FlatParseTree::Create(data));
+//   ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<ParserOutput> output,
+//                    tree.Deserialize(ParserOptions()));
+//
+// The encoding is a sequence of 32-bit little-endian words:
+//   header:   magic, version, schema hash, node count, child count, scalar
+//             count, string count, string byte count, string index of the
+//             filename.
+//   nodes:    for each node, in pre-order, starting with the root: node kind,
+//             start and end byte offsets, index of its first entry in the
+//             children section, number of children, index of its first entry
+//             in the scalars section.
+//   children: node indexes of the children of all nodes.
+//   scalars:  the fields of all nodes that are not children. bool, int and
+//             enum fields hold their value, string fields a string index.
+//   strings:  string count + 1 byte offsets of the strings into the string
+//             bytes that follow. Strings that occur more than once are stored
+//             once.
+// The scalar fields of a node kind are listed in flat_parse_tree_fields.cc,
+// which is generated. Encodings are not compatible across versions of the
+// node definitions, so the schema hash identifies them and Create() rejects
+// encodings with another one.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/arena.h"
+#include "zetasql/parser/ast_node_kind.h"
+#include "zetasql/parser/parse_tree.h"
+#include "zetasql/parser/parser.h"
+#include "zetasql/public/id_string.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+
+class FlatParseTree {
+ public:
+  // Encodes the tree rooted at 'root' into 'output', replacing its contents.
+  static absl::Status Serialize(const ASTNode* root, std::string* output);
+
+  // Returns a FlatParseTree reading the encoding in 'data', after checking
+  // that it was written with the same node definitions, that its sections are
+  // consistent and that its node kinds are valid. 'data' is not copied, and
+  // must outlive the returned object.
+  static absl::StatusOr<FlatParseTree> Create(absl::string_view data);
+
+  // Rebuilds the encoded tree as ASTNodes, after checking that the children
+  // of each node have the kinds that its fields expect. The root must be a
+  // statement, script, type or expression. As with
+  // ParseTreeSerializer::Deserialize(), 'parser_options' can set the arena and
+  // IdStringPool to use and the ParserOutput keeps them alive.
+  absl::StatusOr<std::unique_ptr<ParserOutput>> Deserialize(
+      const ParserOptions& parser_options_in) const;
+
+  // Accessors reading the encoding without deserializing it. Nodes are
+  // identified by their index, the root being node 0.
+  int num_nodes() const { return num_nodes_; }
+  ASTNodeKind node_kind(int node) const;
+  int start_byte_offset(int node) const;
+  int end_byte_offset(int node) const;
+  int num_children(int node) const;
+  // Returns the node index of child 'i' of 'node'.
+  int child(int node, int i) const;
+  // Returns the number of fields of 'node' that are not children, and their
+  // values, in the order used by flat_parse_tree_fields.cc.
+  int num_scalars(int node) const;
+  uint32_t scalar(int node, int i) const;
+  // Returns the string with index 'index', such as a string scalar.
+  int num_strings() const { return num_strings_; }
+  absl::string_view string(uint32_t index) const;
+  absl::string_view filename() const { return string(filename_index_); }
+
+ private:
+  explicit FlatParseTree(absl::string_view data) : data_(data) {}
+
+  // Returns the 32-bit word at index 'word' of data_.
+  uint32_t Word(int word) const;
+  uint32_t NodeWord(int node, int field) const;
+
+  absl::string_view data_;
+  int num_nodes_ = 0;
+  int num_children_ = 0;
+  int num_scalars_ = 0;
+  int num_strings_ = 0;
+  uint32_t filename_index_ = 0;
+  // Index in data_ of the first word of each section.
+  int nodes_word_ = 0;
+  int children_word_ = 0;
+  int scalars_word_ = 0;
+  int string_offsets_word_ = 0;
+  // Index in data_ of the first byte of the strings.
+  int string_bytes_ = 0;
+};
+
+// Reads and writes the fields of each node kind that are not children. Only
+// used by FlatParseTree. Generated in flat_parse_tree_fields.cc, and a friend
+// of all node classes.
+class FlatParseTreeFields {
+ public:
+  class Writer {
+   public:
+    Writer(std::vector<uint32_t>* scalars,
+           std::vector<absl::string_view>* strings)
+        : scalars_(scalars), strings_(strings) {}
+    Writer(const Writer&) = delete;
+    Writer& operator=(const Writer&) = delete;
+
+    void AddScalar(uint32_t value) { scalars_->push_back(value); }
+    void AddString(absl::string_view value) {
+      AddScalar(GetStringIndex(value));
+    }
+    uint32_t GetStringIndex(absl::string_view value);
+
+   private:
+    std::vector<uint32_t>* scalars_;
+    std::vector<absl::string_view>* strings_;
+    absl::flat_hash_map<absl::string_view, uint32_t> string_indexes_;
+  };
+
+  class Reader {
+   public:
+    Reader(const FlatParseTree& tree, int node)
+        : tree_(tree), node_(node), num_scalars_(tree.num_scalars(node)) {}
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    uint32_t NextScalar() {
+      if (next_scalar_ >= num_scalars_) {
+        ++next_scalar_;
+        return 0;
+      }
+      return tree_.scalar(node_, next_scalar_++);
+    }
+    absl::string_view NextString();
+
+    // Returns an error unless all the scalars of the node were read and all
+    // string indexes were valid.
+    absl::Status Finish() const;
+
+   private:
+    const FlatParseTree& tree_;
+    const int node_;
+    const int num_scalars_;
+    int next_scalar_ = 0;
+    bool bad_string_index_ = false;
+  };
+
+  // Adds the fields of 'node' to 'writer'.
+  static absl::Status Write(const ASTNode* node, Writer* writer);
+
+  // Creates a node of kind 'node_kind' in 'arena' with the fields read from
+  // 'reader'.
+  static absl::StatusOr<ASTNode*> Create(ASTNodeKind node_kind,
+                                         zetasql_base::UnsafeArena* arena,
+                                         IdStringPool* id_string_pool,
+                                         Reader* reader);
+
+  // Returns an error if node->InitFields() would assign a child of 'node' to
+  // a field of another type, or would fail.
+  static absl::Status CheckChildren(const ASTNode* node);
+
+  // Returns kParseTreeSchemaHash combined with the values of the node kinds.
+  static uint32_t SchemaHash();
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_PARSER_FLAT_PARSE_TREE_H_
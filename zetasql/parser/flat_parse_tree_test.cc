@@ -0,0 +1,198 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/parser/flat_parse_tree.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/status.h"
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/parser/parse_tree.h"
+#include "zetasql/parser/parser.h"
+#include "zetasql/public/parse_resume_location.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
+
+namespace zetasql {
+namespace {
+
+using ::testing::HasSubstr;
+using ::zetasql_base::testing::StatusIs;
+
+std::string SerializeOrDie(const ASTNode* node) {
+  std::string data;
+  ZETASQL_CHECK_OK(FlatParseTree::Serialize(node, &data));
+  return data;
+}
+
+class FlatParseTreeStatementTest
+    : public ::testing::TestWithParam<absl::string_view> {};
+
+TEST_P(FlatParseTreeStatementTest, RoundTrip) {
+  std::unique_ptr<ParserOutput> parser_output;
+  ZETASQL_ASSERT_OK(ParseStatement(GetParam(), ParserOptions(), &parser_output));
+  const ASTStatement* statement = parser_output->statement();
+  const std::string data = SerializeOrDie(statement);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(FlatParseTree tree, FlatParseTree::Create(data));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ParserOutput> deserialized,
+                       tree.Deserialize(ParserOptions()));
+  EXPECT_EQ(statement->DebugString(),
+            deserialized->statement()->DebugString());
+  EXPECT_EQ(Unparse(statement), Unparse(deserialized->statement()));
+  // Serializing the deserialized tree gives the same encoding.
+  EXPECT_EQ(data, SerializeOrDie(deserialized->statement()));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Statements, FlatParseTreeStatementTest,
+    ::testing::Values(
+        "SELECT 1",
+        "SELECT a, b AS c FROM t1 JOIN t2 USING (k) WHERE a > 5 ORDER BY 1",
+        "SELECT 'str', b'\\xff\\x00', 1.5, DATE '2020-01-01'",
+        "SELECT COUNT(DISTINCT x) OVER (PARTITION BY y ORDER BY z DESC) FROM t",
+        "WITH q AS (SELECT 1 AS x) SELECT * FROM q UNION ALL SELECT 2",
+        "SELECT CAST(x AS STRUCT<a INT64, b ARRAY<STRING>>) FROM t",
+        "CREATE TEMP TABLE t (a INT64 NOT NULL, b STRING) AS SELECT 1, 'b'",
+        "INSERT INTO t (a, b) VALUES (1, 'x'), (2, 'y')"));
+
+TEST(FlatParseTreeTest, BytesLiteralValue) {
+  std::unique_ptr<ParserOutput> parser_output;
+  ZETASQL_ASSERT_OK(
+      ParseExpression("b'\\xff\\x00'", ParserOptions(), &parser_output));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      FlatParseTree tree,
+      FlatParseTree::Create(SerializeOrDie(parser_output->expression())));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ParserOutput> deserialized,
+                       tree.Deserialize(ParserOptions()));
+  EXPECT_EQ(deserialized->expression()
+                ->GetAsOrDie<ASTBytesLiteral>()
+                ->bytes_value(),
+            absl::string_view("\xff\x00", 2));
+}
+
+TEST(FlatParseTreeTest, ReadsWithoutDeserializing) {
+  std::unique_ptr<ParserOutput> parser_output;
+  ParseResumeLocation location = ParseResumeLocation::FromStringView(
+      "file.sql", "SELECT x FROM x.y");
+  bool at_end_of_input;
+  ZETASQL_ASSERT_OK(ParseNextStatement(&location, ParserOptions(), &parser_output,
+                               &at_end_of_input));
+  const std::string data = SerializeOrDie(parser_output->statement());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(FlatParseTree tree, FlatParseTree::Create(data));
+
+  EXPECT_EQ(tree.filename(), "file.sql");
+  EXPECT_EQ(tree.node_kind(0), AST_QUERY_STATEMENT);
+  EXPECT_EQ(tree.start_byte_offset(0), 0);
+  EXPECT_EQ(tree.end_byte_offset(0), 17);
+  // The first scalar of an ASTIdentifier is its name.
+  std::vector<uint32_t> identifiers;
+  for (int node = 0; node < tree.num_nodes(); ++node) {
+    if (tree.node_kind(node) == AST_IDENTIFIER) {
+      ASSERT_GE(tree.num_scalars(node), 1);
+      identifiers.push_back(tree.scalar(node, 0));
+    }
+  }
+  ASSERT_EQ(identifiers.size(), 3);
+  EXPECT_EQ(tree.string(identifiers[0]), "x");
+  EXPECT_EQ(tree.string(identifiers[2]), "y");
+  // Both "x" are stored once, like the filename.
+  EXPECT_EQ(identifiers[0], identifiers[1]);
+  EXPECT_EQ(tree.num_strings(), 3);
+}
+
+TEST(FlatParseTreeTest, RejectsInvalidData) {
+  std::unique_ptr<ParserOutput> parser_output;
+  ZETASQL_ASSERT_OK(ParseStatement("SELECT a + 1 FROM t", ParserOptions(),
+                           &parser_output));
+  const std::string data = SerializeOrDie(parser_output->statement());
+
+  EXPECT_THAT(FlatParseTree::Create(""),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(FlatParseTree::Create(data.substr(0, data.size() - 1)),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  std::string bad_magic = data;
+  bad_magic[0] ^= 1;
+  EXPECT_THAT(FlatParseTree::Create(bad_magic),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  // Make the first child of the root point back to the root. Its first child
+  // is the first entry of the children section, after the header and the
+  // nodes.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(FlatParseTree tree, FlatParseTree::Create(data));
+  std::string cycle = data;
+  const int children_byte = (9 + 6 * tree.num_nodes()) * 4;
+  cycle.replace(children_byte, 4, std::string(4, '\0'));
+  EXPECT_THAT(FlatParseTree::Create(cycle),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(FlatParseTreeTest, RejectsOtherSchemaHash) {
+  std::unique_ptr<ParserOutput> parser_output;
+  ZETASQL_ASSERT_OK(
+      ParseStatement("SELECT 1", ParserOptions(), &parser_output));
+  std::string data = SerializeOrDie(parser_output->statement());
+  // The schema hash is the third word of the header.
+  data[2 * 4] ^= 1;
+  EXPECT_THAT(FlatParseTree::Create(data),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("other node definitions")));
+}
+
+TEST(FlatParseTreeTest, RejectsInvalidNodeKind) {
+  std::unique_ptr<ParserOutput> parser_output;
+  ZETASQL_ASSERT_OK(
+      ParseStatement("SELECT 1", ParserOptions(), &parser_output));
+  std::string data = SerializeOrDie(parser_output->statement());
+  // The kind of the root is the first word after the header.
+  data.replace(9 * 4, 4, std::string(4, '\xff'));
+  EXPECT_THAT(FlatParseTree::Create(data),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("invalid kind")));
+}
+
+TEST(FlatParseTreeTest, RejectsChildOfWrongKind) {
+  std::unique_ptr<ParserOutput> parser_output;
+  ZETASQL_ASSERT_OK(ParseStatement("SELECT a + 1 FROM t", ParserOptions(),
+                           &parser_output));
+  std::string data = SerializeOrDie(parser_output->statement());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(FlatParseTree tree, FlatParseTree::Create(data));
+
+  // Swap the select list and the FROM clause of the ASTSelect, whose
+  // InitFields() would otherwise take the FROM clause as its select list.
+  int first_child = 0;
+  int select = 0;
+  while (tree.node_kind(select) != AST_SELECT) {
+    first_child += tree.num_children(select);
+    ++select;
+  }
+  ASSERT_EQ(tree.num_children(select), 2);
+  const int children_byte = (9 + 6 * tree.num_nodes() + first_child) * 4;
+  const std::string select_list = data.substr(children_byte, 4);
+  data.replace(children_byte, 4, data.substr(children_byte + 4, 4));
+  data.replace(children_byte + 4, 4, select_list);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(tree, FlatParseTree::Create(data));
+  EXPECT_THAT(tree.Deserialize(ParserOptions()),
+              StatusIs(absl::StatusCode::kInvalidArgument,
+                       HasSubstr("cannot be of kind FromClause")));
+}
+
+}  // namespace
+}  // namespace zetasql
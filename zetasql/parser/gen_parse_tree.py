@@ -25,6 +25,7 @@ Still a work in progress.
 
 import collections
 import enum
+import hashlib
 import operator
 import re
 
@@ -103,11 +104,22 @@ SCALAR_BOOL_DEFAULT_TRUE = ScalarType(
     java_type='boolean',
     cpp_default='true')
 
+# The characters are stored in the arena of the node, so fields of this type
+# need a hand-written setter that copies its argument with CopyToArena().
 SCALAR_STRING = ScalarType(
-    'std::string',
+    'absl::string_view',
     java_type='String',
     proto_type='string')
 
+# The string is owned by the IdStringPool of the parse tree (see
+# IdStringPool::MakeStdString()), so that it can be returned as a
+# const std::string&. Fields of this type need a hand-written setter.
+SCALAR_POOLED_STRING = ScalarType(
+    'const std::string*',
+    java_type='String',
+    proto_type='string',
+    cpp_default='&EmptyString()')
+
 SCALAR_ID_STRING = ScalarType(
     'IdString',
     java_type='String',
@@ -247,7 +259,7 @@ SCALAR_LOAD_INSERTION_MODE = EnumScalarType(
 
 
 # Identifies the FieldLoader method used to populate member fields.
-# Each node field in a subclass is added to the children_ vector in ASTNode,
+# Each node field in a subclass is added to the children_ array in ASTNode,
 # then additionally added to a type-specific field in the subclass using one
 # of these methods:
 # REQUIRED: The next node in the vector, which must exist, is used for this
@@ -340,6 +352,10 @@ def Field(name,
                                                         'not be specified for '
                                                         'scalar field %s' %
                                                         name)
+    assert ctype is not SCALAR_STRING or not gen_setters_and_getters, (
+        'string field %s needs a setter that copies to the arena' % name)
+    assert ctype is not SCALAR_POOLED_STRING or not gen_setters_and_getters, (
+        'string field %s needs a setter that takes a pooled string' % name)
     member_type = ctype.ctype
     cpp_default = ctype.cpp_default
     is_node_ptr = False
@@ -414,7 +430,7 @@ Ancestor = collections.namedtuple('Ancestor', [
 
 # InitField holds the attributes of a field needed to add it in InitFields().
 InitField = collections.namedtuple('InitField', [
-    'field_loader', 'member_name', 'node_kind'])
+    'field_loader', 'member_name', 'node_kind', 'ctype'])
 
 
 class TreeGenerator(object):
@@ -596,17 +612,19 @@ class TreeGenerator(object):
     """
     assert not self.root_child_nodes
 
-    def TraverseToRoot(node, ancestors, init_fields):
+    def TraverseToRoot(node, ancestors, init_fields, scalar_fields):
       """Recursively ascend node's parents to build list of parents' subclasses.
 
       Also builds a list of all the node's fields which need to be included
-      in InitFields().
+      in InitFields(), and a list of all the node's fields which are not
+      children.
 
       End recursion when root node is reached.
       Args:
         node: Node to search up from.
         ancestors: a dict built via recursion of tag_id->Ancester.
         init_fields: A list of InitFields.
+        scalar_fields: A list of field dicts.
       """
       # The list of init_fields is built from the lowest class first, adding
       # fields according to order of declaration, then doing the same at
@@ -614,8 +632,10 @@ class TreeGenerator(object):
       for field in node['fields']:
         if field['is_node_ptr'] or field['is_vector']:
           init_field = InitField(field['field_loader'], field['member_name'],
-                                 field['node_kind'])
+                                 field['node_kind'], field['ctype'])
           init_fields.append(init_field)
+        else:
+          scalar_fields.append(field)
       parent_name = node['parent']
       if parent_name != ROOT_NODE_NAME:
         parent_node = self._GetNodeByName(parent_name)
@@ -623,7 +643,7 @@ class TreeGenerator(object):
                             parent_node['proto_field_type'],
                             node['member_name'], node['proto_field_type'])
         ancestors[ancestor.tag_id] = ancestor
-        TraverseToRoot(parent_node, ancestors, init_fields)
+        TraverseToRoot(parent_node, ancestors, init_fields, scalar_fields)
         parent_subclasses = parent_node['subclasses']
       else:
         parent_subclasses = self.root_child_nodes
@@ -641,8 +661,10 @@ class TreeGenerator(object):
           field['proto_type'] = field_node['proto_field_type']
       ancestors = {}  #  {tag_id : Ancestor}
       init_fields = []
-      TraverseToRoot(node, ancestors, init_fields)
+      scalar_fields = []
+      TraverseToRoot(node, ancestors, init_fields, scalar_fields)
       node['ancestors'] = ancestors
+      node['scalar_fields'] = scalar_fields
       if node['init_fields_order']:
         init_fields_order_members = [
             field + '_' for field in node['init_fields_order']
@@ -657,6 +679,27 @@ class TreeGenerator(object):
           init_fields.append(init_fields_dict[field_name])
       node['init_fields'] = init_fields
 
+  def _ComputeSchemaHash(self):
+    """Returns a 32-bit hash of the node classes and their fields.
+
+    Encodings that depend on the layout of the nodes, such as FlatParseTree,
+    store it to reject encodings written with other node definitions.
+    """
+    schema = []
+    for node in self.nodes:
+      schema.append('{}:{}:{}:{}:{}'.format(node['name'], node['parent'],
+                                            node['is_abstract'],
+                                            node['node_kind'],
+                                            node['gen_init_fields']))
+      for field in node['fields']:
+        schema.append(' {}:{}:{}:{}'.format(field['name'], field['ctype'],
+                                            field['member_type'],
+                                            field['field_loader']))
+      for init_field in node.get('init_fields', []):
+        schema.append(' init:{}'.format(init_field.member_name))
+    digest = hashlib.sha256('\n'.join(schema).encode('utf-8')).digest()
+    return '0x' + digest[:4].hex()
+
   def Generate(
       self,
       output_path,
@@ -683,6 +726,7 @@ class TreeGenerator(object):
     context = {
         'nodes': self.nodes,
         'root_child_nodes': self.root_child_nodes,
+        'schema_hash': self._ComputeSchemaHash(),
         # For when we need to force a blank line and jinja wants to
         # eat blank lines from the template.
         'blank_line': '\n'
@@ -912,7 +956,7 @@ def main(argv):
       extra_public_defs="""
   // image() references data with the same lifetime as this ASTLeaf object.
   absl::string_view image() const { return image_; }
-  void set_image(std::string image) { image_ = std::move(image); }
+  void set_image(absl::string_view image) { image_ = CopyToArena(image); }
 
   bool IsLeaf() const override { return true; }
       """,
@@ -1248,16 +1292,19 @@ def main(argv):
       fields=[
           Field(
               'string_value',
-              SCALAR_STRING,
+              SCALAR_POOLED_STRING,
               tag_id=2,
               gen_setters_and_getters=False),
       ],
       extra_public_defs="""
   // The parsed and validated value of this literal. The raw input value can be
   // found in image().
-  const std::string& string_value() const { return string_value_; }
-  void set_string_value(std::string string_value) {
-    string_value_ = std::move(string_value);
+  const std::string& string_value() const { return *string_value_; }
+  absl::string_view string_value_view() const { return *string_value_; }
+  // 'string_value' is not owned and must outlive this node. It normally
+  // comes from IdStringPool::MakeStdString() on the pool of the parse tree.
+  void set_string_value(const std::string* string_value) {
+    string_value_ = string_value;
   }
        """
       )
@@ -1527,14 +1574,15 @@ def main(argv):
     // The node where the error occurs.
     const ASTNode* error_node;
 
-    std::string message;
+    absl::string_view message;
   };
 
   const ParseError* parse_error() const {
-    return parse_error_.get();
+    return parse_error_;
   }
-  void set_parse_error(std::unique_ptr<ParseError> parse_error) {
-    parse_error_ = std::move(parse_error);
+  void set_parse_error(const ASTNode* error_node, absl::string_view message) {
+    parse_error_ = zetasql_base::NewInArena<ParseError>(
+        arena(), ParseError{error_node, CopyToArena(message)});
   }
 
   // The join type and hint strings
@@ -1542,7 +1590,7 @@ def main(argv):
   std::string GetSQLForJoinHint() const;
        """,
       extra_private_defs="""
-  std::unique_ptr<ParseError> parse_error_ = nullptr;
+  const ParseError* parse_error_ = nullptr;
        """
       )
 
@@ -2101,16 +2149,23 @@ def main(argv):
       name='ASTBytesLiteral',
       tag_id=55,
       parent='ASTLeaf',
+      fields=[
+          Field(
+              'bytes_value',
+              SCALAR_POOLED_STRING,
+              tag_id=2,
+              gen_setters_and_getters=False),
+      ],
       extra_public_defs="""
   // The parsed and validated value of this literal. The raw input value can be
   // found in image().
-  const std::string& bytes_value() const { return bytes_value_; }
-  void set_bytes_value(std::string bytes_value) {
-    bytes_value_ = std::move(bytes_value);
+  const std::string& bytes_value() const { return *bytes_value_; }
+  absl::string_view bytes_value_view() const { return *bytes_value_; }
+  // 'bytes_value' is not owned and must outlive this node. It normally
+  // comes from IdStringPool::MakeStdString() on the pool of the parse tree.
+  void set_bytes_value(const std::string* bytes_value) {
+    bytes_value_ = bytes_value;
   }
-      """,
-      extra_private_defs="""
-  std::string bytes_value_;
       """)
 
   gen.AddNode(
@@ -463,7 +463,7 @@ ASTNode* JoinRuleAction(
                        clause_list->child(unmatched_join_count);
     std::string message =
         parse_error != nullptr ?
-        parse_error->message :
+        std::string(parse_error->message) :
         absl::StrCat(
             "The number of join conditions is ", clause_count,
             " but the number of joins that require a join condition is "
@@ -480,8 +480,7 @@ ASTNode* JoinRuleAction(
     } else {
       // Does not throw the error to maintain the backward compatibility. Saves
       // the error instead.
-      join->set_parse_error(std::make_unique<ASTJoin::ParseError>(
-          ASTJoin::ParseError{error_node, message}));
+      join->set_parse_error(error_node, message);
     }
   }
 
@@ -407,24 +407,59 @@ static const absl::flat_hash_map<ASTNodeKind, std::string>& GetNodeNamesMap() {
   return map;
 }
 
-ASTNode::~ASTNode() {}
+void ASTNode::ReserveChildren(int capacity) {
+  if (capacity <= children_capacity_) return;
+  ZETASQL_DCHECK(arena_ != nullptr)
+      << "Only ASTNodes from Create() can have children";
+  // The old array is left in the arena, which only frees memory as a whole.
+  ASTNode** children = zetasql_base::NewInArena<ASTNode*[]>(arena_, capacity);
+  std::copy(children_, children_ + num_children_, children);
+  children_ = children;
+  children_capacity_ = capacity;
+}
+
+absl::string_view ASTNode::CopyToArena(absl::string_view str) {
+  ZETASQL_DCHECK(arena_ != nullptr)
+      << "Only ASTNodes from Create() can have strings";
+  if (str.empty()) return absl::string_view();
+  return absl::string_view(arena_->Memdup(str.data(), str.size()), str.size());
+}
+
+const std::string& ASTNode::EmptyString() {
+  static const std::string* const kEmptyString = new std::string;
+  return *kEmptyString;
+}
 
 void ASTNode::AddChild(ASTNode* child) {
   ZETASQL_DCHECK(child != nullptr);
-  children_.push_back(child);
+  if (num_children_ == children_capacity_) {
+    ReserveChildren(std::max(2 * children_capacity_, 2));
+  }
+  children_[num_children_++] = child;
   child->set_parent(this);
 }
 
 void ASTNode::AddChildFront(ASTNode* child) {
   ZETASQL_DCHECK(child != nullptr);
-  children_.insert(children_.begin(), child);
+  if (num_children_ == children_capacity_) {
+    ReserveChildren(std::max(2 * children_capacity_, 2));
+  }
+  std::copy_backward(children_, children_ + num_children_,
+                     children_ + num_children_ + 1);
+  children_[0] = child;
+  ++num_children_;
   child->set_parent(this);
 }
 
 void ASTNode::AddChildren(absl::Span<ASTNode* const> children) {
+  int num_new_children = 0;
+  for (ASTNode* child : children) {
+    if (child != nullptr) ++num_new_children;
+  }
+  ReserveChildren(num_children_ + num_new_children);
   for (ASTNode* child : children) {
     if (child != nullptr) {
-      children_.push_back(child);
+      children_[num_children_++] = child;
       child->set_parent(this);
     }
   }
@@ -474,7 +509,7 @@ void ASTNode::Accept(ParseTreeVisitor* visitor, void* data) const {
 }
 
 void ASTNode::ChildrenAccept(ParseTreeVisitor* visitor, void* data) const {
-  for (int i = 0; i < children_.size(); ++i) {
+  for (int i = 0; i < num_children_; ++i) {
     children_[i]->Accept(visitor, data);
   }
 }
@@ -538,7 +573,8 @@ void ASTNode::Dumper::Dump() {
     return;
   }
   ++current_depth_;
-  const auto& children = node_->children_;
+  const absl::Span<ASTNode* const> children(node_->children_,
+                                            node_->num_children_);
   for (ASTNode* n : children) {
     if (n != nullptr) {
       node_ = n;
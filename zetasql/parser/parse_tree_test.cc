@@ -282,6 +282,48 @@ TEST(ParseTreeTest, NodeKindCategories_LiteralExpression) {
   EXPECT_FALSE(expr->IsTableExpression());
 }
 
+TEST(ParseTreeTest, ParseTreeOutlivesInput) {
+  // The parse tree, including its child arrays and literal values, is
+  // allocated in the parser arena and must not reference 'sql'.
+  std::string sql = "SELECT 'abc', b'xyz'";
+  for (int i = 0; i < 100; ++i) {
+    absl::StrAppend(&sql, ", col", i);
+  }
+
+  std::unique_ptr<ParserOutput> parser_output;
+  ZETASQL_ASSERT_OK(ParseStatement(sql, ParserOptions(), &parser_output));
+  sql.assign(sql.size(), ' ');
+
+  const ASTQueryStatement* statement =
+      parser_output->statement()->GetAsOrDie<ASTQueryStatement>();
+  const ASTSelectList* select_list =
+      statement->query()->query_expr()->GetAsOrDie<ASTSelect>()->select_list();
+  ASSERT_EQ(select_list->columns().size(), 102);
+  EXPECT_EQ(select_list->columns(0)
+                ->expression()
+                ->GetAsOrDie<ASTStringLiteral>()
+                ->string_value(),
+            "abc");
+  EXPECT_EQ(select_list->columns(1)
+                ->expression()
+                ->GetAsOrDie<ASTBytesLiteral>()
+                ->bytes_value(),
+            "xyz");
+  EXPECT_EQ(select_list->columns(1)
+                ->expression()
+                ->GetAsOrDie<ASTBytesLiteral>()
+                ->bytes_value_view(),
+            "xyz");
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(select_list->columns(i + 2)
+                  ->expression()
+                  ->GetAsOrDie<ASTPathExpression>()
+                  ->last_name()
+                  ->GetAsString(),
+              absl::StrCat("col", i));
+  }
+}
+
 TEST(ParseTreeTest, GetDescendantsWithKinds) {
   const std::string sql =
       "select * from (select 1+0x2, x+y), "
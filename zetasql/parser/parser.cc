@@ -18,7 +18,9 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "zetasql/base/arena_pool.h"
 #include "zetasql/base/logging.h"
 #include "zetasql/common/errors.h"
 #include "zetasql/parser/bison_parser.h"
@@ -53,7 +55,7 @@ ParserOptions::ParserOptions(std::shared_ptr<IdStringPool> id_string_pool,
 }
 
 ParserOptions::ParserOptions(LanguageOptions language_options)
-    : arena_(std::make_shared<zetasql_base::UnsafeArena>(/*block_size=*/4096)),
+    : arena_(zetasql_base::ArenaPool::GetDefault().GetArena()),
       id_string_pool_(std::make_shared<IdStringPool>(arena_)),
       language_options_(std::move(language_options)) {}
 
@@ -68,7 +70,7 @@ ParserOptions::~ParserOptions() {}
 
 void ParserOptions::CreateDefaultArenasIfNotSet() {
   if (arena_ == nullptr) {
-    arena_ = std::make_shared<zetasql_base::UnsafeArena>(/*block_size=*/4096);
+    arena_ = zetasql_base::ArenaPool::GetDefault().GetArena();
   }
   if (id_string_pool_ == nullptr) {
     id_string_pool_ = std::make_shared<IdStringPool>(arena_);
@@ -78,14 +80,10 @@ void ParserOptions::CreateDefaultArenasIfNotSet() {
 ParserOutput::ParserOutput(
     std::shared_ptr<IdStringPool> id_string_pool,
     std::shared_ptr<zetasql_base::UnsafeArena> arena,
-    std::vector<std::unique_ptr<ASTNode>> other_allocated_ast_nodes,
-    absl::variant<std::unique_ptr<ASTStatement>, std::unique_ptr<ASTScript>,
-                  std::unique_ptr<ASTType>, std::unique_ptr<ASTExpression>>
-        node)
+    absl::variant<ASTStatement*, ASTScript*, ASTType*, ASTExpression*> node)
     : id_string_pool_(std::move(id_string_pool)),
       arena_(std::move(arena)),
-      other_allocated_ast_nodes_(std::move(other_allocated_ast_nodes)),
-      node_(std::move(node)) {}
+      node_(node) {}
 
 ParserOutput::~ParserOutput() {}
 
@@ -100,23 +98,25 @@ absl::Status ParseStatement(absl::string_view statement_string,
   // messages from the parser change depending on whether a "next" statement is
   // expected to occur or not.
   BisonParser parser;
-  std::unique_ptr<ASTNode> ast_node;
-  std::vector<std::unique_ptr<ASTNode>> other_allocated_ast_nodes;
+  std::vector<const ASTNode*> collected_nodes;
+  parser.CollectNodes(parser_options.node_kinds_to_collect(),
+                      &collected_nodes);
+  ASTNode* ast_node = nullptr;
   absl::Status status = parser.Parse(
       BisonParserMode::kStatement, /*filename=*/absl::string_view(),
       statement_string, /*start_byte_offset=*/0,
       parser_options.id_string_pool().get(), parser_options.arena().get(),
-      parser_options.language_options(), &ast_node, &other_allocated_ast_nodes,
+      parser_options.language_options(), &ast_node,
       /*ast_statement_properties=*/nullptr,
       /*statement_end_byte_offset=*/nullptr);
   ZETASQL_RETURN_IF_ERROR(
       ConvertInternalErrorLocationToExternal(status, statement_string));
   ZETASQL_RET_CHECK(ast_node != nullptr);
-  std::unique_ptr<ASTStatement> statement(
-      ast_node.release()->GetAsOrDie<ASTStatement>());
+  ASTStatement* statement = ast_node->GetAsOrDie<ASTStatement>();
   *output = std::make_unique<ParserOutput>(
       parser_options.id_string_pool(), parser_options.arena(),
-      std::move(other_allocated_ast_nodes), std::move(statement));
+      statement);
+  (*output)->set_collected_nodes(std::move(collected_nodes));
   return absl::OkStatus();
 }
 
@@ -128,26 +128,29 @@ absl::Status ParseScript(absl::string_view script_string,
   parser_options.CreateDefaultArenasIfNotSet();
 
   BisonParser parser;
-  std::unique_ptr<ASTNode> ast_node;
-  std::vector<std::unique_ptr<ASTNode>> other_allocated_ast_nodes;
+  std::vector<const ASTNode*> collected_nodes;
+  parser.CollectNodes(parser_options.node_kinds_to_collect(),
+                      &collected_nodes);
+  ASTNode* ast_node = nullptr;
   absl::Status status = parser.Parse(
       BisonParserMode::kScript, /*filename=*/absl::string_view(), script_string,
       /*start_byte_offset=*/0, parser_options.id_string_pool().get(),
       parser_options.arena().get(), parser_options.language_options(),
-      &ast_node, &other_allocated_ast_nodes,
+      &ast_node,
       /*ast_statement_properties=*/nullptr,
       /*statement_end_byte_offset=*/nullptr);
 
-  std::unique_ptr<ASTScript> script;
+  ASTScript* script = nullptr;
   if (status.ok()) {
     ZETASQL_RET_CHECK_EQ(ast_node->node_kind(), AST_SCRIPT);
-    script = absl::WrapUnique(ast_node.release()->GetAsOrDie<ASTScript>());
+    script = ast_node->GetAsOrDie<ASTScript>();
   }
   ZETASQL_RETURN_IF_ERROR(ConvertInternalErrorLocationAndAdjustErrorString(
       error_message_mode, script_string, status));
   *output = std::make_unique<ParserOutput>(
       parser_options.id_string_pool(), parser_options.arena(),
-      std::move(other_allocated_ast_nodes), std::move(script));
+      script);
+  (*output)->set_collected_nodes(std::move(collected_nodes));
   return absl::OkStatus();
 }
 
@@ -165,8 +168,10 @@ absl::Status ParseNextStatementInternal(ParseResumeLocation* resume_location,
   ZETASQL_RETURN_IF_ERROR(resume_location->Validate());
 
   parser::BisonParser parser;
-  std::unique_ptr<ASTNode> ast_node;
-  std::vector<std::unique_ptr<ASTNode>> other_allocated_ast_nodes;
+  std::vector<const ASTNode*> collected_nodes;
+  parser.CollectNodes(parser_options.node_kinds_to_collect(),
+                      &collected_nodes);
+  ASTNode* ast_node = nullptr;
 
   int next_statement_byte_offset = 0;
 
@@ -174,7 +179,7 @@ absl::Status ParseNextStatementInternal(ParseResumeLocation* resume_location,
       mode, resume_location->filename(), resume_location->input(),
       resume_location->byte_position(), parser_options.id_string_pool().get(),
       parser_options.arena().get(), parser_options.language_options(),
-      &ast_node, &other_allocated_ast_nodes,
+      &ast_node,
       /*ast_statement_properties=*/nullptr, &next_statement_byte_offset);
   ZETASQL_RETURN_IF_ERROR(
       ConvertInternalErrorLocationToExternal(status, resume_location->input()));
@@ -188,13 +193,13 @@ absl::Status ParseNextStatementInternal(ParseResumeLocation* resume_location,
   }
   ZETASQL_RET_CHECK(ast_node != nullptr);
   ZETASQL_RET_CHECK(ast_node->IsStatement());
-  std::unique_ptr<ASTStatement> statement(
-      ast_node.release()->GetAsOrDie<ASTStatement>());
+  ASTStatement* statement = ast_node->GetAsOrDie<ASTStatement>();
   resume_location->set_byte_position(next_statement_byte_offset);
 
   *output = std::make_unique<ParserOutput>(
       parser_options.id_string_pool(), parser_options.arena(),
-      std::move(other_allocated_ast_nodes), std::move(statement));
+      statement);
+  (*output)->set_collected_nodes(std::move(collected_nodes));
   return absl::OkStatus();
 }
 }  // namespace
@@ -224,23 +229,22 @@ absl::Status ParseType(absl::string_view type_string,
   parser_options.CreateDefaultArenasIfNotSet();
 
   parser::BisonParser parser;
-  std::unique_ptr<ASTNode> ast_node;
-  std::vector<std::unique_ptr<ASTNode>> other_allocated_ast_nodes;
+  ASTNode* ast_node = nullptr;
   absl::Status status = parser.Parse(
       BisonParserMode::kType, /* filename = */ absl::string_view(), type_string,
       0 /* offset */, parser_options.id_string_pool().get(),
       parser_options.arena().get(), parser_options.language_options(),
-      &ast_node, &other_allocated_ast_nodes,
+      &ast_node,
       /*ast_statement_properties=*/nullptr,
       /*statement_end_byte_offset=*/nullptr);
   ZETASQL_RETURN_IF_ERROR(ConvertInternalErrorLocationToExternal(status, type_string));
   ZETASQL_RET_CHECK(ast_node != nullptr);
   ZETASQL_RET_CHECK(ast_node->IsType());
-  std::unique_ptr<ASTType> type(ast_node.release()->GetAsOrDie<ASTType>());
+  ASTType* type = ast_node->GetAsOrDie<ASTType>();
 
   *output = std::make_unique<ParserOutput>(
       parser_options.id_string_pool(), parser_options.arena(),
-      std::move(other_allocated_ast_nodes), std::move(type));
+      type);
   return absl::OkStatus();
 }
 
@@ -251,24 +255,22 @@ absl::Status ParseExpression(absl::string_view expression_string,
   parser_options.CreateDefaultArenasIfNotSet();
 
   parser::BisonParser parser;
-  std::unique_ptr<ASTNode> ast_node;
-  std::vector<std::unique_ptr<ASTNode>> other_allocated_ast_nodes;
+  ASTNode* ast_node = nullptr;
   absl::Status status = parser.Parse(
       BisonParserMode::kExpression, /* filename = */ absl::string_view(),
       expression_string, 0 /* offset */, parser_options.id_string_pool().get(),
       parser_options.arena().get(), parser_options.language_options(),
-      &ast_node, &other_allocated_ast_nodes,
+      &ast_node,
       /*ast_statement_properties=*/nullptr,
       /*statement_end_byte_offset=*/nullptr);
   ZETASQL_RETURN_IF_ERROR(
       ConvertInternalErrorLocationToExternal(status, expression_string));
   ZETASQL_RET_CHECK(ast_node != nullptr);
   ZETASQL_RET_CHECK(ast_node->IsExpression());
-  std::unique_ptr<ASTExpression> expression(
-      ast_node.release()->GetAsOrDie<ASTExpression>());
+  ASTExpression* expression = ast_node->GetAsOrDie<ASTExpression>();
   *output = std::make_unique<ParserOutput>(
       parser_options.id_string_pool(), parser_options.arena(),
-      std::move(other_allocated_ast_nodes), std::move(expression));
+      expression);
   return absl::OkStatus();
 }
 
@@ -279,23 +281,21 @@ absl::Status ParseExpression(const ParseResumeLocation& resume_location,
   parser_options.CreateDefaultArenasIfNotSet();
 
   parser::BisonParser parser;
-  std::unique_ptr<ASTNode> ast_node;
-  std::vector<std::unique_ptr<ASTNode>> other_allocated_ast_nodes;
+  ASTNode* ast_node = nullptr;
   absl::Status status = parser.Parse(
       BisonParserMode::kExpression, resume_location.filename(),
       resume_location.input(), resume_location.byte_position(),
       parser_options.id_string_pool().get(), parser_options.arena().get(),
-      parser_options.language_options(), &ast_node, &other_allocated_ast_nodes,
+      parser_options.language_options(), &ast_node,
       /*ast_statement_properties=*/nullptr,
       /*statement_end_byte_offset=*/nullptr);
   ZETASQL_RETURN_IF_ERROR(
       ConvertInternalErrorLocationToExternal(status, resume_location.input()));
   ZETASQL_RET_CHECK(ast_node != nullptr);
-  std::unique_ptr<ASTExpression> expression(
-      ast_node.release()->GetAsOrDie<ASTExpression>());
+  ASTExpression* expression = ast_node->GetAsOrDie<ASTExpression>();
   *output = std::make_unique<ParserOutput>(
       parser_options.id_string_pool(), parser_options.arena(),
-      std::move(other_allocated_ast_nodes), std::move(expression));
+      expression);
   return absl::OkStatus();
 }
 
@@ -314,13 +314,12 @@ ASTNodeKind ParseNextStatementKind(const ParseResumeLocation& resume_location,
   parser::BisonParser parser;
   IdStringPool id_string_pool;
   zetasql_base::UnsafeArena arena(/*block_size=*/1024);
-  std::vector<std::unique_ptr<ASTNode>> other_allocated_ast_nodes;
   parser::ASTStatementProperties ast_statement_properties;
   parser
       .Parse(BisonParserMode::kNextStatementKind, resume_location.filename(),
              resume_location.input(), resume_location.byte_position(),
              &id_string_pool, &arena, language_options, /*output=*/nullptr,
-             &other_allocated_ast_nodes, &ast_statement_properties,
+             &ast_statement_properties,
              /*statement_end_byte_offset=*/nullptr)
       .IgnoreError();
   *next_statement_is_ctas = ast_statement_properties.is_create_table_as_select;
@@ -330,7 +329,6 @@ ASTNodeKind ParseNextStatementKind(const ParseResumeLocation& resume_location,
 absl::Status ParseNextStatementProperties(
     const ParseResumeLocation& resume_location,
     const ParserOptions& parser_options,
-    std::vector<std::unique_ptr<ASTNode>>* allocated_ast_nodes,
     parser::ASTStatementProperties* ast_statement_properties) {
   ZETASQL_RETURN_IF_ERROR(resume_location.Validate());
   ZETASQL_RET_CHECK(parser_options.AllArenasAreInitialized());
@@ -346,8 +344,8 @@ absl::Status ParseNextStatementProperties(
       resume_location.input(), resume_location.byte_position(),
       parser_options.id_string_pool().get(),
       parser_options.arena().get(), parser_options.language_options(),
-      /*output=*/nullptr, allocated_ast_nodes,
-      ast_statement_properties, /*statement_end_byte_offset=*/nullptr)
+      /*output=*/nullptr, ast_statement_properties,
+      /*statement_end_byte_offset=*/nullptr)
           .IgnoreError();
   return absl::OkStatus();
 }
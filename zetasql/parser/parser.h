@@ -81,7 +81,9 @@ class ParserOptions {
   }
   std::shared_ptr<zetasql_base::UnsafeArena> arena() const { return arena_; }
 
-  // Creates a default-sized id_string_pool() and arena().
+  // Creates a default-sized id_string_pool() and arena(). The arena comes from
+  // zetasql_base::ArenaPool::GetDefault(), which recycles it once these options
+  // and the outputs of parsing with them are destroyed.
   // WARNING: After calling this, calling Parse functions concurrently with
   // the same ParserOptions is no longer allowed.
   void CreateDefaultArenasIfNotSet();
@@ -108,6 +110,17 @@ class ParserOptions {
 
   const LanguageOptions& language_options() const { return language_options_; }
 
+  // Makes ParseStatement(), ParseNextStatement() and ParseScript() return the
+  // nodes of these kinds in ParserOutput::collected_nodes(). The parser
+  // records them as it creates them, which is cheaper than searching the
+  // tree afterwards with GetDescendantSubtreesWithKinds().
+  void set_node_kinds_to_collect(std::vector<ASTNodeKind> node_kinds) {
+    node_kinds_to_collect_ = std::move(node_kinds);
+  }
+  const std::vector<ASTNodeKind>& node_kinds_to_collect() const {
+    return node_kinds_to_collect_;
+  }
+
  private:
   // Allocate all AST nodes in this arena.
   // The arena will also be referenced in ParserOutput to keep it alive.
@@ -118,6 +131,8 @@ class ParserOptions {
   std::shared_ptr<IdStringPool> id_string_pool_;
 
   LanguageOptions language_options_;
+
+  std::vector<ASTNodeKind> node_kinds_to_collect_;
 };
 
 // Output of a parse operation. The output parse tree can be accessed via
@@ -125,13 +140,12 @@ class ParserOptions {
 // was called.
 class ParserOutput {
  public:
-  ParserOutput(
-      std::shared_ptr<IdStringPool> id_string_pool,
-      std::shared_ptr<zetasql_base::UnsafeArena> arena,
-      std::vector<std::unique_ptr<ASTNode>> other_allocated_ast_nodes,
-      absl::variant<std::unique_ptr<ASTStatement>, std::unique_ptr<ASTScript>,
-                    std::unique_ptr<ASTType>, std::unique_ptr<ASTExpression>>
-          node);
+  // 'node' and the rest of its parse tree are allocated in 'arena'.
+  ParserOutput(std::shared_ptr<IdStringPool> id_string_pool,
+               std::shared_ptr<zetasql_base::UnsafeArena> arena,
+               absl::variant<ASTStatement*, ASTScript*, ASTType*,
+                             ASTExpression*>
+                   node);
   ParserOutput(const ParserOutput&) = delete;
   ParserOutput& operator=(const ParserOutput&) = delete;
   ~ParserOutput();
@@ -144,16 +158,16 @@ class ParserOutput {
   const ASTExpression* expression() const { return GetNodeAs<ASTExpression>(); }
 
   const ASTNode* node() const {
-    if (std::holds_alternative<std::unique_ptr<ASTStatement>>(node_)) {
+    if (std::holds_alternative<ASTStatement*>(node_)) {
       return statement();
     }
-    if (std::holds_alternative<std::unique_ptr<ASTScript>>(node_)) {
+    if (std::holds_alternative<ASTScript*>(node_)) {
       return script();
     }
-    if (std::holds_alternative<std::unique_ptr<ASTType>>(node_)) {
+    if (std::holds_alternative<ASTType*>(node_)) {
       return type();
     }
-    if (std::holds_alternative<std::unique_ptr<ASTExpression>>(node_)) {
+    if (std::holds_alternative<ASTExpression*>(node_)) {
       return expression();
     }
     return nullptr;
@@ -169,24 +183,32 @@ class ParserOutput {
   // ParserOptions.
   const std::shared_ptr<zetasql_base::UnsafeArena>& arena() const { return arena_; }
 
+  // Returns the nodes of the kinds given by
+  // ParserOptions::node_kinds_to_collect(), in the order the parser created
+  // them. This can include nodes that the parser created and then did not
+  // attach to the returned tree.
+  const std::vector<const ASTNode*>& collected_nodes() const {
+    return collected_nodes_;
+  }
+  void set_collected_nodes(std::vector<const ASTNode*> collected_nodes) {
+    collected_nodes_ = std::move(collected_nodes);
+  }
+
  private:
   template<class T>
       T* GetNodeAs() const {
-    return std::get<std::unique_ptr<T>>(node_).get();
+    return std::get<T*>(node_);
   }
 
-  // This IdStringPool and arena must be kept alive for the parse trees below to
-  // be valid. Careful: do not reorder these members to go after the ASTNodes
-  // below, because the destruction order is relevant!
+  // This IdStringPool and arena must be kept alive for the parse tree below to
+  // be valid. The ASTNodes of the tree are never destroyed, so releasing the
+  // arena is all it takes to free them.
   std::shared_ptr<IdStringPool> id_string_pool_;
   std::shared_ptr<zetasql_base::UnsafeArena> arena_;
 
-  // This vector owns the non-root nodes in the AST.
-  std::vector<std::unique_ptr<ASTNode>> other_allocated_ast_nodes_;
+  absl::variant<ASTStatement*, ASTScript*, ASTType*, ASTExpression*> node_;
 
-  absl::variant<std::unique_ptr<ASTStatement>, std::unique_ptr<ASTScript>,
-                std::unique_ptr<ASTType>, std::unique_ptr<ASTExpression>>
-      node_;
+  std::vector<const ASTNode*> collected_nodes_;
 };
 
 // Parses <statement_string> and returns the parser output in <output> upon
@@ -318,7 +340,6 @@ ASTNodeKind ParseNextStatementKind(const ParseResumeLocation& resume_location,
 absl::Status ParseNextStatementProperties(
     const ParseResumeLocation& resume_location,
     const ParserOptions& parser_options,
-    std::vector<std::unique_ptr<ASTNode>>* allocated_ast_nodes,
     parser::ASTStatementProperties* ast_statement_properties);
 
 }  // namespace zetasql
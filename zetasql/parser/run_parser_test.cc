@@ -314,10 +314,9 @@ class RunParserTest : public ::testing::Test {
     parser::ASTStatementProperties ast_statement_properties;
     ParserOptions parser_options = GetParserOptions();
     parser_options.CreateDefaultArenasIfNotSet();
-    std::vector<std::unique_ptr<ASTNode>> allocated_ast_nodes;
     ZETASQL_ASSERT_OK(ParseNextStatementProperties(
         ParseResumeLocation::FromStringView(test_case), parser_options,
-        &allocated_ast_nodes, &ast_statement_properties));
+        &ast_statement_properties));
 
     // The statement kinds fetched from ParseStatementKind() and
     // ParseNextStatementProperties() should match.
@@ -354,10 +353,8 @@ class RunParserTest : public ::testing::Test {
       parser::ASTStatementProperties ast_statement_properties;
       ParserOptions parser_options = GetParserOptions();
       parser_options.CreateDefaultArenasIfNotSet();
-      std::vector<std::unique_ptr<ASTNode>> allocated_ast_nodes;
       ZETASQL_ASSERT_OK(ParseNextStatementProperties(
-          location, parser_options, &allocated_ast_nodes,
-          &ast_statement_properties));
+          location, parser_options, &ast_statement_properties));
 
       // The statement kinds fetched from ParseNextStatementKind() and
       // ParseNextStatementProperties() should match.
@@ -18,6 +18,7 @@
 
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <thread>
 #include <string>
 #include <type_traits>
@@ -27,8 +28,11 @@
 #include "zetasql/base/logging.h"
 #include "zetasql/analyzer/all_rewriters.h"
 #include "zetasql/analyzer/analyzer_impl.h"
+#include "zetasql/analyzer/analyzer_output_mutator.h"
 #include "zetasql/analyzer/anonymization_rewriter.h"
+#include "zetasql/analyzer/find_counting_catalog.h"
 #include "zetasql/analyzer/function_resolver.h"
+#include "zetasql/analyzer/resolved_ast_validation.h"
 #include "zetasql/analyzer/resolver.h"
 #include "zetasql/analyzer/rewrite_resolved_ast.h"
 #include "zetasql/common/errors.h"
@@ -36,6 +40,7 @@
 #include "zetasql/parser/parse_tree_errors.h"
 #include "zetasql/parser/parser.h"
 #include "zetasql/public/analyzer_options.h"
+#include "zetasql/public/analyzer_runtime_info.h"
 #include "zetasql/public/options.pb.h"
 #include "zetasql/public/parse_helpers.h"
 #include "zetasql/public/parse_resume_location.h"
@@ -43,7 +48,6 @@
 #include "zetasql/public/type.h"
 #include "zetasql/public/type.pb.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
-#include "zetasql/resolved_ast/validator.h"
 #include "absl/base/attributes.h"
 #include "absl/flags/flag.h"
 #include "absl/memory/memory.h"
@@ -85,19 +89,29 @@ void EnsureResolutionTimeInfoForEveryTable(
 static absl::Status FinishAnalyzeStatementImpl(
     absl::string_view sql, const ASTStatement& ast_statement,
     Resolver* resolver, const AnalyzerOptions& options, Catalog* catalog,
-    TypeFactory* type_factory,
+    TypeFactory* type_factory, AnalyzerRuntimeInfo* runtime_info,
     std::unique_ptr<const ResolvedStatement>* resolved_statement) {
   ZETASQL_VLOG(5) << "Parsed AST:\n" << ast_statement.DebugString();
 
-  ZETASQL_RETURN_IF_ERROR(
-      resolver->ResolveStatement(sql, &ast_statement, resolved_statement));
+  {
+    ScopedAnalyzerPhaseTimer timer(
+        runtime_info == nullptr ? nullptr : &runtime_info->resolver,
+        options.arena().get());
+    ZETASQL_RETURN_IF_ERROR(
+        resolver->ResolveStatement(sql, &ast_statement, resolved_statement));
+  }
 
   ZETASQL_VLOG(3) << "Resolved AST:\n" << (*resolved_statement)->DebugString();
 
-  if (absl::GetFlag(FLAGS_zetasql_validate_resolved_ast)) {
-    Validator validator(options.language());
-    ZETASQL_RETURN_IF_ERROR(
-        validator.ValidateResolvedStatement(resolved_statement->get()));
+  {
+    ScopedAnalyzerPhaseTimer timer(
+        runtime_info == nullptr ? nullptr : &runtime_info->validator,
+        options.arena().get());
+    ZETASQL_RETURN_IF_ERROR(MaybeValidateResolvedStatement(
+        options,
+        ShouldValidateAnalysis(
+            options, absl::GetFlag(FLAGS_zetasql_validate_resolved_ast)),
+        resolved_statement->get()));
   }
 
   if (absl::GetFlag(FLAGS_zetasql_print_resolved_ast)) {
@@ -133,6 +147,20 @@ static absl::Status UnsupportedStatementErrorOrStatus(
   return status;
 }
 
+static absl::Status AnalyzeStatementFromParserOutputImpl(
+    std::unique_ptr<ParserOutput>* statement_parser_output,
+    bool take_ownership_on_success, const AnalyzerOptions& options,
+    absl::string_view sql, Catalog* catalog, TypeFactory* type_factory,
+    std::unique_ptr<AnalyzerRuntimeInfo> runtime_info,
+    std::unique_ptr<const AnalyzerOutput>* output);
+
+// Returns a new AnalyzerRuntimeInfo if <options> asks for one, or null.
+static std::unique_ptr<AnalyzerRuntimeInfo> MaybeCreateRuntimeInfo(
+    const AnalyzerOptions& options) {
+  if (!options.collect_runtime_info()) return nullptr;
+  return std::make_unique<AnalyzerRuntimeInfo>();
+}
+
 static absl::Status AnalyzeStatementImpl(
     absl::string_view sql, const AnalyzerOptions& options, Catalog* catalog,
     TypeFactory* type_factory, std::unique_ptr<const AnalyzerOutput>* output) {
@@ -141,16 +169,24 @@ static absl::Status AnalyzeStatementImpl(
   ZETASQL_RETURN_IF_ERROR(ValidateAnalyzerOptions(options));
 
   ZETASQL_VLOG(1) << "Parsing statement:\n" << sql;
+  std::unique_ptr<AnalyzerRuntimeInfo> runtime_info =
+      MaybeCreateRuntimeInfo(options);
   std::unique_ptr<ParserOutput> parser_output;
-  const absl::Status status = ParseStatement(
-      sql, options.GetParserOptions(), &parser_output);
+  absl::Status status;
+  {
+    ScopedAnalyzerPhaseTimer timer(
+        runtime_info == nullptr ? nullptr : &runtime_info->parser,
+        options.arena().get());
+    status = ParseStatement(sql, options.GetParserOptions(), &parser_output);
+  }
   if (!status.ok()) {
     return UnsupportedStatementErrorOrStatus(
         status, ParseResumeLocation::FromStringView(sql), options);
   }
 
-  return AnalyzeStatementFromParserOutputOwnedOnSuccess(
-      &parser_output, options, sql, catalog, type_factory, output);
+  return AnalyzeStatementFromParserOutputImpl(
+      &parser_output, /*take_ownership_on_success=*/true, options, sql,
+      catalog, type_factory, std::move(runtime_info), output);
 }
 
 absl::Status AnalyzeStatement(absl::string_view sql,
@@ -183,18 +219,26 @@ static absl::Status AnalyzeNextStatementImpl(
             << resume_location->byte_position();
   }
 
+  std::unique_ptr<AnalyzerRuntimeInfo> runtime_info =
+      MaybeCreateRuntimeInfo(options);
   std::unique_ptr<ParserOutput> parser_output;
-  const absl::Status status = ParseNextStatement(
-      resume_location, options.GetParserOptions(), &parser_output,
-      at_end_of_input);
+  absl::Status status;
+  {
+    ScopedAnalyzerPhaseTimer timer(
+        runtime_info == nullptr ? nullptr : &runtime_info->parser,
+        options.arena().get());
+    status = ParseNextStatement(resume_location, options.GetParserOptions(),
+                                &parser_output, at_end_of_input);
+  }
   if (!status.ok()) {
     return UnsupportedStatementErrorOrStatus(status, *resume_location, options);
   }
   ZETASQL_RET_CHECK(parser_output != nullptr);
 
-  return AnalyzeStatementFromParserOutputOwnedOnSuccess(
-      &parser_output, options, resume_location->input(), catalog,
-      type_factory, output);
+  return AnalyzeStatementFromParserOutputImpl(
+      &parser_output, /*take_ownership_on_success=*/true, options,
+      resume_location->input(), catalog, type_factory, std::move(runtime_info),
+      output);
 }
 
 absl::Status AnalyzeNextStatement(
@@ -218,14 +262,21 @@ static absl::Status AnalyzeStatementHelper(
     absl::string_view sql, Catalog* catalog, TypeFactory* type_factory,
     std::unique_ptr<ParserOutput>* statement_parser_output,
     bool take_parser_output_ownership_on_success,
+    std::unique_ptr<AnalyzerRuntimeInfo> runtime_info,
     std::unique_ptr<const AnalyzerOutput>* output) {
   output->reset();
   ZETASQL_RET_CHECK(options.AllArenasAreInitialized());
+  if (runtime_info == nullptr) runtime_info = MaybeCreateRuntimeInfo(options);
+  std::optional<FindCountingCatalog> counting_catalog;
+  if (runtime_info != nullptr) {
+    counting_catalog.emplace(catalog);
+    catalog = &*counting_catalog;
+  }
   std::unique_ptr<const ResolvedStatement> resolved_statement;
   Resolver resolver(catalog, type_factory, &options);
-  const absl::Status status =
-      FinishAnalyzeStatementImpl(sql, ast_statement, &resolver, options,
-                                 catalog, type_factory, &resolved_statement);
+  const absl::Status status = FinishAnalyzeStatementImpl(
+      sql, ast_statement, &resolver, options, catalog, type_factory,
+      runtime_info.get(), &resolved_statement);
   if (!status.ok()) {
     return ConvertInternalErrorLocationAndAdjustErrorString(
         options.error_message_mode(), sql, status);
@@ -243,8 +294,17 @@ static absl::Status AnalyzeStatementHelper(
           options.error_message_mode(), sql, resolver.deprecation_warnings()),
       resolver.undeclared_parameters(),
       resolver.undeclared_positional_parameters(), resolver.max_column_id());
-  ZETASQL_RETURN_IF_ERROR(RewriteResolvedAst(options, sql, catalog, type_factory,
-                                     *original_output));
+  AnalyzerOutputMutator output_mutator(original_output.get());
+  output_mutator.set_runtime_info(std::move(runtime_info));
+  // <original_output> is discarded on error, so rewriters can take its tree.
+  RegisterBuiltinRewriters();
+  ZETASQL_RETURN_IF_ERROR(InternalRewriteResolvedAst(
+      options, sql, catalog, type_factory, *original_output,
+      /*keep_output_on_error=*/false));
+  if (counting_catalog.has_value()) {
+    output_mutator.mutable_runtime_info()->catalog_find_calls =
+        counting_catalog->num_find_calls();
+  }
   *output = std::move(original_output);
   return absl::OkStatus();
 }
@@ -253,6 +313,7 @@ static absl::Status AnalyzeStatementFromParserOutputImpl(
     std::unique_ptr<ParserOutput>* statement_parser_output,
     bool take_ownership_on_success, const AnalyzerOptions& options,
     absl::string_view sql, Catalog* catalog, TypeFactory* type_factory,
+    std::unique_ptr<AnalyzerRuntimeInfo> runtime_info,
     std::unique_ptr<const AnalyzerOutput>* output) {
   AnalyzerOptions local_options = options;
 
@@ -271,7 +332,8 @@ static absl::Status AnalyzeStatementFromParserOutputImpl(
   const ASTStatement* ast_statement = (*statement_parser_output)->statement();
   return AnalyzeStatementHelper(
       *ast_statement, local_options, sql, catalog, type_factory,
-      statement_parser_output, take_ownership_on_success, output);
+      statement_parser_output, take_ownership_on_success,
+      std::move(runtime_info), output);
 }
 
 absl::Status AnalyzeStatementFromParserOutputOwnedOnSuccess(
@@ -280,7 +342,7 @@ absl::Status AnalyzeStatementFromParserOutputOwnedOnSuccess(
     TypeFactory* type_factory, std::unique_ptr<const AnalyzerOutput>* output) {
   return AnalyzeStatementFromParserOutputImpl(
       statement_parser_output, /*take_ownership_on_success=*/true, options,
-      sql, catalog, type_factory, output);
+      sql, catalog, type_factory, /*runtime_info=*/nullptr, output);
 }
 
 absl::Status AnalyzeStatementFromParserOutputUnowned(
@@ -289,7 +351,7 @@ absl::Status AnalyzeStatementFromParserOutputUnowned(
     TypeFactory* type_factory, std::unique_ptr<const AnalyzerOutput>* output) {
   return AnalyzeStatementFromParserOutputImpl(
       statement_parser_output, /*take_ownership_on_success=*/false, options,
-      sql, catalog, type_factory, output);
+      sql, catalog, type_factory, /*runtime_info=*/nullptr, output);
 }
 
 absl::Status AnalyzeStatementFromParserAST(
@@ -302,7 +364,8 @@ absl::Status AnalyzeStatementFromParserAST(
   return AnalyzeStatementHelper(
       statement, options_with_arenas, sql, catalog, type_factory,
       /*statement_parser_output=*/nullptr,
-      /*take_parser_output_ownership_on_success=*/false, output);
+      /*take_parser_output_ownership_on_success=*/false,
+      /*runtime_info=*/nullptr, output);
 }
 
 absl::Status AnalyzeExpression(absl::string_view sql,
@@ -391,18 +454,27 @@ absl::Status AnalyzeType(const std::string& type_name,
       options.error_message_mode(), type_name, status);
 }
 
+// Returns the ParserOptions for extracting table names, which make the parser
+// collect the ASTQuery nodes for table_name_resolver::FindTablesInParserOutput.
+static ParserOptions GetParserOptionsForTableNames(
+    const AnalyzerOptions& options) {
+  ParserOptions parser_options = options.GetParserOptions();
+  parser_options.set_node_kinds_to_collect({AST_QUERY});
+  return parser_options;
+}
+
 static absl::Status ExtractTableNamesFromStatementImpl(
     absl::string_view sql, const AnalyzerOptions& options,
     TableNamesSet* table_names) {
   ZETASQL_RETURN_IF_ERROR(ValidateAnalyzerOptions(options));
   ZETASQL_VLOG(3) << "Extracting table names from statement:\n" << sql;
   std::unique_ptr<ParserOutput> parser_output;
-  ZETASQL_RETURN_IF_ERROR(
-      ParseStatement(sql, options.GetParserOptions(), &parser_output));
+  ZETASQL_RETURN_IF_ERROR(ParseStatement(
+      sql, GetParserOptionsForTableNames(options), &parser_output));
   ZETASQL_VLOG(5) << "Parsed AST:\n" << parser_output->statement()->DebugString();
 
-  return table_name_resolver::FindTables(sql, *parser_output->statement(),
-                                         options, table_names);
+  return table_name_resolver::FindTablesInParserOutput(sql, *parser_output,
+                                                       options, table_names);
 }
 
 static absl::Status ExtractTableResolutionTimeFromStatementImpl(
@@ -462,13 +534,12 @@ static absl::Status ExtractTableNamesFromNextStatementImpl(
           << resume_location->byte_position();
   std::unique_ptr<ParserOutput> parser_output;
   ZETASQL_RETURN_IF_ERROR(ParseNextStatement(resume_location,
-                                     options.GetParserOptions(), &parser_output,
-                                     at_end_of_input));
+                                     GetParserOptionsForTableNames(options),
+                                     &parser_output, at_end_of_input));
   ZETASQL_VLOG(5) << "Parsed AST:\n" << parser_output->statement()->DebugString();
 
-  return table_name_resolver::FindTables(resume_location->input(),
-                                         *parser_output->statement(),
-                                         options, table_names);
+  return table_name_resolver::FindTablesInParserOutput(
+      resume_location->input(), *parser_output, options, table_names);
 }
 
 absl::Status ExtractTableNamesFromNextStatement(
@@ -536,12 +607,13 @@ absl::Status ExtractTableNamesFromScript(absl::string_view sql,
   std::unique_ptr<AnalyzerOptions> copy;
   const AnalyzerOptions& options = GetOptionsWithArenas(&options_in, &copy);
   std::unique_ptr<ParserOutput> parser_output;
-  ZETASQL_RETURN_IF_ERROR(ParseScript(sql, options.GetParserOptions(),
-                              options.error_message_mode(), &parser_output));
+  ZETASQL_RETURN_IF_ERROR(ParseScript(
+      sql, GetParserOptionsForTableNames(options),
+      options.error_message_mode(), &parser_output));
   ZETASQL_VLOG(5) << "Parsed AST:\n" << parser_output->script()->DebugString();
 
-  absl::Status status = table_name_resolver::FindTableNamesInScript(
-      sql, *(parser_output->script()), options, table_names);
+  absl::Status status = table_name_resolver::FindTablesInParserOutput(
+      sql, *parser_output, options, table_names);
   return ConvertInternalErrorLocationAndAdjustErrorString(
       options.error_message_mode(), sql, status);
 }
@@ -580,9 +652,9 @@ absl::StatusOr<std::unique_ptr<const AnalyzerOutput>> RewriteForAnonymization(
       RewriteForAnonymizationOutput anonymized_output,
       RewriteForAnonymization(*analyzer_output.resolved_statement(), catalog,
                               type_factory, analyzer_options, column_factory));
-  Validator validator(analyzer_options.language());
   ZETASQL_RET_CHECK(anonymized_output.node->Is<ResolvedStatement>());
-  ZETASQL_RETURN_IF_ERROR(validator.ValidateResolvedStatement(
+  ZETASQL_RETURN_IF_ERROR(MaybeValidateResolvedStatement(
+      analyzer_options, ShouldValidateRewriterOutput(analyzer_options),
       anonymized_output.node->GetAs<ResolvedStatement>()));
   AnalyzerOutputProperties analyzer_output_properties_with_map(
       analyzer_output.analyzer_output_properties());
@@ -613,7 +685,8 @@ absl::Status RewriteResolvedAst(const AnalyzerOptions& analyzer_options,
   // would create a dependency cycle.
   RegisterBuiltinRewriters();
   return InternalRewriteResolvedAst(analyzer_options, sql, catalog,
-                                    type_factory, analyzer_output);
+                                    type_factory, analyzer_output,
+                                    /*keep_output_on_error=*/true);
 }
 
 }  // namespace zetasql
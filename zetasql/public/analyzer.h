@@ -446,8 +446,10 @@ absl::StatusOr<std::unique_ptr<const AnalyzerOutput>> RewriteForAnonymization(
 // wants rewrites to happen after analyzing or which wants to apply more
 // rewrites.
 //
-// *WARNING* On error, 'analyzer_output' may be in an inconsistent state with
-// some rewrites applied (or even partially applied).
+// On error, 'analyzer_output' holds the resolved statement or expression
+// produced by the last rewriter that succeeded, or the input if none did, so
+// some of the rewrites may have been applied. Its other fields, such as
+// max_column_id(), may not have been updated.
 absl::Status RewriteResolvedAst(const AnalyzerOptions& analyzer_options,
                                 absl::string_view sql, Catalog* catalog,
                                 TypeFactory* type_factory,
@@ -20,6 +20,7 @@
 #include <string>
 #include <utility>
 
+#include "zetasql/base/arena_pool.h"
 #include "zetasql/base/case.h"
 
 namespace zetasql {
@@ -226,7 +227,7 @@ AnalyzerOptions::~AnalyzerOptions() {}
 
 void AnalyzerOptions::CreateDefaultArenasIfNotSet() {
   if (arena_ == nullptr) {
-    arena_ = std::make_shared<zetasql_base::UnsafeArena>(/*block_size=*/4096);
+    arena_ = zetasql_base::ArenaPool::GetDefault().GetArena();
   }
   if (id_string_pool_ == nullptr) {
     id_string_pool_ = std::make_shared<IdStringPool>(arena_);
@@ -321,6 +322,12 @@ absl::Status AnalyzerOptions::Deserialize(
   result->set_parameter_mode(proto.parameter_mode());
   result->set_preserve_column_aliases(proto.preserve_column_aliases());
   result->set_preserve_unnecessary_cast(proto.preserve_unnecessary_cast());
+  result->set_validation_mode(proto.validation_mode());
+  ZETASQL_RET_CHECK_GT(proto.validation_sampling_interval(), 0)
+      << "validation_sampling_interval must be positive";
+  result->set_validation_sampling_interval(
+      proto.validation_sampling_interval());
+  result->set_collect_runtime_info(proto.collect_runtime_info());
 
   if (proto.has_allowed_hints_and_options()) {
     AllowedHintsAndOptions hints_and_options("");
@@ -402,6 +409,9 @@ absl::Status AnalyzerOptions::Serialize(FileDescriptorSetMap* map,
   proto->set_parameter_mode(parameter_mode_);
   proto->set_preserve_column_aliases(preserve_column_aliases_);
   proto->set_preserve_unnecessary_cast(preserve_unnecessary_cast_);
+  proto->set_validation_mode(validation_mode_);
+  proto->set_validation_sampling_interval(validation_sampling_interval_);
+  proto->set_collect_runtime_info(collect_runtime_info_);
 
   ZETASQL_RETURN_IF_ERROR(allowed_hints_and_options_.Serialize(
       map, proto->mutable_allowed_hints_and_options()));
@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "zetasql/base/atomic_sequence_num.h"
+#include "zetasql/base/logging.h"
 #include "zetasql/parser/parser.h"
 #include "zetasql/public/catalog.h"
 #include "zetasql/public/id_string.h"
@@ -398,7 +399,9 @@ class AnalyzerOptions {
   }
   std::shared_ptr<zetasql_base::UnsafeArena> arena() const { return arena_; }
 
-  // Creates default-sized id_string_pool() and arena().
+  // Creates default-sized id_string_pool() and arena(). The arena comes from
+  // zetasql_base::ArenaPool::GetDefault(), which recycles it once these options
+  // and the outputs of analyzing with them are destroyed.
   // WARNING: After calling this, calling Analyze functions concurrently with
   // the same AnalyzerOptions is no longer allowed.
   void CreateDefaultArenasIfNotSet();
@@ -498,6 +501,35 @@ class AnalyzerOptions {
   }
   bool preserve_unnecessary_cast() const { return preserve_unnecessary_cast_; }
 
+  // Controls whether the resolved AST validator runs on the analyzer output;
+  // see ResolvedASTValidationMode. Validation catches analyzer bugs but adds
+  // to analysis latency, so a deployment may, for example, validate always in
+  // canaries and only a sample of the analyses elsewhere. The number of
+  // validations and the time spent in them are available from
+  // GetResolvedASTValidationStats() in
+  // zetasql/analyzer/resolved_ast_validation.h.
+  void set_validation_mode(ResolvedASTValidationMode mode) {
+    validation_mode_ = mode;
+  }
+  ResolvedASTValidationMode validation_mode() const { return validation_mode_; }
+
+  // With RESOLVED_AST_VALIDATION_SAMPLED, one in every <interval> analyses is
+  // validated. Must be positive.
+  void set_validation_sampling_interval(int64_t interval) {
+    ZETASQL_CHECK_GT(interval, 0)
+        << "validation_sampling_interval must be positive";
+    validation_sampling_interval_ = interval;
+  }
+  int64_t validation_sampling_interval() const {
+    return validation_sampling_interval_;
+  }
+
+  // If true, AnalyzerOutput::runtime_info() returns the wall and CPU time,
+  // arena bytes and Catalog lookups of each phase of the analysis. Collecting
+  // them adds a few clock reads per phase and per rewriter.
+  void set_collect_runtime_info(bool value) { collect_runtime_info_ = value; }
+  bool collect_runtime_info() const { return collect_runtime_info_; }
+
   // Controls whether to preserve aliases of aggregate columns and analytic
   // function columns. This option has no effect on query semantics and just
   // changes what names are used inside ResolvedColumns.
@@ -694,6 +726,11 @@ class AnalyzerOptions {
   // same.
   bool preserve_unnecessary_cast_ = false;
 
+  ResolvedASTValidationMode validation_mode_ = RESOLVED_AST_VALIDATION_DEFAULT;
+  int64_t validation_sampling_interval_ = 100;
+
+  bool collect_runtime_info_ = false;
+
   // The annotations specs that are passed in and should be handled by
   // the annotation framework.
   std::vector<AnnotationSpec*> annotation_specs_;  // Not owned.
@@ -24,6 +24,7 @@
 #include "zetasql/parser/parser.h"
 #include "zetasql/public/analyzer_options.h"
 #include "zetasql/public/analyzer_output_properties.h"
+#include "zetasql/public/analyzer_runtime_info.h"
 #include "zetasql/public/id_string.h"
 #include "zetasql/public/types/type.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
@@ -115,6 +116,12 @@ class AnalyzerOutput {
   // Column ids above this number are unused.
   int max_column_id() const { return max_column_id_; }
 
+  // Returns the time and resources spent in each phase of the analysis, or
+  // null unless AnalyzerOptions::collect_runtime_info() was true.
+  const AnalyzerRuntimeInfo* runtime_info() const {
+    return runtime_info_.get();
+  }
+
  private:
   friend class AnalyzerOutputMutator;
 
@@ -139,6 +146,8 @@ class AnalyzerOutput {
   QueryParametersMap undeclared_parameters_;
   std::vector<const Type*> undeclared_positional_parameters_;
   int max_column_id_;
+
+  std::unique_ptr<AnalyzerRuntimeInfo> runtime_info_;
 };
 }  // namespace zetasql
 
@@ -0,0 +1,106 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/analyzer_runtime_info.h"
+
+#include <time.h>
+
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/clock.h"
+
+namespace zetasql {
+
+namespace {
+
+absl::Duration ThreadCpuTime() {
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) {
+    return absl::ZeroDuration();
+  }
+  return absl::DurationFromTimespec(ts);
+}
+
+// Returns the number of bytes handed out by <arena> so far. Unlike
+// Status::bytes_allocated(), this does not grow by a whole block at a time.
+int64_t ArenaBytesUsed(const zetasql_base::UnsafeArena& arena) {
+  return static_cast<int64_t>(arena.status().bytes_allocated()) -
+         static_cast<int64_t>(arena.bytes_until_next_allocation());
+}
+
+void AppendPhase(absl::string_view name, const AnalyzerPhaseStats& stats,
+                 std::string* out) {
+  absl::StrAppendFormat(out, "%-40s wall: %10s  cpu: %10s  arena: %d\n", name,
+                        absl::FormatDuration(stats.wall_time),
+                        absl::FormatDuration(stats.cpu_time),
+                        stats.arena_bytes_allocated);
+}
+
+}  // namespace
+
+AnalyzerPhaseStats& AnalyzerPhaseStats::operator+=(
+    const AnalyzerPhaseStats& other) {
+  wall_time += other.wall_time;
+  cpu_time += other.cpu_time;
+  arena_bytes_allocated += other.arena_bytes_allocated;
+  return *this;
+}
+
+AnalyzerPhaseStats AnalyzerRuntimeInfo::Total() const {
+  AnalyzerPhaseStats total = parser;
+  total += resolver;
+  total += validator;
+  total += rewriters;
+  return total;
+}
+
+std::string AnalyzerRuntimeInfo::DebugString() const {
+  std::string out;
+  AppendPhase("parser", parser, &out);
+  AppendPhase("resolver", resolver, &out);
+  AppendPhase("validator", validator, &out);
+  AppendPhase(absl::StrCat("rewriters (", rewriter_iterations, " iterations)"),
+              rewriters, &out);
+  for (const auto& [name, stats] : rewriter_stats) {
+    AppendPhase(absl::StrCat("  ", name), stats, &out);
+  }
+  AppendPhase("total", Total(), &out);
+  absl::StrAppend(&out, "catalog find calls: ", catalog_find_calls, "\n");
+  return out;
+}
+
+ScopedAnalyzerPhaseTimer::ScopedAnalyzerPhaseTimer(
+    AnalyzerPhaseStats* stats, const zetasql_base::UnsafeArena* arena)
+    : stats_(stats), arena_(arena) {
+  if (stats_ == nullptr) return;
+  if (arena_ != nullptr) start_arena_bytes_ = ArenaBytesUsed(*arena_);
+  start_cpu_time_ = ThreadCpuTime();
+  start_wall_time_ = absl::Now();
+}
+
+ScopedAnalyzerPhaseTimer::~ScopedAnalyzerPhaseTimer() {
+  if (stats_ == nullptr) return;
+  stats_->wall_time += absl::Now() - start_wall_time_;
+  stats_->cpu_time += ThreadCpuTime() - start_cpu_time_;
+  if (arena_ != nullptr) {
+    stats_->arena_bytes_allocated += ArenaBytesUsed(*arena_) -
+                                     start_arena_bytes_;
+  }
+}
+
+}  // namespace zetasql
@@ -0,0 +1,91 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_PUBLIC_ANALYZER_RUNTIME_INFO_H_
+#define ZETASQL_PUBLIC_ANALYZER_RUNTIME_INFO_H_
+
+#include <cstdint>
+#include <string>
+
+#include "zetasql/base/arena.h"
+#include "absl/container/btree_map.h"
+#include "absl/time/time.h"
+
+namespace zetasql {
+
+// Resources used by one phase of an analysis.
+struct AnalyzerPhaseStats {
+  // Elapsed time.
+  absl::Duration wall_time;
+  // CPU time of the analyzing thread.
+  absl::Duration cpu_time;
+  // Bytes allocated in the arena, mostly for the parse tree and the resolved
+  // AST.
+  int64_t arena_bytes_allocated = 0;
+
+  AnalyzerPhaseStats& operator+=(const AnalyzerPhaseStats& other);
+};
+
+// Profile of one call to AnalyzeStatement(), AnalyzeNextStatement() or
+// AnalyzeExpression(), returned by AnalyzerOutput::runtime_info() when
+// AnalyzerOptions::collect_runtime_info() is true.
+//
+// Phases do not overlap, so their sum is about the total time of the
+// analysis. Analyses that start from a parse tree have no parser time.
+struct AnalyzerRuntimeInfo {
+  AnalyzerPhaseStats parser;
+  AnalyzerPhaseStats resolver;
+  // Includes the validation of the output of the rewriters.
+  AnalyzerPhaseStats validator;
+  // All the rewriter iterations, including the detection of the rewrites that
+  // apply to the output of an iteration.
+  AnalyzerPhaseStats rewriters;
+  // Time spent in each rewriter, by Rewriter::Name(), summed over iterations.
+  absl::btree_map<std::string, AnalyzerPhaseStats> rewriter_stats;
+  int64_t rewriter_iterations = 0;
+  // Number of Find*() calls on the Catalog, including FindConversion().
+  int64_t catalog_find_calls = 0;
+
+  // Returns the sum of the phases.
+  AnalyzerPhaseStats Total() const;
+
+  std::string DebugString() const;
+};
+
+// Adds the resources used from construction to destruction to <stats>.
+// Does nothing if <stats> is null, so that call sites need no branches when
+// runtime info is not collected. <arena> may be null if the phase does not
+// allocate in an arena.
+class ScopedAnalyzerPhaseTimer {
+ public:
+  ScopedAnalyzerPhaseTimer(AnalyzerPhaseStats* stats,
+                           const zetasql_base::UnsafeArena* arena);
+  ScopedAnalyzerPhaseTimer(const ScopedAnalyzerPhaseTimer&) = delete;
+  ScopedAnalyzerPhaseTimer& operator=(const ScopedAnalyzerPhaseTimer&) =
+      delete;
+  ~ScopedAnalyzerPhaseTimer();
+
+ private:
+  AnalyzerPhaseStats* stats_;
+  const zetasql_base::UnsafeArena* arena_;
+  absl::Time start_wall_time_;
+  absl::Duration start_cpu_time_;
+  int64_t start_arena_bytes_ = 0;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_PUBLIC_ANALYZER_RUNTIME_INFO_H_
@@ -37,10 +37,12 @@
 #include "zetasql/base/case.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
+#include "absl/base/thread_annotations.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/ret_check.h"
 #include "zetasql/base/status.h"
@@ -138,6 +140,53 @@ void GetZetaSQLFunctions(TypeFactory* type_factory,
   GetFilterFieldsFunction(type_factory, options, functions);
 }
 
+namespace {
+
+// The built-in functions for one ZetaSQLBuiltinFunctionOptions value.
+struct SharedZetaSQLFunctions {
+  NameToFunctionMap function_map;
+  std::vector<const Function*> functions;
+};
+
+ABSL_CONST_INIT absl::Mutex shared_functions_mutex(absl::kConstInit);
+
+// The shared functions, and the TypeFactory that owns the types their
+// signatures reference, are never destroyed. Analyzer output may reference
+// those types long after the catalog that provided the function is gone.
+struct SharedFunctionsRegistry {
+  TypeFactory type_factory;
+  absl::flat_hash_map<ZetaSQLBuiltinFunctionOptions,
+                      std::unique_ptr<const SharedZetaSQLFunctions>>
+      entries;
+};
+
+SharedFunctionsRegistry& GetSharedFunctionsRegistry()
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(shared_functions_mutex) {
+  static auto* registry = new SharedFunctionsRegistry();
+  return *registry;
+}
+
+}  // namespace
+
+const std::vector<const Function*>& GetSharedZetaSQLFunctions(
+    const ZetaSQLBuiltinFunctionOptions& options) {
+  absl::MutexLock lock(&shared_functions_mutex);
+  SharedFunctionsRegistry& registry = GetSharedFunctionsRegistry();
+  std::unique_ptr<const SharedZetaSQLFunctions>& entry =
+      registry.entries[options];
+  if (entry == nullptr) {
+    auto shared = std::make_unique<SharedZetaSQLFunctions>();
+    GetZetaSQLFunctions(&registry.type_factory, options,
+                        &shared->function_map);
+    shared->functions.reserve(shared->function_map.size());
+    for (const auto& [name, function] : shared->function_map) {
+      shared->functions.push_back(function.get());
+    }
+    entry = std::move(shared);
+  }
+  return entry->functions;
+}
+
 bool FunctionMayHaveUnintendedArgumentCoercion(const Function* function) {
   if (function->NumSignatures() == 0 ||
       !function->ArgumentsAreCoercible()) {
@@ -22,6 +22,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "zetasql/proto/options.pb.h"
 #include "zetasql/public/builtin_function.pb.h"
@@ -49,6 +50,19 @@ void GetZetaSQLFunctions(
     TypeFactory* type_factory, const ZetaSQLBuiltinFunctionOptions& options,
     std::map<std::string, std::unique_ptr<Function>>* functions);
 
+// Returns the built-in ZetaSQL functions for <options>, ordered by name, from
+// a process-wide registry. The functions are built with GetZetaSQLFunctions()
+// on the first call for <options>, and later calls return the same objects.
+// The functions and the types they reference are immutable and live until the
+// process exits, so any number of catalogs may reference them concurrently
+// instead of building their own copies (see
+// SimpleCatalog::AddSharedZetaSQLFunctions()).
+//
+// Each distinct <options> value adds an entry that is never released, so this
+// is meant for a small, fixed set of configurations.
+const std::vector<const Function*>& GetSharedZetaSQLFunctions(
+    const ZetaSQLBuiltinFunctionOptions& options);
+
 // If the function allows argument coercion, then checks the function
 // signatures to see if they are defined for floating point and
 // only one of signed/unsigned integer arguments (but not both integer
@@ -19,8 +19,11 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "zetasql/proto/options.pb.h"
 #include "zetasql/public/builtin_function.pb.h"
@@ -80,6 +83,30 @@ struct ZetaSQLBuiltinFunctionOptions {
   // Ignore FunctionSignatures for FunctionSignatureIds in this set.
   absl::flat_hash_set<FunctionSignatureId, FunctionSignatureIdHasher>
       exclude_function_ids;
+
+  bool operator==(const ZetaSQLBuiltinFunctionOptions& rhs) const {
+    return language_options == rhs.language_options &&
+           include_function_ids == rhs.include_function_ids &&
+           exclude_function_ids == rhs.exclude_function_ids;
+  }
+  bool operator!=(const ZetaSQLBuiltinFunctionOptions& rhs) const {
+    return !(*this == rhs);
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const ZetaSQLBuiltinFunctionOptions& value) {
+    // absl::flat_hash_set does not support being absl Hash-ed.
+    auto sorted = [](const absl::flat_hash_set<FunctionSignatureId,
+                                               FunctionSignatureIdHasher>&
+                         ids) {
+      std::vector<FunctionSignatureId> result(ids.begin(), ids.end());
+      std::sort(result.begin(), result.end());
+      return result;
+    };
+    return H::combine(std::move(h), value.language_options,
+                      sorted(value.include_function_ids),
+                      sorted(value.exclude_function_ids));
+  }
 };
 
 }  // namespace zetasql
@@ -16,6 +16,7 @@
 
 #include "zetasql/public/builtin_function.h"
 
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -26,11 +27,13 @@
 #include "zetasql/public/function.pb.h"
 #include "zetasql/public/language_options.h"
 #include "zetasql/public/options.pb.h"
+#include "zetasql/public/simple_catalog.h"
 #include "zetasql/public/value.h"
 #include "zetasql/resolved_ast/resolved_node_kind.pb.h"
 #include "zetasql/testdata/test_schema.pb.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "absl/hash/hash.h"
 #include "absl/strings/str_join.h"
 #include "zetasql/base/map_util.h"
 #include "zetasql/base/status.h"
@@ -459,6 +462,74 @@ TEST(SimpleBuiltinFunctionTests, LanguageOptions) {
   EXPECT_FALSE(zetasql_base::ContainsKey(functions, FunctionSignatureIdToName(FN_LEAD)));
 }
 
+TEST(SimpleBuiltinFunctionTests, OptionsEqualityAndHash) {
+  ZetaSQLBuiltinFunctionOptions options1;
+  ZetaSQLBuiltinFunctionOptions options2;
+  options1.include_function_ids.insert(FN_ADD_INT64);
+  options1.include_function_ids.insert(FN_ADD_DOUBLE);
+  options2.include_function_ids.insert(FN_ADD_DOUBLE);
+  options2.include_function_ids.insert(FN_ADD_INT64);
+  EXPECT_EQ(options1, options2);
+  EXPECT_EQ(absl::HashOf(options1), absl::HashOf(options2));
+
+  options2.exclude_function_ids.insert(FN_ADD_INT64);
+  EXPECT_NE(options1, options2);
+  options2.exclude_function_ids.clear();
+  options2.language_options.DisableAllLanguageFeatures();
+  EXPECT_NE(options1, options2);
+}
+
+TEST(SimpleBuiltinFunctionTests, SharedFunctions) {
+  ZetaSQLBuiltinFunctionOptions options;
+  options.language_options.EnableLanguageFeature(FEATURE_ANALYTIC_FUNCTIONS);
+
+  TypeFactory type_factory;
+  NameToFunctionMap functions;
+  GetZetaSQLFunctions(&type_factory, options, &functions);
+
+  // The shared functions are the same as those built for a single catalog,
+  // in the same order.
+  const std::vector<const Function*>& shared =
+      GetSharedZetaSQLFunctions(options);
+  ASSERT_EQ(shared.size(), functions.size());
+  int i = 0;
+  for (const auto& [name, function] : functions) {
+    EXPECT_EQ(shared[i]->Name(), function->Name());
+    EXPECT_EQ(shared[i]->DebugString(/*verbose=*/true),
+              function->DebugString(/*verbose=*/true));
+    ++i;
+  }
+
+  // Equal options share one set of functions; other options get their own.
+  ZetaSQLBuiltinFunctionOptions same_options = options;
+  EXPECT_EQ(&GetSharedZetaSQLFunctions(same_options), &shared);
+
+  ZetaSQLBuiltinFunctionOptions other_options = options;
+  other_options.exclude_function_ids.insert(FN_RANK);
+  const std::vector<const Function*>& other_shared =
+      GetSharedZetaSQLFunctions(other_options);
+  EXPECT_NE(&other_shared, &shared);
+  EXPECT_EQ(other_shared.size(), shared.size() - 1);
+
+  // Catalogs created one after another reference the same functions, which
+  // outlive the catalogs along with the types in their signatures.
+  const Function* first_rank;
+  {
+    SimpleCatalog catalog("catalog");
+    catalog.AddSharedZetaSQLFunctions(options);
+    ZETASQL_ASSERT_OK(catalog.FindFunction({"rank"}, &first_rank));
+  }
+  {
+    SimpleCatalog catalog("catalog");
+    catalog.AddSharedZetaSQLFunctions(options);
+    const Function* rank;
+    ZETASQL_ASSERT_OK(catalog.FindFunction({"rank"}, &rank));
+    EXPECT_EQ(rank, first_rank);
+  }
+  EXPECT_EQ(&GetSharedZetaSQLFunctions(options), &shared);
+  EXPECT_TRUE(first_rank->GetSignature(0)->result_type().type()->IsInt64());
+}
+
 TEST(SimpleBuiltinFunctionTests, NumericFunctions) {
   TypeFactory type_factory;
   NameToFunctionMap functions;
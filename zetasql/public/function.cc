@@ -152,9 +152,10 @@ Function::Function(absl::string_view name, absl::string_view group, Mode mode,
       function_options_(std::move(function_options)) {
   function_name_path_.emplace_back(name);
   ZETASQL_CHECK_OK(CheckWindowSupportOptions());
-  for (const FunctionSignature& signature : function_signatures_) {
-    ZETASQL_CHECK_OK(signature.IsValidForFunction())
-        << signature.DebugString(FullName());
+  for (int i = 0; i < function_signatures_.size(); ++i) {
+    ZETASQL_CHECK_OK(function_signatures_[i].IsValidForFunction())
+        << function_signatures_[i].DebugString(FullName());
+    IndexSignatureForExactMatch(i);
   }
   ZETASQL_CHECK_OK(CheckMultipleSignatureMatchingSameFunctionCall());
 }
@@ -169,9 +170,10 @@ Function::Function(std::vector<std::string> name_path, absl::string_view group,
       function_signatures_(std::move(function_signatures)),
       function_options_(std::move(function_options)) {
   ZETASQL_CHECK_OK(CheckWindowSupportOptions());
-  for (const FunctionSignature& signature : function_signatures_) {
-    ZETASQL_CHECK_OK(signature.IsValidForFunction())
-        << signature.DebugString(FullName());
+  for (int i = 0; i < function_signatures_.size(); ++i) {
+    ZETASQL_CHECK_OK(function_signatures_[i].IsValidForFunction())
+        << function_signatures_[i].DebugString(FullName());
+    IndexSignatureForExactMatch(i);
   }
   ZETASQL_CHECK_OK(CheckMultipleSignatureMatchingSameFunctionCall());
 }
@@ -320,9 +322,12 @@ const std::vector<FunctionSignature>& Function::signatures() const {
 void Function::ResetSignatures(
     const std::vector<FunctionSignature>& signatures) {
   function_signatures_ = signatures;
-  for (const FunctionSignature& signature : signatures) {
-    ZETASQL_CHECK_OK(signature.IsValidForFunction())
-        << signature.DebugString(FullName());
+  exact_match_signatures_.clear();
+  non_exact_match_signatures_.clear();
+  for (int i = 0; i < function_signatures_.size(); ++i) {
+    ZETASQL_CHECK_OK(function_signatures_[i].IsValidForFunction())
+        << function_signatures_[i].DebugString(FullName());
+    IndexSignatureForExactMatch(i);
   }
 }
 
@@ -388,6 +393,7 @@ void Function::AddSignature(const FunctionSignature& signature) {
       << signature.DebugString(FullName());
   function_signatures_.push_back(signature);
   ZETASQL_CHECK_OK(signature.IsValidForFunction()) << signature.DebugString(FullName());
+  IndexSignatureForExactMatch(NumSignatures() - 1);
 }
 
 absl::Status Function::AddSignature(const TypeKind result_kind,
@@ -431,6 +437,81 @@ const FunctionSignature* Function::GetSignature(int idx) const {
   return &(function_signatures_[idx]);
 }
 
+// Returns true if a call matches <signature> without coercion exactly when the
+// type kinds of its arguments are those of the signature arguments.
+static bool HasOnlyFixedSimpleArguments(const FunctionSignature& signature) {
+  if (signature.IsInternal()) {
+    return false;
+  }
+  for (const FunctionArgumentType& argument : signature.arguments()) {
+    if (!argument.required() || argument.kind() != ARG_TYPE_FIXED ||
+        argument.type() == nullptr || !argument.type()->IsSimpleType() ||
+        argument.options().has_argument_name()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns false if <signature> cannot accept <num_arguments> arguments. This
+// is conservative for signatures with repeated arguments.
+static bool MayAcceptArgumentCount(const FunctionSignature& signature,
+                                   int num_arguments) {
+  return num_arguments >= signature.NumRequiredArguments() &&
+         (signature.NumRepeatedArguments() > 0 ||
+          num_arguments <= signature.NumRequiredArguments() +
+                               signature.NumOptionalArguments());
+}
+
+void Function::IndexSignatureForExactMatch(int signature_idx) {
+  const FunctionSignature& signature = function_signatures_[signature_idx];
+  if (!HasOnlyFixedSimpleArguments(signature)) {
+    non_exact_match_signatures_.push_back(signature_idx);
+    return;
+  }
+  // Signature matching prefers the first of the signatures matching with the
+  // same cost, so a signature is only used for exact matches if no earlier
+  // signature could match the same arguments without coercion. An earlier
+  // signature with fixed simple arguments of other kinds needs coercion, and
+  // one with the same kinds is already in the index.
+  const int num_arguments = static_cast<int>(signature.arguments().size());
+  for (const int other_idx : non_exact_match_signatures_) {
+    if (MayAcceptArgumentCount(function_signatures_[other_idx],
+                               num_arguments)) {
+      return;
+    }
+  }
+  std::vector<TypeKind> argument_kinds;
+  argument_kinds.reserve(num_arguments);
+  for (const FunctionArgumentType& argument : signature.arguments()) {
+    argument_kinds.push_back(argument.type()->kind());
+  }
+  exact_match_signatures_.emplace(std::move(argument_kinds), signature_idx);
+}
+
+const FunctionSignature* Function::GetExactMatchSignature(
+    const std::vector<InputArgumentType>& arguments) const {
+  if (exact_match_signatures_.empty()) {
+    return nullptr;
+  }
+  std::vector<TypeKind> argument_kinds;
+  argument_kinds.reserve(arguments.size());
+  for (const InputArgumentType& argument : arguments) {
+    if (argument.is_untyped() || argument.is_relation() ||
+        argument.is_model() || argument.is_connection() ||
+        argument.is_lambda() || argument.type() == nullptr ||
+        !argument.type()->IsSimpleType()) {
+      return nullptr;
+    }
+    argument_kinds.push_back(argument.type()->kind());
+  }
+  auto it = exact_match_signatures_.find(argument_kinds);
+  if (it == exact_match_signatures_.end()) {
+    return nullptr;
+  }
+  return &function_signatures_[it->second];
+}
+
 std::string Function::DebugString(bool verbose) const {
   if (verbose) {
     return absl::StrCat(
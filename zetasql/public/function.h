@@ -33,6 +33,7 @@
 #include "zetasql/public/types/type_deserializer.h"
 #include "zetasql/public/value.h"
 #include "absl/base/attributes.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/types/span.h"
@@ -641,6 +642,19 @@ class Function {
   // specified idx does not exist.
   const FunctionSignature* GetSignature(int idx) const;
 
+  // Returns the signature that a call with <arguments> resolves to when the
+  // argument types match the signature exactly, without any coercion.  Only
+  // signatures whose arguments are all required, unnamed and of a fixed
+  // simple type are considered, and only when no earlier signature could also
+  // match <arguments> without coercion.  Returns NULL if the call must go
+  // through the full signature matching, which is the case for all calls with
+  // untyped, non-simple or non-scalar arguments.
+  //
+  // The returned signature still has to be checked against the enabled
+  // language features and argument constraints, like any other signature.
+  const FunctionSignature* GetExactMatchSignature(
+      const std::vector<InputArgumentType>& arguments) const;
+
   // Returns the function name.  If <verbose> then also returns DebugString()s
   // of all its function signatures.
   virtual std::string DebugString(bool verbose = false) const;
@@ -762,10 +776,21 @@ class Function {
  private:
   bool is_operator() const;
 
+  // Adds function_signatures_[<signature_idx>], which must be the last
+  // signature, to <exact_match_signatures_> if it qualifies.
+  void IndexSignatureForExactMatch(int signature_idx);
+
   std::vector<std::string> function_name_path_;
   std::string group_;
   Mode mode_;
   std::vector<FunctionSignature> function_signatures_;
+
+  // Index of function_signatures_ used by GetExactMatchSignature, keyed by the
+  // argument type kinds of the signatures that have only fixed simple
+  // argument types.
+  absl::flat_hash_map<std::vector<TypeKind>, int> exact_match_signatures_;
+  // The indexes of the signatures that are not in <exact_match_signatures_>.
+  std::vector<int> non_exact_match_signatures_;
   const FunctionOptions function_options_;
 };
 
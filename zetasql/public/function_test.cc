@@ -30,6 +30,7 @@
 #include "zetasql/public/error_location.pb.h"
 #include "zetasql/public/function.pb.h"
 #include "zetasql/public/function_signature.h"
+#include "zetasql/public/input_argument_type.h"
 #include "zetasql/public/language_options.h"
 #include "zetasql/public/parse_location.h"
 #include "zetasql/public/parse_location_range.pb.h"
@@ -38,6 +39,7 @@
 #include "zetasql/public/type.h"
 #include "zetasql/public/types/type_deserializer.h"
 #include "zetasql/public/types/type_factory.h"
+#include "zetasql/public/value.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -206,6 +208,50 @@ TEST(SimpleFunctionTests, WindowSupportTests) {
   EXPECT_FALSE(analytic_function.RequiresWindowOrdering());
 }
 
+TEST(SimpleFunctionTests, ExactMatchSignatureTests) {
+  TypeFactory type_factory;
+  const Type* int64_type = type_factory.get_int64();
+  const Type* double_type = type_factory.get_double();
+  const InputArgumentType int64_arg(int64_type);
+  const InputArgumentType double_arg(double_type);
+
+  Function fn("test_function_name", Function::kZetaSQLFunctionGroupName,
+              Function::SCALAR);
+  EXPECT_THAT(fn.GetExactMatchSignature({int64_arg, int64_arg}), IsNull());
+  fn.AddSignatureOrDie(TYPE_INT64, {TYPE_INT64, TYPE_INT64}, nullptr,
+                       &type_factory);
+  fn.AddSignatureOrDie(TYPE_DOUBLE, {TYPE_DOUBLE, TYPE_DOUBLE}, nullptr,
+                       &type_factory);
+  // A later signature with the same argument types is never chosen.
+  fn.AddSignatureOrDie(TYPE_STRING, {TYPE_INT64, TYPE_INT64}, nullptr,
+                       &type_factory);
+
+  EXPECT_EQ(fn.GetExactMatchSignature({int64_arg, int64_arg}),
+            fn.GetSignature(0));
+  EXPECT_EQ(fn.GetExactMatchSignature({double_arg, double_arg}),
+            fn.GetSignature(1));
+  EXPECT_EQ(fn.GetExactMatchSignature(
+                {InputArgumentType(Value::Int64(1)), int64_arg}),
+            fn.GetSignature(0));
+  // Calls that need coercion or have untyped arguments are not indexed.
+  EXPECT_THAT(fn.GetExactMatchSignature({int64_arg, double_arg}), IsNull());
+  EXPECT_THAT(fn.GetExactMatchSignature({int64_arg}), IsNull());
+  EXPECT_THAT(fn.GetExactMatchSignature(
+                  {InputArgumentType::UntypedNull(), int64_arg}),
+              IsNull());
+
+  // A templated signature may match without coercion too, so fixed signatures
+  // with the same number of arguments after it are not indexed.
+  fn.ResetSignatures(
+      {FunctionSignature(ARG_TYPE_ANY_1, {ARG_TYPE_ANY_1, ARG_TYPE_ANY_1},
+                         /*context_id=*/-1),
+       FunctionSignature(int64_type, {int64_type, int64_type},
+                         /*context_id=*/-1),
+       FunctionSignature(int64_type, {int64_type}, /*context_id=*/-1)});
+  EXPECT_THAT(fn.GetExactMatchSignature({int64_arg, int64_arg}), IsNull());
+  EXPECT_EQ(fn.GetExactMatchSignature({int64_arg}), fn.GetSignature(2));
+}
+
 TEST(SimpleFunctionTests,
      LambdaMultipleSignaturePossiblyMatchingSameCallTests) {
   const Type* bool_type = zetasql::types::Int64Type();
@@ -16,6 +16,8 @@
 
 #include "zetasql/public/functions/convert_string.h"
 
+#include <string.h>
+
 #include <cstdint>
 #include <string>
 
@@ -23,6 +25,7 @@
 #include "zetasql/public/functions/util.h"
 #include "zetasql/base/case.h"
 #include "zetasql/base/string_numbers.h"
+#include "absl/base/config.h"
 #include "absl/base/optimization.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/escaping.h"
@@ -62,6 +65,158 @@ bool IsHex(absl::string_view str) {
   return str.size() >= 2 && str[0] == '0' && (str[1] == 'x' || str[1] == 'X');
 }
 
+// Fast paths for the common shapes of numeric strings. Each one recognizes a
+// strict subset of the inputs accepted by the general parser and returns false
+// for anything else, leaving the caller to take the general path. They never
+// report errors themselves, so error semantics are unchanged.
+
+// Returns true if all 8 bytes of <chunk> are ASCII digits.
+inline bool IsEightDigits(uint64_t chunk) {
+  return (((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+           (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+          0x3333333333333333ULL);
+}
+
+// Converts 8 ASCII digits, loaded little-endian into <chunk>, to their value.
+inline uint64_t EightDigitsToValue(uint64_t chunk) {
+  chunk = (chunk & 0x0F0F0F0F0F0F0F0FULL) * 2561 >> 8;
+  chunk = (chunk & 0x00FF00FF00FF00FFULL) * 6553601 >> 16;
+  return (chunk & 0x0000FFFF0000FFFFULL) * 42949672960001ULL >> 32;
+}
+
+// Parses 1 to 18 ASCII digits into <out>. Returns false if <digits> is empty,
+// too long, or contains anything but digits.
+bool ParseShortDecimal(absl::string_view digits, uint64_t* out) {
+  if (digits.empty() || digits.size() > 18) return false;
+  const char* p = digits.data();
+  size_t n = digits.size();
+  uint64_t value = 0;
+#if defined(ABSL_IS_LITTLE_ENDIAN)
+  while (n >= 8) {
+    uint64_t chunk;
+    memcpy(&chunk, p, sizeof(chunk));
+    if (!IsEightDigits(chunk)) return false;
+    value = value * 100000000 + EightDigitsToValue(chunk);
+    p += 8;
+    n -= 8;
+  }
+#endif
+  for (; n > 0; ++p, --n) {
+    const unsigned digit = static_cast<unsigned char>(*p) - '0';
+    if (digit > 9) return false;
+    value = value * 10 + digit;
+  }
+  *out = value;
+  return true;
+}
+
+// Strips an optional leading sign from <str>, returning true if it was '-'.
+inline bool ConsumeSign(absl::string_view* str) {
+  if (!str->empty() && ((*str)[0] == '-' || (*str)[0] == '+')) {
+    const bool negative = (*str)[0] == '-';
+    str->remove_prefix(1);
+    return negative;
+  }
+  return false;
+}
+
+// Recognizes [+-]digits with at most 18 digits, which always fits in int64_t.
+// <max_digits> may be lowered for narrower types.
+template <typename T>
+bool FastStringToInteger(absl::string_view str, int max_digits, T* out) {
+  const bool negative = ConsumeSign(&str);
+  uint64_t magnitude;
+  if (static_cast<int>(str.size()) > max_digits ||
+      !ParseShortDecimal(str, &magnitude)) {
+    return false;
+  }
+  const int64_t value = static_cast<int64_t>(magnitude);
+  *out = static_cast<T>(negative ? -value : value);
+  return true;
+}
+
+// Recognizes [+-]digits[.digits] with at most 15 significant digits in total
+// and no exponent. The mantissa is then exactly representable as a double and
+// so is the power of ten it is divided by, which makes the quotient correctly
+// rounded (Clinger's fast path).
+bool FastStringToDouble(absl::string_view str, double* out) {
+  static constexpr uint64_t kPowersOfTen[] = {
+      1ULL,
+      10ULL,
+      100ULL,
+      1000ULL,
+      10000ULL,
+      100000ULL,
+      1000000ULL,
+      10000000ULL,
+      100000000ULL,
+      1000000000ULL,
+      10000000000ULL,
+      100000000000ULL,
+      1000000000000ULL,
+      10000000000000ULL,
+      100000000000000ULL,
+      1000000000000000ULL};
+  const bool negative = ConsumeSign(&str);
+  absl::string_view integer_part = str;
+  absl::string_view fractional_part;
+  const size_t dot = str.find('.');
+  if (dot != absl::string_view::npos) {
+    integer_part = str.substr(0, dot);
+    fractional_part = str.substr(dot + 1);
+    if (fractional_part.empty()) return false;
+  }
+  if (integer_part.empty() ||
+      integer_part.size() + fractional_part.size() > 15) {
+    return false;
+  }
+  uint64_t integer_value;
+  uint64_t fractional_value = 0;
+  if (!ParseShortDecimal(integer_part, &integer_value) ||
+      (!fractional_part.empty() &&
+       !ParseShortDecimal(fractional_part, &fractional_value))) {
+    return false;
+  }
+  const int scale = static_cast<int>(fractional_part.size());
+  double value = static_cast<double>(integer_value * kPowersOfTen[scale] +
+                                     fractional_value);
+  if (scale > 0) value /= static_cast<double>(kPowersOfTen[scale]);
+  *out = negative ? -value : value;
+  return true;
+}
+
+// Recognizes [+-]digits[.digits] with at most 18 integer and at most 9
+// fractional digits, i.e. values that fit NUMERIC without rounding.
+bool FastStringToNumericValue(absl::string_view str, NumericValue* out) {
+  static constexpr uint64_t kFractionalScale[] = {
+      1000000000, 100000000, 10000000, 1000000, 100000,
+      10000,      1000,      100,      10,      1};
+  const bool negative = ConsumeSign(&str);
+  absl::string_view integer_part = str;
+  absl::string_view fractional_part;
+  const size_t dot = str.find('.');
+  if (dot != absl::string_view::npos) {
+    integer_part = str.substr(0, dot);
+    fractional_part = str.substr(dot + 1);
+    if (fractional_part.empty() || fractional_part.size() > 9) return false;
+  }
+  uint64_t integer_value;
+  uint64_t fractional_value = 0;
+  if (!ParseShortDecimal(integer_part, &integer_value) ||
+      (!fractional_part.empty() &&
+       !ParseShortDecimal(fractional_part, &fractional_value))) {
+    return false;
+  }
+  __int128 packed =
+      static_cast<__int128>(integer_value) * 1000000000 +
+      fractional_value * kFractionalScale[fractional_part.size()];
+  if (negative) packed = -packed;
+  absl::StatusOr<NumericValue> value = NumericValue::FromPackedInt(packed);
+  if (!value.ok()) return false;
+  *out = *value;
+  return true;
+}
+
 constexpr absl::string_view kTrueStringValue = "true";
 constexpr absl::string_view kFalseStringValue = "false";
 
@@ -154,6 +309,9 @@ template <>
 bool StringToNumeric(absl::string_view value, int32_t* out,
                      absl::Status* error) {
   TrimLeadingSpaces(&value);
+  if (ABSL_PREDICT_TRUE(FastStringToInteger(value, /*max_digits=*/9, out))) {
+    return true;
+  }
   if (ABSL_PREDICT_FALSE(IsHex(value))) {
     if (ABSL_PREDICT_TRUE(
             zetasql_base::safe_strto32_base(value, out, 16 /* base */)))
@@ -168,6 +326,9 @@ template <>
 bool StringToNumeric(absl::string_view value, int64_t* out,
                      absl::Status* error) {
   TrimLeadingSpaces(&value);
+  if (ABSL_PREDICT_TRUE(FastStringToInteger(value, /*max_digits=*/18, out))) {
+    return true;
+  }
   if (ABSL_PREDICT_FALSE(IsHex(value))) {
     if (ABSL_PREDICT_TRUE(
             zetasql_base::safe_strto64_base(value, out, 16 /* base */)))
@@ -215,6 +376,7 @@ bool StringToNumeric(absl::string_view value, float* out, absl::Status* error) {
 template <>
 bool StringToNumeric(absl::string_view value, double* out,
                      absl::Status* error) {
+  if (ABSL_PREDICT_TRUE(FastStringToDouble(value, out))) return true;
   if (ABSL_PREDICT_TRUE(absl::SimpleAtod(value, out))) return true;
   return internal::UpdateError(error, FormatError("Bad double value: ", value));
 }
@@ -222,6 +384,7 @@ bool StringToNumeric(absl::string_view value, double* out,
 template <>
 bool StringToNumeric(absl::string_view value, NumericValue* out,
                      absl::Status* error) {
+  if (ABSL_PREDICT_TRUE(FastStringToNumericValue(value, out))) return true;
   const auto numeric_status = NumericValue::FromString(value);
   if (ABSL_PREDICT_TRUE(numeric_status.ok())) {
     *out = numeric_status.value();
@@ -0,0 +1,140 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Compares CAST(STRING AS ...) conversions of typical inputs, which take the
+// fast paths in StringToNumeric(), ConvertStringToDate() and
+// ConvertStringToTimestamp(), against the general parsers they bypass.
+
+#include <cstdint>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/public/functions/convert_string.h"
+#include "zetasql/public/functions/date_time_util.h"
+#include "zetasql/public/numeric_value.h"
+#include "benchmark/benchmark.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/numbers.h"
+#include "absl/time/time.h"
+
+namespace zetasql {
+namespace functions {
+namespace {
+
+void BM_StringToInt64(benchmark::State& state) {
+  int64_t out;
+  absl::Status error;
+  for (auto s : state) {
+    ZETASQL_CHECK(StringToNumeric("1234567890123", &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_StringToInt64);
+
+void BM_SimpleAtoiInt64(benchmark::State& state) {
+  int64_t out;
+  for (auto s : state) {
+    ZETASQL_CHECK(absl::SimpleAtoi("1234567890123", &out));
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_SimpleAtoiInt64);
+
+void BM_StringToDouble(benchmark::State& state) {
+  double out;
+  absl::Status error;
+  for (auto s : state) {
+    ZETASQL_CHECK(StringToNumeric("-12345.678901", &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_StringToDouble);
+
+void BM_SimpleAtodDouble(benchmark::State& state) {
+  double out;
+  for (auto s : state) {
+    ZETASQL_CHECK(absl::SimpleAtod("-12345.678901", &out));
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_SimpleAtodDouble);
+
+void BM_StringToNumericValue(benchmark::State& state) {
+  NumericValue out;
+  absl::Status error;
+  for (auto s : state) {
+    ZETASQL_CHECK(StringToNumeric("123456789.123456789", &out, &error));
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_StringToNumericValue);
+
+void BM_NumericValueFromString(benchmark::State& state) {
+  for (auto s : state) {
+    absl::StatusOr<NumericValue> out =
+        NumericValue::FromString("123456789.123456789");
+    ZETASQL_CHECK_OK(out.status());
+    benchmark::DoNotOptimize(out);
+  }
+}
+BENCHMARK(BM_NumericValueFromString);
+
+// The second input of each pair is accepted by the general parser only.
+const char* const kDateInputs[] = {"2024-02-29", "2024-2-29"};
+
+void BM_ConvertStringToDate(benchmark::State& state) {
+  const char* input = kDateInputs[state.range(0)];
+  int32_t date;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(ConvertStringToDate(input, &date));
+    benchmark::DoNotOptimize(date);
+  }
+  state.SetLabel(input);
+}
+BENCHMARK(BM_ConvertStringToDate)->DenseRange(0, 1);
+
+const char* const kTimestampInputs[] = {"2024-02-29 13:14:15.123456",
+                                        "2024-2-29 13:14:15.123456"};
+
+void BM_ConvertStringToTimestamp(benchmark::State& state) {
+  const char* input = kTimestampInputs[state.range(0)];
+  int64_t timestamp;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(ConvertStringToTimestamp(input, absl::UTCTimeZone(),
+                                      kMicroseconds, &timestamp));
+    benchmark::DoNotOptimize(timestamp);
+  }
+  state.SetLabel(input);
+}
+BENCHMARK(BM_ConvertStringToTimestamp)->DenseRange(0, 1);
+
+void BM_ConvertStringToTimestampWithTimeZone(benchmark::State& state) {
+  const char* input = kTimestampInputs[state.range(0)];
+  absl::TimeZone timezone;
+  ZETASQL_CHECK_OK(MakeTimeZone("America/Los_Angeles", &timezone));
+  int64_t timestamp;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(
+        ConvertStringToTimestamp(input, timezone, kMicroseconds, &timestamp));
+    benchmark::DoNotOptimize(timestamp);
+  }
+  state.SetLabel(input);
+}
+BENCHMARK(BM_ConvertStringToTimestampWithTimeZone)->DenseRange(0, 1);
+
+}  // namespace
+}  // namespace functions
+}  // namespace zetasql
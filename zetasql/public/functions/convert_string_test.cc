@@ -21,6 +21,7 @@
 #include <cstdint>
 #include <limits>
 #include <map>
+#include <random>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -35,6 +36,7 @@
 #include "gtest/gtest.h"
 #include "absl/strings/ascii.h"
 #include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/string_view.h"
 #include "zetasql/base/status.h"
 
@@ -180,6 +182,83 @@ TEST(Convert, TestDouble) {
   TestAll<double>();
 }
 
+// Inputs around the limits of the fast paths in StringToNumeric(), which must
+// produce exactly what the general parsers produce.
+const char* const kFastPathBoundaryInputs[] = {
+    "0", "-0", "+0", "00", "7", "-7", "+7", "+-7", "-", "+", "", " 1", "1 ",
+    "12345678", "123456789", "1234567890", "-2147483648", "2147483647",
+    "2147483648", "123456789012345678", "-123456789012345678",
+    "1234567890123456789", "9223372036854775807", "-9223372036854775808",
+    "9223372036854775808", "000000000000000001", "1234567a", "12345678a",
+    "1.5", "-1.5", "0.1", "-0.0", "1.", ".5", "1.2.3", "1e5",
+    "123456789012345", "1234567890123456", "12345.6789012345",
+    "0.000000000000001", "999999999999999", "0.999999999", "1.0000000001",
+    "999999999999999999.999999999", "-999999999999999999.999999999",
+    "99999999999999999999.5", "1.23456789", "nan", "inf",
+};
+
+TEST(Convert, FastPathsMatchGeneralParsers) {
+  for (const char* input : kFastPathBoundaryInputs) {
+    SCOPED_TRACE(input);
+    absl::Status error;
+    int32_t int32_out;
+    int32_t int32_expected;
+    EXPECT_EQ(StringToNumeric(input, &int32_out, &error),
+              absl::SimpleAtoi(input, &int32_expected));
+    if (error.ok()) {
+      EXPECT_EQ(int32_out, int32_expected);
+    }
+
+    error = absl::OkStatus();
+    int64_t int64_out;
+    int64_t int64_expected;
+    EXPECT_EQ(StringToNumeric(input, &int64_out, &error),
+              absl::SimpleAtoi(input, &int64_expected));
+    if (error.ok()) {
+      EXPECT_EQ(int64_out, int64_expected);
+    }
+
+    error = absl::OkStatus();
+    double double_out;
+    double double_expected;
+    EXPECT_EQ(StringToNumeric(input, &double_out, &error),
+              absl::SimpleAtod(input, &double_expected));
+    if (error.ok() && !std::isnan(double_expected)) {
+      EXPECT_EQ(double_out, double_expected);
+      EXPECT_EQ(std::signbit(double_out), std::signbit(double_expected));
+    }
+
+    error = absl::OkStatus();
+    NumericValue numeric_out;
+    const absl::StatusOr<NumericValue> numeric_expected =
+        NumericValue::FromString(input);
+    EXPECT_EQ(StringToNumeric(input, &numeric_out, &error),
+              numeric_expected.ok());
+    if (error.ok()) {
+      EXPECT_EQ(numeric_out, *numeric_expected);
+    }
+  }
+}
+
+TEST(Convert, FastDoublePathIsCorrectlyRounded) {
+  std::mt19937_64 random(1234);
+  for (int i = 0; i < 100000; ++i) {
+    const int num_digits = 1 + random() % 15;
+    const int num_fractional_digits = random() % num_digits;
+    std::string input;
+    for (int d = 0; d < num_digits; ++d) {
+      if (d == num_digits - num_fractional_digits && d > 0) input += '.';
+      input += static_cast<char>('0' + random() % 10);
+    }
+    double out;
+    double expected;
+    absl::Status error;
+    ASSERT_TRUE(StringToNumeric(input, &out, &error)) << input;
+    ASSERT_TRUE(absl::SimpleAtod(input, &expected)) << input;
+    ASSERT_EQ(out, expected) << input;
+  }
+}
+
 template <typename T>
 void TestNumericToString(const QueryParamsWithResult& test) {
   if (test.param(0).is_null()) return;
@@ -0,0 +1,166 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Compares formatting and parsing with a format string that is interpreted on
+// every call against a DateTimeFormatter/DateTimeParser built once.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/public/functions/date_time_util.h"
+#include "zetasql/public/functions/parse_date_time.h"
+#include "zetasql/public/type.pb.h"
+#include "benchmark/benchmark.h"
+#include "absl/time/civil_time.h"
+#include "absl/time/time.h"
+
+namespace zetasql {
+namespace functions {
+namespace {
+
+constexpr FormatDateTimestampOptions kExpandQandJ = {.expand_Q = true,
+                                                     .expand_J = true};
+
+const char* const kFormats[] = {
+    "%Y-%m-%d %H:%M:%S",
+    "%Y-%m-%d %H:%M:%E6S %Z",
+    "%d/%m/%Y",
+    // Falls back to absl::FormatTime().
+    "%a %b %e %H:%M:%S %Y",
+};
+
+const char* const kParseInputs[] = {
+    "2024-02-29 13:14:15",
+    "2024-02-29 13:14:15.123456 UTC",
+    "29/02/2024",
+    "Thu Feb 29 13:14:15 2024",
+};
+
+absl::Time GetTimestamp() {
+  return absl::UTCTimeZone().At(absl::CivilSecond(2024, 2, 29, 13, 14, 15)).pre +
+         absl::Microseconds(123456);
+}
+
+void BM_FormatTimestampToString(benchmark::State& state) {
+  const char* format = kFormats[state.range(0)];
+  const absl::Time timestamp = GetTimestamp();
+  std::string out;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(FormatTimestampToString(format, timestamp, absl::UTCTimeZone(),
+                                     kExpandQandJ, &out));
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetLabel(format);
+}
+BENCHMARK(BM_FormatTimestampToString)->DenseRange(0, 3);
+
+void BM_DateTimeFormatterFormatTimestamp(benchmark::State& state) {
+  const char* format = kFormats[state.range(0)];
+  const DateTimeFormatter formatter(format, TYPE_TIMESTAMP, kExpandQandJ);
+  const absl::Time timestamp = GetTimestamp();
+  std::string out;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(
+        formatter.FormatTimestamp(timestamp, absl::UTCTimeZone(), &out));
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetLabel(format);
+}
+BENCHMARK(BM_DateTimeFormatterFormatTimestamp)->DenseRange(0, 3);
+
+void BM_FormatDatetimeToString(benchmark::State& state) {
+  const char* format = kFormats[state.range(0)];
+  const DatetimeValue datetime =
+      DatetimeValue::FromYMDHMSAndMicros(2024, 2, 29, 13, 14, 15, 123456);
+  std::string out;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(FormatDatetimeToStringWithOptions(format, datetime,
+                                               kExpandQandJ, &out));
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetLabel(format);
+}
+BENCHMARK(BM_FormatDatetimeToString)->DenseRange(0, 3);
+
+void BM_DateTimeFormatterFormatDatetime(benchmark::State& state) {
+  const char* format = kFormats[state.range(0)];
+  const DateTimeFormatter formatter(format, TYPE_DATETIME, kExpandQandJ);
+  const DatetimeValue datetime =
+      DatetimeValue::FromYMDHMSAndMicros(2024, 2, 29, 13, 14, 15, 123456);
+  std::string out;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(formatter.FormatDatetime(datetime, &out));
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetLabel(format);
+}
+BENCHMARK(BM_DateTimeFormatterFormatDatetime)->DenseRange(0, 3);
+
+void BM_ParseStringToTimestamp(benchmark::State& state) {
+  const char* format = kFormats[state.range(0)];
+  const char* input = kParseInputs[state.range(0)];
+  int64_t timestamp;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(ParseStringToTimestamp(format, input, absl::UTCTimeZone(),
+                                    /*parse_version2=*/true, &timestamp));
+    benchmark::DoNotOptimize(timestamp);
+  }
+  state.SetLabel(format);
+}
+BENCHMARK(BM_ParseStringToTimestamp)->DenseRange(0, 3);
+
+void BM_DateTimeParserParseTimestamp(benchmark::State& state) {
+  const char* format = kFormats[state.range(0)];
+  const char* input = kParseInputs[state.range(0)];
+  std::unique_ptr<const DateTimeParser> parser =
+      DateTimeParser::Create(format, TYPE_TIMESTAMP).value();
+  int64_t timestamp;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(parser->ParseTimestamp(input, absl::UTCTimeZone(),
+                                    /*parse_version2=*/true, &timestamp));
+    benchmark::DoNotOptimize(timestamp);
+  }
+  state.SetLabel(format);
+}
+BENCHMARK(BM_DateTimeParserParseTimestamp)->DenseRange(0, 3);
+
+void BM_ParseStringToDate(benchmark::State& state) {
+  int32_t date;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(ParseStringToDate("%d/%m/%Y", "29/02/2024",
+                               /*parse_version2=*/true, &date));
+    benchmark::DoNotOptimize(date);
+  }
+}
+BENCHMARK(BM_ParseStringToDate);
+
+void BM_DateTimeParserParseDate(benchmark::State& state) {
+  std::unique_ptr<const DateTimeParser> parser =
+      DateTimeParser::Create("%d/%m/%Y", TYPE_DATE).value();
+  int32_t date;
+  for (auto s : state) {
+    ZETASQL_CHECK_OK(
+        parser->ParseDate("29/02/2024", /*parse_version2=*/true, &date));
+    benchmark::DoNotOptimize(date);
+  }
+}
+BENCHMARK(BM_DateTimeParserParseDate);
+
+}  // namespace
+}  // namespace functions
+}  // namespace zetasql
@@ -0,0 +1,354 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Tests that DateTimeFormatter and DateTimeParser produce exactly the same
+// results and errors as the Format*ToString() and ParseStringTo*() functions
+// they precompile.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/civil_time.h"
+#include "zetasql/public/functions/date_time_util.h"
+#include "zetasql/public/functions/parse_date_time.h"
+#include "zetasql/public/type.pb.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/time/civil_time.h"
+#include "absl/time/time.h"
+
+namespace zetasql {
+namespace functions {
+namespace {
+
+using zetasql_base::testing::StatusIs;
+
+constexpr FormatDateTimestampOptions kExpandQandJ = {.expand_Q = true,
+                                                     .expand_J = true};
+
+const char* const kFormats[] = {
+    "",
+    "%Y-%m-%d %H:%M:%S",
+    "%F %T",
+    "%E4Y%m%d",
+    "%y/%e/%j",
+    "%H:%M:%E*S",
+    "%H:%M:%E0S",
+    "%H:%M:%E3S",
+    "%H:%M:%E6S",
+    "%H:%M:%E9S",
+    "Quarter %Q of %Y",
+    "%Y-%m-%d %H:%M:%S %Z",
+    "%Y-%m-%d %H:%M:%S%Ez",
+    "%%Y%% %%Q",
+    "%c",
+    "%A %B %d",
+    "%J",
+    "%E*S %s",
+    "%5Y",
+    "trailing %",
+    "%E",
+};
+
+absl::Time TimeFromCivil(absl::CivilSecond cs, int64_t nanos,
+                         absl::TimeZone timezone) {
+  return timezone.At(cs).pre + absl::Nanoseconds(nanos);
+}
+
+// Expects <actual> to match <expected> in both status and output.
+void ExpectSameResult(const absl::Status& expected_status,
+                      const std::string& expected, const absl::Status& status,
+                      const std::string& actual, absl::string_view context) {
+  EXPECT_EQ(expected_status, status) << context;
+  if (expected_status.ok() && status.ok()) {
+    EXPECT_EQ(expected, actual) << context;
+  }
+}
+
+TEST(DateTimeFormatterTest, FormatTimestampMatchesFormatTimestampToString) {
+  absl::TimeZone los_angeles;
+  ASSERT_TRUE(absl::LoadTimeZone("America/Los_Angeles", &los_angeles));
+  absl::TimeZone kolkata;
+  ASSERT_TRUE(absl::LoadTimeZone("Asia/Kolkata", &kolkata));
+  const absl::TimeZone timezones[] = {absl::UTCTimeZone(), los_angeles,
+                                      kolkata,
+                                      absl::FixedTimeZone(-(5 * 60 + 45) * 60)};
+  const absl::TimeZone utc = absl::UTCTimeZone();
+  const absl::Time timestamps[] = {
+      absl::UnixEpoch(),
+      absl::UnixEpoch() - absl::Nanoseconds(1),
+      TimeFromCivil(absl::CivilSecond(2024, 2, 29, 23, 59, 59), 123456789, utc),
+      TimeFromCivil(absl::CivilSecond(2021, 7, 4, 1, 2, 3), 120000, utc),
+      TimeFromCivil(absl::CivilSecond(2021, 11, 7, 9, 30, 0), 0, utc),
+      // Local mean time in America/Los_Angeles has a seconds offset.
+      TimeFromCivil(absl::CivilSecond(1850, 5, 6, 7, 8, 9), 5000, utc),
+      TimeFromCivil(absl::CivilSecond(1, 1, 1, 0, 0, 0), 0, utc),
+      TimeFromCivil(absl::CivilSecond(9999, 12, 31, 23, 59, 59), 999999999,
+                    utc),
+      // Out of range.
+      TimeFromCivil(absl::CivilSecond(10000, 1, 1, 0, 0, 0), 0, utc),
+  };
+  for (const char* format : kFormats) {
+    const DateTimeFormatter formatter(format, TYPE_TIMESTAMP, kExpandQandJ);
+    for (const absl::Time timestamp : timestamps) {
+      for (const absl::TimeZone& timezone : timezones) {
+        std::string expected;
+        const absl::Status expected_status = FormatTimestampToString(
+            format, timestamp, timezone, kExpandQandJ, &expected);
+        std::string actual;
+        const absl::Status status =
+            formatter.FormatTimestamp(timestamp, timezone, &actual);
+        ExpectSameResult(expected_status, expected, status, actual,
+                         absl::StrCat("format: '", format, "' timestamp: ",
+                                      absl::FormatTime(timestamp),
+                                      " timezone: ", timezone.name()));
+      }
+    }
+  }
+}
+
+TEST(DateTimeFormatterTest, FormatCivilTimesMatchFormatFunctions) {
+  const int32_t dates[] = {0, -1, 19782, -719162, 2932896, 2932897};
+  const DatetimeValue datetimes[] = {
+      DatetimeValue::FromYMDHMSAndNanos(2024, 2, 29, 13, 14, 15, 123456789),
+      DatetimeValue::FromYMDHMSAndNanos(1, 1, 1, 0, 0, 0, 0),
+      DatetimeValue::FromYMDHMSAndNanos(9999, 12, 31, 23, 59, 59, 999999000),
+  };
+  const TimeValue times[] = {
+      TimeValue::FromHMSAndNanos(0, 0, 0, 0),
+      TimeValue::FromHMSAndNanos(7, 8, 9, 100),
+      TimeValue::FromHMSAndNanos(23, 59, 59, 999999999),
+  };
+  for (const char* format : kFormats) {
+    const std::string context = absl::StrCat("format: '", format, "'");
+    const DateTimeFormatter date_formatter(format, TYPE_DATE, kExpandQandJ);
+    for (const int32_t date : dates) {
+      std::string expected;
+      const absl::Status expected_status =
+          FormatDateToString(format, date, kExpandQandJ, &expected);
+      std::string actual;
+      const absl::Status status = date_formatter.FormatDate(date, &actual);
+      ExpectSameResult(expected_status, expected, status, actual,
+                       absl::StrCat(context, " date: ", date));
+    }
+
+    const DateTimeFormatter datetime_formatter(format, TYPE_DATETIME,
+                                               kExpandQandJ);
+    for (const DatetimeValue& datetime : datetimes) {
+      std::string expected;
+      const absl::Status expected_status = FormatDatetimeToStringWithOptions(
+          format, datetime, kExpandQandJ, &expected);
+      std::string actual;
+      const absl::Status status =
+          datetime_formatter.FormatDatetime(datetime, &actual);
+      ExpectSameResult(
+          expected_status, expected, status, actual,
+          absl::StrCat(context, " datetime: ", datetime.DebugString()));
+    }
+
+    const DateTimeFormatter time_formatter(format, TYPE_TIME, kExpandQandJ);
+    for (const TimeValue& time : times) {
+      std::string expected;
+      const absl::Status expected_status =
+          FormatTimeToString(format, time, &expected);
+      std::string actual;
+      const absl::Status status = time_formatter.FormatTime(time, &actual);
+      ExpectSameResult(expected_status, expected, status, actual,
+                       absl::StrCat(context, " time: ", time.DebugString()));
+    }
+  }
+}
+
+TEST(DateTimeFormatterTest, IsNative) {
+  EXPECT_TRUE(DateTimeFormatter("%Y-%m-%d %H:%M:%E6S %Z", TYPE_TIMESTAMP,
+                                kExpandQandJ)
+                  .is_native());
+  EXPECT_TRUE(
+      DateTimeFormatter("%F %T", TYPE_DATETIME, kExpandQandJ).is_native());
+  // Escaped elements are literal text.
+  EXPECT_TRUE(DateTimeFormatter("%H:%M", TYPE_DATE, kExpandQandJ).is_native());
+  EXPECT_FALSE(DateTimeFormatter("%c", TYPE_TIMESTAMP, kExpandQandJ)
+                   .is_native());
+  EXPECT_FALSE(
+      DateTimeFormatter("%Q", TYPE_TIMESTAMP,
+                        {.expand_Q = false, .expand_J = false})
+          .is_native());
+}
+
+TEST(DateTimeParserTest, CreateRejectsElementsNotAllowedForType) {
+  int32_t date;
+  const absl::Status expected = ParseStringToDate(
+      "%Y-%m-%d %H", "2020-01-01 10", /*parse_version2=*/true, &date);
+  ASSERT_FALSE(expected.ok());
+  EXPECT_EQ(DateTimeParser::Create("%Y-%m-%d %H", TYPE_DATE).status(),
+            expected);
+  EXPECT_THAT(DateTimeParser::Create("%Y", TYPE_TIME),
+              StatusIs(absl::StatusCode::kOutOfRange));
+  EXPECT_THAT(DateTimeParser::Create("%z", TYPE_DATETIME),
+              StatusIs(absl::StatusCode::kOutOfRange));
+  EXPECT_THAT(DateTimeParser::Create("%Y", TYPE_INT64),
+              StatusIs(absl::StatusCode::kInternal));
+}
+
+struct ParseTestCase {
+  const char* format;
+  std::vector<std::string> inputs;
+};
+
+std::vector<ParseTestCase> GetParseTestCases() {
+  const std::vector<std::string> datetime_inputs = {
+      "2024-02-29 13:14:15",
+      "  2024-02-29   13:14:15  ",
+      "2024-02-29 13:14:15.123456789",
+      "2024-2-9 3:4:5",
+      "2024-02-30 13:14:15",
+      "2024-13-01 13:14:15",
+      "2024-02-29 23:59:60",
+      "2024-02-29 23:59:60.5",
+      "2024-02-29",
+      "2024-02-29 13:14:15 extra",
+      "2024/02/29 13:14:15",
+      "10000-01-01 00:00:00",
+      "0000-12-31 00:00:00",
+      "-2024-02-29 13:14:15",
+      std::string("2024-02-29 13:14:15\0", 20),
+      "",
+  };
+  return {
+      {"%Y-%m-%d %H:%M:%S", datetime_inputs},
+      {"%Y-%m-%d %H:%M:%E*S", datetime_inputs},
+      {"%Y-%m-%d %H:%M:%E3S", datetime_inputs},
+      {"%Y-%m-%d %H:%M:%E9S", datetime_inputs},
+      {"%Y-%m-%d %H:%M:%E0S", datetime_inputs},
+      {"%F %T", datetime_inputs},
+      {"%Y-%m-%d", {"2024-02-29", "2024-2-29 ", "20240229", "9999-12-31"}},
+      {"%Y%m%d", {"20240229", "2024229", "202402290", "1-1-1"}},
+      {"%Y-%m-%d %H:%M:%S%Ez",
+       {"2024-02-29 13:14:15+05:30", "2024-02-29 13:14:15Z",
+        "2024-02-29 13:14:15-14:01", "2024-02-29 13:14:15+0530",
+        "2024-02-29 13:14:15+5:30", "0001-01-01 00:00:00+01:00"}},
+      {"%Y-%m-%d %H:%M:%S %z",
+       {"2024-02-29 13:14:15 +0530", "2024-02-29 13:14:15 -1400",
+        "2024-02-29 13:14:15 +1401", "2024-02-29 13:14:15 Z",
+        "2024-02-29 13:14:15 +05"}},
+      {"%H:%M:%E*S", {"13:14:15.5", "00:00:00", "24:00:00", "13:14"}},
+      {"%Y-%m-%d %Z", {"2024-02-29 America/Los_Angeles", "2024-02-29 UTC"}},
+      {"%A %d %B %Y", {"Thursday 29 February 2024", "Thu 29 Feb 2024"}},
+      {"%Y-%j", {"2024-060", "2024-367"}},
+      {"%s", {"1709212455", "abc"}},
+      {"%Y %", {"2024 %"}},
+  };
+}
+
+TEST(DateTimeParserTest, ParseTimestampMatchesParseStringToTimestamp) {
+  absl::TimeZone los_angeles;
+  ASSERT_TRUE(absl::LoadTimeZone("America/Los_Angeles", &los_angeles));
+  for (const ParseTestCase& test : GetParseTestCases()) {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<const DateTimeParser> parser,
+                         DateTimeParser::Create(test.format, TYPE_TIMESTAMP));
+    for (const std::string& input : test.inputs) {
+      for (const absl::TimeZone& timezone :
+           {absl::UTCTimeZone(), los_angeles}) {
+        const std::string context =
+            absl::StrCat("format: '", test.format, "' input: '", input,
+                         "' timezone: ", timezone.name());
+        int64_t expected_micros = 0;
+        int64_t micros = 0;
+        EXPECT_EQ(ParseStringToTimestamp(test.format, input, timezone,
+                                         /*parse_version2=*/true,
+                                         &expected_micros),
+                  parser->ParseTimestamp(input, timezone,
+                                         /*parse_version2=*/true, &micros))
+            << context;
+        EXPECT_EQ(expected_micros, micros) << context;
+
+        absl::Time expected_time;
+        absl::Time time;
+        const absl::Status expected_status =
+            ParseStringToTimestamp(test.format, input, timezone,
+                                   /*parse_version2=*/true, &expected_time);
+        const absl::Status status = parser->ParseTimestamp(
+            input, timezone, /*parse_version2=*/true, &time);
+        EXPECT_EQ(expected_status, status) << context;
+        if (expected_status.ok() && status.ok()) {
+          EXPECT_EQ(expected_time, time) << context;
+        }
+      }
+    }
+  }
+}
+
+TEST(DateTimeParserTest, ParseCivilTimesMatchParseFunctions) {
+  for (const ParseTestCase& test : GetParseTestCases()) {
+    for (const std::string& input : test.inputs) {
+      const std::string context =
+          absl::StrCat("format: '", test.format, "' input: '", input, "'");
+      if (auto parser = DateTimeParser::Create(test.format, TYPE_DATE);
+          parser.ok()) {
+        int32_t expected = 0;
+        int32_t actual = 0;
+        EXPECT_EQ(ParseStringToDate(test.format, input,
+                                    /*parse_version2=*/true, &expected),
+                  (*parser)->ParseDate(input, /*parse_version2=*/true,
+                                       &actual))
+            << context;
+        EXPECT_EQ(expected, actual) << context;
+      }
+      for (const TimestampScale scale : {kMicroseconds, kNanoseconds}) {
+        if (auto parser = DateTimeParser::Create(test.format, TYPE_DATETIME);
+            parser.ok()) {
+          DatetimeValue expected;
+          DatetimeValue actual;
+          EXPECT_EQ(ParseStringToDatetime(test.format, input, scale,
+                                          /*parse_version2=*/true, &expected),
+                    (*parser)->ParseDatetime(input, scale,
+                                             /*parse_version2=*/true, &actual))
+              << context;
+          EXPECT_EQ(expected.DebugString(), actual.DebugString()) << context;
+        }
+        if (auto parser = DateTimeParser::Create(test.format, TYPE_TIME);
+            parser.ok()) {
+          TimeValue expected;
+          TimeValue actual;
+          EXPECT_EQ(ParseStringToTime(test.format, input, scale, &expected),
+                    (*parser)->ParseTime(input, scale, &actual))
+              << context;
+          EXPECT_EQ(expected.DebugString(), actual.DebugString()) << context;
+        }
+      }
+    }
+  }
+}
+
+TEST(DateTimeParserTest, IsNative) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto parser,
+      DateTimeParser::Create("%Y-%m-%d %H:%M:%E*S%Ez", TYPE_TIMESTAMP));
+  EXPECT_TRUE(parser->is_native());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(parser, DateTimeParser::Create("%F %T", TYPE_DATETIME));
+  EXPECT_FALSE(parser->is_native());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(parser, DateTimeParser::Create("%Y-%j", TYPE_DATE));
+  EXPECT_FALSE(parser->is_native());
+}
+
+}  // namespace
+}  // namespace functions
+}  // namespace zetasql
@@ -302,6 +302,107 @@ static bool IsValidTimeOfDay(int hour, int minute, int second) {
   return true;
 }
 
+// Parses exactly <num_digits> ASCII digits starting at <p> into <value>.
+static bool ParseFixedDigits(const char* p, int num_digits, int* value) {
+  int result = 0;
+  for (int i = 0; i < num_digits; ++i) {
+    const unsigned digit = static_cast<unsigned char>(p[i]) - '0';
+    if (digit > 9) return false;
+    result = result * 10 + static_cast<int>(digit);
+  }
+  *value = result;
+  return true;
+}
+
+// Returns the number of days between 1970-01-01 and the given date in the
+// proleptic Gregorian calendar. Requires a valid date with <year> >= 1.
+static int64_t DaysSinceEpoch(int year, int month, int day) {
+  year -= month <= 2;
+  const int era = year / 400;
+  const int year_of_era = year - era * 400;
+  const int day_of_year =
+      (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  const int day_of_era =
+      year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+  return static_cast<int64_t>(era) * 146097 + day_of_era - 719468;
+}
+
+// Fast path for the canonical 'YYYY-MM-DD' layout. Returns false for anything
+// else, including invalid dates, so that the caller can take the general path
+// and produce the usual error.
+static bool ParseCanonicalDate(absl::string_view str, int64_t* days) {
+  if (str.size() < 10 || str[4] != '-' || str[7] != '-') return false;
+  int year, month, day;
+  if (!ParseFixedDigits(str.data(), 4, &year) ||
+      !ParseFixedDigits(str.data() + 5, 2, &month) ||
+      !ParseFixedDigits(str.data() + 8, 2, &day)) {
+    return false;
+  }
+  static constexpr int kDaysInMonth[] = {0,  31, 29, 31, 30, 31, 30,
+                                         31, 31, 30, 31, 30, 31};
+  if (year < 1 || month < 1 || month > 12 || day < 1 ||
+      day > kDaysInMonth[month]) {
+    return false;
+  }
+  if (month == 2 && day == 29 &&
+      (year % 4 != 0 || (year % 100 == 0 && year % 400 != 0))) {
+    return false;
+  }
+  *days = DaysSinceEpoch(year, month, day);
+  return true;
+}
+
+// Fast path for 'YYYY-MM-DD[( |T|t)HH:MM:SS[.F]][(Z|z| UTC)]', with at most
+// <scale> subsecond digits. On success returns the civil time as seconds since
+// the epoch as if it were UTC, the subsecond part normalized to <scale>, and
+// whether the string ends with a UTC designator. Anything else, including
+// invalid values, returns false so that the general path produces the error.
+static bool ParseCanonicalTimestamp(absl::string_view str, TimestampScale scale,
+                                    int64_t* civil_seconds, int* subsecond,
+                                    bool* is_utc) {
+  int64_t days;
+  if (!ParseCanonicalDate(str, &days)) return false;
+  *civil_seconds = days * kNaiveNumSecondsPerDay;
+  *subsecond = 0;
+  *is_utc = false;
+  if (str.size() == 10) return true;
+
+  if (str.size() < 19 || (str[10] != ' ' && str[10] != 'T' && str[10] != 't') ||
+      str[13] != ':' || str[16] != ':') {
+    return false;
+  }
+  int hour, minute, second;
+  if (!ParseFixedDigits(str.data() + 11, 2, &hour) ||
+      !ParseFixedDigits(str.data() + 14, 2, &minute) ||
+      !ParseFixedDigits(str.data() + 17, 2, &second) ||
+      !IsValidTimeOfDay(hour, minute, second)) {
+    return false;
+  }
+  *civil_seconds += hour * kNaiveNumSecondsPerHour +
+                    minute * kNaiveNumSecondsPerMinute + second;
+
+  absl::string_view rest = str.substr(19);
+  if (absl::ConsumePrefix(&rest, ".")) {
+    size_t num_digits = 0;
+    while (num_digits < rest.size() && absl::ascii_isdigit(rest[num_digits])) {
+      ++num_digits;
+    }
+    if (num_digits == 0 || num_digits > static_cast<size_t>(scale) ||
+        !ParseFixedDigits(rest.data(), static_cast<int>(num_digits),
+                          subsecond)) {
+      return false;
+    }
+    *subsecond *= powers_of_ten[scale - num_digits];
+    rest.remove_prefix(num_digits);
+  }
+  if (rest.empty()) return true;
+  if (rest == "Z" || rest == "z" || rest == " UTC") {
+    *is_utc = true;
+    return true;
+  }
+  return false;
+}
+
 static std::string DateErrorString(int32_t date) {
   std::string out;
   if (!ConvertDateToString(date, &out).ok()) {
@@ -1074,6 +1175,37 @@ static void NarrowTimestampIfPossible(int64_t* timestamp,
   }
 }
 
+// Appends the ZetaSQL rendering of %Z for a time zone that is <seconds>
+// east of UTC, i.e. 'UTC[+/-HH[MM]]'.  <seconds> must be a whole number of
+// minutes.
+static absl::Status AppendPercentZ(int seconds, std::string* out) {
+  absl::StrAppend(out, "UTC");
+  if (seconds == 0) {
+    return absl::OkStatus();
+  }
+  const char sign = (seconds < 0 ? '-' : '+');
+  int minutes = seconds / 60;
+  seconds %= 60;
+  if (sign == '-') {
+    if (seconds > 0) {
+      seconds -= 60;
+      minutes += 1;
+    }
+    seconds = -seconds;
+    minutes = -minutes;
+  }
+  int hours = minutes / 60;
+  minutes %= 60;
+  out->push_back(sign);
+  ZETASQL_RET_CHECK_EQ(seconds, 0);
+  if (minutes != 0) {
+    absl::StrAppend(out, absl::StrFormat("%02d%02d", hours, minutes));
+  } else {
+    absl::StrAppend(out, absl::StrFormat("%d", hours));
+  }
+  return absl::OkStatus();
+}
+
 static absl::Status FormatTimestampToStringInternal(
     absl::string_view format_string, absl::Time base_time,
     absl::TimeZone timezone,
@@ -2124,6 +2256,305 @@ absl::Status FormatTimeToString(absl::string_view format_string,
   return absl::OkStatus();
 }
 
+// Appends <value> zero-padded to <width> digits.  <value> must not be
+// negative.
+static void AppendZeroPadded(int64_t value, int width, std::string* out) {
+  char buffer[20];
+  char* const end = buffer + sizeof(buffer);
+  char* p = end;
+  do {
+    *--p = static_cast<char>('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+  while (end - p < width) *--p = '0';
+  out->append(p, end - p);
+}
+
+DateTimeFormatter::DateTimeFormatter(
+    absl::string_view format_string, TypeKind target_type,
+    const FormatDateTimestampOptions& format_options)
+    : target_type_(target_type),
+      // TIME does not support %Q or %J.
+      format_options_(target_type == TYPE_TIME
+                          ? FormatDateTimestampOptions{.expand_Q = false,
+                                                       .expand_J = false}
+                          : format_options) {
+  switch (target_type) {
+    case TYPE_DATE:
+      SanitizeDateFormat(format_string, &sanitized_format_);
+      break;
+    case TYPE_DATETIME:
+      SanitizeDatetimeFormat(format_string, &sanitized_format_);
+      break;
+    case TYPE_TIME:
+      SanitizeTimeFormat(format_string, &sanitized_format_);
+      break;
+    default:
+      ZETASQL_DCHECK_EQ(target_type, TYPE_TIMESTAMP);
+      sanitized_format_ = std::string(format_string);
+      break;
+  }
+  native_ = Decode();
+  if (!native_) {
+    elements_.clear();
+    needs_subseconds_ = false;
+  }
+}
+
+bool DateTimeFormatter::Decode() {
+  const absl::string_view format = sanitized_format_;
+  std::string literal;
+  auto add = [this, &literal](Element::Kind kind, int digits = 0) {
+    if (!literal.empty()) {
+      elements_.push_back({Element::kLiteral, 0, std::move(literal)});
+      literal.clear();
+    }
+    elements_.push_back({kind, digits, ""});
+  };
+
+  size_t i = 0;
+  while (i < format.size()) {
+    if (format[i] != '%') {
+      literal.push_back(format[i++]);
+      continue;
+    }
+    // A trailing single '%' is left to absl::FormatTime().
+    if (i + 1 == format.size()) return false;
+    const char element = format[i + 1];
+    i += 2;
+    switch (element) {
+      case '%':
+        literal.push_back('%');
+        break;
+      case 'Y':
+        add(Element::kYear);
+        break;
+      case 'y':
+        add(Element::kYear2);
+        break;
+      case 'm':
+        add(Element::kMonth);
+        break;
+      case 'd':
+        add(Element::kDay);
+        break;
+      case 'e':
+        add(Element::kDaySpacePadded);
+        break;
+      case 'j':
+        add(Element::kDayOfYear);
+        break;
+      case 'H':
+        add(Element::kHour);
+        break;
+      case 'M':
+        add(Element::kMinute);
+        break;
+      case 'S':
+        add(Element::kSecond);
+        break;
+      case 'F':
+        add(Element::kYear);
+        literal.push_back('-');
+        add(Element::kMonth);
+        literal.push_back('-');
+        add(Element::kDay);
+        break;
+      case 'T':
+        add(Element::kHour);
+        literal.push_back(':');
+        add(Element::kMinute);
+        literal.push_back(':');
+        add(Element::kSecond);
+        break;
+      case 'Q':
+        if (!format_options_.expand_Q) return false;
+        add(Element::kQuarter);
+        break;
+      case 'Z':
+        add(Element::kTimeZone);
+        break;
+      case 'E': {
+        if (i + 1 >= format.size()) return false;
+        const char modifier = format[i];
+        const char extended = format[i + 1];
+        i += 2;
+        if (modifier == '4' && extended == 'Y') {
+          add(Element::kYear4);
+        } else if (modifier == '*' && extended == 'S') {
+          add(Element::kSecond);
+          add(Element::kSubseconds, -1);
+          needs_subseconds_ = true;
+        } else if (absl::ascii_isdigit(modifier) && extended == 'S') {
+          add(Element::kSecond);
+          if (modifier != '0') {
+            add(Element::kSubseconds, modifier - '0');
+            needs_subseconds_ = true;
+          }
+        } else {
+          return false;
+        }
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  if (!literal.empty()) {
+    elements_.push_back({Element::kLiteral, 0, std::move(literal)});
+  }
+  return true;
+}
+
+absl::Status DateTimeFormatter::FormatInternal(absl::Time base_time,
+                                               absl::TimeZone timezone,
+                                               std::string* out) const {
+  const internal_functions::ExpansionOptions expansion_options = {
+      .truncate_tz = false,
+      .expand_quarter = format_options_.expand_Q,
+      .expand_iso_dayofyear = format_options_.expand_J};
+  if (!native_) {
+    return FormatTimestampToStringInternal(sanitized_format_, base_time,
+                                           timezone, expansion_options, out);
+  }
+  if (!IsValidTime(base_time)) {
+    return MakeEvalError() << "Invalid timestamp value: "
+                           << absl::ToUnixMicros(base_time);
+  }
+
+  int64_t nanos = 0;
+  if (needs_subseconds_) {
+    const absl::Duration subseconds =
+        base_time - absl::FromUnixSeconds(absl::ToUnixSeconds(base_time));
+    nanos = absl::ToInt64Nanoseconds(subseconds);
+    if (absl::Nanoseconds(nanos) != subseconds) {
+      // absl::FormatTime() renders digits beyond nanoseconds for %E*S.
+      return FormatTimestampToStringInternal(sanitized_format_, base_time,
+                                             timezone, expansion_options, out);
+    }
+  }
+
+  const absl::TimeZone normalized_timezone =
+      internal_functions::GetNormalizedTimeZone(base_time, timezone);
+  const absl::TimeZone::CivilInfo info = normalized_timezone.At(base_time);
+  const absl::CivilSecond& cs = info.cs;
+
+  out->clear();
+  for (const Element& element : elements_) {
+    switch (element.kind) {
+      case Element::kLiteral:
+        out->append(element.literal);
+        break;
+      case Element::kYear:
+        absl::StrAppend(out, cs.year());
+        break;
+      case Element::kYear4:
+        AppendZeroPadded(cs.year(), 4, out);
+        break;
+      case Element::kYear2:
+        AppendZeroPadded(cs.year() % 100, 2, out);
+        break;
+      case Element::kMonth:
+        AppendZeroPadded(cs.month(), 2, out);
+        break;
+      case Element::kDay:
+        AppendZeroPadded(cs.day(), 2, out);
+        break;
+      case Element::kDaySpacePadded:
+        if (cs.day() < 10) out->push_back(' ');
+        AppendZeroPadded(cs.day(), 1, out);
+        break;
+      case Element::kDayOfYear:
+        AppendZeroPadded(absl::GetYearDay(absl::CivilDay(cs)), 3, out);
+        break;
+      case Element::kHour:
+        AppendZeroPadded(cs.hour(), 2, out);
+        break;
+      case Element::kMinute:
+        AppendZeroPadded(cs.minute(), 2, out);
+        break;
+      case Element::kSecond:
+        AppendZeroPadded(cs.second(), 2, out);
+        break;
+      case Element::kSubseconds: {
+        if (element.digits < 0) {
+          // %E*S omits the fraction entirely if it is zero, and otherwise
+          // drops trailing zeros.
+          if (nanos == 0) break;
+          int64_t fraction = nanos;
+          int digits = 9;
+          while (fraction % 10 == 0) {
+            fraction /= 10;
+            --digits;
+          }
+          out->push_back('.');
+          AppendZeroPadded(fraction, digits, out);
+        } else {
+          int64_t fraction = nanos;
+          for (int d = element.digits; d < 9; ++d) fraction /= 10;
+          out->push_back('.');
+          AppendZeroPadded(fraction, element.digits, out);
+        }
+        break;
+      }
+      case Element::kQuarter:
+        AppendZeroPadded((cs.month() - 1) / 3 + 1, 1, out);
+        break;
+      case Element::kTimeZone:
+        ZETASQL_RETURN_IF_ERROR(AppendPercentZ(info.offset, out));
+        break;
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status DateTimeFormatter::FormatDate(int32_t date,
+                                           std::string* out) const {
+  ZETASQL_DCHECK_EQ(target_type_, TYPE_DATE);
+  if (!IsValidDate(date)) {
+    return MakeEvalError() << "Invalid date value: " << date;
+  }
+  return FormatInternal(
+      MakeTime(static_cast<int64_t>(date) * kNaiveNumMicrosPerDay,
+               kMicroseconds),
+      absl::UTCTimeZone(), out);
+}
+
+absl::Status DateTimeFormatter::FormatDatetime(const DatetimeValue& datetime,
+                                               std::string* out) const {
+  ZETASQL_DCHECK_EQ(target_type_, TYPE_DATETIME);
+  if (!datetime.IsValid()) {
+    return MakeEvalError() << "Invalid datetime value: "
+                           << datetime.DebugString();
+  }
+  const absl::Time datetime_in_utc =
+      absl::UTCTimeZone().At(datetime.ConvertToCivilSecond()).pre +
+      absl::Nanoseconds(datetime.Nanoseconds());
+  return FormatInternal(datetime_in_utc, absl::UTCTimeZone(), out);
+}
+
+absl::Status DateTimeFormatter::FormatTime(const TimeValue& time,
+                                           std::string* out) const {
+  ZETASQL_DCHECK_EQ(target_type_, TYPE_TIME);
+  if (!time.IsValid()) {
+    return MakeEvalError() << "Invalid time value: " << time.DebugString();
+  }
+  const absl::Time time_in_epoch_day =
+      absl::UTCTimeZone()
+          .At(absl::CivilSecond(1970, 1, 1, time.Hour(), time.Minute(),
+                                time.Second()))
+          .pre +
+      absl::Nanoseconds(time.Nanoseconds());
+  return FormatInternal(time_in_epoch_day, absl::UTCTimeZone(), out);
+}
+
+absl::Status DateTimeFormatter::FormatTimestamp(absl::Time timestamp,
+                                                absl::TimeZone timezone,
+                                                std::string* out) const {
+  ZETASQL_DCHECK_EQ(target_type_, TYPE_TIMESTAMP);
+  return FormatInternal(timestamp, timezone, out);
+}
+
 absl::Status FormatTimestampToString(
     absl::string_view format_str, absl::Time timestamp, absl::TimeZone timezone,
     const FormatDateTimestampOptions& format_options, std::string* out) {
@@ -2259,6 +2690,12 @@ absl::Status MakeTimeZone(absl::string_view timezone_string,
 }
 
 absl::Status ConvertStringToDate(absl::string_view str, int32_t* date) {
+  int64_t days;
+  if (ABSL_PREDICT_TRUE(str.size() == 10 && ParseCanonicalDate(str, &days))) {
+    *date = static_cast<int32_t>(days);
+    ZETASQL_DCHECK(IsValidDate(*date));
+    return absl::OkStatus();
+  }
   int year = 0, month = 0, day = 0, idx = 0;
   if (!ParseStringToDateParts(str, &idx, &year, &month, &day) ||
       !IsValidDay(year, month, day)) {
@@ -2281,6 +2718,31 @@ absl::StatusOr<int32_t> ConvertCivilDayToDate(absl::CivilDay civil_day) {
   return date;
 }
 
+// Converts <str> using ParseCanonicalTimestamp(). Returns false if the fast
+// path does not apply or the result is out of range.
+static bool ConvertCanonicalStringToTimestamp(absl::string_view str,
+                                              absl::TimeZone default_timezone,
+                                              TimestampScale scale,
+                                              bool allow_tz_in_str,
+                                              absl::Time* output) {
+  int64_t civil_seconds;
+  int subsecond;
+  bool is_utc;
+  if (!ParseCanonicalTimestamp(str, scale, &civil_seconds, &subsecond,
+                               &is_utc) ||
+      (is_utc && !allow_tz_in_str)) {
+    return false;
+  }
+  if (is_utc || default_timezone == absl::UTCTimeZone()) {
+    *output = absl::FromUnixSeconds(civil_seconds);
+  } else {
+    *output =
+        default_timezone.At(absl::CivilSecond(1970, 1, 1) + civil_seconds).pre;
+  }
+  *output += MakeDuration(subsecond, scale);
+  return IsValidTime(*output);
+}
+
 absl::Status ConvertStringToTimestamp(absl::string_view str,
                                       absl::TimeZone default_timezone,
                                       TimestampScale scale,
@@ -2331,6 +2793,10 @@ absl::Status ConvertStringToTimestamp(absl::string_view str,
                                       TimestampScale scale,
                                       bool allow_tz_in_str,
                                       absl::Time* output) {
+  if (ABSL_PREDICT_TRUE(ConvertCanonicalStringToTimestamp(
+          str, default_timezone, scale, allow_tz_in_str, output))) {
+    return absl::OkStatus();
+  }
   int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
   int subsecond = 0;
   bool string_includes_timezone = false;
@@ -4309,30 +4775,8 @@ absl::Status ExpandPercentZQJ(absl::string_view format_string,
               (absl::ToCivilMonth(base_time, timezone).month() - 1) / 3 + 1));
     } else if (format_string[pct + 1] == 'Z') {
       // Handle %Z, computing the ZetaSQL defined timezone format.
-      absl::StrAppend(expanded_format_string, "UTC");
-      if (int seconds = timezone.At(base_time).offset) {
-        const char sign = (seconds < 0 ? '-' : '+');
-        int minutes = seconds / 60;
-        seconds %= 60;
-        if (sign == '-') {
-          if (seconds > 0) {
-            seconds -= 60;
-            minutes += 1;
-          }
-          seconds = -seconds;
-          minutes = -minutes;
-        }
-        int hours = minutes / 60;
-        minutes %= 60;
-        expanded_format_string->push_back(sign);
-        ZETASQL_RET_CHECK_EQ(seconds, 0);
-        if (minutes != 0) {
-          absl::StrAppend(expanded_format_string,
-                          absl::StrFormat("%02d%02d", hours, minutes));
-        } else {
-          absl::StrAppend(expanded_format_string, absl::StrFormat("%d", hours));
-        }
-      }
+      ZETASQL_RETURN_IF_ERROR(AppendPercentZ(timezone.At(base_time).offset,
+                                     expanded_format_string));
     } else if (expansion_options.expand_iso_dayofyear &&
                format_string[pct + 1] == 'J') {
       // Handle %J, computing ISO day of year.
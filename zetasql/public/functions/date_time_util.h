@@ -18,7 +18,9 @@
 #define ZETASQL_PUBLIC_FUNCTIONS_DATE_TIME_UTIL_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "google/protobuf/timestamp.pb.h"
 #include "google/type/date.pb.h"
@@ -26,6 +28,7 @@
 #include "zetasql/public/functions/datetime.pb.h"
 #include "zetasql/public/interval_value.h"
 #include "zetasql/public/proto/type_annotation.pb.h"
+#include "zetasql/public/type.pb.h"
 #include "absl/base/attributes.h"
 #include <cstdint>
 #include "absl/base/macros.h"
@@ -293,6 +296,91 @@ absl::Status FormatDatetimeToString(absl::string_view format_string,
 absl::Status FormatTimeToString(absl::string_view format_string,
                                 const TimeValue& time, std::string* out);
 
+// A FORMAT_* format string that has been sanitized and decoded once, so that
+// it can be applied to many values without re-scanning the format string.
+// Results and errors are identical to the Format*ToString() functions above.
+//
+// Formats made up only of literal text and the common numeric elements
+// (%Y, %E4Y, %y, %m, %d, %e, %j, %H, %M, %S, %E#S, %E*S, %F, %T, %Q and %Z)
+// are rendered directly from the civil time fields.  Any other element makes
+// the formatter fall back to absl::FormatTime() with the pre-sanitized
+// format string.
+class DateTimeFormatter {
+ public:
+  // <target_type> must be one of TYPE_DATE, TYPE_DATETIME, TYPE_TIME or
+  // TYPE_TIMESTAMP, and determines which format elements are escaped.
+  // <format_options> are ignored for TYPE_TIME, which never expands %Q or %J.
+  DateTimeFormatter(absl::string_view format_string, TypeKind target_type,
+                    const FormatDateTimestampOptions& format_options);
+
+  DateTimeFormatter(const DateTimeFormatter&) = delete;
+  DateTimeFormatter& operator=(const DateTimeFormatter&) = delete;
+
+  // Equivalent to FormatDateToString(format_string, date, format_options).
+  // Requires TYPE_DATE.
+  absl::Status FormatDate(int32_t date, std::string* out) const;
+
+  // Equivalent to FormatDatetimeToStringWithOptions().  Requires
+  // TYPE_DATETIME.
+  absl::Status FormatDatetime(const DatetimeValue& datetime,
+                              std::string* out) const;
+
+  // Equivalent to FormatTimeToString().  Requires TYPE_TIME.
+  absl::Status FormatTime(const TimeValue& time, std::string* out) const;
+
+  // Equivalent to FormatTimestampToString(format_string, timestamp, timezone,
+  // format_options).  Requires TYPE_TIMESTAMP.
+  absl::Status FormatTimestamp(absl::Time timestamp, absl::TimeZone timezone,
+                               std::string* out) const;
+
+  // Returns true if the format is rendered without absl::FormatTime().
+  bool is_native() const { return native_; }
+
+ private:
+  // One decoded piece of the format string.
+  struct Element {
+    enum Kind {
+      kLiteral,
+      kYear,            // %Y
+      kYear4,           // %E4Y
+      kYear2,           // %y
+      kMonth,           // %m
+      kDay,             // %d
+      kDaySpacePadded,  // %e
+      kDayOfYear,       // %j
+      kHour,            // %H
+      kMinute,          // %M
+      kSecond,          // %S
+      kSubseconds,      // The fraction of %E#S (#>0) and %E*S.
+      kQuarter,         // %Q
+      kTimeZone,        // %Z
+    };
+    Kind kind;
+    // For kSubseconds, the number of digits, or -1 for %E*S.
+    int digits = 0;
+    // For kLiteral, the text to copy to the output.
+    std::string literal;
+  };
+
+  // Decodes <sanitized_format_> into <elements_>.  Returns false if the
+  // format contains an element that is not rendered natively.
+  bool Decode();
+
+  // Formats <base_time> in <timezone>.
+  absl::Status FormatInternal(absl::Time base_time, absl::TimeZone timezone,
+                              std::string* out) const;
+
+  const TypeKind target_type_;
+  const FormatDateTimestampOptions format_options_;
+  // The format string after escaping the elements not valid for
+  // <target_type_>.
+  std::string sanitized_format_;
+  // Decoded <sanitized_format_>; only populated if <native_> is true.
+  std::vector<Element> elements_;
+  bool native_ = false;
+  bool needs_subseconds_ = false;
+};
+
 // Converts the string representation of a date to a date value.
 // Supported format: "YYYY-[M]M-[D]D".
 // Returns error status if conversion fails.
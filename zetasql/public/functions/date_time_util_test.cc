@@ -0,0 +1,149 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/functions/date_time_util.h"
+
+#include <cstdint>
+#include <string>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/time/civil_time.h"
+#include "absl/time/time.h"
+
+namespace zetasql {
+namespace functions {
+namespace {
+
+using zetasql_base::testing::StatusIs;
+
+TEST(ConvertStringToDateTest, CanonicalLayout) {
+  const absl::CivilDay epoch(1970, 1, 1);
+  // Every day of the years around the epoch and a sample of all others.
+  for (absl::CivilDay day(1, 1, 1); day <= absl::CivilDay(9999, 12, 31);
+       day += (day.year() >= 1899 && day.year() <= 2101) ? 1 : 97) {
+    const std::string str =
+        absl::StrFormat("%04d-%02d-%02d", day.year(), day.month(), day.day());
+    SCOPED_TRACE(str);
+    int32_t date;
+    ZETASQL_ASSERT_OK(ConvertStringToDate(str, &date));
+    ASSERT_EQ(date, day - epoch);
+  }
+}
+
+TEST(ConvertStringToDateTest, CanonicalLayoutErrors) {
+  int32_t date;
+  for (const char* str : {"2023-02-29", "1900-02-29", "2024-13-01",
+                          "2024-00-10", "2024-01-00", "2024-01-32",
+                          "2024-04-31", "2024-01-0a", "2024-01-01 "}) {
+    EXPECT_THAT(ConvertStringToDate(str, &date),
+                StatusIs(absl::StatusCode::kOutOfRange,
+                         absl::StrCat("Invalid date: '", str, "'")));
+  }
+  EXPECT_THAT(ConvertStringToDate("0000-12-31", &date),
+              StatusIs(absl::StatusCode::kOutOfRange,
+                       "Date value out of range: '0000-12-31'"));
+  ZETASQL_EXPECT_OK(ConvertStringToDate("2000-02-29", &date));
+  EXPECT_EQ(date, 11016);
+}
+
+// The canonical 'YYYY-MM-DD...' layout takes a fast path in
+// ConvertStringToTimestamp(). A five digit year with a leading zero is
+// accepted too but takes the general path, so the two must agree.
+TEST(ConvertStringToTimestampTest, CanonicalLayoutMatchesGeneralPath) {
+  const char* const kInputs[] = {
+      "2024-02-29",
+      "1970-01-01 00:00:00",
+      "1969-12-31T23:59:59.999999",
+      "2024-02-29t13:14:15.1",
+      "2024-03-10 02:30:00",
+      "2024-11-03 01:30:00.123",
+      "2016-12-31 23:59:60",
+      "2016-12-31 23:59:60.5",
+      "0001-01-01 00:00:00",
+      "9999-12-31 23:59:59.999999",
+      "2024-02-29 13:14:15Z",
+      "2024-02-29 13:14:15.25z",
+      "2024-02-29 13:14:15 UTC",
+      "2024-02-29 13:14:15+05:30",
+  };
+  for (const char* timezone : {"UTC", "America/Los_Angeles", "+05:30"}) {
+    for (TimestampScale scale : {kMicroseconds, kNanoseconds}) {
+      for (const char* input : kInputs) {
+        SCOPED_TRACE(absl::StrCat(input, " ", timezone, " ", scale));
+        int64_t timestamp;
+        int64_t expected_timestamp;
+        const absl::Status status =
+            ConvertStringToTimestamp(input, timezone, scale,
+                                     /*allow_tz_in_str=*/true, &timestamp);
+        const absl::Status expected_status = ConvertStringToTimestamp(
+            absl::StrCat("0", input), timezone, scale,
+            /*allow_tz_in_str=*/true, &expected_timestamp);
+        ASSERT_EQ(status.ok(), expected_status.ok()) << status;
+        if (status.ok()) {
+          EXPECT_EQ(timestamp, expected_timestamp);
+        }
+
+        absl::TimeZone zone;
+        ZETASQL_ASSERT_OK(MakeTimeZone(timezone, &zone));
+        absl::Time time;
+        absl::Time expected_time;
+        const absl::Status time_status = ConvertStringToTimestamp(
+            input, zone, scale, /*allow_tz_in_str=*/true, &time);
+        const absl::Status expected_time_status = ConvertStringToTimestamp(
+            absl::StrCat("0", input), zone, scale, /*allow_tz_in_str=*/true,
+            &expected_time);
+        ASSERT_EQ(time_status.ok(), expected_time_status.ok()) << time_status;
+        if (time_status.ok()) {
+          EXPECT_EQ(time, expected_time);
+        }
+      }
+    }
+  }
+}
+
+TEST(ConvertStringToTimestampTest, CanonicalLayoutErrors) {
+  int64_t timestamp;
+  for (const char* str :
+       {"2024-02-30 00:00:00", "2024-02-29 24:00:00", "2024-02-29 23:60:00",
+        "2024-02-29 23:59:61", "2024-02-29 23:59:59.", "2024-02-29 23:59:",
+        "2024-02-29 23:59:59.1234567", "2024-02-29 23:59:59 U",
+        "2024-02-29 23:59:59Zz", "2024-02-29 23:59:59.0000000000"}) {
+    EXPECT_THAT(ConvertStringToTimestamp(str, absl::UTCTimeZone(),
+                                         kMicroseconds,
+                                         /*allow_tz_in_str=*/true, &timestamp),
+                StatusIs(absl::StatusCode::kOutOfRange))
+        << str;
+  }
+  EXPECT_THAT(ConvertStringToTimestamp("2024-02-29 13:14:15Z",
+                                       absl::UTCTimeZone(), kMicroseconds,
+                                       /*allow_tz_in_str=*/false, &timestamp),
+              StatusIs(absl::StatusCode::kOutOfRange,
+                       "Timezone is not allowed in \"2024-02-29 13:14:15Z\""));
+  // Beyond the range of TIMESTAMP once the time zone offset is applied.
+  EXPECT_THAT(ConvertStringToTimestamp("0001-01-01 00:00:00", "+01:00",
+                                       kMicroseconds,
+                                       /*allow_tz_in_str=*/true, &timestamp),
+              StatusIs(absl::StatusCode::kOutOfRange));
+}
+
+}  // namespace
+}  // namespace functions
+}  // namespace zetasql
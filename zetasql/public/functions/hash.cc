@@ -55,6 +55,21 @@ class OpenSSLHasher final : public Hasher {
     return std::string(reinterpret_cast<const char*>(digest_), sizeof(digest_));
   }
 
+  void HashBatch(absl::Span<const absl::string_view> inputs,
+                 absl::Span<std::string> outputs) final {
+    ZETASQL_DCHECK_EQ(inputs.size(), outputs.size());
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      const absl::string_view input = inputs[i];
+      init_f(&ctx_);
+      ZETASQL_CHECK_EQ(update_f(&ctx_, input.data(), input.length()), 1);
+      // The digest is finalized directly into the output.
+      std::string& output = outputs[i];
+      output.resize(kDigestSize);
+      ZETASQL_CHECK_EQ(
+          finalize_f(reinterpret_cast<unsigned char*>(&output[0]), &ctx_), 1);
+    }
+  }
+
  private:
   // Note: Neither of these values are really state of the class, rather, they
   // are used as buffers to avoid having to allocate on every call to `Hash()`.
@@ -95,6 +110,14 @@ using Sha512Hasher = OpenSSLHasher<SHA512_CTX, SHA512_Init, SHA512_Update,
 
 }  // namespace
 
+void Hasher::HashBatch(absl::Span<const absl::string_view> inputs,
+                       absl::Span<std::string> outputs) {
+  ZETASQL_DCHECK_EQ(inputs.size(), outputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    outputs[i] = Hash(inputs[i]);
+  }
+}
+
 // static
 std::unique_ptr<Hasher> Hasher::Create(Algorithm algorithm) {
   switch (algorithm) {
@@ -113,5 +136,14 @@ int64_t FarmFingerprint(absl::string_view input) {
   return absl::bit_cast<int64_t>(farmhash::Fingerprint64(input));
 }
 
+void FarmFingerprintBatch(absl::Span<const absl::string_view> inputs,
+                          absl::Span<int64_t> outputs) {
+  ZETASQL_DCHECK_EQ(inputs.size(), outputs.size());
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    outputs[i] = absl::bit_cast<int64_t>(
+        farmhash::Fingerprint64(inputs[i].data(), inputs[i].size()));
+  }
+}
+
 }  // namespace functions
 }  // namespace zetasql
@@ -26,6 +26,7 @@
 #include "absl/base/attributes.h"
 #include <cstdint>
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 namespace zetasql {
 namespace functions {
@@ -48,12 +49,25 @@ class Hasher {
   // Returns the hash of the input bytes. Calling this method concurrently
   // on the same object is not thread-safe.
   ABSL_MUST_USE_RESULT virtual std::string Hash(absl::string_view input) = 0;
+
+  // Stores the hash of each of <inputs> in the corresponding element of
+  // <outputs>, which must have the same size. Equivalent to calling Hash() on
+  // each input, but skips the per-call setup, and writes the digests in place
+  // so that strings reused across batches are not reallocated. Calling this
+  // method concurrently on the same object is not thread-safe.
+  virtual void HashBatch(absl::Span<const absl::string_view> inputs,
+                         absl::Span<std::string> outputs);
 };
 
 // Computes the fingerprint of the input bytes using the farmhash::Fingerprint64
 // function from the FarmHash library (https://github.com/google/farmhash).
 int64_t FarmFingerprint(absl::string_view input);
 
+// Stores FarmFingerprint() of each of <inputs> in the corresponding element of
+// <outputs>, which must have the same size.
+void FarmFingerprintBatch(absl::Span<const absl::string_view> inputs,
+                          absl::Span<int64_t> outputs);
+
 }  // namespace functions
 }  // namespace zetasql
 
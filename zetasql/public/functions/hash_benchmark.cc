@@ -0,0 +1,106 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Compares hashing a column of strings one value per call with the batch
+// entry points, for values of the size of typical dedup keys.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/public/functions/hash.h"
+#include "benchmark/benchmark.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+namespace zetasql {
+namespace functions {
+namespace {
+
+constexpr int kNumValues = 10000;
+
+std::vector<std::string> MakeValues(int value_size) {
+  std::vector<std::string> values;
+  values.reserve(kNumValues);
+  for (int i = 0; i < kNumValues; ++i) {
+    std::string value = absl::StrCat("key_", i, "_");
+    value.resize(value_size, static_cast<char>('a' + i % 26));
+    values.push_back(std::move(value));
+  }
+  return values;
+}
+
+void BM_FarmFingerprint(benchmark::State& state) {
+  const std::vector<std::string> values = MakeValues(state.range(0));
+  std::vector<int64_t> outputs(values.size());
+  for (auto s : state) {
+    for (int i = 0; i < values.size(); ++i) {
+      outputs[i] = FarmFingerprint(values[i]);
+    }
+    benchmark::DoNotOptimize(outputs.data());
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+  state.SetBytesProcessed(state.iterations() * values.size() * state.range(0));
+}
+BENCHMARK(BM_FarmFingerprint)->Arg(16)->Arg(64)->Arg(1024);
+
+void BM_FarmFingerprintBatch(benchmark::State& state) {
+  const std::vector<std::string> values = MakeValues(state.range(0));
+  const std::vector<absl::string_view> views(values.begin(), values.end());
+  std::vector<int64_t> outputs(values.size());
+  for (auto s : state) {
+    FarmFingerprintBatch(views, absl::MakeSpan(outputs));
+    benchmark::DoNotOptimize(outputs.data());
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+  state.SetBytesProcessed(state.iterations() * values.size() * state.range(0));
+}
+BENCHMARK(BM_FarmFingerprintBatch)->Arg(16)->Arg(64)->Arg(1024);
+
+void BM_Sha256(benchmark::State& state) {
+  const std::vector<std::string> values = MakeValues(state.range(0));
+  const std::unique_ptr<Hasher> hasher = Hasher::Create(Hasher::kSha256);
+  std::vector<std::string> outputs(values.size());
+  for (auto s : state) {
+    for (int i = 0; i < values.size(); ++i) {
+      outputs[i] = hasher->Hash(values[i]);
+    }
+    benchmark::DoNotOptimize(outputs.data());
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+  state.SetBytesProcessed(state.iterations() * values.size() * state.range(0));
+}
+BENCHMARK(BM_Sha256)->Arg(16)->Arg(64)->Arg(1024);
+
+void BM_Sha256Batch(benchmark::State& state) {
+  const std::vector<std::string> values = MakeValues(state.range(0));
+  const std::vector<absl::string_view> views(values.begin(), values.end());
+  const std::unique_ptr<Hasher> hasher = Hasher::Create(Hasher::kSha256);
+  std::vector<std::string> outputs(values.size());
+  for (auto s : state) {
+    hasher->HashBatch(views, absl::MakeSpan(outputs));
+    benchmark::DoNotOptimize(outputs.data());
+  }
+  state.SetItemsProcessed(state.iterations() * values.size());
+  state.SetBytesProcessed(state.iterations() * values.size() * state.range(0));
+}
+BENCHMARK(BM_Sha256Batch)->Arg(16)->Arg(64)->Arg(1024);
+
+}  // namespace
+}  // namespace functions
+}  // namespace zetasql
@@ -16,6 +16,9 @@
 
 #include "zetasql/public/functions/hash.h"
 
+#include <cstdint>
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -24,7 +27,9 @@
 #include "zetasql/public/value.h"
 #include "zetasql/testing/test_function.h"
 #include "gtest/gtest.h"
+#include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "absl/types/span.h"
 
 namespace zetasql {
 namespace functions {
@@ -79,6 +84,42 @@ TEST(HashTest, BasicCorrectness) {
   }
 }
 
+std::vector<std::string> BatchTestInputs() {
+  std::vector<std::string> inputs = {"", "abc [] +-", "123456"};
+  for (int length = 1; length < 300; length += 13) {
+    inputs.push_back(std::string(length, static_cast<char>('a' + length % 26)));
+  }
+  return inputs;
+}
+
+TEST(HashTest, HashBatch) {
+  const std::vector<std::string> inputs = BatchTestInputs();
+  const std::vector<absl::string_view> input_views(inputs.begin(),
+                                                   inputs.end());
+  for (const Hasher::Algorithm algorithm :
+       {Hasher::kMd5, Hasher::kSha1, Hasher::kSha256, Hasher::kSha512}) {
+    SCOPED_TRACE(absl::Substitute("Algorithm $0", algorithm));
+    const std::unique_ptr<Hasher> hasher = Hasher::Create(algorithm);
+    // Outputs are overwritten, whatever their previous contents.
+    std::vector<std::string> outputs(inputs.size(), "previous output");
+    hasher->HashBatch(input_views, absl::MakeSpan(outputs));
+    for (int i = 0; i < inputs.size(); ++i) {
+      EXPECT_EQ(outputs[i], hasher->Hash(inputs[i])) << inputs[i];
+    }
+  }
+}
+
+TEST(FingerprintTest, FarmFingerprintBatch) {
+  const std::vector<std::string> inputs = BatchTestInputs();
+  const std::vector<absl::string_view> input_views(inputs.begin(),
+                                                   inputs.end());
+  std::vector<int64_t> outputs(inputs.size());
+  FarmFingerprintBatch(input_views, absl::MakeSpan(outputs));
+  for (int i = 0; i < inputs.size(); ++i) {
+    EXPECT_EQ(outputs[i], FarmFingerprint(inputs[i])) << inputs[i];
+  }
+}
+
 TEST(HashTest, ComplianceTests) {
   std::unique_ptr<Hasher> md5 = Hasher::Create(Hasher::Algorithm::kMd5);
   std::unique_ptr<Hasher> sha1 = Hasher::Create(Hasher::Algorithm::kSha1);
@@ -19,9 +19,11 @@
 #include <string.h>
 #include <time.h>
 
+#include <algorithm>
 #include <cctype>
 #include <cstdint>
 #include <limits>
+#include <memory>
 #include <string>
 
 #include "zetasql/base/logging.h"
@@ -33,6 +35,8 @@
 #include "zetasql/public/type.h"
 #include <cstdint>
 #include "absl/base/optimization.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/str_format.h"
 #include "absl/time/time.h"
 #include "zetasql/base/mathutil.h"
@@ -1896,5 +1900,289 @@ absl::Status ParseStringToDatetime(absl::string_view format_string,
   return ConvertTimestampToDatetime(base_time, absl::UTCTimeZone(), datetime);
 }
 
+absl::StatusOr<std::unique_ptr<const DateTimeParser>> DateTimeParser::Create(
+    absl::string_view format_string, TypeKind target_type) {
+  switch (target_type) {
+    case TYPE_DATE:
+      ZETASQL_RETURN_IF_ERROR(ValidateDateFormat(format_string));
+      break;
+    case TYPE_DATETIME:
+      ZETASQL_RETURN_IF_ERROR(ValidateDatetimeFormat(format_string));
+      break;
+    case TYPE_TIME:
+      ZETASQL_RETURN_IF_ERROR(ValidateTimeFormat(format_string));
+      break;
+    case TYPE_TIMESTAMP:
+      break;
+    default:
+      ZETASQL_RET_CHECK_FAIL() << "Unsupported target type for DateTimeParser: "
+                       << TypeKind_Name(target_type);
+  }
+  return absl::WrapUnique(new DateTimeParser(format_string, target_type));
+}
+
+DateTimeParser::DateTimeParser(absl::string_view format_string,
+                               TypeKind target_type)
+    : target_type_(target_type), format_(format_string) {
+  native_ = Decode();
+  if (!native_) {
+    elements_.clear();
+  }
+}
+
+bool DateTimeParser::Decode() {
+  absl::string_view format = format_;
+  // Like the general parser, ignore a trailing nul-byte.
+  if (!format.empty() && format.back() == '\0') {
+    format.remove_suffix(1);
+  }
+  auto add_integer = [this](char field, int max_width, int min, int max) {
+    elements_.push_back({Element::kInteger, field, max_width, min, max});
+  };
+
+  size_t i = 0;
+  while (i < format.size()) {
+    if (absl::ascii_isspace(format[i])) {
+      while (i < format.size() && absl::ascii_isspace(format[i])) ++i;
+      elements_.push_back({Element::kWhitespace});
+      continue;
+    }
+    if (format[i] != '%') {
+      elements_.push_back({Element::kLiteral, format[i++]});
+      continue;
+    }
+    if (i + 1 == format.size()) return false;
+    const char element = format[i + 1];
+    i += 2;
+    // True if the next element in the format is another formatting escape.
+    const bool next_is_percent = i < format.size() && format[i] == '%';
+    switch (element) {
+      case 'Y':
+        // Years are offset by the time zone later, so 10000 is accepted
+        // unless another element directly follows.
+        if (next_is_percent) {
+          add_integer('Y', 4, 0, 9999);
+        } else {
+          add_integer('Y', 5, 0, 10000);
+        }
+        break;
+      case 'm':
+        add_integer('m', 2, 1, 12);
+        break;
+      case 'd':
+        add_integer('d', 2, 1, 31);
+        break;
+      case 'H':
+        add_integer('H', 2, 0, 23);
+        break;
+      case 'M':
+        add_integer('M', 2, 0, 59);
+        break;
+      case 'S':
+        elements_.push_back({Element::kSeconds, 'S', 0});
+        break;
+      case 'z':
+        elements_.push_back({Element::kOffset, '\0'});
+        break;
+      case 'E': {
+        if (i < format.size() && format[i] == 'z') {
+          elements_.push_back({Element::kOffset, ':'});
+          i += 1;
+          break;
+        }
+        if (i + 1 >= format.size() || format[i + 1] != 'S') return false;
+        if (format[i] == '*') {
+          elements_.push_back({Element::kSeconds, 'S', -1});
+        } else if (absl::ascii_isdigit(format[i])) {
+          const int digits = format[i] - '0';
+          max_subsecond_digits_ = std::max(max_subsecond_digits_, digits);
+          elements_.push_back({Element::kSeconds, 'S', digits});
+        } else {
+          return false;
+        }
+        i += 2;
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+bool DateTimeParser::TryParseNative(absl::string_view input,
+                                    absl::TimeZone default_timezone,
+                                    TimestampScale scale,
+                                    absl::Time* timestamp) const {
+  // The general parser treats a %E#S with more digits than <scale> as an
+  // strptime() element.
+  if (max_subsecond_digits_ > scale) return false;
+
+  const char* data = input.data();
+  const char* end_of_data = data + input.size();
+  if (data != end_of_data && *(end_of_data - 1) == '\0') --end_of_data;
+  data = ConsumeWhitespace(data, end_of_data);
+
+  int64_t year = 1970;
+  int month = 1;
+  int mday = 1;
+  int hour = 0;
+  int minute = 0;
+  int second = 0;
+  absl::Duration subseconds;
+  int timezone_offset_minutes = 0;
+  bool saw_timezone_offset = false;
+
+  auto element = elements_.begin();
+  for (; data != nullptr && data < end_of_data && element != elements_.end();
+       ++element) {
+    switch (element->kind) {
+      case Element::kWhitespace:
+        data = ConsumeWhitespace(data, end_of_data);
+        break;
+      case Element::kLiteral:
+        if (*data != element->field) return false;
+        ++data;
+        break;
+      case Element::kInteger: {
+        int value;
+        data = ParseInt(data, end_of_data, element->max_width, element->min,
+                        element->max, &value);
+        if (data == nullptr) return false;
+        switch (element->field) {
+          case 'Y':
+            year = value;
+            break;
+          case 'm':
+            month = value;
+            break;
+          case 'd':
+            mday = value;
+            break;
+          case 'H':
+            hour = value;
+            break;
+          case 'M':
+            minute = value;
+            break;
+        }
+        break;
+      }
+      case Element::kSeconds:
+        data = ParseInt(data, end_of_data, 2, 0, 60, &second);
+        if (element->max_width != 0) {
+          data = ParseSubSecondsIfStartingWithPoint(
+              data, end_of_data, std::max(element->max_width, 0), scale,
+              &subseconds);
+        }
+        break;
+      case Element::kOffset:
+        if (element->field == ':' && *data == 'Z') {
+          timezone_offset_minutes = 0;
+          saw_timezone_offset = true;
+          ++data;
+          break;
+        }
+        data = ParseOffset(data, end_of_data, element->field,
+                           &timezone_offset_minutes);
+        if (!IsValidTimeZone(timezone_offset_minutes)) return false;
+        saw_timezone_offset = true;
+        break;
+    }
+  }
+  if (data == nullptr) return false;
+  while (data < end_of_data && absl::ascii_isspace(*data)) ++data;
+  while (element != elements_.end() && element->kind == Element::kWhitespace) {
+    ++element;
+  }
+  if (data != end_of_data || element != elements_.end()) return false;
+
+  const absl::TimeZone timezone =
+      saw_timezone_offset ? absl::UTCTimeZone() : default_timezone;
+  // Normalizes a leap second of 60 to the following ":00".
+  if (second == 60) {
+    second -= 1;
+    subseconds = absl::Seconds(1);
+  }
+  const absl::TimeConversion tc = absl::ConvertDateTime(
+      year, month, mday, hour, minute, second, timezone);
+  if (tc.normalized) return false;
+  *timestamp = tc.pre - absl::Minutes(timezone_offset_minutes) + subseconds;
+  return IsValidTime(*timestamp);
+}
+
+absl::Status DateTimeParser::ParseInternal(absl::string_view input,
+                                           absl::TimeZone default_timezone,
+                                           TimestampScale scale,
+                                           bool parse_version2,
+                                           absl::Time* timestamp) const {
+  if (native_ && TryParseNative(input, default_timezone, scale, timestamp)) {
+    return absl::OkStatus();
+  }
+  return functions::ParseTime(format_, input, default_timezone, scale,
+                              parse_version2, timestamp);
+}
+
+absl::Status DateTimeParser::ParseTimestamp(absl::string_view timestamp_string,
+                                            absl::TimeZone default_timezone,
+                                            bool parse_version2,
+                                            int64_t* timestamp) const {
+  ZETASQL_DCHECK_EQ(target_type_, TYPE_TIMESTAMP);
+  absl::Time base_time;
+  ZETASQL_RETURN_IF_ERROR(ParseInternal(timestamp_string, default_timezone,
+                                kMicroseconds, parse_version2, &base_time));
+  if (!ConvertTimeToTimestamp(base_time, timestamp)) {
+    return MakeEvalError() << "Invalid result from parsing function";
+  }
+  return absl::OkStatus();
+}
+
+absl::Status DateTimeParser::ParseTimestamp(absl::string_view timestamp_string,
+                                            absl::TimeZone default_timezone,
+                                            bool parse_version2,
+                                            absl::Time* timestamp) const {
+  ZETASQL_DCHECK_EQ(target_type_, TYPE_TIMESTAMP);
+  return ParseInternal(timestamp_string, default_timezone, kNanoseconds,
+                       parse_version2, timestamp);
+}
+
+absl::Status DateTimeParser::ParseDate(absl::string_view date_string,
+                                       bool parse_version2,
+                                       int32_t* date) const {
+  ZETASQL_DCHECK_EQ(target_type_, TYPE_DATE);
+  absl::Time base_time;
+  ZETASQL_RETURN_IF_ERROR(ParseInternal(date_string, absl::UTCTimeZone(),
+                                kMicroseconds, parse_version2, &base_time));
+  int64_t timestamp;
+  if (!ConvertTimeToTimestamp(base_time, &timestamp)) {
+    return MakeEvalError() << "Invalid result from parsing function";
+  }
+  return ExtractFromTimestamp(DATE, timestamp, kMicroseconds,
+                              absl::UTCTimeZone(), date);
+}
+
+absl::Status DateTimeParser::ParseTime(absl::string_view time_string,
+                                       TimestampScale scale,
+                                       TimeValue* time) const {
+  ZETASQL_DCHECK_EQ(target_type_, TYPE_TIME);
+  ZETASQL_CHECK(scale == kNanoseconds || scale == kMicroseconds);
+  absl::Time base_time;
+  ZETASQL_RETURN_IF_ERROR(ParseInternal(time_string, absl::UTCTimeZone(), scale,
+                                /*parse_version2=*/false, &base_time));
+  return ConvertTimestampToTime(base_time, absl::UTCTimeZone(), scale, time);
+}
+
+absl::Status DateTimeParser::ParseDatetime(absl::string_view datetime_string,
+                                           TimestampScale scale,
+                                           bool parse_version2,
+                                           DatetimeValue* datetime) const {
+  ZETASQL_DCHECK_EQ(target_type_, TYPE_DATETIME);
+  ZETASQL_CHECK(scale == kNanoseconds || scale == kMicroseconds);
+  absl::Time base_time;
+  ZETASQL_RETURN_IF_ERROR(ParseInternal(datetime_string, absl::UTCTimeZone(),
+                                scale, parse_version2, &base_time));
+  return ConvertTimestampToDatetime(base_time, absl::UTCTimeZone(), datetime);
+}
+
 }  // namespace functions
 }  // namespace zetasql
@@ -18,11 +18,15 @@
 #define ZETASQL_PUBLIC_FUNCTIONS_PARSE_DATE_TIME_H_
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "zetasql/public/civil_time.h"
 #include "zetasql/public/functions/date_time_util.h"
+#include "zetasql/public/type.pb.h"
 #include <cstdint>
+#include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
 #include "absl/time/time.h"
 #include "zetasql/base/status.h"
@@ -154,6 +158,101 @@ absl::Status ParseStringToDatetime(absl::string_view format_string,
                                    TimestampScale scale, bool parse_version2,
                                    DatetimeValue* datetime);
 
+// A PARSE_* format string that has been validated and decoded once, so that
+// it can be applied to many input strings without re-scanning the format.
+// Results and errors are identical to the ParseStringTo*() functions above.
+//
+// Formats made up only of literal characters, whitespace and the numeric
+// elements %Y, %m, %d, %H, %M, %S, %E#S, %E*S, %z and %Ez are parsed by a
+// straight-line loop over the decoded elements.  Other formats, and
+// inputs that the straight-line loop rejects, go through the general parser
+// so that error messages do not change.
+class DateTimeParser {
+ public:
+  // <target_type> must be one of TYPE_DATE, TYPE_DATETIME, TYPE_TIME or
+  // TYPE_TIMESTAMP.  Returns the same error as the corresponding
+  // ParseStringTo*() function if <format_string> contains an element that is
+  // not allowed for <target_type>.
+  static absl::StatusOr<std::unique_ptr<const DateTimeParser>> Create(
+      absl::string_view format_string, TypeKind target_type);
+
+  DateTimeParser(const DateTimeParser&) = delete;
+  DateTimeParser& operator=(const DateTimeParser&) = delete;
+
+  // Equivalent to ParseStringToTimestamp().  Requires TYPE_TIMESTAMP.
+  absl::Status ParseTimestamp(absl::string_view timestamp_string,
+                              absl::TimeZone default_timezone,
+                              bool parse_version2, int64_t* timestamp) const;
+  absl::Status ParseTimestamp(absl::string_view timestamp_string,
+                              absl::TimeZone default_timezone,
+                              bool parse_version2, absl::Time* timestamp) const;
+
+  // Equivalent to ParseStringToDate().  Requires TYPE_DATE.
+  absl::Status ParseDate(absl::string_view date_string, bool parse_version2,
+                         int32_t* date) const;
+
+  // Equivalent to ParseStringToTime().  Requires TYPE_TIME.
+  absl::Status ParseTime(absl::string_view time_string, TimestampScale scale,
+                         TimeValue* time) const;
+
+  // Equivalent to ParseStringToDatetime().  Requires TYPE_DATETIME.
+  absl::Status ParseDatetime(absl::string_view datetime_string,
+                             TimestampScale scale, bool parse_version2,
+                             DatetimeValue* datetime) const;
+
+  // Returns true if the format is handled by the straight-line loop.
+  bool is_native() const { return native_; }
+
+ private:
+  // One decoded piece of the format string.
+  struct Element {
+    enum Kind {
+      kWhitespace,  // A run of whitespace, matching any amount of whitespace.
+      kLiteral,     // A single character that must match exactly.
+      kInteger,     // %Y, %m, %d, %H, %M.
+      kSeconds,     // %S, %E#S and %E*S.
+      kOffset,      // %z and %Ez.
+    };
+    Kind kind;
+    // For kLiteral, the character to match.  For kInteger, the field being
+    // parsed ('Y', 'm', 'd', 'H' or 'M').  For kOffset, the separator between
+    // hours and minutes ('\0' for %z).
+    char field = '\0';
+    // For kInteger, the maximum number of digits and the accepted range.
+    // For kSeconds, <max_width> is the number of subsecond digits accepted:
+    // 0 for %S and %E0S, -1 for %E*S.
+    int max_width = 0;
+    int min = 0;
+    int max = 0;
+  };
+
+  DateTimeParser(absl::string_view format_string, TypeKind target_type);
+
+  // Decodes <format_> into <elements_>.  Returns false if the format contains
+  // anything that is not handled by TryParseNative().
+  bool Decode();
+
+  // Parses <input> into <timestamp> like the general parser.
+  absl::Status ParseInternal(absl::string_view input,
+                             absl::TimeZone default_timezone,
+                             TimestampScale scale, bool parse_version2,
+                             absl::Time* timestamp) const;
+
+  // Runs the straight-line loop.  Returns false if the input does not parse
+  // or the result is invalid, in which case the general parser is used to
+  // produce the error.
+  bool TryParseNative(absl::string_view input, absl::TimeZone default_timezone,
+                      TimestampScale scale, absl::Time* timestamp) const;
+
+  const TypeKind target_type_;
+  const std::string format_;
+  // Decoded <format_>; only populated if <native_> is true.
+  std::vector<Element> elements_;
+  bool native_ = false;
+  // The largest # of any %E#S element, which must not exceed the scale.
+  int max_subsecond_digits_ = 0;
+};
+
 }  // namespace functions
 }  // namespace zetasql
 
@@ -0,0 +1,394 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Approximate percentiles in bounded memory.
+
+#ifndef ZETASQL_PUBLIC_FUNCTIONS_PERCENTILE_SKETCH_H_
+#define ZETASQL_PUBLIC_FUNCTIONS_PERCENTILE_SKETCH_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+
+namespace zetasql {
+
+// A KLL quantile sketch (Karnin, Lang and Liberty, "Optimal Quantile
+// Approximation in Streams", 2016) of the non-NULL values of a column, for
+// computing PERCENTILE_CONT and PERCENTILE_DISC approximately without storing
+// all the values. T must be copyable and ordered by operator<.
+//
+// The sketch keeps levels of sorted samples, where each sample of level h
+// stands for 2^h input values. When the sketch is full, the lowest full level
+// is compacted: every other value of it moves up one level. For n values, the
+// sketch retains fewer than 3 * k + 2 * log2(n) + 2 of them. With the default
+// size k = 200, the rank of the value returned for a percentile differs from
+// the exact rank by less than 2% of n (see percentile_sketch_test.cc).
+// The smallest and largest values are exact. For floating point types, NaNs
+// are counted exactly, and are ordered before all other values like in
+// PercentileEvaluator.
+//
+// Compactions alternate between keeping the even and the odd positions instead
+// of choosing randomly, so results are deterministic.
+//
+// Sketches of parts of the input can be combined with Merge(), with the same
+// error bounds as a single sketch of the whole input.
+//
+// Example:
+//   PercentileSketch<double> sketch;
+//   for (double value : values) sketch.Add(value);
+//   PercentileSketch<double>::SortedView view = sketch.GetSortedView();
+//   ZETASQL_ASSIGN_OR_RETURN(PercentileEvaluator<double> evaluator,
+//                    PercentileEvaluator<double>::Create(0.9));
+//   double result;
+//   if (evaluator.ComputePercentileCont</*sorted=*/true>(
+//           view.begin(), view.end(), /*num_nulls=*/0, &result)) { ... }
+template <typename T>
+class PercentileSketch {
+ public:
+  static constexpr int kDefaultSize = 200;
+  // The smallest supported size.
+  static constexpr int kMinSize = 8;
+
+  // <k> controls the accuracy and the memory: the rank error shrinks and the
+  // number of retained values grows proportionally to it. Values below
+  // kMinSize are raised to kMinSize.
+  explicit PercentileSketch(int k = kDefaultSize)
+      : k_(std::max(k, kMinSize)), levels_(1), capacity_(LevelCapacity(0)) {}
+
+  PercentileSketch(const PercentileSketch&) = default;
+  PercentileSketch& operator=(const PercentileSketch&) = default;
+  PercentileSketch(PercentileSketch&&) = default;
+  PercentileSketch& operator=(PercentileSketch&&) = default;
+
+  void Add(const T& value) {
+    if (IsNaN(value)) {
+      ++num_nans_;
+      return;
+    }
+    UpdateMinMax(value);
+    ++num_values_;
+    levels_[0].push_back(value);
+    ++num_retained_;
+    if (num_retained_ > capacity_) Compress();
+  }
+
+  // Adds the values of <other>, which must have the same size.
+  void Merge(const PercentileSketch& other) {
+    ZETASQL_DCHECK_EQ(k_, other.k_);
+    num_nans_ += other.num_nans_;
+    if (other.num_values_ == 0) return;
+    if (num_values_ == 0) {
+      min_ = other.min_;
+      max_ = other.max_;
+    } else {
+      UpdateMinMax(other.min_);
+      UpdateMinMax(other.max_);
+    }
+    num_values_ += other.num_values_;
+    if (levels_.size() < other.levels_.size()) {
+      levels_.resize(other.levels_.size());
+      capacity_ = Capacity();
+    }
+    for (size_t h = 0; h < other.levels_.size(); ++h) {
+      levels_[h].insert(levels_[h].end(), other.levels_[h].begin(),
+                        other.levels_[h].end());
+    }
+    num_retained_ += other.num_retained_;
+    Compress();
+  }
+
+  // Returns the number of values added, including NaNs.
+  int64_t num_values() const { return num_values_ + num_nans_; }
+
+  // Returns the number of values held in memory.
+  size_t num_retained() const { return num_retained_; }
+
+  // The fields of the sketch, for serializing it. The samples of levels()[h]
+  // stand for 2^h values each. min() and max() are meaningful only if some
+  // non-NaN values were added.
+  int k() const { return k_; }
+  int64_t num_nans() const { return num_nans_; }
+  const T& min() const { return min_; }
+  const T& max() const { return max_; }
+  const std::vector<std::vector<T>>& levels() const { return levels_; }
+
+  // Recreates in <sketch> a sketch of size <k> from the fields returned by
+  // the accessors above. Returns false if the fields are inconsistent.
+  static bool FromFields(int k, int64_t num_nans, const T& min, const T& max,
+                         std::vector<std::vector<T>> levels,
+                         PercentileSketch* sketch) {
+    if (k < kMinSize || num_nans < 0 || levels.empty() || levels.size() > 62) {
+      return false;
+    }
+    int64_t num_values = 0;
+    size_t num_retained = 0;
+    for (size_t h = 0; h < levels.size(); ++h) {
+      for (const T& value : levels[h]) {
+        if (IsNaN(value) || value < min || max < value) return false;
+      }
+      const int64_t weight = int64_t{1} << h;
+      if (levels[h].size() >
+          static_cast<size_t>((std::numeric_limits<int64_t>::max() -
+                               num_values) / weight)) {
+        return false;
+      }
+      num_values += static_cast<int64_t>(levels[h].size()) * weight;
+      num_retained += levels[h].size();
+    }
+    *sketch = PercentileSketch(k);
+    sketch->levels_ = std::move(levels);
+    sketch->capacity_ = sketch->Capacity();
+    sketch->num_retained_ = num_retained;
+    sketch->num_values_ = num_values;
+    sketch->num_nans_ = num_nans;
+    if (num_values > 0) {
+      sketch->min_ = min;
+      sketch->max_ = max;
+    }
+    sketch->Compress();
+    return true;
+  }
+
+  // The values of a sketch in ascending order, with an estimated value at each
+  // rank. SortedView::iterator is a random access iterator that can be passed
+  // to PercentileEvaluator::ComputePercentileCont() and
+  // ComputePercentileDisc() with <sorted> = true.
+  class SortedView {
+   public:
+    class iterator {
+     public:
+      using iterator_category = std::random_access_iterator_tag;
+      using value_type = T;
+      using difference_type = std::ptrdiff_t;
+      using pointer = const T*;
+      using reference = const T&;
+
+      iterator() = default;
+
+      reference operator*() const { return view_->ValueAtRank(rank_); }
+      pointer operator->() const { return &**this; }
+      reference operator[](difference_type n) const { return *(*this + n); }
+
+      iterator& operator++() {
+        ++rank_;
+        return *this;
+      }
+      iterator operator++(int) {
+        iterator result = *this;
+        ++rank_;
+        return result;
+      }
+      iterator& operator--() {
+        --rank_;
+        return *this;
+      }
+      iterator operator--(int) {
+        iterator result = *this;
+        --rank_;
+        return result;
+      }
+      iterator& operator+=(difference_type n) {
+        rank_ += n;
+        return *this;
+      }
+      iterator& operator-=(difference_type n) {
+        rank_ -= n;
+        return *this;
+      }
+      friend iterator operator+(iterator itr, difference_type n) {
+        return itr += n;
+      }
+      friend iterator operator+(difference_type n, iterator itr) {
+        return itr += n;
+      }
+      friend iterator operator-(iterator itr, difference_type n) {
+        return itr -= n;
+      }
+      friend difference_type operator-(const iterator& a, const iterator& b) {
+        return a.rank_ - b.rank_;
+      }
+      friend bool operator==(const iterator& a, const iterator& b) {
+        return a.rank_ == b.rank_;
+      }
+      friend bool operator!=(const iterator& a, const iterator& b) {
+        return a.rank_ != b.rank_;
+      }
+      friend bool operator<(const iterator& a, const iterator& b) {
+        return a.rank_ < b.rank_;
+      }
+      friend bool operator>(const iterator& a, const iterator& b) {
+        return a.rank_ > b.rank_;
+      }
+      friend bool operator<=(const iterator& a, const iterator& b) {
+        return a.rank_ <= b.rank_;
+      }
+      friend bool operator>=(const iterator& a, const iterator& b) {
+        return a.rank_ >= b.rank_;
+      }
+
+     private:
+      friend class SortedView;
+      iterator(const SortedView* view, difference_type rank)
+          : view_(view), rank_(rank) {}
+
+      const SortedView* view_ = nullptr;
+      difference_type rank_ = 0;
+    };
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, size()); }
+    std::ptrdiff_t size() const { return num_nans_ + num_values_; }
+
+   private:
+    friend class PercentileSketch;
+
+    SortedView() = default;
+
+    // Returns the estimated value at 0-based <rank> among all the values.
+    const T& ValueAtRank(int64_t rank) const {
+      if (rank < num_nans_) return nan_;
+      rank -= num_nans_;
+      if (rank == 0) return min_;
+      if (rank == num_values_ - 1) return max_;
+      // The first sample whose cumulative weight exceeds <rank>.
+      const auto itr = std::upper_bound(cumulative_weights_.begin(),
+                                        cumulative_weights_.end(), rank);
+      if (itr == cumulative_weights_.end()) return max_;
+      return samples_[itr - cumulative_weights_.begin()];
+    }
+
+    int64_t num_nans_ = 0;
+    int64_t num_values_ = 0;
+    T nan_{};
+    T min_{};
+    T max_{};
+    std::vector<T> samples_;
+    std::vector<int64_t> cumulative_weights_;
+  };
+
+  // Returns a view of the values in ascending order, for computing
+  // percentiles. The view does not refer to the sketch.
+  SortedView GetSortedView() const {
+    SortedView view;
+    view.num_nans_ = num_nans_;
+    view.num_values_ = num_values_;
+    if constexpr (std::is_floating_point_v<T>) {
+      view.nan_ = std::numeric_limits<T>::quiet_NaN();
+    }
+    if (num_values_ == 0) return view;
+    view.min_ = min_;
+    view.max_ = max_;
+
+    std::vector<std::pair<T, int64_t>> weighted_samples;
+    weighted_samples.reserve(num_retained_);
+    for (size_t h = 0; h < levels_.size(); ++h) {
+      for (const T& value : levels_[h]) {
+        weighted_samples.emplace_back(value, int64_t{1} << h);
+      }
+    }
+    std::sort(weighted_samples.begin(), weighted_samples.end(),
+              [](const std::pair<T, int64_t>& a,
+                 const std::pair<T, int64_t>& b) { return a.first < b.first; });
+    view.samples_.reserve(weighted_samples.size());
+    view.cumulative_weights_.reserve(weighted_samples.size());
+    int64_t cumulative_weight = 0;
+    for (auto& [value, weight] : weighted_samples) {
+      cumulative_weight += weight;
+      view.samples_.push_back(std::move(value));
+      view.cumulative_weights_.push_back(cumulative_weight);
+    }
+    return view;
+  }
+
+ private:
+  static bool IsNaN(const T& value) {
+    if constexpr (std::is_floating_point_v<T>) {
+      return std::isnan(value);
+    } else {
+      return false;
+    }
+  }
+
+  void UpdateMinMax(const T& value) {
+    if (num_values_ == 0 || value < min_) min_ = value;
+    if (num_values_ == 0 || max_ < value) max_ = value;
+  }
+
+  // Returns the capacity of level <h>: k for the top level, and 2/3 of the
+  // capacity of the level above for the others, but at least 2.
+  size_t LevelCapacity(size_t h) const {
+    const size_t depth = levels_.size() - 1 - h;
+    return std::max<size_t>(
+        2, static_cast<size_t>(std::ceil(k_ * std::pow(2.0 / 3.0, depth))));
+  }
+
+  size_t Capacity() const {
+    size_t capacity = 0;
+    for (size_t h = 0; h < levels_.size(); ++h) capacity += LevelCapacity(h);
+    return capacity;
+  }
+
+  // Compacts the lowest full levels until the sketch fits in its capacity.
+  void Compress() {
+    while (num_retained_ > capacity_) {
+      size_t h = 0;
+      while (levels_[h].size() < LevelCapacity(h)) ++h;
+      if (h + 1 == levels_.size()) {
+        levels_.emplace_back();
+        capacity_ = Capacity();
+      }
+      std::vector<T>& level = levels_[h];
+      std::vector<T>& next_level = levels_[h + 1];
+      // An odd value out stays at this level, so that weights are preserved.
+      auto end = level.end();
+      if (level.size() % 2 == 1) --end;
+      std::sort(level.begin(), end);
+      const size_t offset = compaction_parity_ ? 1 : 0;
+      compaction_parity_ = !compaction_parity_;
+      const size_t num_compacted = end - level.begin();
+      for (size_t i = offset; i < num_compacted; i += 2) {
+        next_level.push_back(std::move(level[i]));
+      }
+      level.erase(level.begin(), end);
+      num_retained_ -= num_compacted / 2;
+    }
+  }
+
+  int k_;
+  // levels_[h] holds samples of weight 2^h. Only compacted runs are sorted.
+  std::vector<std::vector<T>> levels_;
+  // The sum of the capacities of the levels.
+  size_t capacity_;
+  size_t num_retained_ = 0;
+  // Number of non-NaN values added.
+  int64_t num_values_ = 0;
+  int64_t num_nans_ = 0;
+  T min_{};
+  T max_{};
+  bool compaction_parity_ = false;
+};
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_PUBLIC_FUNCTIONS_PERCENTILE_SKETCH_H_
@@ -0,0 +1,273 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/functions/percentile_sketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/functions/percentile.h"
+#include "zetasql/public/numeric_value.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace zetasql {
+namespace {
+
+constexpr double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+// The documented bound on the rank error, as a fraction of the number of
+// values, for the default size.
+constexpr double kMaxRankError = 0.02;
+
+// Returns the range of 0-based ranks of <value> in <sorted_values>.
+std::pair<int64_t, int64_t> RankRange(const std::vector<double>& sorted_values,
+                                      double value) {
+  return {std::lower_bound(sorted_values.begin(), sorted_values.end(), value) -
+              sorted_values.begin(),
+          std::upper_bound(sorted_values.begin(), sorted_values.end(), value) -
+              sorted_values.begin() - 1};
+}
+
+// Checks that PERCENTILE_DISC computed from <sketch> returns values whose
+// ranks in <values> are within <max_rank_error> * values.size() of the exact
+// ranks, for percentiles 0, 0.01, ..., 1.
+void ExpectRankErrorWithin(const PercentileSketch<double>& sketch,
+                           std::vector<double> values, double max_rank_error) {
+  std::sort(values.begin(), values.end());
+  const PercentileSketch<double>::SortedView view = sketch.GetSortedView();
+  ASSERT_EQ(view.size(), values.size());
+  const double n = values.size();
+  for (int i = 0; i <= 100; ++i) {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(PercentileEvaluator<double> evaluator,
+                         PercentileEvaluator<double>::Create(i / 100.0));
+    const auto approximate =
+        evaluator.ComputePercentileDisc<double, /*sorted=*/true>(
+            view.begin(), view.end(), /*num_nulls=*/0);
+    const auto exact = evaluator.ComputePercentileDisc<double, /*sorted=*/true>(
+        values.begin(), values.end(), /*num_nulls=*/0);
+    ASSERT_NE(approximate, view.end());
+    const int64_t exact_rank = exact - values.begin();
+    const auto [min_rank, max_rank] = RankRange(values, *approximate);
+    const int64_t rank_error =
+        exact_rank < min_rank   ? min_rank - exact_rank
+        : exact_rank > max_rank ? exact_rank - max_rank
+                                : 0;
+    EXPECT_LE(rank_error, max_rank_error * n)
+        << "percentile " << i / 100.0 << ": " << *approximate << " vs "
+        << *exact;
+  }
+}
+
+std::vector<double> RandomValues(int n, uint32_t seed) {
+  std::mt19937 random(seed);
+  std::normal_distribution<double> distribution(100, 30);
+  std::vector<double> values(n);
+  for (double& value : values) value = distribution(random);
+  return values;
+}
+
+TEST(PercentileSketchTest, SmallInputsAreExact) {
+  PercentileSketch<double> sketch;
+  std::vector<double> values;
+  for (int i = 0; i < PercentileSketch<double>::kDefaultSize; ++i) {
+    values.push_back((i * 37) % 101);
+    sketch.Add(values.back());
+  }
+  ExpectRankErrorWithin(sketch, values, 0);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(PercentileEvaluator<double> evaluator,
+                       PercentileEvaluator<double>::Create(0.5));
+  const PercentileSketch<double>::SortedView view = sketch.GetSortedView();
+  double approximate, exact;
+  ASSERT_TRUE(evaluator.ComputePercentileCont</*sorted=*/true>(
+      view.begin(), view.end(), /*num_nulls=*/0, &approximate));
+  ASSERT_TRUE(evaluator.ComputePercentileCont</*sorted=*/false>(
+      values.begin(), values.end(), /*num_nulls=*/0, &exact));
+  EXPECT_EQ(approximate, exact);
+}
+
+TEST(PercentileSketchTest, EmptySketch) {
+  PercentileSketch<double> sketch;
+  const PercentileSketch<double>::SortedView view = sketch.GetSortedView();
+  EXPECT_EQ(view.size(), 0);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(PercentileEvaluator<double> evaluator,
+                       PercentileEvaluator<double>::Create(0.5));
+  double result;
+  EXPECT_FALSE(evaluator.ComputePercentileCont</*sorted=*/true>(
+      view.begin(), view.end(), /*num_nulls=*/0, &result));
+}
+
+TEST(PercentileSketchTest, RankErrorAndMemoryAreBounded) {
+  for (const int n : {1000, 100000, 300000}) {
+    SCOPED_TRACE(n);
+    const std::vector<double> random_values = RandomValues(n, /*seed=*/n);
+    std::vector<double> ascending_values = random_values;
+    std::sort(ascending_values.begin(), ascending_values.end());
+    std::vector<double> descending_values(ascending_values.rbegin(),
+                                          ascending_values.rend());
+    std::vector<double> few_distinct_values;
+    for (int i = 0; i < n; ++i) few_distinct_values.push_back(i % 10);
+
+    for (const std::vector<double>* values :
+         std::vector<const std::vector<double>*>{
+             &random_values, &ascending_values, &descending_values,
+             &few_distinct_values}) {
+      PercentileSketch<double> sketch;
+      for (double value : *values) sketch.Add(value);
+      EXPECT_EQ(sketch.num_values(), n);
+      EXPECT_LT(sketch.num_retained(),
+                3 * PercentileSketch<double>::kDefaultSize +
+                    2 * std::log2(n) + 2);
+      ExpectRankErrorWithin(sketch, *values, kMaxRankError);
+    }
+  }
+}
+
+TEST(PercentileSketchTest, SmallerSizesHaveLargerErrors) {
+  // With size k, the rank error stays below about 4 / k.
+  const std::vector<double> values = RandomValues(100000, /*seed=*/1);
+  for (const int k : {50, 100, 400}) {
+    SCOPED_TRACE(k);
+    PercentileSketch<double> sketch(k);
+    for (double value : values) sketch.Add(value);
+    EXPECT_LT(sketch.num_retained(), 3 * k + 2 * std::log2(values.size()) + 2);
+    ExpectRankErrorWithin(sketch, values, 4.0 / k);
+  }
+}
+
+TEST(PercentileSketchTest, MergedSketches) {
+  const std::vector<double> values = RandomValues(200000, /*seed=*/2);
+  // Sketches of 16 parts of unequal sizes, merged in a tree like a parallel
+  // aggregation would.
+  std::vector<PercentileSketch<double>> sketches(16);
+  for (int i = 0; i < values.size(); ++i) {
+    sketches[i % 13 + (i / 1000) % 4].Add(values[i]);
+  }
+  for (int step = 1; step < sketches.size(); step *= 2) {
+    for (int i = 0; i + step < sketches.size(); i += 2 * step) {
+      sketches[i].Merge(sketches[i + step]);
+    }
+  }
+  EXPECT_EQ(sketches[0].num_values(), values.size());
+  EXPECT_LT(sketches[0].num_retained(),
+            3 * PercentileSketch<double>::kDefaultSize +
+                2 * std::log2(values.size()) + 2);
+  ExpectRankErrorWithin(sketches[0], values, kMaxRankError);
+
+  // Merging into an empty sketch takes the extremes of the other sketch.
+  PercentileSketch<double> merged;
+  merged.Merge(sketches[0]);
+  EXPECT_EQ(merged.num_values(), values.size());
+  const PercentileSketch<double>::SortedView view = merged.GetSortedView();
+  EXPECT_EQ(*view.begin(), *std::min_element(values.begin(), values.end()));
+  EXPECT_EQ(*(view.end() - 1), *std::max_element(values.begin(), values.end()));
+  ExpectRankErrorWithin(merged, values, kMaxRankError);
+
+  PercentileSketch<double> small;
+  small.Add(5);
+  small.Add(1);
+  PercentileSketch<double> merged_small;
+  merged_small.Merge(small);
+  const PercentileSketch<double>::SortedView small_view =
+      merged_small.GetSortedView();
+  ASSERT_EQ(small_view.size(), 2);
+  EXPECT_EQ(small_view.begin()[0], 1);
+  EXPECT_EQ(small_view.begin()[1], 5);
+}
+
+TEST(PercentileSketchTest, FromFields) {
+  const std::vector<double> values = RandomValues(50000, /*seed=*/4);
+  PercentileSketch<double> sketch;
+  for (double value : values) sketch.Add(value);
+  sketch.Add(std::numeric_limits<double>::quiet_NaN());
+
+  PercentileSketch<double> copy;
+  ASSERT_TRUE(PercentileSketch<double>::FromFields(
+      sketch.k(), sketch.num_nans(), sketch.min(), sketch.max(),
+      sketch.levels(), &copy));
+  EXPECT_EQ(copy.num_values(), sketch.num_values());
+  EXPECT_EQ(copy.num_retained(), sketch.num_retained());
+  const PercentileSketch<double>::SortedView view = sketch.GetSortedView();
+  const PercentileSketch<double>::SortedView copy_view = copy.GetSortedView();
+  ASSERT_EQ(copy_view.size(), view.size());
+  for (int64_t rank = 1; rank < view.size(); rank += 97) {
+    EXPECT_EQ(copy_view.begin()[rank], view.begin()[rank]) << rank;
+  }
+
+  // Samples outside of [min, max] and sizes below kMinSize are rejected.
+  EXPECT_FALSE(PercentileSketch<double>::FromFields(
+      sketch.k(), 0, sketch.min() + 1, sketch.max(), sketch.levels(), &copy));
+  EXPECT_FALSE(PercentileSketch<double>::FromFields(
+      PercentileSketch<double>::kMinSize - 1, 0, sketch.min(), sketch.max(),
+      sketch.levels(), &copy));
+  EXPECT_FALSE(PercentileSketch<double>::FromFields(
+      sketch.k(), 0, sketch.min(), sketch.max(), {}, &copy));
+}
+
+TEST(PercentileSketchTest, ExactExtremesAndNaNs) {
+  std::vector<double> values = RandomValues(50000, /*seed=*/3);
+  PercentileSketch<double> sketch;
+  for (double value : values) sketch.Add(value);
+  for (int i = 0; i < 10; ++i) sketch.Add(kNaN);
+  const PercentileSketch<double>::SortedView view = sketch.GetSortedView();
+  ASSERT_EQ(view.size(), values.size() + 10);
+
+  // NaNs come first, like in PercentileEvaluator.
+  EXPECT_TRUE(std::isnan(view.begin()[9]));
+  EXPECT_EQ(view.begin()[10], *std::min_element(values.begin(), values.end()));
+  EXPECT_EQ(*(view.end() - 1), *std::max_element(values.begin(), values.end()));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(PercentileEvaluator<double> evaluator,
+                       PercentileEvaluator<double>::Create(1.0));
+  double result;
+  ASSERT_TRUE(evaluator.ComputePercentileCont</*sorted=*/true>(
+      view.begin(), view.end(), /*num_nulls=*/0, &result));
+  EXPECT_EQ(result, *std::max_element(values.begin(), values.end()));
+
+  // With NULLs, the percentile can fall on a NULL.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(PercentileEvaluator<double> min_evaluator,
+                       PercentileEvaluator<double>::Create(0.0));
+  EXPECT_FALSE(min_evaluator.ComputePercentileCont</*sorted=*/true>(
+      view.begin(), view.end(), /*num_nulls=*/5, &result));
+}
+
+TEST(PercentileSketchTest, NumericValues) {
+  PercentileSketch<NumericValue> sketch;
+  for (int i = 0; i < 100000; ++i) {
+    sketch.Add(NumericValue((i * 7919) % 100000));
+  }
+  const PercentileSketch<NumericValue>::SortedView view =
+      sketch.GetSortedView();
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      PercentileEvaluator<NumericValue> evaluator,
+      PercentileEvaluator<NumericValue>::Create(NumericValue::FromDouble(0.25)
+                                                    .value()));
+  NumericValue result;
+  ASSERT_TRUE(evaluator.ComputePercentileCont</*sorted=*/true>(
+      view.begin(), view.end(), /*num_nulls=*/0, &result));
+  // The exact result is 24999.75.
+  EXPECT_LT(std::abs(result.ToDouble() - 24999.75), kMaxRankError * 100000);
+}
+
+}  // namespace
+}  // namespace zetasql
@@ -22,6 +22,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <deque>
 #include <iosfwd>
 #include <memory>
 #include <new>
@@ -29,6 +30,7 @@
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "zetasql/base/arena.h"
@@ -428,6 +430,15 @@ class IdStringPool {
   // Do NOT use for any allocations that are done on a per-query basis.
   static IdString MakeGlobal(absl::string_view str);
 
+  // Returns a std::string holding <str> that is valid for the lifetime of this
+  // pool. This is for objects that must return a const std::string& but
+  // cannot own one, such as the literals of parse trees, which are never
+  // destroyed.
+  const std::string* MakeStdString(std::string str) {
+    std_strings_.push_back(std::move(str));
+    return &std_strings_.back();
+  }
+
  private:
   // Make an IdString::Shared for <str>, allocated in the arena.
   const IdString::Shared* MakeShared(absl::string_view str) {
@@ -473,6 +484,10 @@ class IdStringPool {
 
   std::shared_ptr<zetasql_base::UnsafeArena> arena_;
 
+  // The strings returned by MakeStdString(). A deque does not move them as it
+  // grows.
+  std::deque<std::string> std_strings_;
+
 #ifndef NDEBUG
   static absl::Mutex global_mutex_;
 
@@ -22,6 +22,10 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
 #include <memory>
 #include <optional>
 #include <queue>
@@ -37,12 +41,15 @@
 #include "zetasql/public/numeric_parser.h"
 #include <cstdint>  
 #include "absl/base/optimization.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "absl/types/span.h"
 #include "single_include/nlohmann/json.hpp"
 #include "zetasql/base/ret_check.h"
 #include "zetasql/base/status_builder.h"
@@ -53,13 +60,139 @@ namespace zetasql {
 using JSON = ::nlohmann::json;
 using ::absl::StatusOr;
 
+namespace internal {
+
+// Compact, read-only representation of a JSON document.
+//
+// Nodes are stored in document order in a single vector with the root at
+// index 0. Objects and arrays reference their direct children through a
+// contiguous range of 'children'; the members of an object are sorted by key
+// so that lookups are a binary search. Object keys are interned in 'keys', and
+// the bytes of all keys and string values live in 'string_data'.
+struct JSONValueTape {
+  enum class Kind : uint8_t {
+    kNull,
+    kBoolean,
+    kInt64,
+    kUInt64,
+    kDouble,
+    kString,
+    kObject,
+    kArray,
+  };
+
+  struct Node {
+    Kind kind;
+    // The length of the string for kString, the number of children for
+    // kObject and kArray. Unused otherwise.
+    uint32_t size;
+    union {
+      bool boolean_value;
+      int64_t int64_value;
+      uint64_t uint64_value;
+      double double_value;
+      // The offset into 'string_data' for kString, into 'children' for kObject
+      // and kArray.
+      uint32_t offset;
+    };
+  };
+
+  struct Child {
+    // Index into 'keys'. Unused for array elements.
+    uint32_t key;
+    // Index into 'nodes'.
+    uint32_t node;
+  };
+
+  struct StringRef {
+    uint32_t offset;
+    uint32_t length;
+  };
+
+  bool IsContainer(const Node& node) const {
+    return node.kind == Kind::kObject || node.kind == Kind::kArray;
+  }
+
+  absl::string_view GetString(const Node& node) const {
+    return absl::string_view(string_data).substr(node.offset, node.size);
+  }
+
+  absl::string_view GetKey(uint32_t key) const {
+    return absl::string_view(string_data)
+        .substr(keys[key].offset, keys[key].length);
+  }
+
+  absl::Span<const Child> GetChildren(const Node& node) const {
+    return absl::MakeConstSpan(children).subspan(node.offset, node.size);
+  }
+
+  // Returns the index of the node holding member 'key' of the object 'node',
+  // or std::nullopt if there is no such member.
+  std::optional<uint32_t> FindMember(const Node& node,
+                                     absl::string_view key) const {
+    absl::Span<const Child> members = GetChildren(node);
+    auto it = std::lower_bound(
+        members.begin(), members.end(), key,
+        [this](const Child& member, absl::string_view key) {
+          return GetKey(member.key) < key;
+        });
+    if (it == members.end() || GetKey(it->key) != key) {
+      return std::nullopt;
+    }
+    return it->node;
+  }
+
+  void ShrinkToFit() {
+    nodes.shrink_to_fit();
+    children.shrink_to_fit();
+    keys.shrink_to_fit();
+    string_data.shrink_to_fit();
+  }
+
+  std::vector<Node> nodes;
+  std::vector<Child> children;
+  std::vector<StringRef> keys;
+  std::string string_data;
+};
+
+}  // namespace internal
+
 namespace {
 
+using TapeKind = internal::JSONValueTape::Kind;
+using TapeNode = internal::JSONValueTape::Node;
+using TapeChild = internal::JSONValueTape::Child;
+
+// Adds the number in 'str' to 'builder'. To match the nlohmann json library
+// behavior, first tries to parse 'str' as unsigned int and only falls back to
+// int if the value is signed integer. This is to make sure that
+// is_number_unsigned() and is_number_integer() both return true for unsigned
+// integers.
+template <typename ValueBuilder>
+absl::Status ParseNumberInto(absl::string_view str, ValueBuilder& builder) {
+  uint64_t uint64_value;
+  if (absl::SimpleAtoi(str, &uint64_value)) {
+    return builder.ParsedUInt(uint64_value);
+  }
+  int64_t int64_value;
+  if (absl::SimpleAtoi(str, &int64_value)) {
+    return builder.ParsedInt(int64_value);
+  }
+  double double_value;
+  if (absl::SimpleAtod(str, &double_value)) {
+    return builder.ParsedDouble(double_value);
+  }
+  return absl::InternalError(
+      absl::Substitute("Attempting to parse invalid JSON number $0", str));
+}
+
 // A helper class that is used by the two parser implementations,
 // JSONValueLegacyParser and JSONValueStandardParser to construct a JSON
 // document tree from a given JSON string.
 class JSONValueBuilder {
  public:
+  using Target = JSON;
+
   // Constructs a builder that adds content to the given 'value'. If
   // 'max_nesting' has a value, then the parser will return an error when the
   // JSON document exceeds the max level of nesting. If 'max_nesting' is
@@ -137,24 +270,7 @@ class JSONValueBuilder {
   }
 
   absl::Status ParsedNumber(absl::string_view str) {
-    // To match the nlohmann json library behavior, first try to parse 'str' as
-    // unsigned int and only fallback to int if the value is signed integer.
-    // This is to make sure that is_number_unsigned() and is_number_integer()
-    // both return true for unsigned integers.
-    uint64_t uint64_value;
-    if (absl::SimpleAtoi(str, &uint64_value)) {
-      return HandleValue(uint64_value).status();
-    }
-    int64_t int64_value;
-    if (absl::SimpleAtoi(str, &int64_value)) {
-      return HandleValue(int64_value).status();
-    }
-    double double_value;
-    if (absl::SimpleAtod(str, &double_value)) {
-      return HandleValue(double_value).status();
-    }
-    return absl::InternalError(
-        absl::Substitute("Attempting to parse invalid JSON number $0", str));
+    return ParseNumberInto(str, *this);
   }
 
   absl::Status ParsedInt(int64_t val) { return HandleValue(val).status(); }
@@ -217,6 +333,421 @@ class JSONValueBuilder {
   JSON* object_member_ = nullptr;
 };
 
+// Builds a JSONValueTape from the same sequence of events that
+// JSONValueBuilder consumes. Used by the parsers when the compact
+// representation is requested.
+class JSONValueTapeBuilder {
+ public:
+  using Target = internal::JSONValueTape;
+
+  // Constructs a builder that appends the document to the given empty 'tape'.
+  // 'max_nesting' has the same semantics as for JSONValueBuilder.
+  JSONValueTapeBuilder(internal::JSONValueTape& tape,
+                       std::optional<int> max_nesting)
+      : tape_(tape), max_nesting_(max_nesting) {
+    if (max_nesting_.has_value() && *max_nesting_ < 0) {
+      max_nesting_ = 0;
+    }
+  }
+
+  absl::Status BeginObject() { return BeginContainer(TapeKind::kObject); }
+
+  absl::Status EndObject() {
+    // Members are sorted by key. For duplicate keys the first occurrence wins,
+    // which matches JSONValueBuilder. The nodes of the dropped duplicates stay
+    // in the tape but are unreachable.
+    auto first = pending_.begin() + open_.back().first_pending;
+    std::stable_sort(first, pending_.end(),
+                     [this](const TapeChild& lhs, const TapeChild& rhs) {
+                       return tape_.GetKey(lhs.key) < tape_.GetKey(rhs.key);
+                     });
+    pending_.erase(std::unique(first, pending_.end(),
+                               [](const TapeChild& lhs, const TapeChild& rhs) {
+                                 return lhs.key == rhs.key;
+                               }),
+                   pending_.end());
+    return EndContainer();
+  }
+
+  absl::Status BeginMember(const std::string& key) {
+    auto [it, inserted] =
+        key_ids_.try_emplace(key, static_cast<uint32_t>(tape_.keys.size()));
+    if (inserted) {
+      ZETASQL_ASSIGN_OR_RETURN(uint32_t offset, AppendStringData(key));
+      tape_.keys.push_back({offset, static_cast<uint32_t>(key.size())});
+    }
+    member_key_ = it->second;
+    return absl::OkStatus();
+  }
+
+  absl::Status BeginArray() { return BeginContainer(TapeKind::kArray); }
+
+  absl::Status EndArray() { return EndContainer(); }
+
+  absl::Status ParsedString(const std::string& str) {
+    TapeNode node{};
+    node.kind = TapeKind::kString;
+    node.size = static_cast<uint32_t>(str.size());
+    ZETASQL_ASSIGN_OR_RETURN(node.offset, AppendStringData(str));
+    return AddNode(node).status();
+  }
+
+  absl::Status ParsedNumber(absl::string_view str) {
+    return ParseNumberInto(str, *this);
+  }
+
+  absl::Status ParsedInt(int64_t val) {
+    TapeNode node{};
+    node.kind = TapeKind::kInt64;
+    node.int64_value = val;
+    return AddNode(node).status();
+  }
+
+  absl::Status ParsedUInt(uint64_t val) {
+    TapeNode node{};
+    node.kind = TapeKind::kUInt64;
+    node.uint64_value = val;
+    return AddNode(node).status();
+  }
+
+  absl::Status ParsedDouble(double val) {
+    TapeNode node{};
+    node.kind = TapeKind::kDouble;
+    node.double_value = val;
+    return AddNode(node).status();
+  }
+
+  absl::Status ParsedBool(bool val) {
+    TapeNode node{};
+    node.kind = TapeKind::kBoolean;
+    node.boolean_value = val;
+    return AddNode(node).status();
+  }
+
+  absl::Status ParsedNull() {
+    TapeNode node{};
+    node.kind = TapeKind::kNull;
+    return AddNode(node).status();
+  }
+
+ private:
+  // A container whose children are still being parsed.
+  struct OpenContainer {
+    // Index of the container node in the tape.
+    uint32_t node;
+    // Index of the first child of the container in 'pending_'.
+    size_t first_pending;
+  };
+
+  absl::Status BeginContainer(TapeKind kind) {
+    if (max_nesting_.has_value() && open_.size() >= *max_nesting_) {
+      return absl::InvalidArgumentError(
+          absl::StrCat("Max nesting of ", *max_nesting_,
+                       " has been exceeded while parsing JSON document"));
+    }
+    TapeNode node{};
+    node.kind = kind;
+    ZETASQL_ASSIGN_OR_RETURN(uint32_t index, AddNode(node));
+    open_.push_back({index, pending_.size()});
+    return absl::OkStatus();
+  }
+
+  // Moves the children of the innermost open container into a contiguous
+  // range of the tape. Nested containers are always closed before their
+  // parent, so the children of the innermost container are the suffix of
+  // 'pending_'.
+  absl::Status EndContainer() {
+    ZETASQL_RET_CHECK(!open_.empty());
+    const OpenContainer container = open_.back();
+    open_.pop_back();
+    if (tape_.children.size() > std::numeric_limits<uint32_t>::max()) {
+      return TooLargeError();
+    }
+    TapeNode& node = tape_.nodes[container.node];
+    node.offset = static_cast<uint32_t>(tape_.children.size());
+    node.size = static_cast<uint32_t>(pending_.size() - container.first_pending);
+    tape_.children.insert(tape_.children.end(),
+                          pending_.begin() + container.first_pending,
+                          pending_.end());
+    pending_.resize(container.first_pending);
+    return absl::OkStatus();
+  }
+
+  // Appends 'node' to the tape and registers it as a child of the innermost
+  // open container, if any. Returns the index of the node.
+  absl::StatusOr<uint32_t> AddNode(const TapeNode& node) {
+    if (tape_.nodes.size() >= std::numeric_limits<uint32_t>::max()) {
+      return TooLargeError();
+    }
+    const uint32_t index = static_cast<uint32_t>(tape_.nodes.size());
+    tape_.nodes.push_back(node);
+    if (!open_.empty()) {
+      pending_.push_back({member_key_, index});
+    }
+    return index;
+  }
+
+  absl::StatusOr<uint32_t> AppendStringData(absl::string_view str) {
+    if (tape_.string_data.size() + str.size() >
+        std::numeric_limits<uint32_t>::max()) {
+      return TooLargeError();
+    }
+    const uint32_t offset = static_cast<uint32_t>(tape_.string_data.size());
+    tape_.string_data.append(str.data(), str.size());
+    return offset;
+  }
+
+  static absl::Status TooLargeError() {
+    return absl::OutOfRangeError(
+        "JSON document is too large for the compact representation");
+  }
+
+  // The tape being built.
+  internal::JSONValueTape& tape_;
+  // Max nesting allowed.
+  std::optional<int> max_nesting_;
+  // Containers that have been started but not ended, innermost last.
+  std::vector<OpenContainer> open_;
+  // Children of all open containers, in the order of 'open_'.
+  std::vector<TapeChild> pending_;
+  // The key of the next object member.
+  uint32_t member_key_ = 0;
+  // Maps each interned key to its index in 'tape_.keys'.
+  absl::flat_hash_map<std::string, uint32_t> key_ids_;
+};
+
+// Feeds the subtree rooted at 'node_index' of 'tape' to 'builder' as if it
+// was being parsed.
+template <typename ValueBuilder>
+absl::Status ReplayTape(const internal::JSONValueTape& tape,
+                        uint32_t node_index, ValueBuilder& builder) {
+  const TapeNode& node = tape.nodes[node_index];
+  switch (node.kind) {
+    case TapeKind::kNull:
+      return builder.ParsedNull();
+    case TapeKind::kBoolean:
+      return builder.ParsedBool(node.boolean_value);
+    case TapeKind::kInt64:
+      return builder.ParsedInt(node.int64_value);
+    case TapeKind::kUInt64:
+      return builder.ParsedUInt(node.uint64_value);
+    case TapeKind::kDouble:
+      return builder.ParsedDouble(node.double_value);
+    case TapeKind::kString:
+      return builder.ParsedString(std::string(tape.GetString(node)));
+    case TapeKind::kObject:
+      ZETASQL_RETURN_IF_ERROR(builder.BeginObject());
+      for (const TapeChild& member : tape.GetChildren(node)) {
+        ZETASQL_RETURN_IF_ERROR(
+            builder.BeginMember(std::string(tape.GetKey(member.key))));
+        ZETASQL_RETURN_IF_ERROR(ReplayTape(tape, member.node, builder));
+      }
+      return builder.EndObject();
+    case TapeKind::kArray:
+      ZETASQL_RETURN_IF_ERROR(builder.BeginArray());
+      for (const TapeChild& element : tape.GetChildren(node)) {
+        ZETASQL_RETURN_IF_ERROR(ReplayTape(tape, element.node, builder));
+      }
+      return builder.EndArray();
+  }
+}
+
+// Converts the subtree rooted at 'node_index' of 'tape' into the default
+// representation.
+JSON TapeToJSON(const internal::JSONValueTape& tape, uint32_t node_index) {
+  JSON value;
+  JSONValueBuilder builder(value, /*max_nesting=*/std::nullopt);
+  ZETASQL_CHECK_OK(ReplayTape(tape, node_index, builder));
+  return value;
+}
+
+// Appends 'str' to 'output' as a JSON string, escaped like
+// nlohmann::json::dump() escapes it. The bytes of multi-byte UTF-8 characters
+// are all >= 0x80 and are copied as is.
+void AppendEscapedJSONString(absl::string_view str, std::string& output) {
+  static constexpr char kHexDigits[] = "0123456789abcdef";
+  output.push_back('"');
+  for (const char c : str) {
+    switch (c) {
+      case '\b':
+        output.append("\\b");
+        break;
+      case '\t':
+        output.append("\\t");
+        break;
+      case '\n':
+        output.append("\\n");
+        break;
+      case '\f':
+        output.append("\\f");
+        break;
+      case '\r':
+        output.append("\\r");
+        break;
+      case '"':
+        output.append("\\\"");
+        break;
+      case '\\':
+        output.append("\\\\");
+        break;
+      default:
+        if (static_cast<unsigned char>(c) <= 0x1F) {
+          output.append("\\u00");
+          output.push_back(kHexDigits[c >> 4]);
+          output.push_back(kHexDigits[c & 0xF]);
+        } else {
+          output.push_back(c);
+        }
+    }
+  }
+  output.push_back('"');
+}
+
+// Appends the subtree rooted at 'node_index' of 'tape' to 'output' exactly as
+// nlohmann::json::dump() serializes it in the default representation. The
+// output is compact if 'indent' is negative. Otherwise it has one value per
+// line, and nested values are indented by 'indent' more spaces than the
+// 'current_indent' of their container.
+void DumpTape(const internal::JSONValueTape& tape, uint32_t node_index,
+              int indent, int current_indent, std::string& output) {
+  const TapeNode& node = tape.nodes[node_index];
+  switch (node.kind) {
+    case TapeKind::kNull:
+      output.append("null");
+      return;
+    case TapeKind::kBoolean:
+      output.append(node.boolean_value ? "true" : "false");
+      return;
+    case TapeKind::kInt64:
+      absl::StrAppend(&output, node.int64_value);
+      return;
+    case TapeKind::kUInt64:
+      absl::StrAppend(&output, node.uint64_value);
+      return;
+    case TapeKind::kDouble: {
+      if (!std::isfinite(node.double_value)) {
+        output.append("null");
+        return;
+      }
+      std::array<char, 64> buffer;
+      char* end = nlohmann::detail::to_chars(
+          buffer.data(), buffer.data() + buffer.size(), node.double_value);
+      output.append(buffer.data(), end);
+      return;
+    }
+    case TapeKind::kString:
+      AppendEscapedJSONString(tape.GetString(node), output);
+      return;
+    case TapeKind::kObject:
+    case TapeKind::kArray: {
+      const bool is_object = node.kind == TapeKind::kObject;
+      if (node.size == 0) {
+        output.append(is_object ? "{}" : "[]");
+        return;
+      }
+      output.push_back(is_object ? '{' : '[');
+      const int child_indent = current_indent + indent;
+      bool first = true;
+      for (const TapeChild& child : tape.GetChildren(node)) {
+        if (!first) {
+          output.push_back(',');
+        }
+        first = false;
+        if (indent >= 0) {
+          output.push_back('\n');
+          output.append(child_indent, ' ');
+        }
+        if (is_object) {
+          AppendEscapedJSONString(tape.GetKey(child.key), output);
+          output.append(indent >= 0 ? ": " : ":");
+        }
+        DumpTape(tape, child.node, indent, child_indent, output);
+      }
+      if (indent >= 0) {
+        output.push_back('\n');
+        output.append(current_indent, ' ');
+      }
+      output.push_back(is_object ? '}' : ']');
+      return;
+    }
+  }
+}
+
+using UBJSONWriter = nlohmann::detail::binary_writer<JSON, char>;
+
+// Appends the subtree rooted at 'node_index' of 'tape' to 'output' exactly as
+// nlohmann::json::to_ubjson() encodes it in the default representation.
+// 'writer' writes to 'output' and encodes the numbers, which only needs a
+// scalar nlohmann::json value.
+void WriteTapeAsUBJSON(const internal::JSONValueTape& tape, uint32_t node_index,
+                       UBJSONWriter& writer, std::string& output) {
+  const TapeNode& node = tape.nodes[node_index];
+  switch (node.kind) {
+    case TapeKind::kNull:
+      output.push_back('Z');
+      return;
+    case TapeKind::kBoolean:
+      output.push_back(node.boolean_value ? 'T' : 'F');
+      return;
+    case TapeKind::kInt64:
+      writer.write_ubjson(JSON(node.int64_value), /*use_count=*/false,
+                          /*use_type=*/false);
+      return;
+    case TapeKind::kUInt64:
+      writer.write_ubjson(JSON(node.uint64_value), /*use_count=*/false,
+                          /*use_type=*/false);
+      return;
+    case TapeKind::kDouble:
+      writer.write_ubjson(JSON(node.double_value), /*use_count=*/false,
+                          /*use_type=*/false);
+      return;
+    case TapeKind::kString: {
+      output.push_back('S');
+      writer.write_ubjson(JSON(uint64_t{node.size}), /*use_count=*/false,
+                          /*use_type=*/false);
+      const absl::string_view str = tape.GetString(node);
+      output.append(str.data(), str.size());
+      return;
+    }
+    case TapeKind::kObject:
+      output.push_back('{');
+      for (const TapeChild& member : tape.GetChildren(node)) {
+        const absl::string_view key = tape.GetKey(member.key);
+        writer.write_ubjson(JSON(uint64_t{key.size()}), /*use_count=*/false,
+                            /*use_type=*/false);
+        output.append(key.data(), key.size());
+        WriteTapeAsUBJSON(tape, member.node, writer, output);
+      }
+      output.push_back('}');
+      return;
+    case TapeKind::kArray:
+      output.push_back('[');
+      for (const TapeChild& element : tape.GetChildren(node)) {
+        WriteTapeAsUBJSON(tape, element.node, writer, output);
+      }
+      output.push_back(']');
+      return;
+  }
+}
+
+// Returns the number value of 'node' converted to 'T'. Follows the conversion
+// rules of nlohmann::json::get<T>() for the default representation.
+template <typename T>
+T GetTapeNumber(const TapeNode& node) {
+  switch (node.kind) {
+    case TapeKind::kInt64:
+      return static_cast<T>(node.int64_value);
+    case TapeKind::kUInt64:
+      return static_cast<T>(node.uint64_value);
+    case TapeKind::kDouble:
+      return static_cast<T>(node.double_value);
+    case TapeKind::kBoolean:
+      return static_cast<T>(node.boolean_value);
+    default:
+      ZETASQL_LOG(FATAL) << "JSON value is not a number";
+  }
+}
+
 // The base class for JSONValue parsers that provides status tracking.
 class JSONValueParserBase {
  public:
@@ -244,10 +775,13 @@ class JSONValueParserBase {
 };
 
 // The parser implementation that uses proto based legacy ZetaSQL JSON parser.
+// 'ValueBuilder' is either JSONValueBuilder or JSONValueTapeBuilder.
+template <typename ValueBuilder>
 class JSONValueLegacyParser : public ::zetasql::JSONParser,
                               public JSONValueParserBase {
  public:
-  JSONValueLegacyParser(absl::string_view str, JSON& value,
+  JSONValueLegacyParser(absl::string_view str,
+                        typename ValueBuilder::Target& value,
                         std::optional<int> max_nesting)
       : zetasql::JSONParser(str), value_builder_(value, max_nesting) {}
 
@@ -296,16 +830,19 @@ class JSONValueLegacyParser : public ::zetasql::JSONParser,
   }
 
  private:
-  JSONValueBuilder value_builder_;
+  ValueBuilder value_builder_;
 };
 
 // The parser implementation that uses nlohmann library implementation based on
 // the JSON RFC.
 //
 // NOTE: Method names are specific requirement of nlohmann SAX parser interface.
+// 'ValueBuilder' is either JSONValueBuilder or JSONValueTapeBuilder.
+template <typename ValueBuilder>
 class JSONValueStandardParser : public JSONValueParserBase {
  public:
-  JSONValueStandardParser(JSON& value, bool strict_number_parsing,
+  JSONValueStandardParser(typename ValueBuilder::Target& value,
+                          bool strict_number_parsing,
                           std::optional<int> max_nesting)
       : value_builder_(value, max_nesting),
         strict_number_parsing_(strict_number_parsing) {}
@@ -375,10 +912,37 @@ class JSONValueStandardParser : public JSONValueParserBase {
   bool is_errored() const { return !status().ok(); }
 
  private:
-  JSONValueBuilder value_builder_;
+  ValueBuilder value_builder_;
   const bool strict_number_parsing_;
 };
 
+// Parses 'str' into 'value' using the parser selected by 'parsing_options'.
+template <typename ValueBuilder>
+absl::Status ParseJSONStringInto(absl::string_view str,
+                                 const JSONParsingOptions& parsing_options,
+                                 typename ValueBuilder::Target& value) {
+  if (parsing_options.legacy_mode) {
+    ZETASQL_RET_CHECK(!parsing_options.strict_number_parsing)
+        << "Strict number parsing not supported in legacy mode.";
+    JSONValueLegacyParser<ValueBuilder> parser(str, value,
+                                               parsing_options.max_nesting);
+    if (!parser.Parse()) {
+      if (parser.status().ok()) {
+        return absl::InternalError(
+            "Parsing JSON failed but didn't return an error");
+      } else {
+        return parser.status();
+      }
+    }
+    return absl::OkStatus();
+  }
+  JSONValueStandardParser<ValueBuilder> parser(
+      value, parsing_options.strict_number_parsing,
+      parsing_options.max_nesting);
+  JSON::sax_parse(str, &parser);
+  return parser.status();
+}
+
 // The parser implementation that uses nlohmann library implementation based on
 // the JSON RFC. This parser only checks some general properties and is used for
 // validation.
@@ -491,36 +1055,25 @@ struct JSONValue::Impl {
 StatusOr<JSONValue> JSONValue::ParseJSONString(
     absl::string_view str, JSONParsingOptions parsing_options) {
   JSONValue json;
-  if (parsing_options.legacy_mode) {
-    ZETASQL_RET_CHECK(!parsing_options.strict_number_parsing)
-        << "Strict number parsing not supported in legacy mode.";
-    JSONValueLegacyParser parser(str, json.impl_->value,
-                                 parsing_options.max_nesting);
-    if (!parser.Parse()) {
-      if (parser.status().ok()) {
-        return absl::InternalError(
-            "Parsing JSON failed but didn't return an error");
-      } else {
-        return parser.status();
-      }
-    }
+  if (parsing_options.compact_representation) {
+    auto tape = std::make_unique<internal::JSONValueTape>();
+    ZETASQL_RETURN_IF_ERROR(ParseJSONStringInto<JSONValueTapeBuilder>(
+        str, parsing_options, *tape));
+    tape->ShrinkToFit();
+    json.tape_ = std::move(tape);
   } else {
-    JSONValueStandardParser parser(json.impl_->value,
-                                   parsing_options.strict_number_parsing,
-                                   parsing_options.max_nesting);
-    JSON::sax_parse(str, &parser);
-    ZETASQL_RETURN_IF_ERROR(parser.status());
+    ZETASQL_RETURN_IF_ERROR(ParseJSONStringInto<JSONValueBuilder>(
+        str, parsing_options, json.impl_->value));
   }
-
   return json;
 }
 
 StatusOr<JSONValue> JSONValue::DeserializeFromProtoBytes(
     absl::string_view str, std::optional<int> max_nesting_level) {
   JSONValue json;
-  JSONValueStandardParser parser(json.impl_->value,
-                                 /*strict_number_parsing=*/false,
-                                 max_nesting_level);
+  JSONValueStandardParser<JSONValueBuilder> parser(
+      json.impl_->value,
+      /*strict_number_parsing=*/false, max_nesting_level);
   JSON::sax_parse(str, &parser, JSON::input_format_t::ubjson);
   ZETASQL_RETURN_IF_ERROR(parser.status());
   return json;
@@ -528,10 +1081,29 @@ StatusOr<JSONValue> JSONValue::DeserializeFromProtoBytes(
 
 JSONValue JSONValue::CopyFrom(JSONValueConstRef value) {
   JSONValue copy;
+  if (value.tape_ != nullptr) {
+    if (value.tape_node_ == 0) {
+      copy.tape_ = std::make_unique<internal::JSONValueTape>(*value.tape_);
+    } else {
+      copy.tape_ = std::make_unique<internal::JSONValueTape>();
+      JSONValueTapeBuilder builder(*copy.tape_, /*max_nesting=*/std::nullopt);
+      ZETASQL_CHECK_OK(ReplayTape(*value.tape_, value.tape_node_, builder));
+      copy.tape_->ShrinkToFit();
+    }
+    return copy;
+  }
   copy.impl_->value = value.impl_->value;
   return copy;
 }
 
+void JSONValue::MaterializeTape() {
+  if (tape_ == nullptr) {
+    return;
+  }
+  impl_->value = TapeToJSON(*tape_, 0);
+  materialized_tape_ = std::move(tape_);
+}
+
 JSONValue::JSONValue() : impl_(std::make_unique<Impl>()) {}
 
 JSONValue::JSONValue(int64_t value) : impl_(new Impl{value}) {}
@@ -540,37 +1112,91 @@ JSONValue::JSONValue(double value) : impl_(new Impl{value}) {}
 JSONValue::JSONValue(bool value) : impl_(new Impl{value}) {}
 JSONValue::JSONValue(std::string value) : impl_(new Impl{std::move(value)}) {}
 
-JSONValue::JSONValue(JSONValue&& value) : impl_(std::move(value.impl_)) {}
+JSONValue::JSONValue(JSONValue&& value)
+    : impl_(std::move(value.impl_)),
+      tape_(std::move(value.tape_)),
+      materialized_tape_(std::move(value.materialized_tape_)) {}
 
 JSONValue::~JSONValue() {}
 
 JSONValue& JSONValue::operator=(JSONValue&& value) {
   impl_ = std::move(value.impl_);
+  tape_ = std::move(value.tape_);
+  materialized_tape_ = std::move(value.materialized_tape_);
   return *this;
 }
 
-JSONValueRef JSONValue::GetRef() { return JSONValueRef(impl_.get()); }
+JSONValueRef JSONValue::GetRef() {
+  MaterializeTape();
+  return JSONValueRef(impl_.get());
+}
 
 JSONValueConstRef JSONValue::GetConstRef() const {
+  if (tape_ != nullptr) {
+    return JSONValueConstRef(tape_.get(), /*node=*/0);
+  }
   return JSONValueConstRef(impl_.get());
 }
 
 JSONValueConstRef::JSONValueConstRef(const JSONValue::Impl* value_pointer)
     : impl_(value_pointer) {}
 
-bool JSONValueConstRef::IsBoolean() const { return impl_->value.is_boolean(); }
+JSONValueConstRef::JSONValueConstRef(const internal::JSONValueTape* tape,
+                                     uint32_t node)
+    : impl_(nullptr), tape_(tape), tape_node_(node) {}
 
-bool JSONValueConstRef::IsNumber() const { return impl_->value.is_number(); }
+bool JSONValueConstRef::IsBoolean() const {
+  if (tape_ != nullptr) {
+    return tape_->nodes[tape_node_].kind == TapeKind::kBoolean;
+  }
+  return impl_->value.is_boolean();
+}
 
-bool JSONValueConstRef::IsNull() const { return impl_->value.is_null(); }
+bool JSONValueConstRef::IsNumber() const {
+  if (tape_ != nullptr) {
+    const TapeKind kind = tape_->nodes[tape_node_].kind;
+    return kind == TapeKind::kInt64 || kind == TapeKind::kUInt64 ||
+           kind == TapeKind::kDouble;
+  }
+  return impl_->value.is_number();
+}
+
+bool JSONValueConstRef::IsNull() const {
+  if (tape_ != nullptr) {
+    return tape_->nodes[tape_node_].kind == TapeKind::kNull;
+  }
+  return impl_->value.is_null();
+}
 
-bool JSONValueConstRef::IsString() const { return impl_->value.is_string(); }
+bool JSONValueConstRef::IsString() const {
+  if (tape_ != nullptr) {
+    return tape_->nodes[tape_node_].kind == TapeKind::kString;
+  }
+  return impl_->value.is_string();
+}
 
-bool JSONValueConstRef::IsObject() const { return impl_->value.is_object(); }
+bool JSONValueConstRef::IsObject() const {
+  if (tape_ != nullptr) {
+    return tape_->nodes[tape_node_].kind == TapeKind::kObject;
+  }
+  return impl_->value.is_object();
+}
 
-bool JSONValueConstRef::IsArray() const { return impl_->value.is_array(); }
+bool JSONValueConstRef::IsArray() const {
+  if (tape_ != nullptr) {
+    return tape_->nodes[tape_node_].kind == TapeKind::kArray;
+  }
+  return impl_->value.is_array();
+}
 
 bool JSONValueConstRef::IsInt64() const {
+  if (tape_ != nullptr) {
+    const TapeNode& node = tape_->nodes[tape_node_];
+    return node.kind == TapeKind::kInt64 ||
+           (node.kind == TapeKind::kUInt64 &&
+            node.uint64_value <=
+                static_cast<uint64_t>(std::numeric_limits<int64_t>::max()));
+  }
   // is_number_integer() returns true for both signed and unsigned values. We
   // need to make sure that the value fits int64_t if it is unsigned.
   return impl_->value.is_number_integer() &&
@@ -579,49 +1205,103 @@ bool JSONValueConstRef::IsInt64() const {
 }
 
 bool JSONValueConstRef::IsUInt64() const {
+  if (tape_ != nullptr) {
+    return tape_->nodes[tape_node_].kind == TapeKind::kUInt64;
+  }
   return impl_->value.is_number_unsigned();
 }
 
 bool JSONValueConstRef::IsDouble() const {
+  if (tape_ != nullptr) {
+    return tape_->nodes[tape_node_].kind == TapeKind::kDouble;
+  }
   return impl_->value.is_number_float();
 }
 
 int64_t JSONValueConstRef::GetInt64() const {
+  if (tape_ != nullptr) {
+    return GetTapeNumber<int64_t>(tape_->nodes[tape_node_]);
+  }
   return impl_->value.get<int64_t>();
 }
 
 uint64_t JSONValueConstRef::GetUInt64() const {
+  if (tape_ != nullptr) {
+    return GetTapeNumber<uint64_t>(tape_->nodes[tape_node_]);
+  }
   return impl_->value.get<uint64_t>();
 }
 
 double JSONValueConstRef::GetDouble() const {
+  if (tape_ != nullptr) {
+    return GetTapeNumber<double>(tape_->nodes[tape_node_]);
+  }
   return impl_->value.get<double>();
 }
 
 std::string JSONValueConstRef::GetString() const {
+  if (tape_ != nullptr) {
+    if (ABSL_PREDICT_FALSE(!IsString())) {
+      ZETASQL_LOG(FATAL) << "JSON value is not a string";
+    }
+    return std::string(tape_->GetString(tape_->nodes[tape_node_]));
+  }
   return impl_->value.get<std::string>();
 }
 
-bool JSONValueConstRef::GetBoolean() const { return impl_->value.get<bool>(); }
+bool JSONValueConstRef::GetBoolean() const {
+  if (tape_ != nullptr) {
+    if (ABSL_PREDICT_FALSE(!IsBoolean())) {
+      ZETASQL_LOG(FATAL) << "JSON value is not a boolean";
+    }
+    return tape_->nodes[tape_node_].boolean_value;
+  }
+  return impl_->value.get<bool>();
+}
 
 size_t JSONValueConstRef::GetObjectSize() const {
   if (ABSL_PREDICT_FALSE(!IsObject())) {
     ZETASQL_LOG(FATAL) << "JSON value is not an object";
   }
+  if (tape_ != nullptr) {
+    return tape_->nodes[tape_node_].size;
+  }
   return impl_->value.size();
 }
 
 bool JSONValueConstRef::HasMember(absl::string_view key) const {
+  if (tape_ != nullptr) {
+    return IsObject() &&
+           tape_->FindMember(tape_->nodes[tape_node_], key).has_value();
+  }
   return impl_->value.find(key) != impl_->value.end();
 }
 
 JSONValueConstRef JSONValueConstRef::GetMember(absl::string_view key) const {
+  if (tape_ != nullptr) {
+    std::optional<JSONValueConstRef> member = GetMemberIfExists(key);
+    if (ABSL_PREDICT_FALSE(!member.has_value())) {
+      ZETASQL_LOG(FATAL) << "JSON value does not have member " << key;
+    }
+    return *member;
+  }
   return JSONValueConstRef(reinterpret_cast<const JSONValue::Impl*>(
       &impl_->value[std::string(key)]));
 }
 
 std::optional<JSONValueConstRef> JSONValueConstRef::GetMemberIfExists(
     absl::string_view key) const {
+  if (tape_ != nullptr) {
+    if (!IsObject()) {
+      return std::nullopt;
+    }
+    std::optional<uint32_t> member =
+        tape_->FindMember(tape_->nodes[tape_node_], key);
+    if (!member.has_value()) {
+      return std::nullopt;
+    }
+    return JSONValueConstRef(tape_, *member);
+  }
   auto iter = impl_->value.find(key);
   if (iter == impl_->value.end()) {
     return std::nullopt;
@@ -633,6 +1313,19 @@ std::optional<JSONValueConstRef> JSONValueConstRef::GetMemberIfExists(
 std::vector<std::pair<absl::string_view, JSONValueConstRef>>
 JSONValueConstRef::GetMembers() const {
   std::vector<std::pair<absl::string_view, JSONValueConstRef>> members;
+  if (tape_ != nullptr) {
+    if (ABSL_PREDICT_FALSE(!IsObject())) {
+      ZETASQL_LOG(FATAL) << "JSON value is not an object";
+    }
+    absl::Span<const TapeChild> children =
+        tape_->GetChildren(tape_->nodes[tape_node_]);
+    members.reserve(children.size());
+    for (const TapeChild& member : children) {
+      members.push_back({tape_->GetKey(member.key),
+                         JSONValueConstRef(tape_, member.node)});
+    }
+    return members;
+  }
   for (auto& member : impl_->value.items()) {
     members.push_back(
         {member.key(),
@@ -646,16 +1339,41 @@ size_t JSONValueConstRef::GetArraySize() const {
   if (ABSL_PREDICT_FALSE(!IsArray())) {
     ZETASQL_LOG(FATAL) << "JSON value is not an array";
   }
+  if (tape_ != nullptr) {
+    return tape_->nodes[tape_node_].size;
+  }
   return impl_->value.size();
 }
 
 JSONValueConstRef JSONValueConstRef::GetArrayElement(size_t index) const {
+  if (tape_ != nullptr) {
+    if (ABSL_PREDICT_FALSE(!IsArray())) {
+      ZETASQL_LOG(FATAL) << "JSON value is not an array";
+    }
+    const TapeNode& node = tape_->nodes[tape_node_];
+    ZETASQL_DCHECK_LT(index, node.size);
+    return JSONValueConstRef(tape_, tape_->children[node.offset + index].node);
+  }
   return JSONValueConstRef(
       reinterpret_cast<const JSONValue::Impl*>(&impl_->value[index]));
 }
 
 std::vector<JSONValueConstRef> JSONValueConstRef::GetArrayElements() const {
   std::vector<JSONValueConstRef> elements;
+  if (tape_ != nullptr) {
+    // Matches iteration over the default representation: containers yield
+    // their children, null yields nothing and other scalars yield themselves.
+    const TapeNode& node = tape_->nodes[tape_node_];
+    if (tape_->IsContainer(node)) {
+      elements.reserve(node.size);
+      for (const TapeChild& element : tape_->GetChildren(node)) {
+        elements.push_back(JSONValueConstRef(tape_, element.node));
+      }
+    } else if (node.kind != TapeKind::kNull) {
+      elements.push_back(*this);
+    }
+    return elements;
+  }
   for (auto& element : impl_->value) {
     elements.emplace_back(
         JSONValueConstRef(reinterpret_cast<const JSONValue::Impl*>(&element)));
@@ -663,14 +1381,31 @@ std::vector<JSONValueConstRef> JSONValueConstRef::GetArrayElements() const {
   return elements;
 }
 
-std::string JSONValueConstRef::ToString() const { return impl_->value.dump(); }
+std::string JSONValueConstRef::ToString() const {
+  if (tape_ != nullptr) {
+    std::string output;
+    DumpTape(*tape_, tape_node_, /*indent=*/-1, /*current_indent=*/0, output);
+    return output;
+  }
+  return impl_->value.dump();
+}
 
 std::string JSONValueConstRef::Format() const {
+  if (tape_ != nullptr) {
+    std::string output;
+    DumpTape(*tape_, tape_node_, /*indent=*/2, /*current_indent=*/0, output);
+    return output;
+  }
   return impl_->value.dump(/*indent=*/2);
 }
 
 void JSONValueConstRef::SerializeAndAppendToProtoBytes(
     std::string* output) const {
+  if (tape_ != nullptr) {
+    UBJSONWriter writer{nlohmann::detail::output_adapter<char>(*output)};
+    WriteTapeAsUBJSON(*tape_, tape_node_, writer, *output);
+    return;
+  }
   JSON::to_ubjson(impl_->value, *output);
 }
 
@@ -686,6 +1421,39 @@ uint64_t EstimateStringSpaceUsed(const std::string& str) {
 }  // namespace
 
 uint64_t JSONValueConstRef::SpaceUsed() const {
+  if (tape_ != nullptr) {
+    uint64_t space_used = sizeof(JSONValue) + sizeof(internal::JSONValueTape);
+    if (tape_node_ == 0) {
+      // The whole document is referenced.
+      return space_used +
+             tape_->nodes.capacity() * sizeof(internal::JSONValueTape::Node) +
+             tape_->children.capacity() * sizeof(TapeChild) +
+             tape_->keys.capacity() *
+                 sizeof(internal::JSONValueTape::StringRef) +
+             tape_->string_data.capacity();
+    }
+    // Estimate the space a copy of the subtree would use. Interned keys are
+    // attributed to every member using them.
+    std::vector<uint32_t> nodes = {tape_node_};
+    while (!nodes.empty()) {
+      const TapeNode& node = tape_->nodes[nodes.back()];
+      nodes.pop_back();
+      space_used += sizeof(TapeNode);
+      if (node.kind == TapeKind::kString) {
+        space_used += node.size;
+      } else if (tape_->IsContainer(node)) {
+        for (const TapeChild& child : tape_->GetChildren(node)) {
+          space_used += sizeof(TapeChild);
+          if (node.kind == TapeKind::kObject) {
+            space_used += tape_->GetKey(child.key).size() +
+                          sizeof(internal::JSONValueTape::StringRef);
+          }
+          nodes.push_back(child.node);
+        }
+      }
+    }
+    return space_used;
+  }
   uint64_t space_used = sizeof(JSONValue);
   std::queue<const JSON*> nodes;
   nodes.push(&impl_->value);
@@ -724,6 +1492,26 @@ bool JSONValueConstRef::NestingLevelExceedsMax(int64_t max_nesting) const {
   if (!IsArray() && !IsObject()) {
     return false;
   }
+  if (tape_ != nullptr) {
+    // Same traversal as below over the children ranges of the tape.
+    std::stack<absl::Span<const TapeChild>> stack;
+    stack.push(tape_->GetChildren(tape_->nodes[tape_node_]));
+    while (!stack.empty()) {
+      if (stack.size() > max_nesting) {
+        return true;
+      }
+      if (stack.top().empty()) {
+        stack.pop();
+        continue;
+      }
+      const TapeNode& first_child = tape_->nodes[stack.top().front().node];
+      stack.top().remove_prefix(1);
+      if (tape_->IsContainer(first_child)) {
+        stack.push(tape_->GetChildren(first_child));
+      }
+    }
+    return false;
+  }
   // For each element in the stack, it holds the [begin,end) iterators of
   // unproccessed JSON document.
   std::stack<std::pair<JSON::const_iterator, JSON::const_iterator>> stack;
@@ -753,7 +1541,71 @@ bool JSONValueConstRef::NestingLevelExceedsMax(int64_t max_nesting) const {
 // casting the integer into a floating point and comparing the numbers as
 // floating points. Signed and unsigned integers can also be equal.
 bool JSONValueConstRef::NormalizedEquals(JSONValueConstRef that) const {
-  return impl_->value == that.impl_->value;
+  if (tape_ == nullptr && that.tape_ == nullptr) {
+    return impl_->value == that.impl_->value;
+  }
+  // At least one side is in compact representation. Compare node by node with
+  // the same rules as nlohmann's operator==.
+  if (IsNumber() && that.IsNumber()) {
+    if (IsDouble() || that.IsDouble()) {
+      auto as_double = [](JSONValueConstRef ref) {
+        return ref.IsDouble()    ? ref.GetDouble()
+               : ref.IsUInt64() ? static_cast<double>(ref.GetUInt64())
+                                 : static_cast<double>(ref.GetInt64());
+      };
+      return as_double(*this) == as_double(that);
+    }
+    if (IsUInt64() && that.IsUInt64()) {
+      return GetUInt64() == that.GetUInt64();
+    }
+    // Signed and unsigned integers compare as signed.
+    auto as_int64 = [](JSONValueConstRef ref) {
+      return ref.IsUInt64() ? static_cast<int64_t>(ref.GetUInt64())
+                            : ref.GetInt64();
+    };
+    return as_int64(*this) == as_int64(that);
+  }
+  if (IsString() && that.IsString()) {
+    auto as_string_view = [](JSONValueConstRef ref) -> absl::string_view {
+      if (ref.tape_ != nullptr) {
+        return ref.tape_->GetString(ref.tape_->nodes[ref.tape_node_]);
+      }
+      return ref.impl_->value.get_ref<const std::string&>();
+    };
+    return as_string_view(*this) == as_string_view(that);
+  }
+  if (IsBoolean() && that.IsBoolean()) {
+    return GetBoolean() == that.GetBoolean();
+  }
+  if (IsNull() && that.IsNull()) {
+    return true;
+  }
+  if (IsArray() && that.IsArray()) {
+    const size_t size = GetArraySize();
+    if (size != that.GetArraySize()) {
+      return false;
+    }
+    for (size_t i = 0; i < size; ++i) {
+      if (!GetArrayElement(i).NormalizedEquals(that.GetArrayElement(i))) {
+        return false;
+      }
+    }
+    return true;
+  }
+  if (IsObject() && that.IsObject()) {
+    if (GetObjectSize() != that.GetObjectSize()) {
+      return false;
+    }
+    for (const auto& [key, member] : GetMembers()) {
+      std::optional<JSONValueConstRef> that_member =
+          that.GetMemberIfExists(key);
+      if (!that_member.has_value() || !member.NormalizedEquals(*that_member)) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return false;
 }
 
 JSONValueRef::JSONValueRef(JSONValue::Impl* impl)
@@ -801,6 +1653,7 @@ void JSONValueRef::SetString(absl::string_view value) { impl_->value = value; }
 void JSONValueRef::SetBoolean(bool value) { impl_->value = value; }
 
 void JSONValueRef::Set(JSONValue json_value) {
+  json_value.MaterializeTape();
   impl_->value = std::move(json_value.impl_->value);
 }
 
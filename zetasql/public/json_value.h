@@ -38,6 +38,10 @@ namespace zetasql {
 class JSONValueConstRef;
 class JSONValueRef;
 
+namespace internal {
+struct JSONValueTape;
+}  // namespace internal
+
 // Options for parsing an input JSON-formatted string.
 struct JSONParsingOptions {
   // If 'legacy_mode' is set to true, the parsing will be done using the legacy
@@ -55,6 +59,14 @@ struct JSONParsingOptions {
   // to a negative number, the max nesting will be set to 0 instead (i.e. only
   // allowing scalar JSONs). JSON Arrays and Objects increase nesting levels.
   std::optional<int> max_nesting;
+  // If 'compact_representation' is set to true, the parsed document is stored
+  // in a read-optimized representation: all nodes live in one contiguous
+  // array, object keys are interned and object members are sorted by key so
+  // that member lookup is a binary search. It uses considerably less memory
+  // than the default representation and is intended for documents that are
+  // only read, such as JSON-typed values. Obtaining a JSONValueRef to the
+  // document converts it to the default mutable representation.
+  bool compact_representation = false;
 };
 
 // Returns whether 'json_str' is a valid JSON string.
@@ -95,6 +107,9 @@ class JSONValue final {
 
   // Returns a read/write reference to the JSON value. The reference can be used
   // to access or update the value including object members and array elements.
+  // If the document is in compact representation, converts it to the default
+  // representation first. References obtained from GetConstRef() before the
+  // conversion remain valid but keep reading the document as it was then.
   JSONValueRef GetRef();
   // Returns a read-only reference to the JSON value. The reference can be used
   // to read the value including object members and array elements.
@@ -116,13 +131,29 @@ class JSONValue final {
       absl::string_view str,
       std::optional<int> max_nesting_level = std::nullopt);
 
-  // Returns a JSON value that is a deep copy of the given value.
+  // Returns a JSON value that is a deep copy of the given value. If 'value'
+  // references a document in compact representation, the copy uses the compact
+  // representation as well.
   static JSONValue CopyFrom(JSONValueConstRef value);
 
+  // Returns true if the document is stored in the compact, read-optimized
+  // representation (see JSONParsingOptions::compact_representation).
+  bool IsCompact() const { return tape_ != nullptr; }
+
  private:
   struct Impl;
 
+  // Converts a document in compact representation into the default mutable
+  // representation. No-op if the document is not compact.
+  void MaterializeTape();
+
   std::unique_ptr<Impl> impl_;
+  // Set iff the document is stored in compact representation, in which case
+  // 'impl_' holds a null value and is not used.
+  std::unique_ptr<internal::JSONValueTape> tape_;
+  // The tape of a document that MaterializeTape() converted, kept alive for the
+  // JSONValueConstRefs that still point into it.
+  std::unique_ptr<internal::JSONValueTape> materialized_tape_;
 
   friend class JSONValueConstRef;
   friend class JSONValueRef;
@@ -238,9 +269,14 @@ class JSONValueConstRef {
 
  protected:
   explicit JSONValueConstRef(const JSONValue::Impl* value_pointer);
+  JSONValueConstRef(const internal::JSONValueTape* tape, uint32_t node);
 
  private:
   const JSONValue::Impl* impl_;
+  // If non-null, the reference points to node 'tape_node_' of a document in
+  // compact representation and 'impl_' is unused.
+  const internal::JSONValueTape* tape_ = nullptr;
+  uint32_t tape_node_ = 0;
 
   friend class JSONValue;
 };
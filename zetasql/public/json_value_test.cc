@@ -36,6 +36,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
 
@@ -723,7 +724,16 @@ INSTANTIATE_TEST_SUITE_P(
                       JSONParsingOptions{.legacy_mode = false,
                                          .strict_number_parsing = false},
                       JSONParsingOptions{.legacy_mode = false,
-                                         .strict_number_parsing = true}));
+                                         .strict_number_parsing = true},
+                      JSONParsingOptions{.legacy_mode = true,
+                                         .strict_number_parsing = false,
+                                         .compact_representation = true},
+                      JSONParsingOptions{.legacy_mode = false,
+                                         .strict_number_parsing = false,
+                                         .compact_representation = true},
+                      JSONParsingOptions{.legacy_mode = false,
+                                         .strict_number_parsing = true,
+                                         .compact_representation = true}));
 
 TEST(JSONStrictNumberParsingTest, NumberParsingSuccess) {
   JSONParsingOptions options{.legacy_mode = false,
@@ -1336,6 +1346,217 @@ TEST(JSONValueTest, ParseWithNestingLimit) {
           "Max nesting of 3 has been exceeded while parsing JSON document"));
 }
 
+constexpr JSONParsingOptions kCompactParsingOptions{
+    .legacy_mode = false,
+    .strict_number_parsing = false,
+    .compact_representation = true};
+
+TEST(JSONCompactRepresentationTest, MatchesDefaultRepresentation) {
+  std::vector<std::string> jsons = {
+      "10",
+      "-1.3123",
+      "18446744073709551615",
+      "null",
+      "true",
+      R"("foo")",
+      R"([])",
+      R"({})",
+      R"([10, "bar", null])",
+      R"({"foo": "bar", "abc": null, "bar": 15})",
+      R"({"a": {"b": {"c": [10, null, [null, "a", 1e10]]}}})",
+      R"([[[[[[[[10], null], "foo"]]]]]])",
+      R"([10, {"foo": 20}, [null, "abc", {"bar": "baz"}]])",
+      R"({"z": 1, "a": {"z": 2, "a": 3}, "m": [{"z": 4}, {"a": 5}]})",
+      R"({"a": [], "b": {}, "c": [[], {}, [{}]]})",
+      R"([-9223372036854775808, -1, 0, 127, 128, 255, 256, 32768, 4294967296])",
+      R"([0.1, -0.0, 3.0, 1e100, 1.5e-7, -2.5e300, 123456789012345678901])",
+      R"(["", "\"\\\/\b\f\n\r\t", "\u0001\u001f\u007f"])",
+      R"(["caf\u00e9", "\ud83d\ude00"])",
+      R"({"\n": "key with a newline", "\u00e9": ["\u0000"]})",
+      kJSONStr,
+  };
+
+  for (const std::string& json : jsons) {
+    SCOPED_TRACE(json);
+    ZETASQL_ASSERT_OK_AND_ASSIGN(JSONValue value, JSONValue::ParseJSONString(json));
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        JSONValue compact,
+        JSONValue::ParseJSONString(json, kCompactParsingOptions));
+    EXPECT_FALSE(value.IsCompact());
+    EXPECT_TRUE(compact.IsCompact());
+    EXPECT_EQ(compact.GetConstRef().ToString(), value.GetConstRef().ToString());
+    EXPECT_EQ(compact.GetConstRef().Format(), value.GetConstRef().Format());
+    EXPECT_TRUE(compact.GetConstRef().NormalizedEquals(value.GetConstRef()));
+    EXPECT_TRUE(value.GetConstRef().NormalizedEquals(compact.GetConstRef()));
+
+    std::string value_bytes;
+    std::string compact_bytes;
+    value.GetConstRef().SerializeAndAppendToProtoBytes(&value_bytes);
+    compact.GetConstRef().SerializeAndAppendToProtoBytes(&compact_bytes);
+    EXPECT_EQ(compact_bytes, value_bytes);
+
+    for (int max_nesting = 0; max_nesting < 10; ++max_nesting) {
+      EXPECT_EQ(compact.GetConstRef().NestingLevelExceedsMax(max_nesting),
+                value.GetConstRef().NestingLevelExceedsMax(max_nesting));
+    }
+  }
+}
+
+TEST(JSONCompactRepresentationTest, MemberAccess) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      JSONValue value,
+      JSONValue::ParseJSONString(kJSONStr, kCompactParsingOptions));
+  JSONValueConstRef ref = value.GetConstRef();
+  ASSERT_TRUE(ref.IsObject());
+  EXPECT_EQ(ref.GetObjectSize(), 7);
+  EXPECT_TRUE(ref.HasMember("answer"));
+  EXPECT_FALSE(ref.HasMember("question"));
+  EXPECT_FALSE(ref.GetMemberIfExists("question").has_value());
+  EXPECT_EQ(ref.GetMember("answer").GetMember("everything").GetInt64(), 42);
+  EXPECT_EQ(ref.GetMember("name").GetString(), "Niels");
+  EXPECT_TRUE(ref.GetMember("nothing").IsNull());
+  EXPECT_FALSE(ref.GetMember("nothing").HasMember("a"));
+
+  // Members are returned in key order.
+  std::vector<std::string> keys;
+  for (const auto& [key, member] : ref.GetMembers()) {
+    keys.emplace_back(key);
+  }
+  EXPECT_THAT(keys, ::testing::ElementsAre("answer", "happy", "list", "name",
+                                           "nothing", "object", "pi"));
+
+  JSONValueConstRef list = ref.GetMember("list");
+  ASSERT_TRUE(list.IsArray());
+  ASSERT_EQ(list.GetArraySize(), 3);
+  EXPECT_EQ(list.GetArrayElement(2).GetInt64(), 2);
+  std::vector<int64_t> elements;
+  for (JSONValueConstRef element : list.GetArrayElements()) {
+    elements.push_back(element.GetInt64());
+  }
+  EXPECT_THAT(elements, ::testing::ElementsAre(1, 0, 2));
+}
+
+TEST(JSONCompactRepresentationTest, DuplicateKeysKeepFirstMember) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      JSONValue value,
+      JSONValue::ParseJSONString(R"({"b":1,"a":{"x":1,"x":2},"b":[3]})",
+                                 kCompactParsingOptions));
+  EXPECT_EQ(value.GetConstRef().ToString(), R"({"a":{"x":1},"b":1})");
+  EXPECT_EQ(value.GetConstRef().GetObjectSize(), 2);
+}
+
+TEST(JSONCompactRepresentationTest, MaxNesting) {
+  JSONParsingOptions options = kCompactParsingOptions;
+  options.max_nesting = 2;
+  ZETASQL_EXPECT_OK(JSONValue::ParseJSONString(R"({"a": [1]})", options));
+  EXPECT_THAT(
+      JSONValue::ParseJSONString(R"({"a": [[1]]})", options),
+      StatusIs(absl::StatusCode::kInvalidArgument,
+               HasSubstr("Max nesting of 2 has been exceeded while parsing "
+                         "JSON document")));
+}
+
+TEST(JSONCompactRepresentationTest, NormalizedEqualsAcrossNumberTypes) {
+  auto equals = [](absl::string_view lhs, absl::string_view rhs) {
+    JSONValue compact =
+        JSONValue::ParseJSONString(lhs, kCompactParsingOptions).value();
+    JSONValue value = JSONValue::ParseJSONString(rhs).value();
+    const bool result = compact.GetConstRef().NormalizedEquals(
+        value.GetConstRef());
+    EXPECT_EQ(value.GetConstRef().NormalizedEquals(compact.GetConstRef()),
+              result);
+    // Matches the default representation on both sides.
+    EXPECT_EQ(JSONValue::ParseJSONString(lhs).value().GetConstRef()
+                  .NormalizedEquals(value.GetConstRef()),
+              result);
+    return result;
+  };
+  EXPECT_TRUE(equals("1", "1.0"));
+  EXPECT_TRUE(equals("-1", "-1.0"));
+  EXPECT_FALSE(equals("1", "-1"));
+  EXPECT_FALSE(equals("1", R"("1")"));
+  EXPECT_FALSE(equals("null", "false"));
+  EXPECT_TRUE(equals(R"({"a": [1, {"b": 2.0}]})", R"({"a": [1.0, {"b": 2}]})"));
+  EXPECT_FALSE(equals(R"({"a": [1, {"b": 2}]})", R"({"a": [1, {"c": 2}]})"));
+  EXPECT_FALSE(equals("[1, 2]", "[1, 2, 3]"));
+  EXPECT_FALSE(equals("[]", "{}"));
+}
+
+TEST(JSONCompactRepresentationTest, GetRefConvertsToDefaultRepresentation) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      JSONValue value,
+      JSONValue::ParseJSONString(R"({"a": [1, 2], "b": "str"})",
+                                 kCompactParsingOptions));
+  JSONValueRef ref = value.GetRef();
+  EXPECT_FALSE(value.IsCompact());
+  ref.GetMember("c").SetBoolean(true);
+  ref.GetMember("a").GetArrayElement(2).SetInt64(3);
+  EXPECT_EQ(value.GetConstRef().ToString(),
+            R"({"a":[1,2,3],"b":"str","c":true})");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      JSONValue compact,
+      JSONValue::ParseJSONString(R"({"d": null})", kCompactParsingOptions));
+  ref.GetMember("a").Set(std::move(compact));
+  EXPECT_EQ(value.GetConstRef().ToString(),
+            R"({"a":{"d":null},"b":"str","c":true})");
+}
+
+TEST(JSONCompactRepresentationTest, RefsTakenBeforeUpdateStayValid) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      JSONValue value,
+      JSONValue::ParseJSONString(R"({"a": [1, 2], "b": "str"})",
+                                 kCompactParsingOptions));
+  JSONValueConstRef const_ref = value.GetConstRef();
+  JSONValueConstRef const_member = const_ref.GetMember("a");
+  JSONValueRef ref = value.GetRef();
+  JSONValueRef other_ref = value.GetRef();
+  ref.SetNull();
+
+  // Both refs from GetRef() see the update.
+  EXPECT_TRUE(other_ref.IsNull());
+  other_ref.SetInt64(10);
+  EXPECT_EQ(ref.GetInt64(), 10);
+  EXPECT_EQ(value.GetConstRef().ToString(), "10");
+
+  // Const refs taken while the document was compact still read it as it was.
+  EXPECT_EQ(const_ref.ToString(), R"({"a":[1,2],"b":"str"})");
+  EXPECT_EQ(const_member.GetArrayElement(1).GetInt64(), 2);
+}
+
+TEST(JSONCompactRepresentationTest, CopyFrom) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      JSONValue value,
+      JSONValue::ParseJSONString(kJSONStr, kCompactParsingOptions));
+  JSONValue copy = JSONValue::CopyFrom(value.GetConstRef());
+  EXPECT_TRUE(copy.IsCompact());
+  EXPECT_TRUE(copy.GetConstRef().NormalizedEquals(value.GetConstRef()));
+
+  JSONValue member_copy =
+      JSONValue::CopyFrom(value.GetConstRef().GetMember("object"));
+  EXPECT_TRUE(member_copy.IsCompact());
+  EXPECT_EQ(member_copy.GetConstRef().ToString(),
+            R"({"currency":"USD","value":42.99})");
+  value = JSONValue();
+  EXPECT_EQ(member_copy.GetConstRef().GetMember("currency").GetString(),
+            "USD");
+}
+
+TEST(JSONCompactRepresentationTest, UsesLessSpace) {
+  std::string json = "[";
+  for (int i = 0; i < 1000; ++i) {
+    absl::StrAppend(&json, i == 0 ? "" : ",",
+                    R"({"id":)", i, R"(,"name":"n","tags":[1,2,3]})");
+  }
+  absl::StrAppend(&json, "]");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(JSONValue value, JSONValue::ParseJSONString(json));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      JSONValue compact,
+      JSONValue::ParseJSONString(json, kCompactParsingOptions));
+  EXPECT_LT(compact.GetConstRef().SpaceUsed(),
+            value.GetConstRef().SpaceUsed() / 2);
+}
+
 // TODO: Add more tests.
 TEST(JSONValueValidator, ValidJSON) {
   std::vector<std::string> jsons = {
@@ -67,6 +67,24 @@ inline unsigned __int128 int128_abs(__int128 x) {
   return (x >= 0) ? x : -static_cast<unsigned __int128>(x);
 }
 
+// Returns x / NumericValue::kScalingFactor. Compilers emit a call to a library
+// routine for 128-bit divisions even by constants, so this divides 32 bits at
+// a time with 64-bit divisions by the constant, which compile into
+// multiplications and shifts.
+inline unsigned __int128 DivideByNumericScalingFactor(unsigned __int128 x) {
+  constexpr uint64_t kDivisor = NumericValue::kScalingFactor;
+  const uint64_t hi = static_cast<uint64_t>(x >> 64);
+  const uint64_t lo = static_cast<uint64_t>(x);
+  const uint64_t q_hi = hi / kDivisor;
+  // Each remainder is less than 2^30, so each dividend below fits in 62 bits
+  // and each quotient in 32 bits.
+  const uint64_t mid = ((hi % kDivisor) << 32) | (lo >> 32);
+  const uint64_t q_mid = mid / kDivisor;
+  const uint64_t low = ((mid % kDivisor) << 32) | (lo & 0xffffffff);
+  const uint64_t q_low = low / kDivisor;
+  return (static_cast<unsigned __int128>(q_hi) << 64) | (q_mid << 32 | q_low);
+}
+
 constexpr FixedUint<64, 1> NumericScalingFactorSquared() {
   return FixedUint<64, 1>(static_cast<uint64_t>(NumericValue::kScalingFactor) *
                           NumericValue::kScalingFactor);
@@ -1161,9 +1179,21 @@ absl::StatusOr<NumericValue> NumericValue::Multiply(NumericValue rh) const {
   const __int128 rh_value = rh.as_packed_int();
   bool negative = value < 0;
   bool rh_negative = rh_value < 0;
-  FixedUint<64, 4> product =
-      ExtendAndMultiply(FixedUint<64, 2>(int128_abs(value)),
-                        FixedUint<64, 2>(int128_abs(rh_value)));
+  const unsigned __int128 abs_value = int128_abs(value);
+  const unsigned __int128 rh_abs_value = int128_abs(rh_value);
+  if (ABSL_PREDICT_TRUE((abs_value >> 64) == 0) &&
+      ABSL_PREDICT_TRUE((rh_abs_value >> 64) == 0)) {
+    // Both values are less than about 1.8e10, which covers most values in
+    // practice. The product fits in 128 bits, is computed with a single
+    // multiplication, and cannot overflow after removing the scaling factor.
+    unsigned __int128 product = abs_value * rh_abs_value;
+    product += kScalingFactor / 2;
+    const unsigned __int128 v = DivideByNumericScalingFactor(product);
+    return NumericValue(
+        static_cast<__int128>(negative == rh_negative ? v : -v));
+  }
+  FixedUint<64, 4> product = ExtendAndMultiply(FixedUint<64, 2>(abs_value),
+                                               FixedUint<64, 2>(rh_abs_value));
 
   // This value represents kNumericMax * kScalingFactor + kScalingFactor / 2.
   // At this value, <res> would be internal::kNumericMax + 1 and overflow.
@@ -1552,9 +1582,26 @@ absl::StatusOr<NumericValue> NumericValue::Divide(NumericValue rh) const {
   const bool rh_is_negative = rh_value < 0;
 
   if (ABSL_PREDICT_TRUE(rh_value != 0)) {
-    FixedUint<64, 3> dividend(int128_abs(value));
+    const unsigned __int128 abs_value = int128_abs(value);
     unsigned __int128 divisor = int128_abs(rh_value);
 
+    // If the scaled dividend is less than 2^127, it fits in 128 bits even
+    // after adding half of the divisor, and a single 128-bit division, which
+    // only takes two 64-bit divisions when the divisor is less than 2^64, is
+    // much cheaper than the long division of FixedUint.
+    constexpr unsigned __int128 kMaxValueForNativeDivision =
+        (static_cast<unsigned __int128>(1) << 127) / kScalingFactor;
+    if (ABSL_PREDICT_TRUE(abs_value < kMaxValueForNativeDivision)) {
+      const unsigned __int128 quotient =
+          (abs_value * kScalingFactor + (divisor >> 1)) / divisor;
+      if (ABSL_PREDICT_TRUE(quotient <= internal::kNumericMax)) {
+        return NumericValue(static_cast<__int128>(
+            is_negative != rh_is_negative ? -quotient : quotient));
+      }
+    }
+
+    FixedUint<64, 3> dividend(abs_value);
+
     // To preserve the scale of the result we need to multiply the dividend by
     // the scaling factor first.
     dividend *= kScalingFactor;
@@ -2395,12 +2442,25 @@ absl::StatusOr<BigNumericValue> BigNumericValue::Multiply(
     const BigNumericValue& rh) const {
   bool lh_negative = value_.is_negative();
   bool rh_negative = rh.value_.is_negative();
-  FixedUint<64, 8> abs_result_64x8 =
-      ExtendAndMultiply(value_.abs(), rh.value_.abs());
-  if (ABSL_PREDICT_TRUE(abs_result_64x8.number()[6] == 0) &&
-      ABSL_PREDICT_TRUE(abs_result_64x8.number()[7] == 0)) {
-    FixedUint<64, 5> abs_result_64x5 = RemoveScalingFactor</* round = */ true>(
-        FixedUint<64, 6>(abs_result_64x8));
+  const FixedUint<64, 4> lh_abs = value_.abs();
+  const FixedUint<64, 4> rh_abs = rh.value_.abs();
+  FixedUint<64, 6> abs_result_64x6;
+  bool product_fits = true;
+  if (ABSL_PREDICT_TRUE(lh_abs.number()[3] == 0) &&
+      ABSL_PREDICT_TRUE(rh_abs.number()[3] == 0)) {
+    // Both values are less than about 6.2e19 and use at most 3 words, so the
+    // product takes 9 word multiplications instead of 16.
+    abs_result_64x6 = ExtendAndMultiply(FixedUint<64, 3>(lh_abs),
+                                        FixedUint<64, 3>(rh_abs));
+  } else {
+    FixedUint<64, 8> abs_result_64x8 = ExtendAndMultiply(lh_abs, rh_abs);
+    product_fits = abs_result_64x8.number()[6] == 0 &&
+                   abs_result_64x8.number()[7] == 0;
+    abs_result_64x6 = FixedUint<64, 6>(abs_result_64x8);
+  }
+  if (ABSL_PREDICT_TRUE(product_fits)) {
+    FixedUint<64, 5> abs_result_64x5 =
+        RemoveScalingFactor</* round = */ true>(abs_result_64x6);
     if (ABSL_PREDICT_TRUE(abs_result_64x5.number()[4] == 0)) {
       FixedInt<64, 4> result;
       FixedUint<64, 4> abs_result_64x4(abs_result_64x5);
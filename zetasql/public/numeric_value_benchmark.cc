@@ -0,0 +1,112 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures NUMERIC and BIGNUMERIC multiplication and division. The "Small"
+// variants use operands typical of money amounts, which take the fast paths
+// for operands that fit in 64 bits (NUMERIC) or 192 bits (BIGNUMERIC); the
+// "Large" variants use operands that take the general multi-word paths.
+
+#include <cstdint>
+#include <vector>
+
+#include "zetasql/public/numeric_value.h"
+#include "absl/random/random.h"
+#include "benchmark/benchmark.h"
+
+namespace zetasql {
+namespace {
+
+constexpr int kNumValues = 1024;
+
+// Returns values with up to <integer_digits> integer digits and 9 fractional
+// digits.
+std::vector<NumericValue> MakeNumericValues(int integer_digits) {
+  absl::BitGen gen(std::seed_seq{integer_digits});
+  unsigned __int128 limit = NumericValue::kScalingFactor;
+  for (int i = 0; i < integer_digits; ++i) {
+    limit *= 10;
+  }
+  std::vector<NumericValue> values;
+  values.reserve(kNumValues);
+  for (int i = 0; i < kNumValues; ++i) {
+    const unsigned __int128 random =
+        static_cast<unsigned __int128>(absl::Uniform<uint64_t>(gen)) << 64 |
+        absl::Uniform<uint64_t>(gen);
+    const __int128 packed = random % limit + 1;
+    values.push_back(
+        NumericValue::FromPackedInt(i % 2 == 0 ? packed : -packed).value());
+  }
+  return values;
+}
+
+std::vector<BigNumericValue> MakeBigNumericValues(int integer_digits) {
+  std::vector<BigNumericValue> values;
+  values.reserve(kNumValues);
+  for (const NumericValue& value : MakeNumericValues(integer_digits)) {
+    values.push_back(BigNumericValue(value));
+  }
+  return values;
+}
+
+void BM_NumericMultiply(benchmark::State& state) {
+  const std::vector<NumericValue> lhs = MakeNumericValues(state.range(0));
+  const std::vector<NumericValue> rhs = MakeNumericValues(state.range(1));
+  for (auto s : state) {
+    for (int i = 0; i < kNumValues; ++i) {
+      benchmark::DoNotOptimize(lhs[i].Multiply(rhs[i]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumValues);
+}
+BENCHMARK(BM_NumericMultiply)
+    ->ArgNames({"lhs_digits", "rhs_digits"})
+    ->Args({9, 6})  // Small
+    ->Args({19, 9});  // Large
+
+void BM_NumericDivide(benchmark::State& state) {
+  const std::vector<NumericValue> lhs = MakeNumericValues(state.range(0));
+  const std::vector<NumericValue> rhs = MakeNumericValues(state.range(1));
+  for (auto s : state) {
+    for (int i = 0; i < kNumValues; ++i) {
+      benchmark::DoNotOptimize(lhs[i].Divide(rhs[i]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumValues);
+}
+BENCHMARK(BM_NumericDivide)
+    ->ArgNames({"lhs_digits", "rhs_digits"})
+    ->Args({12, 4})  // Small
+    ->Args({28, 12});  // Large
+
+void BM_BigNumericMultiply(benchmark::State& state) {
+  const std::vector<BigNumericValue> lhs =
+      MakeBigNumericValues(state.range(0));
+  const std::vector<BigNumericValue> rhs =
+      MakeBigNumericValues(state.range(1));
+  for (auto s : state) {
+    for (int i = 0; i < kNumValues; ++i) {
+      benchmark::DoNotOptimize(lhs[i].Multiply(rhs[i]));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumValues);
+}
+BENCHMARK(BM_BigNumericMultiply)
+    ->ArgNames({"lhs_digits", "rhs_digits"})
+    ->Args({12, 6})  // Small
+    ->Args({25, 6});  // Large
+
+}  // namespace
+}  // namespace zetasql
@@ -1517,6 +1517,12 @@ TEST_F(NumericValueTest, Multiply) {
       // Overflow after rounding.
       {"99999999.99", "1000000000100000000010.000000001", kNumericOverflow},
       {"5e14", "2e14", kNumericOverflow},
+      // Largest values whose packed representation fits in 64 bits, and the
+      // smallest one that does not.
+      {"18446744073.709551615", "18446744073.709551615",
+       "340282366920938463426.481119284"},
+      {"18446744073.709551615", "18446744073.709551616",
+       "340282366920938463444.927863358"},
   };
 
   NumericMultiplyOp op;
@@ -2091,6 +2097,11 @@ TEST_F(NumericValueTest, Divide) {
        "2367730588486448005.037486330"},
       {"75968009597863048104202226663", "56017.999",
        "1356135723410310462967487.051135118"},
+      // Around the largest dividend that is divided with 128-bit integers.
+      {"170141183460469231731.687303714", 7, "24305883351495604533.098186245"},
+      {"170141183460469231731.687303714", "0.7",
+       "243058833514956045330.981862449"},
+      {"170141183460469231731.687303715", 7, "24305883351495604533.098186245"},
 
       {kMaxNumericValueStr, "0.3", kNumericOverflow},
       {kMaxNumericValueStr, "0.999999999", kNumericOverflow},
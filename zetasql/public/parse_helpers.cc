@@ -223,14 +223,8 @@ absl::Status GetNextStatementProperties(
   parser_options.CreateDefaultArenasIfNotSet();
 
   parser::ASTStatementProperties ast_statement_properties;
-  // Since the ASTStatementProperties will include the ASTHint node if
-  // statement level hints are present, we need a vector to own the allocated
-  // ASTNodes.
-  std::vector<std::unique_ptr<ASTNode>> allocated_ast_nodes;
-
   ZETASQL_RETURN_IF_ERROR(ParseNextStatementProperties(
-      resume_location, parser_options, &allocated_ast_nodes,
-      &ast_statement_properties));
+      resume_location, parser_options, &ast_statement_properties));
   statement_properties->node_kind =
       GetStatementKind(ast_statement_properties.node_kind);
 
@@ -16,6 +16,7 @@
 
 #include "zetasql/public/proto_util.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <iterator>
 #include <memory>
@@ -41,12 +42,15 @@
 #include "absl/base/casts.h"
 #include <cstdint>
 #include "absl/base/optimization.h"
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/flags/flag.h"
+#include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "absl/types/variant.h"
 #include "zetasql/base/map_util.h"
@@ -549,12 +553,14 @@ static bool ReadWireValue(google::protobuf::FieldDescriptor::Type field_type,
       return false;
     }
     case WireFormatLite::TYPE_MESSAGE: {
-      std::string c;
-      if (WireFormatLite::ReadBytes(in, &c)) {
-        *value = absl::Cord(c);
-        return true;
-      }
-      return false;
+      // Share the message bytes with 'bytes' rather than copying them, which
+      // matters for deeply nested messages.
+      uint32_t length;
+      if (!in->ReadVarint32(&length)) return false;
+      const int start_position = in->CurrentPosition();
+      if (!in->Skip(length)) return false;
+      *value = bytes.Subcord(start_position, length);
+      return true;
     }
     case WireFormatLite::TYPE_GROUP: {
       const uint32_t start_position = in->CurrentPosition();
@@ -877,180 +883,248 @@ static absl::StatusOr<Value> ReadSingularProtoField(
   return std::move(elements.back());
 }
 
-namespace {
-
-// Maps a tag number to all ProtoFieldInfos indexes with that tag number.
-using FieldInfoMap = absl::flat_hash_map<int, std::vector<int>>;
+// Field numbers up to this use a dense dispatch table in ProtoFieldReadPlan.
+static constexpr int kMaxDenseFieldNumber = 1024;
 
-// Maps a ProtoFieldInfo (by its index) to the corresponding Values we have
-// seen for it, with errors for failure to convert wire values to the
-// appropriate FieldFormats.
-using ElementValueList = std::vector<std::vector<absl::StatusOr<Value>>>;
-
-}  // namespace
+absl::StatusOr<std::unique_ptr<const ProtoFieldReadPlan>>
+ProtoFieldReadPlan::Create(
+    absl::Span<const ProtoFieldInfo* const> field_infos) {
+  ZETASQL_RET_CHECK(!field_infos.empty());
+  auto plan = absl::WrapUnique(new ProtoFieldReadPlan);
+  const google::protobuf::Descriptor* message =
+      field_infos[0]->descriptor->containing_type();
+  plan->message_name_ = message->full_name();
+
+  // Group the requested fields by field number, in order of first appearance.
+  absl::flat_hash_map<int, std::vector<int>> indexes_by_field_number;
+  std::vector<int> field_numbers;
+  plan->requested_fields_.reserve(field_infos.size());
+  for (int i = 0; i < field_infos.size(); ++i) {
+    const ProtoFieldInfo* info = field_infos[i];
+    ZETASQL_RET_CHECK_EQ(info->descriptor->containing_type(), message);
+    RequestedField field{info, FieldKind::kLastValue,
+                         /*element_type=*/nullptr, /*repeated_index=*/-1};
+    if (info->get_has_bit) {
+      field.kind = FieldKind::kHasBit;
+    } else {
+      ZETASQL_RET_CHECK_EQ(info->type->IsArray(), info->descriptor->is_repeated());
+      if (info->type->IsArray()) {
+        field.kind = FieldKind::kRepeated;
+        field.element_type = info->type->AsArray()->element_type();
+        field.repeated_index = plan->num_repeated_fields_++;
+      } else {
+        field.kind = info->type->IsProto() ? FieldKind::kMessage
+                                           : FieldKind::kLastValue;
+        field.element_type = info->type;
+      }
+    }
+    plan->requested_fields_.push_back(field);
 
-absl::Status ReadProtoFields(
-    absl::Span<const ProtoFieldInfo* const> field_infos,
-    const absl::Cord& bytes, ProtoFieldValueList* field_value_list) {
-  const bool use_optimization =
-      field_infos.size() == 1 &&
-      absl::GetFlag(FLAGS_zetasql_read_proto_field_optimized_path);
+    std::vector<int>& indexes =
+        indexes_by_field_number[info->descriptor->number()];
+    if (indexes.empty()) {
+      field_numbers.push_back(info->descriptor->number());
+    }
+    indexes.push_back(i);
+  }
 
-  if (use_optimization) {
-    ZETASQL_ASSIGN_OR_RETURN(absl::StatusOr<Value> value,
-                     ReadSingularProtoField(*field_infos[0], bytes));
-    field_value_list->push_back(std::move(value));
-    return absl::OkStatus();
+  int max_field_number = 0;
+  for (const int field_number : field_numbers) {
+    const std::vector<int>& indexes = indexes_by_field_number[field_number];
+    const google::protobuf::FieldDescriptor* descriptor =
+        field_infos[indexes[0]]->descriptor;
+    const int begin = plan->requested_field_indexes_.size();
+    plan->requested_field_indexes_.insert(plan->requested_field_indexes_.end(),
+                                          indexes.begin(), indexes.end());
+    plan->entries_.push_back(
+        {descriptor, descriptor->is_packable(), begin,
+         static_cast<int>(plan->requested_field_indexes_.size())});
+    max_field_number = std::max(max_field_number, field_number);
   }
 
-  field_value_list->resize(field_infos.size());
+  if (max_field_number <= kMaxDenseFieldNumber) {
+    plan->dense_entry_indexes_.assign(max_field_number + 1, -1);
+    for (int i = 0; i < field_numbers.size(); ++i) {
+      plan->dense_entry_indexes_[field_numbers[i]] = i;
+    }
+  } else {
+    for (int i = 0; i < field_numbers.size(); ++i) {
+      plan->sparse_entry_indexes_[field_numbers[i]] = i;
+    }
+  }
+  return plan;
+}
 
-  FieldInfoMap field_info_map;
-  for (int i = 0; i < field_infos.size(); ++i) {
-    const ProtoFieldInfo* field_info = field_infos[i];
-    field_info_map[field_info->descriptor->number()].push_back(i);
+absl::Status ProtoFieldReadPlan::Read(
+    const absl::Cord& bytes, ProtoFieldValueList* field_value_list) const {
+  field_value_list->clear();
+  field_value_list->resize(requested_fields_.size());
+  ProtoFieldValueList& values = *field_value_list;
+
+  // Whether a value has been read for each requested field. For kRepeated, it
+  // is also set once translating an element fails, in which case the error is
+  // in 'values'.
+  absl::InlinedVector<bool, 16> seen(requested_fields_.size(), false);
+  std::vector<std::vector<Value>> repeated_elements(num_repeated_fields_);
+
+  // Read directly from the bytes of a flat Cord, and only copy them otherwise.
+  std::string bytes_str;
+  absl::string_view flat_bytes;
+  if (auto flat = bytes.TryFlat(); flat.has_value()) {
+    flat_bytes = *flat;
+  } else {
+    bytes_str = std::string(bytes);
+    flat_bytes = bytes_str;
   }
+  google::protobuf::io::CodedInputStream in(
+      reinterpret_cast<const uint8_t*>(flat_bytes.data()),
+      static_cast<int>(flat_bytes.size()));
 
-  // If get_has_bit is true, this is either empty or contains a single
-  // Value::Bool(true).
-  ElementValueList element_value_list(field_infos.size());
-  ZETASQL_RET_CHECK(!field_infos.empty());
-  const google::protobuf::FieldDescriptor* some_field = field_infos[0]->descriptor;
-    uint32_t tag_and_type;
-    std::string bytes_str(bytes);
-    google::protobuf::io::ArrayInputStream cord_stream(bytes_str.data(),
-    bytes_str.size());
-    google::protobuf::io::CodedInputStream in(&cord_stream);
-    while (0 < (tag_and_type = in.ReadTag())) {
-      const int tag_number = WireFormatLite::GetTagFieldNumber(tag_and_type);
-      const std::vector<int>* info_idxs =
-          zetasql_base::FindOrNull(field_info_map, tag_number);
-      if (info_idxs == nullptr) {
-        if (ABSL_PREDICT_TRUE(WireFormatLite::SkipField(&in, tag_and_type))) {
-          continue;
-        }
+  uint32_t tag_and_type;
+  while (0 < (tag_and_type = in.ReadTag())) {
+    const int tag_number = WireFormatLite::GetTagFieldNumber(tag_and_type);
+    const FieldNumberEntry* entry = FindEntry(tag_number);
+    if (entry == nullptr) {
+      if (ABSL_PREDICT_TRUE(WireFormatLite::SkipField(&in, tag_and_type))) {
+        continue;
+      }
+      return ::zetasql_base::OutOfRangeErrorBuilder()
+             << "Corrupted protocol buffer: "
+             << "Failed to skip field with tag number " << tag_number << " in "
+             << message_name_;
+    }
+    const google::protobuf::FieldDescriptor* descriptor = entry->descriptor;
+
+    PackedValuesVector wire_values;
+    // Protocol buffer parsers must be able to parse repeated fields that were
+    // compiled as packed as if they were not packed, and vice versa.  Both
+    // packed and non-packed field occurrences may appear within the same
+    // message.
+    if (entry->is_packable && IsPackedWireType(tag_and_type)) {
+      if (ABSL_PREDICT_FALSE(!ReadPackedWireValues(
+              descriptor->number(), descriptor->type(), &in, &wire_values))) {
         return ::zetasql_base::OutOfRangeErrorBuilder()
                << "Corrupted protocol buffer: "
-               << "Failed to skip field with tag number " << tag_number
-               << " in " << some_field->containing_type()->full_name();
+               << "Failed to read packed elements for field "
+               << descriptor->full_name();
       }
-      // All of the field descriptors must come from the same
-      // google::protobuf::Descriptor, so for a particular tag number, they are all the
-      // same.
-      ZETASQL_RET_CHECK(!info_idxs->empty());
-      const google::protobuf::FieldDescriptor* descriptor =
-          field_infos[(*info_idxs)[0]]->descriptor;
-
-      PackedValuesVector wire_values;
-      // Protocol buffer parsers must be able to parse repeated fields that were
-      // compiled as packed as if they were not packed, and vice versa.  Both
-      // packed and non-packed field occurrences may appear within the same
-      // message.
-      if (descriptor->is_packable() && IsPackedWireType(tag_and_type)) {
-        if (ABSL_PREDICT_FALSE(!ReadPackedWireValues(
-                descriptor->number(), descriptor->type(), &in, &wire_values))) {
-          return ::zetasql_base::OutOfRangeErrorBuilder()
-                 << "Corrupted protocol buffer: "
-                 << "Failed to read packed elements for field "
-                 << descriptor->full_name();
-        }
-      } else {
-        WireValueType wire_value;
-        if (ABSL_PREDICT_FALSE(!ReadWireValue(descriptor->type(), tag_and_type,
-                                              bytes, &in, &wire_value))) {
-          return zetasql_base::OutOfRangeErrorBuilder()
-                 << "Corrupted protocol buffer: Failed to read value for field "
-                 << descriptor->full_name();
-        }
-        wire_values.push_back(std::move(wire_value));
+    } else {
+      WireValueType wire_value;
+      if (ABSL_PREDICT_FALSE(!ReadWireValue(descriptor->type(), tag_and_type,
+                                            bytes, &in, &wire_value))) {
+        return zetasql_base::OutOfRangeErrorBuilder()
+               << "Corrupted protocol buffer: Failed to read value for field "
+               << descriptor->full_name();
       }
-      ZETASQL_RET_CHECK(!wire_values.empty());
-
-      for (int i = 0; i < info_idxs->size(); ++i) {
-        const int idx = (*info_idxs)[i];
-        const ProtoFieldInfo* info = field_infos[idx];
-        std::vector<absl::StatusOr<Value>>& elements = element_value_list[idx];
+      wire_values.push_back(std::move(wire_value));
+    }
+    ZETASQL_RET_CHECK(!wire_values.empty());
 
-        if (info->get_has_bit) {
-          if (elements.empty()) {
-            elements.push_back(Value::Bool(true));
-          }
-        } else {
-          const Type* element_type = info->type->IsArray()
-                                         ? info->type->AsArray()->element_type()
-                                         : info->type;
+    for (int i = entry->begin; i < entry->end; ++i) {
+      const int idx = requested_field_indexes_[i];
+      const RequestedField& field = requested_fields_[idx];
+      switch (field.kind) {
+        case FieldKind::kHasBit:
+          seen[idx] = true;
+          break;
+        case FieldKind::kRepeated: {
+          if (seen[idx]) break;  // An element failed to translate.
+          std::vector<Value>& elements =
+              repeated_elements[field.repeated_index];
           for (const WireValueType& wire_value : wire_values) {
-            elements.push_back(TranslateWireValue(wire_value, descriptor,
-                                                  info->format, element_type));
+            absl::StatusOr<Value> element = TranslateWireValue(
+                wire_value, descriptor, field.info->format,
+                field.element_type);
+            if (ABSL_PREDICT_FALSE(!element.ok())) {
+              values[idx] = element.status();
+              seen[idx] = true;
+              break;
+            }
+            elements.push_back(std::move(element).value());
           }
+          break;
         }
+        case FieldKind::kMessage:
+          for (const WireValueType& wire_value : wire_values) {
+            absl::StatusOr<Value> message = TranslateWireValue(
+                wire_value, descriptor, field.info->format,
+                field.element_type);
+            if (!seen[idx]) {
+              values[idx] = std::move(message);
+            } else if (!values[idx].ok()) {
+              // Keep the first error.
+            } else if (!message.ok()) {
+              values[idx] = std::move(message);
+            } else {
+              // Merge multiple occurrences of embedded message
+              absl::Cord merged_message = values[idx]->ToCord();
+              merged_message.Append(message->ToCord());
+              values[idx] =
+                  Value::Proto(field.element_type->AsProto(), merged_message);
+            }
+            seen[idx] = true;
+          }
+          break;
+        case FieldKind::kLastValue:
+          values[idx] =
+              TranslateWireValue(wire_values.back(), descriptor,
+                                 field.info->format, field.element_type);
+          seen[idx] = true;
+          break;
       }
     }
+  }
 
   // Now that we have read all of the values we care about, use them to populate
-  // 'field_value_list'.
-  for (int i = 0; i < field_infos.size(); ++i) {
-    const ProtoFieldInfo* info = field_infos[i];
-    std::vector<absl::StatusOr<Value>>& values = element_value_list[i];
-    if (info->get_has_bit) {
-      (*field_value_list)[i] = Value::Bool(!values.empty());
-    } else {
-      absl::StatusOr<Value> new_value;
-
-      ZETASQL_RET_CHECK_EQ(info->type->IsArray(), info->descriptor->is_repeated());
-      if (info->type->IsArray()) {
-        std::vector<Value> element_values;
-        element_values.reserve(values.size());
-        bool success = true;
-        for (absl::StatusOr<Value>& value : values) {
-          if (ABSL_PREDICT_FALSE(!value.ok())) {
-            success = false;
-            new_value = value.status();
-            break;
-          }
-          element_values.push_back(std::move(value).value());
-        }
-
-        if (success) {
-          new_value = Value::MakeArray(info->type->AsArray(),
-                                       std::move(element_values));
+  // the values of the fields that were not read or that are arrays.
+  for (int idx = 0; idx < requested_fields_.size(); ++idx) {
+    const RequestedField& field = requested_fields_[idx];
+    switch (field.kind) {
+      case FieldKind::kHasBit:
+        values[idx] = Value::Bool(seen[idx]);
+        break;
+      case FieldKind::kRepeated:
+        if (!seen[idx]) {
+          values[idx] = Value::MakeArray(
+              field.info->type->AsArray(),
+              std::move(repeated_elements[field.repeated_index]));
         }
-      } else if (values.empty()) {
-        if (ABSL_PREDICT_FALSE(info->descriptor->is_required())) {
-          new_value = absl::Status(absl::StatusCode::kOutOfRange,
-                                   "Protocol buffer missing required field " +
-                                       info->descriptor->full_name());
+        break;
+      case FieldKind::kMessage:
+      case FieldKind::kLastValue:
+        if (seen[idx]) break;
+        if (ABSL_PREDICT_FALSE(field.info->descriptor->is_required())) {
+          values[idx] = absl::Status(absl::StatusCode::kOutOfRange,
+                                     "Protocol buffer missing required field " +
+                                         field.info->descriptor->full_name());
         } else {
-          new_value = info->default_value;
-        }
-      } else if (
-          values.size() > 1 &&
-          info->type->IsProto()) {
-        // Merge multiple occurrences of embedded message
-        absl::Cord merged_message;
-        bool success = true;
-        for (const absl::StatusOr<Value>& value : values) {
-          if (!value.ok()) {
-            success = false;
-            new_value = value;
-            break;
-          }
-          merged_message.Append(value->ToCord());
-        }
-        if (success) {
-          new_value = Value::Proto(info->type->AsProto(), merged_message);
+          values[idx] = field.info->default_value;
         }
-      } else {
-        new_value = std::move(values.back());
-      }
-
-      (*field_value_list)[i] = std::move(new_value);
+        break;
     }
   }
-
   return absl::OkStatus();
 }
 
+absl::Status ReadProtoFields(
+    absl::Span<const ProtoFieldInfo* const> field_infos,
+    const absl::Cord& bytes, ProtoFieldValueList* field_value_list) {
+  const bool use_optimization =
+      field_infos.size() == 1 &&
+      absl::GetFlag(FLAGS_zetasql_read_proto_field_optimized_path);
+
+  if (use_optimization) {
+    ZETASQL_ASSIGN_OR_RETURN(absl::StatusOr<Value> value,
+                     ReadSingularProtoField(*field_infos[0], bytes));
+    field_value_list->push_back(std::move(value));
+    return absl::OkStatus();
+  }
+
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ProtoFieldReadPlan> plan,
+                   ProtoFieldReadPlan::Create(field_infos));
+  return plan->Read(bytes, field_value_list);
+}
+
 absl::Status ReadProtoField(const google::protobuf::FieldDescriptor* field_descr,
                             FieldFormat::Format format, const Type* type,
                             const Value& default_value, bool get_has_bit,
@@ -18,6 +18,8 @@
 #define ZETASQL_PUBLIC_PROTO_UTIL_H_
 
 #include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "google/protobuf/descriptor.h"
@@ -30,6 +32,7 @@
 #include "absl/flags/declare.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/cord.h"
+#include "absl/types/span.h"
 #include "zetasql/base/status.h"
 
 ABSL_DECLARE_FLAG(bool, zetasql_read_proto_field_optimized_path);
@@ -97,6 +100,80 @@ absl::Status ReadProtoFields(
     absl::Span<const ProtoFieldInfo* const> field_infos,
     const absl::Cord& bytes, ProtoFieldValueList* field_value_list);
 
+// A compiled form of ReadProtoFields() for a fixed list of fields, for reading
+// the same fields from many serialized protos. Create() precomputes a dispatch
+// table from field number to the requested fields, so Read() is a single pass
+// over the bytes that skips all other fields by wire type without decoding
+// them or allocating per-field state. Thread-safe.
+class ProtoFieldReadPlan {
+ public:
+  // 'field_infos' has the same requirements as for ReadProtoFields() and must
+  // outlive the returned plan.
+  static absl::StatusOr<std::unique_ptr<const ProtoFieldReadPlan>> Create(
+      absl::Span<const ProtoFieldInfo* const> field_infos);
+
+  ProtoFieldReadPlan(const ProtoFieldReadPlan&) = delete;
+  ProtoFieldReadPlan& operator=(const ProtoFieldReadPlan&) = delete;
+
+  // Same as ReadProtoFields() with the 'field_infos' passed to Create().
+  // Replaces the contents of 'field_value_list'.
+  absl::Status Read(const absl::Cord& bytes,
+                    ProtoFieldValueList* field_value_list) const;
+
+ private:
+  // How the values of a requested field are combined.
+  enum class FieldKind {
+    kHasBit,     // Whether the field is present.
+    kRepeated,   // An array of all of the values.
+    kMessage,    // The merge of all of the (singular) PROTO values.
+    kLastValue,  // The last of the (singular) values.
+  };
+
+  struct RequestedField {
+    const ProtoFieldInfo* info;
+    FieldKind kind;
+    // The type of each value read from the wire. NULL for kHasBit.
+    const Type* element_type;
+    // Index into the per-Read() vector of array elements. Only for kRepeated.
+    int repeated_index;
+  };
+
+  // The requested fields with a particular field number, which are the
+  // entries of 'requested_field_indexes_' in ['begin', 'end').
+  struct FieldNumberEntry {
+    const google::protobuf::FieldDescriptor* descriptor;
+    bool is_packable;
+    int begin;
+    int end;
+  };
+
+  ProtoFieldReadPlan() = default;
+
+  // Returns the entry for 'field_number', or NULL if no requested field has
+  // that number.
+  const FieldNumberEntry* FindEntry(int field_number) const {
+    if (!dense_entry_indexes_.empty()) {
+      if (field_number >= dense_entry_indexes_.size()) return nullptr;
+      const int entry_index = dense_entry_indexes_[field_number];
+      return entry_index < 0 ? nullptr : &entries_[entry_index];
+    }
+    const auto it = sparse_entry_indexes_.find(field_number);
+    return it == sparse_entry_indexes_.end() ? nullptr : &entries_[it->second];
+  }
+
+  std::vector<RequestedField> requested_fields_;
+  std::vector<int> requested_field_indexes_;
+  std::vector<FieldNumberEntry> entries_;
+  // Maps a field number to its index in 'entries_' (or -1) when all of the
+  // requested field numbers are small, which is the common case. Otherwise
+  // empty, and 'sparse_entry_indexes_' is used instead.
+  std::vector<int> dense_entry_indexes_;
+  absl::flat_hash_map<int, int> sparse_entry_indexes_;
+  int num_repeated_fields_ = 0;
+  // The full name of the message, for error messages.
+  std::string message_name_;
+};
+
 // Convenience form of ReadProtoFields() for reading a single field. Reads the
 // proto field matching tag and type of 'field_descr' from 'bytes' and returns
 // the result in 'output_value'. If 'tag' is missing in 'bytes', returns
@@ -0,0 +1,187 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Compares reading proto fields with ReadProtoFields(), which sets up the
+// fields to read on every call, against a ProtoFieldReadPlan compiled once,
+// both for a wide proto and for a path of fields through deeply nested protos.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+#include "google/protobuf/descriptor.h"
+#include "zetasql/common/testing/testing_proto_util.h"
+#include "zetasql/public/proto_util.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/types/type_factory.h"
+#include "zetasql/public/value.h"
+#include "zetasql/testdata/test_schema.pb.h"
+#include "benchmark/benchmark.h"
+#include "absl/strings/cord.h"
+
+namespace zetasql {
+namespace {
+
+using zetasql_test__::KitchenSinkPB;
+using zetasql_test__::RecursivePB;
+
+ProtoFieldInfo MakeFieldInfo(const google::protobuf::Descriptor* descriptor,
+                             const char* name, const Type* type,
+                             const Value& default_value) {
+  ProtoFieldInfo info;
+  info.descriptor = descriptor->FindFieldByName(name);
+  ZETASQL_CHECK(info.descriptor != nullptr) << name;
+  info.type = type;
+  info.default_value = default_value;
+  return info;
+}
+
+// A KitchenSinkPB with many fields set, of which the benchmarks read a few.
+absl::Cord MakeWideProto() {
+  KitchenSinkPB proto;
+  proto.set_int64_key_1(1);
+  proto.set_int64_key_2(2);
+  proto.set_int32_val(3);
+  proto.set_int64_val(4);
+  proto.set_string_val("a string that is skipped");
+  proto.set_bytes_val("some bytes that are skipped");
+  for (int i = 0; i < 20; ++i) {
+    proto.add_repeated_int32_val(i);
+    proto.add_repeated_string_val("skipped");
+    proto.mutable_nested_value()->add_nested_repeated_int64(i);
+  }
+  return SerializePartialToCord(proto);
+}
+
+std::vector<ProtoFieldInfo> MakeWideProtoFieldInfos() {
+  const google::protobuf::Descriptor* descriptor = KitchenSinkPB::descriptor();
+  return {MakeFieldInfo(descriptor, "int64_key_1", types::Int64Type(),
+                        Value::Int64(0)),
+          MakeFieldInfo(descriptor, "int64_val", types::Int64Type(),
+                        Value::Int64(0)),
+          MakeFieldInfo(descriptor, "repeated_int32_val",
+                        types::Int32ArrayType(),
+                        Value::EmptyArray(types::Int32ArrayType()))};
+}
+
+std::vector<const ProtoFieldInfo*> GetPointers(
+    const std::vector<ProtoFieldInfo>& infos) {
+  std::vector<const ProtoFieldInfo*> pointers;
+  for (const ProtoFieldInfo& info : infos) {
+    pointers.push_back(&info);
+  }
+  return pointers;
+}
+
+void BM_ReadProtoFieldsWide(benchmark::State& state) {
+  const absl::Cord bytes = MakeWideProto();
+  const std::vector<ProtoFieldInfo> infos = MakeWideProtoFieldInfos();
+  const std::vector<const ProtoFieldInfo*> info_ptrs = GetPointers(infos);
+  for (auto s : state) {
+    ProtoFieldValueList values;
+    ZETASQL_CHECK_OK(ReadProtoFields(info_ptrs, bytes, &values));
+    benchmark::DoNotOptimize(values);
+  }
+}
+BENCHMARK(BM_ReadProtoFieldsWide);
+
+void BM_ProtoFieldReadPlanWide(benchmark::State& state) {
+  const absl::Cord bytes = MakeWideProto();
+  const std::vector<ProtoFieldInfo> infos = MakeWideProtoFieldInfos();
+  const std::vector<const ProtoFieldInfo*> info_ptrs = GetPointers(infos);
+  std::unique_ptr<const ProtoFieldReadPlan> plan =
+      ProtoFieldReadPlan::Create(info_ptrs).value();
+  for (auto s : state) {
+    ProtoFieldValueList values;
+    ZETASQL_CHECK_OK(plan->Read(bytes, &values));
+    benchmark::DoNotOptimize(values);
+  }
+}
+BENCHMARK(BM_ProtoFieldReadPlanWide);
+
+// A RecursivePB nested 'depth' levels deep through 'recursive_pb'. Each level
+// also has an 'int64_val' and siblings in 'repeated_recursive_pb', which are
+// skipped when following the path.
+absl::Cord MakeNestedProto(int depth) {
+  RecursivePB root;
+  RecursivePB* level = &root;
+  for (int i = 0; i < depth; ++i) {
+    level->set_int64_val(i);
+    for (int j = 0; j < 3; ++j) {
+      level->add_repeated_recursive_pb()->set_int64_val(j);
+    }
+    level = level->mutable_recursive_pb();
+  }
+  level->set_int64_val(depth);
+  return SerializePartialToCord(root);
+}
+
+// Reads 'recursive_pb' and 'int64_val' at each level, as a query accessing
+// p.recursive_pb.recursive_pb...int64_val does, one level at a time.
+class NestedPathReader {
+ public:
+  NestedPathReader() {
+    const google::protobuf::Descriptor* descriptor = RecursivePB::descriptor();
+    const Type* recursive_type;
+    ZETASQL_CHECK_OK(type_factory_.MakeProtoType(descriptor, &recursive_type));
+    infos_ = {MakeFieldInfo(descriptor, "recursive_pb", recursive_type,
+                            Value::Null(recursive_type)),
+              MakeFieldInfo(descriptor, "int64_val", types::Int64Type(),
+                            Value::Int64(0))};
+    info_ptrs_ = GetPointers(infos_);
+    plan_ = ProtoFieldReadPlan::Create(info_ptrs_).value();
+  }
+
+  // Returns the sum of the 'int64_val's along the path.
+  int64_t Read(const absl::Cord& bytes, bool use_plan) const {
+    int64_t sum = 0;
+    absl::Cord level = bytes;
+    ProtoFieldValueList values;
+    while (true) {
+      if (use_plan) {
+        ZETASQL_CHECK_OK(plan_->Read(level, &values));
+      } else {
+        values.clear();
+        ZETASQL_CHECK_OK(ReadProtoFields(info_ptrs_, level, &values));
+      }
+      sum += values[1].value().int64_value();
+      const Value& next = values[0].value();
+      if (next.is_null()) return sum;
+      level = next.ToCord();
+    }
+  }
+
+ private:
+  TypeFactory type_factory_;
+  std::vector<ProtoFieldInfo> infos_;
+  std::vector<const ProtoFieldInfo*> info_ptrs_;
+  std::unique_ptr<const ProtoFieldReadPlan> plan_;
+};
+
+template <bool kUsePlan>
+void BM_ReadNestedPath(benchmark::State& state) {
+  const absl::Cord bytes = MakeNestedProto(state.range(0));
+  const NestedPathReader reader;
+  for (auto s : state) {
+    benchmark::DoNotOptimize(reader.Read(bytes, kUsePlan));
+  }
+}
+BENCHMARK_TEMPLATE(BM_ReadNestedPath, false)->Arg(1)->Arg(8)->Arg(32);
+BENCHMARK_TEMPLATE(BM_ReadNestedPath, true)->Arg(1)->Arg(8)->Arg(32);
+
+}  // namespace
+}  // namespace zetasql
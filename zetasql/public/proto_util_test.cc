@@ -17,8 +17,10 @@
 #include "zetasql/public/proto_util.h"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "zetasql/base/logging.h"
 #include "google/protobuf/io/coded_stream.h"
@@ -834,6 +836,101 @@ TEST_P(ReadProtoFieldsTest, SameFieldWithTwoFormats) {
   EXPECT_THAT(value_list[1], IsOkAndHolds(values::Date(10)));
 }
 
+// A ProtoFieldReadPlan gives the same results for each of the protos it reads
+// as reading each field on its own, which uses a separate implementation.
+TEST(ProtoFieldReadPlanTest, ReadsSameFieldsFromManyProtos) {
+  TypeFactory type_factory;
+  const Type* nested_type;
+  ZETASQL_ASSERT_OK(type_factory.MakeProtoType(KitchenSinkPB::Nested::descriptor(),
+                                       &nested_type));
+  const google::protobuf::Descriptor* descriptor = KitchenSinkPB::descriptor();
+
+  std::vector<ProtoFieldInfo> infos(6);
+  infos[0].descriptor = descriptor->FindFieldByName("int64_key_1");
+  infos[0].type = types::Int64Type();
+  infos[0].default_value = values::Int64(0);
+  infos[1].descriptor = descriptor->FindFieldByName("int64_key_2");
+  infos[1].type = types::Int64Type();
+  infos[1].default_value = values::Int64(0);
+  infos[2].descriptor = descriptor->FindFieldByName("repeated_int32_val");
+  infos[2].type = types::Int32ArrayType();
+  infos[2].default_value = Value::EmptyArray(types::Int32ArrayType());
+  infos[3].descriptor = descriptor->FindFieldByName("nested_value");
+  infos[3].type = nested_type;
+  infos[3].default_value = Value::Null(nested_type);
+  infos[4] = infos[3];
+  infos[4].get_has_bit = true;
+  infos[5].descriptor = descriptor->FindFieldByName("date");
+  infos[5].format = FieldFormat::DATE;
+  infos[5].type = types::DateType();
+  infos[5].default_value = values::NullDate();
+  std::vector<const ProtoFieldInfo*> info_ptrs;
+  for (const ProtoFieldInfo& info : infos) {
+    ASSERT_NE(info.descriptor, nullptr);
+    info_ptrs.push_back(&info);
+  }
+
+  std::vector<absl::Cord> protos;
+  KitchenSinkPB kitchen_sink;
+  protos.push_back(SerializePartialToCord(kitchen_sink));
+  kitchen_sink.set_int64_key_1(1);
+  kitchen_sink.set_int64_key_2(2);
+  kitchen_sink.add_repeated_int32_val(10);
+  kitchen_sink.add_repeated_int32_val(20);
+  kitchen_sink.set_int64_val(30);
+  kitchen_sink.set_date(10);
+  protos.push_back(SerializePartialToCord(kitchen_sink));
+  kitchen_sink.mutable_nested_value()->set_nested_int64(40);
+  kitchen_sink.set_date(-1000000);  // Out of range for DATE.
+  protos.push_back(SerializePartialToCord(kitchen_sink));
+  // A second occurrence of 'nested_value' and 'int64_key_1', which are merged
+  // and override the first, respectively.
+  KitchenSinkPB suffix;
+  suffix.set_int64_key_1(3);
+  suffix.mutable_nested_value()->add_nested_repeated_int64(50);
+  protos.push_back(protos.back());
+  protos.back().Append(SerializePartialToCord(suffix));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<const ProtoFieldReadPlan> plan,
+                       ProtoFieldReadPlan::Create(info_ptrs));
+  absl::SetFlag(&FLAGS_zetasql_read_proto_field_optimized_path, true);
+  for (const absl::Cord& bytes : protos) {
+    ProtoFieldValueList actual;
+    ZETASQL_ASSERT_OK(plan->Read(bytes, &actual));
+    ASSERT_EQ(actual.size(), info_ptrs.size());
+    for (int i = 0; i < actual.size(); ++i) {
+      ProtoFieldValueList expected;
+      ZETASQL_ASSERT_OK(ReadProtoFields({info_ptrs[i]}, bytes, &expected));
+      ASSERT_EQ(expected.size(), 1);
+      EXPECT_EQ(actual[i].status(), expected[0].status()) << i;
+      if (actual[i].ok() && expected[0].ok()) {
+        EXPECT_EQ(*actual[i], *expected[0]) << i;
+      }
+    }
+  }
+
+  ProtoFieldValueList values;
+  ZETASQL_ASSERT_OK(plan->Read(protos.back(), &values));
+  EXPECT_THAT(values[0], IsOkAndHolds(values::Int64(3)));
+  EXPECT_THAT(values[2], IsOkAndHolds(Value::Array(
+                             types::Int32ArrayType(),
+                             {values::Int32(10), values::Int32(20)})));
+  KitchenSinkPB::Nested expected_nested;
+  expected_nested.set_nested_int64(40);
+  expected_nested.add_nested_repeated_int64(50);
+  ASSERT_TRUE(values[3].ok());
+  KitchenSinkPB::Nested nested;
+  ASSERT_TRUE(ParsePartialFromCord(values[3]->ToCord(), &nested));
+  EXPECT_THAT(nested, EqualsProto(expected_nested));
+  EXPECT_THAT(values[4], IsOkAndHolds(values::Bool(true)));
+  EXPECT_THAT(values[5], StatusIs(absl::StatusCode::kOutOfRange));
+
+  // Corrupt bytes are an error for the whole read.
+  EXPECT_THAT(plan->Read(absl::Cord("\xff"), &values),
+              StatusIs(absl::StatusCode::kOutOfRange,
+                       HasSubstr("Corrupted protocol buffer")));
+}
+
 TEST(GetProtoFieldDefault, Interval) {
   ProtoWithIntervalField proto;
   ProtoFieldDefaultOptions options;
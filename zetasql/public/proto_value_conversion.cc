@@ -880,7 +880,7 @@ absl::Status ProtoFieldToValue(const google::protobuf::Message& proto,
           reflection->GetString(proto, field);
       ZETASQL_ASSIGN_OR_RETURN(
           JSONValue json_value,
-          JSONValue::ParseJSONString(value));
+          JSONValue::ParseJSONString(value, {.compact_representation = true}));
       *value_out = Value::Json(std::move(json_value));
       return absl::OkStatus();
     }
@@ -0,0 +1,193 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/query_fingerprint.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/parser/parse_tree.h"
+#include "zetasql/parser/parser.h"
+#include "zetasql/public/parse_resume_location.h"
+#include "zetasql/public/parse_tokens.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "farmhash.h"
+#include "zetasql/base/status_macros.h"
+#include "zetasql/base/thread_pool.h"
+
+namespace zetasql {
+
+namespace {
+
+bool IsNumericLiteral(const ASTNode* node) {
+  switch (node->node_kind()) {
+    case AST_INT_LITERAL:
+    case AST_FLOAT_LITERAL:
+    case AST_NUMERIC_LITERAL:
+    case AST_BIGNUMERIC_LITERAL:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns the byte range of <sql> to replace by "?" for <literal>, or
+// {-1, -1} to keep it.
+std::pair<int, int> GetReplacedRange(const ASTNode* literal,
+                                     const ASTStatement* statement) {
+  const std::pair<int, int> kKeep = {-1, -1};
+  const ASTNode* parent = literal->parent();
+  if (parent == nullptr) return kKeep;
+  const ASTNode* replaced = literal;
+  switch (parent->node_kind()) {
+    case AST_DATE_OR_TIME_LITERAL:
+      // Replaced as a whole, with the parent.
+      return kKeep;
+    case AST_UNARY_EXPRESSION:
+      if (IsNumericLiteral(literal) &&
+          parent->GetAsOrDie<ASTUnaryExpression>()->op() ==
+              ASTUnaryExpression::MINUS) {
+        replaced = parent;
+      }
+      break;
+    case AST_ORDERING_EXPRESSION:
+    case AST_GROUPING_ITEM:
+      if (literal->node_kind() == AST_INT_LITERAL) return kKeep;
+      break;
+    default:
+      break;
+  }
+  // Nodes that the parser created but did not attach to the statement end at
+  // another root, and are not in the input.
+  const ASTNode* root = replaced;
+  for (const ASTNode* node = replaced->parent(); node != nullptr;
+       node = node->parent()) {
+    switch (node->node_kind()) {
+      case AST_HINT:
+      case AST_OPTIONS_LIST:
+      case AST_COLLATE:
+      case AST_TYPE_PARAMETER_LIST:
+        return kKeep;
+      default:
+        root = node;
+    }
+  }
+  if (root != statement) return kKeep;
+  const ParseLocationRange& location = replaced->GetParseLocationRange();
+  return {location.start().GetByteOffset(), location.end().GetByteOffset()};
+}
+
+// Appends the normalized text of <token> to <output>.
+void AppendNormalizedToken(const ParseToken& token, std::string* output) {
+  switch (token.kind()) {
+    case ParseToken::KEYWORD:
+      absl::StrAppend(output, token.GetKeyword());
+      break;
+    case ParseToken::IDENTIFIER_OR_KEYWORD:
+      absl::StrAppend(output, absl::AsciiStrToUpper(token.GetImage()));
+      break;
+    default:
+      absl::StrAppend(output, token.GetSQL());
+      break;
+  }
+}
+
+}  // namespace
+
+absl::StatusOr<QueryFingerprint> FingerprintQuery(
+    absl::string_view sql, const LanguageOptions& language_options) {
+  ParserOptions parser_options(language_options);
+  parser_options.set_node_kinds_to_collect(
+      {AST_INT_LITERAL, AST_FLOAT_LITERAL, AST_NUMERIC_LITERAL,
+       AST_BIGNUMERIC_LITERAL, AST_STRING_LITERAL, AST_BYTES_LITERAL,
+       AST_BOOLEAN_LITERAL, AST_DATE_OR_TIME_LITERAL, AST_JSON_LITERAL});
+  std::unique_ptr<ParserOutput> parser_output;
+  ZETASQL_RETURN_IF_ERROR(ParseStatement(sql, parser_options, &parser_output));
+
+  std::vector<std::pair<int, int>> replaced_ranges;
+  for (const ASTNode* literal : parser_output->collected_nodes()) {
+    const std::pair<int, int> range =
+        GetReplacedRange(literal, parser_output->statement());
+    if (range.first >= 0) replaced_ranges.push_back(range);
+  }
+  std::sort(replaced_ranges.begin(), replaced_ranges.end());
+
+  ParseTokenOptions token_options;
+  token_options.language_options = language_options;
+  ParseResumeLocation resume_location =
+      ParseResumeLocation::FromStringView(sql);
+  std::vector<ParseToken> tokens;
+  ZETASQL_RETURN_IF_ERROR(
+      GetParseTokens(token_options, &resume_location, &tokens));
+
+  QueryFingerprint result;
+  auto next_range = replaced_ranges.begin();
+  auto output_range = replaced_ranges.end();
+  for (const ParseToken& token : tokens) {
+    if (token.IsEndOfInput()) break;
+    const int offset = token.GetLocationRange().start().GetByteOffset();
+    while (next_range != replaced_ranges.end() &&
+           next_range->second <= offset) {
+      ++next_range;
+    }
+    const bool in_replaced_range =
+        next_range != replaced_ranges.end() && next_range->first <= offset;
+    if (in_replaced_range) {
+      // Only the first token of a replaced range is output, as "?".
+      if (next_range == output_range) continue;
+      output_range = next_range;
+    }
+    if (!result.normalized_sql.empty()) result.normalized_sql.push_back(' ');
+    if (in_replaced_range) {
+      result.normalized_sql.push_back('?');
+    } else {
+      AppendNormalizedToken(token, &result.normalized_sql);
+    }
+  }
+  result.fingerprint = farmhash::Fingerprint64(result.normalized_sql);
+  return result;
+}
+
+std::vector<absl::StatusOr<QueryFingerprint>> FingerprintQueries(
+    absl::Span<const std::string> queries,
+    const LanguageOptions& language_options, int num_threads) {
+  std::vector<absl::StatusOr<QueryFingerprint>> results(queries.size());
+  if (queries.empty()) return results;
+  zetasql_base::ThreadPool* pool = zetasql_base::ThreadPool::DefaultPool();
+  const int num_ranges =
+      std::clamp(num_threads > 0 ? num_threads : pool->num_threads(), 1,
+                 static_cast<int>(queries.size()));
+  // Each range is contiguous, so that results are written to separate parts
+  // of the vector.
+  pool->ParallelFor(num_ranges, [&](int range) {
+    const size_t begin = queries.size() * range / num_ranges;
+    const size_t end = queries.size() * (range + 1) / num_ranges;
+    for (size_t i = begin; i < end; ++i) {
+      results[i] = FingerprintQuery(queries[i], language_options);
+    }
+  });
+  return results;
+}
+
+}  // namespace zetasql
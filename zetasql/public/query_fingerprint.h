@@ -0,0 +1,69 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef ZETASQL_PUBLIC_QUERY_FINGERPRINT_H_
+#define ZETASQL_PUBLIC_QUERY_FINGERPRINT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "zetasql/public/language_options.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+
+namespace zetasql {
+
+struct QueryFingerprint {
+  // The statement with its literals replaced by "?", its comments removed,
+  // its tokens separated by single spaces, and its keywords and unquoted
+  // identifiers in upper case.
+  std::string normalized_sql;
+
+  // Fingerprint of 'normalized_sql', stable across processes and releases.
+  uint64_t fingerprint = 0;
+};
+
+// Normalizes the statement in <sql> so that statements that only differ by
+// their literal values, comments, whitespace or case get the same
+// QueryFingerprint.
+//
+// Unlike ReplaceLiteralsByParameters() in literal_remover.h, this only parses
+// <sql> and does not need an analyzed statement, so it is much cheaper, but
+// does not know which literals could really be replaced by parameters. It
+// keeps the literals that are never values: ORDER BY and GROUP BY ordinals,
+// and those in hints, OPTIONS lists, COLLATE clauses and type parameters.
+// DATE '...' and other typed literals, and negated numbers, are replaced as
+// a whole.
+//
+// Returns an error if <sql> is not a valid statement.
+absl::StatusOr<QueryFingerprint> FingerprintQuery(
+    absl::string_view sql,
+    const LanguageOptions& language_options = LanguageOptions());
+
+// Calls FingerprintQuery() on each of <queries> and returns the results in the
+// same order. The queries are split into <num_threads> ranges, or one per
+// thread of zetasql_base::ThreadPool::DefaultPool() if <num_threads> is 0, which
+// run on the calling thread and the threads of that pool.
+std::vector<absl::StatusOr<QueryFingerprint>> FingerprintQueries(
+    absl::Span<const std::string> queries,
+    const LanguageOptions& language_options = LanguageOptions(),
+    int num_threads = 0);
+
+}  // namespace zetasql
+
+#endif  // ZETASQL_PUBLIC_QUERY_FINGERPRINT_H_
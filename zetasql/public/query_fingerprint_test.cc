@@ -0,0 +1,108 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/query_fingerprint.h"
+
+#include <string>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+
+namespace zetasql {
+namespace {
+
+using ::zetasql_base::testing::StatusIs;
+
+TEST(QueryFingerprintTest, IgnoresLiteralValuesCommentsAndCase) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      QueryFingerprint fingerprint,
+      FingerprintQuery("SELECT a FROM t WHERE x = 1 AND s = 'abc'"));
+  EXPECT_EQ(fingerprint.normalized_sql,
+            "SELECT A FROM T WHERE X = ? AND S = ?");
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      QueryFingerprint other,
+      FingerprintQuery("select a\n  from t  -- all rows\n"
+                       "where x = 42 and s = \"xyz\""));
+  EXPECT_EQ(other.normalized_sql, fingerprint.normalized_sql);
+  EXPECT_EQ(other.fingerprint, fingerprint.fingerprint);
+}
+
+TEST(QueryFingerprintTest, ReplacesMultiTokenLiteralsAsAWhole) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      QueryFingerprint fingerprint,
+      FingerprintQuery("SELECT DATE '2020-01-01', -5, NUMERIC '1.5', TRUE, "
+                       "b'\\x01', - x"));
+  EXPECT_EQ(fingerprint.normalized_sql, "SELECT ? , ? , ? , ? , ? , - X");
+}
+
+TEST(QueryFingerprintTest, KeepsLiteralsThatAreNotValues) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      QueryFingerprint fingerprint,
+      FingerprintQuery("SELECT a, b FROM t GROUP BY 1, 2 ORDER BY 2 LIMIT 10"));
+  EXPECT_EQ(fingerprint.normalized_sql,
+            "SELECT A , B FROM T GROUP BY 1 , 2 ORDER BY 2 LIMIT ?");
+
+  // Hints are kept.
+  ZETASQL_ASSERT_OK_AND_ASSIGN(fingerprint,
+                       FingerprintQuery("SELECT @{num_shards = 1} a FROM t"));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(QueryFingerprint other,
+                       FingerprintQuery("SELECT @{num_shards = 2} a FROM t"));
+  EXPECT_NE(fingerprint.fingerprint, other.fingerprint);
+}
+
+TEST(QueryFingerprintTest, DifferentStatementsHaveDifferentFingerprints) {
+  ZETASQL_ASSERT_OK_AND_ASSIGN(QueryFingerprint fingerprint,
+                       FingerprintQuery("SELECT a FROM t WHERE x = 1"));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(QueryFingerprint other,
+                       FingerprintQuery("SELECT a FROM t WHERE y = 1"));
+  EXPECT_NE(fingerprint.fingerprint, other.fingerprint);
+}
+
+TEST(QueryFingerprintTest, InvalidStatement) {
+  EXPECT_THAT(FingerprintQuery("SELECT FROM WHERE"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
+TEST(QueryFingerprintTest, FingerprintQueries) {
+  std::vector<std::string> queries;
+  for (int i = 0; i < 100; ++i) {
+    queries.push_back(
+        absl::StrCat("SELECT c", i % 3, " FROM t WHERE x = ", i));
+  }
+  queries[57] = "SELECT (";
+
+  const std::vector<absl::StatusOr<QueryFingerprint>> results =
+      FingerprintQueries(queries, LanguageOptions(), /*num_threads=*/4);
+  ASSERT_EQ(results.size(), queries.size());
+  for (int i = 0; i < queries.size(); ++i) {
+    if (i == 57) {
+      EXPECT_FALSE(results[i].ok());
+      continue;
+    }
+    ZETASQL_ASSERT_OK(results[i].status());
+    EXPECT_EQ(results[i]->normalized_sql,
+              absl::StrCat("SELECT C", i % 3, " FROM T WHERE X = ?"));
+    EXPECT_EQ(results[i]->fingerprint, results[i % 3]->fingerprint);
+  }
+}
+
+}  // namespace
+}  // namespace zetasql
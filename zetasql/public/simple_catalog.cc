@@ -53,7 +53,7 @@ SimpleCatalog::SimpleCatalog(const std::string& name, TypeFactory* type_factory)
 absl::Status SimpleCatalog::GetTable(const std::string& name,
                                      const Table** table,
                                      const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   *table = zetasql_base::FindPtrOrNull(tables_, absl::AsciiStrToLower(name));
   return absl::OkStatus();
 }
@@ -61,7 +61,7 @@ absl::Status SimpleCatalog::GetTable(const std::string& name,
 absl::Status SimpleCatalog::GetModel(const std::string& name,
                                      const Model** model,
                                      const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   *model = zetasql_base::FindPtrOrNull(models_, absl::AsciiStrToLower(name));
   return absl::OkStatus();
 }
@@ -69,7 +69,7 @@ absl::Status SimpleCatalog::GetModel(const std::string& name,
 absl::Status SimpleCatalog::GetConnection(const std::string& name,
                                           const Connection** connection,
                                           const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   *connection = zetasql_base::FindPtrOrNull(connections_, absl::AsciiStrToLower(name));
   return absl::OkStatus();
 }
@@ -77,7 +77,7 @@ absl::Status SimpleCatalog::GetConnection(const std::string& name,
 absl::Status SimpleCatalog::GetFunction(const std::string& name,
                                         const Function** function,
                                         const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   *function = zetasql_base::FindPtrOrNull(functions_, absl::AsciiStrToLower(name));
   return absl::OkStatus();
 }
@@ -85,7 +85,7 @@ absl::Status SimpleCatalog::GetFunction(const std::string& name,
 absl::Status SimpleCatalog::GetTableValuedFunction(
     const std::string& name, const TableValuedFunction** function,
     const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   *function =
       zetasql_base::FindPtrOrNull(table_valued_functions_, absl::AsciiStrToLower(name));
   return absl::OkStatus();
@@ -94,7 +94,7 @@ absl::Status SimpleCatalog::GetTableValuedFunction(
 absl::Status SimpleCatalog::GetProcedure(const std::string& name,
                                          const Procedure** procedure,
                                          const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   *procedure = zetasql_base::FindPtrOrNull(procedures_, absl::AsciiStrToLower(name));
   return absl::OkStatus();
 }
@@ -103,7 +103,7 @@ absl::Status SimpleCatalog::GetType(const std::string& name, const Type** type,
                                     const FindOptions& options) {
   const google::protobuf::DescriptorPool* pool;
   {
-    absl::MutexLock l(&mutex_);
+    absl::MutexLockMaybe l(lookup_mutex());
     // Types contained in types_ have case-insensitive names, so we lowercase
     // the name as is done in AddType.
     *type = zetasql_base::FindPtrOrNull(types_, absl::AsciiStrToLower(name));
@@ -134,7 +134,7 @@ absl::Status SimpleCatalog::GetType(const std::string& name, const Type** type,
 absl::Status SimpleCatalog::GetCatalog(const std::string& name,
                                        Catalog** catalog,
                                        const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   *catalog = zetasql_base::FindPtrOrNull(catalogs_, absl::AsciiStrToLower(name));
   return absl::OkStatus();
 }
@@ -142,7 +142,7 @@ absl::Status SimpleCatalog::GetCatalog(const std::string& name,
 absl::Status SimpleCatalog::GetConstant(const std::string& name,
                                         const Constant** constant,
                                         const FindOptions& options) {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   *constant = zetasql_base::FindPtrOrNull(constants_, absl::AsciiStrToLower(name));
   return absl::OkStatus();
 }
@@ -295,27 +295,32 @@ std::string SimpleCatalog::SuggestConstant(
 
 void SimpleCatalog::AddTable(absl::string_view name, const Table* table) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   zetasql_base::InsertOrDie(&tables_, absl::AsciiStrToLower(name), table);
 }
 
 void SimpleCatalog::AddModel(const std::string& name, const Model* model) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   zetasql_base::InsertOrDie(&models_, absl::AsciiStrToLower(name), model);
 }
 
 void SimpleCatalog::AddConnection(const std::string& name,
                                   const Connection* connection) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   zetasql_base::InsertOrDie(&connections_, absl::AsciiStrToLower(name), connection);
 }
 
 void SimpleCatalog::AddType(const std::string& name, const Type* type) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   ZETASQL_CHECK(types_.insert({absl::AsciiStrToLower(name), type}).second);
 }
 
 void SimpleCatalog::AddCatalog(const std::string& name, Catalog* catalog) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   AddCatalogLocked(name, catalog);
 }
 
@@ -337,6 +342,7 @@ void SimpleCatalog::AddFunctionLocked(const std::string& name,
 void SimpleCatalog::AddFunction(const std::string& name,
                                 const Function* function) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   AddFunctionLocked(name, function);
 }
 
@@ -349,18 +355,21 @@ void SimpleCatalog::AddTableValuedFunctionLocked(
 void SimpleCatalog::AddTableValuedFunction(
     const std::string& name, const TableValuedFunction* function) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   AddTableValuedFunctionLocked(name, function);
 }
 
 void SimpleCatalog::AddProcedure(const std::string& name,
                                  const Procedure* procedure) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   zetasql_base::InsertOrDie(&procedures_, absl::AsciiStrToLower(name), procedure);
 }
 
 void SimpleCatalog::AddConstant(const std::string& name,
                                 const Constant* constant) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   AddConstantLocked(name, constant);
 }
 
@@ -373,12 +382,14 @@ void SimpleCatalog::AddOwnedTable(absl::string_view name,
                                   std::unique_ptr<const Table> table) {
   AddTable(name, table.get());
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   owned_tables_.push_back(std::move(table));
 }
 
 bool SimpleCatalog::AddOwnedTableIfNotPresent(
     absl::string_view name, std::unique_ptr<const Table> table) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   if (!zetasql_base::InsertIfNotPresent(&tables_, absl::AsciiStrToLower(name),
                                table.get())) {
     return false;
@@ -395,6 +406,7 @@ void SimpleCatalog::AddOwnedModel(const std::string& name,
                                   std::unique_ptr<const Model> model) {
   AddModel(name, model.get());
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   owned_models_.emplace_back(std::move(model));
 }
 
@@ -406,6 +418,7 @@ void SimpleCatalog::AddOwnedCatalog(const std::string& name,
                                     std::unique_ptr<Catalog> catalog) {
   AddCatalog(name, catalog.get());
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   owned_catalogs_.push_back(std::move(catalog));
 }
 
@@ -416,6 +429,7 @@ void SimpleCatalog::AddOwnedCatalog(const std::string& name, Catalog* catalog) {
 void SimpleCatalog::AddOwnedFunction(const std::string& name,
                                      std::unique_ptr<const Function> function) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   AddOwnedFunctionLocked(name, std::move(function));
 }
 
@@ -435,6 +449,7 @@ void SimpleCatalog::AddOwnedTableValuedFunction(
     std::unique_ptr<const TableValuedFunction> function) {
   AddTableValuedFunction(name, function.get());
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   owned_table_valued_functions_.emplace_back(std::move(function));
 }
 
@@ -454,12 +469,14 @@ void SimpleCatalog::AddOwnedProcedure(
     const std::string& name, std::unique_ptr<const Procedure> procedure) {
   AddProcedure(name, procedure.get());
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   owned_procedures_.push_back(std::move(procedure));
 }
 
 bool SimpleCatalog::AddOwnedProcedureIfNotPresent(
     std::unique_ptr<Procedure> procedure) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   if (!zetasql_base::InsertIfNotPresent(&procedures_,
                                absl::AsciiStrToLower(procedure->Name()),
                                procedure.get())) {
@@ -478,6 +495,7 @@ void SimpleCatalog::AddOwnedConstant(const std::string& name,
                                      std::unique_ptr<const Constant> constant) {
   AddConstant(name, constant.get());
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   owned_constants_.push_back(std::move(constant));
 }
 
@@ -522,6 +540,7 @@ void SimpleCatalog::AddConstant(const Constant* constant) {
 void SimpleCatalog::AddOwnedTable(std::unique_ptr<const Table> table) {
   AddTable(table.get());
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   owned_tables_.push_back(std::move(table));
 }
 
@@ -532,6 +551,7 @@ void SimpleCatalog::AddOwnedTable(const Table* table) {
 void SimpleCatalog::AddOwnedModel(std::unique_ptr<const Model> model) {
   AddModel(model.get());
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   owned_models_.emplace_back(std::move(model));
 }
 
@@ -541,6 +561,7 @@ void SimpleCatalog::AddOwnedModel(const Model* model) {
 
 void SimpleCatalog::AddOwnedCatalog(std::unique_ptr<Catalog> catalog) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   const std::string name = catalog->FullName();
   AddOwnedCatalogLocked(name, std::move(catalog));
 }
@@ -558,6 +579,7 @@ void SimpleCatalog::AddOwnedCatalogLocked(const std::string& name,
 bool SimpleCatalog::AddOwnedCatalogIfNotPresent(
     const std::string& name, std::unique_ptr<Catalog> catalog) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   if (zetasql_base::ContainsKey(catalogs_, absl::AsciiStrToLower(name))) {
     return false;
   }
@@ -568,6 +590,7 @@ bool SimpleCatalog::AddOwnedCatalogIfNotPresent(
 void SimpleCatalog::AddOwnedFunction(std::unique_ptr<const Function> function) {
   AddFunction(function->Name(), function.get());
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   owned_functions_.push_back(std::move(function));
 }
 
@@ -578,6 +601,7 @@ void SimpleCatalog::AddOwnedFunction(const Function* function) {
 bool SimpleCatalog::AddOwnedFunctionIfNotPresent(
     const std::string& name, std::unique_ptr<Function>* function) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   // If the function name exists, return false.
   if (zetasql_base::ContainsKey(functions_, absl::AsciiStrToLower(name))) {
     return false;
@@ -603,6 +627,7 @@ void SimpleCatalog::AddOwnedTableValuedFunction(
     std::unique_ptr<const TableValuedFunction> function) {
   AddTableValuedFunction(function.get());
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   owned_table_valued_functions_.push_back(std::move(function));
 }
 
@@ -615,6 +640,7 @@ bool SimpleCatalog::AddOwnedTableValuedFunctionIfNotPresent(
     const std::string& name,
     std::unique_ptr<TableValuedFunction>* table_function) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   // If the table function name exists, return false.
   if (zetasql_base::ContainsKey(table_valued_functions_, absl::AsciiStrToLower(name))) {
     return false;
@@ -632,6 +658,7 @@ bool SimpleCatalog::AddOwnedTableValuedFunctionIfNotPresent(
 bool SimpleCatalog::AddTypeIfNotPresent(const std::string& name,
                                         const Type* type) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   return types_.insert({absl::AsciiStrToLower(name), type}).second;
 }
 
@@ -639,6 +666,7 @@ void SimpleCatalog::AddOwnedProcedure(
     std::unique_ptr<const Procedure> procedure) {
   AddProcedure(procedure.get());
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   owned_procedures_.emplace_back(std::move(procedure));
 }
 
@@ -648,6 +676,7 @@ void SimpleCatalog::AddOwnedProcedure(const Procedure* procedure) {
 
 void SimpleCatalog::AddOwnedConstant(std::unique_ptr<const Constant> constant) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   AddConstantLocked(constant->Name(), constant.get());
   owned_constants_.push_back(std::move(constant));
 }
@@ -655,6 +684,7 @@ void SimpleCatalog::AddOwnedConstant(std::unique_ptr<const Constant> constant) {
 bool SimpleCatalog::AddOwnedConstantIfNotPresent(
     std::unique_ptr<const Constant> constant) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   if (!zetasql_base::InsertIfNotPresent(&constants_,
                                absl::AsciiStrToLower(constant->Name()),
                                constant.get())) {
@@ -676,6 +706,7 @@ SimpleCatalog* SimpleCatalog::MakeOwnedSimpleCatalog(const std::string& name) {
 
 void SimpleCatalog::SetDescriptorPool(const google::protobuf::DescriptorPool* pool) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   ZETASQL_CHECK(descriptor_pool_ == nullptr)
       << "SimpleCatalog::SetDescriptorPool can only be called once";
   owned_descriptor_pool_.reset();
@@ -689,6 +720,7 @@ void SimpleCatalog::SetOwnedDescriptorPool(const google::protobuf::DescriptorPoo
 void SimpleCatalog::SetOwnedDescriptorPool(
     std::unique_ptr<const google::protobuf::DescriptorPool> pool) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   ZETASQL_CHECK(descriptor_pool_ == nullptr)
       << "SimpleCatalog::SetDescriptorPool can only be called once";
   owned_descriptor_pool_ = std::move(pool);
@@ -699,6 +731,7 @@ void SimpleCatalog::AddZetaSQLFunctions(
     const std::vector<const Function*>& functions) {
   TypeFactory* type_factory = this->type_factory();
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
 
   for (const auto& function : functions) {
     const std::vector<std::string>& path = function->FunctionNamePath();
@@ -736,6 +769,7 @@ void SimpleCatalog::AddZetaSQLFunctions(
     if (path.size() > 1) {
       ZETASQL_CHECK_LE(path.size(), 2);
       absl::MutexLock l(&mutex_);
+      CheckNotFrozen();
       const std::string& space = path[0];
       auto sub_entry = owned_zetasql_subcatalogs_.find(space);
       if (sub_entry != owned_zetasql_subcatalogs_.end()) {
@@ -753,6 +787,12 @@ void SimpleCatalog::AddZetaSQLFunctions(
     catalog->AddOwnedFunction(path.back(), std::move(function_pair.second));
   }
 }
+
+void SimpleCatalog::AddSharedZetaSQLFunctions(
+    const ZetaSQLBuiltinFunctionOptions& options) {
+  AddZetaSQLFunctions(GetSharedZetaSQLFunctions(options));
+}
+
 int SimpleCatalog::RemoveFunctionsLocked(
     std::function<bool(const Function*)> predicate,
     std::vector<std::unique_ptr<const Function>>& removed) {
@@ -783,6 +823,7 @@ int SimpleCatalog::RemoveFunctionsLocked(
 int SimpleCatalog::RemoveFunctions(
     std::function<bool(const Function*)> predicate) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   std::vector<std::unique_ptr<const Function>> removed;
   return RemoveFunctionsLocked(predicate, removed);
 }
@@ -820,6 +861,7 @@ int SimpleCatalog::RemoveTableValuedFunctionsLocked(
 int SimpleCatalog::RemoveTableValuedFunctions(
     std::function<bool(const TableValuedFunction*)> predicate) {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   std::vector<std::unique_ptr<const TableValuedFunction>> removed;
   return RemoveTableValuedFunctionsLocked(predicate, removed);
 }
@@ -827,6 +869,7 @@ int SimpleCatalog::RemoveTableValuedFunctions(
 // DEPRECATED
 void SimpleCatalog::ClearTableValuedFunctions() {
   absl::MutexLock l(&mutex_);
+  CheckNotFrozen();
   table_valued_functions_.clear();
   owned_table_valued_functions_.clear();
   for (const auto& pair : owned_zetasql_subcatalogs_) {
@@ -835,8 +878,43 @@ void SimpleCatalog::ClearTableValuedFunctions() {
   owned_zetasql_subcatalogs_.clear();
 }
 
+void SimpleCatalog::Freeze() {
+  std::vector<SimpleCatalog*> owned_simple_catalogs;
+  {
+    absl::MutexLock l(&mutex_);
+    // Allocate the TypeFactory now, so that type_factory() does not need to
+    // lock <mutex_> on a frozen catalog.
+    if (type_factory_ == nullptr) {
+      owned_type_factory_ = std::make_unique<TypeFactory>();
+      type_factory_ = owned_type_factory_.get();
+    }
+    absl::flat_hash_set<const Catalog*> owned_catalogs;
+    for (const std::unique_ptr<const Catalog>& catalog : owned_catalogs_) {
+      owned_catalogs.insert(catalog.get());
+    }
+    for (const auto& [_, catalog] : catalogs_) {
+      SimpleCatalog* simple_catalog = dynamic_cast<SimpleCatalog*>(catalog);
+      if (simple_catalog != nullptr && owned_catalogs.contains(catalog)) {
+        owned_simple_catalogs.push_back(simple_catalog);
+      }
+    }
+    for (const auto& [_, catalog] : owned_zetasql_subcatalogs_) {
+      owned_simple_catalogs.push_back(catalog.get());
+    }
+    frozen_.store(true, std::memory_order_release);
+  }
+  for (SimpleCatalog* catalog : owned_simple_catalogs) {
+    catalog->Freeze();
+  }
+}
+
+void SimpleCatalog::CheckNotFrozen() const {
+  ZETASQL_CHECK(!is_frozen()) << "SimpleCatalog " << name_
+                      << " cannot be modified after Freeze()";
+}
+
 TypeFactory* SimpleCatalog::type_factory() {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   if (type_factory_ == nullptr) {
     ZETASQL_DCHECK(owned_type_factory_ == nullptr);
     owned_type_factory_ = std::make_unique<TypeFactory>();
@@ -1139,7 +1217,7 @@ absl::Status SimpleCatalog::GetCatalogs(
     absl::flat_hash_set<const Catalog*>* output) const {
   ZETASQL_RET_CHECK_NE(output, nullptr);
   ZETASQL_RET_CHECK(output->empty());
-  absl::MutexLock lock(&mutex_);
+  absl::MutexLockMaybe lock(lookup_mutex());
   InsertValuesFromMap(catalogs_, output);
   return absl::OkStatus();
 }
@@ -1148,7 +1226,7 @@ absl::Status SimpleCatalog::GetTables(
     absl::flat_hash_set<const Table*>* output) const {
   ZETASQL_RET_CHECK_NE(output, nullptr);
   ZETASQL_RET_CHECK(output->empty());
-  absl::MutexLock lock(&mutex_);
+  absl::MutexLockMaybe lock(lookup_mutex());
   InsertValuesFromMap(tables_, output);
   return absl::OkStatus();
 }
@@ -1157,7 +1235,7 @@ absl::Status SimpleCatalog::GetTypes(
     absl::flat_hash_set<const Type*>* output) const {
   ZETASQL_RET_CHECK_NE(output, nullptr);
   ZETASQL_RET_CHECK(output->empty());
-  absl::MutexLock lock(&mutex_);
+  absl::MutexLockMaybe lock(lookup_mutex());
   InsertValuesFromMap(types_, output);
   return absl::OkStatus();
 }
@@ -1166,48 +1244,48 @@ absl::Status SimpleCatalog::GetFunctions(
     absl::flat_hash_set<const Function*>* output) const {
   ZETASQL_RET_CHECK_NE(output, nullptr);
   ZETASQL_RET_CHECK(output->empty());
-  absl::MutexLock lock(&mutex_);
+  absl::MutexLockMaybe lock(lookup_mutex());
   InsertValuesFromMap(functions_, output);
   return absl::OkStatus();
 }
 
 std::vector<std::string> SimpleCatalog::table_names() const {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   std::vector<std::string> table_names;
   zetasql_base::AppendKeysFromMap(tables_, &table_names);
   return table_names;
 }
 
 std::vector<const Table*> SimpleCatalog::tables() const {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   std::vector<const Table*> tables;
   zetasql_base::AppendValuesFromMap(tables_, &tables);
   return tables;
 }
 
 std::vector<const Type*> SimpleCatalog::types() const {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   std::vector<const Type*> types;
   zetasql_base::AppendValuesFromMap(types_, &types);
   return types;
 }
 
 std::vector<std::string> SimpleCatalog::function_names() const {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   std::vector<std::string> function_names;
   zetasql_base::AppendKeysFromMap(functions_, &function_names);
   return function_names;
 }
 
 std::vector<const Function*> SimpleCatalog::functions() const {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   std::vector<const Function*> functions;
   zetasql_base::AppendValuesFromMap(functions_, &functions);
   return functions;
 }
 
 std::vector<std::string> SimpleCatalog::table_valued_function_names() const {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   std::vector<std::string> table_valued_function_names;
   zetasql_base::AppendKeysFromMap(table_valued_functions_, &table_valued_function_names);
   return table_valued_function_names;
@@ -1215,42 +1293,42 @@ std::vector<std::string> SimpleCatalog::table_valued_function_names() const {
 
 std::vector<const TableValuedFunction*> SimpleCatalog::table_valued_functions()
     const {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   std::vector<const TableValuedFunction*> table_valued_functions;
   zetasql_base::AppendValuesFromMap(table_valued_functions_, &table_valued_functions);
   return table_valued_functions;
 }
 
 std::vector<const Procedure*> SimpleCatalog::procedures() const {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   std::vector<const Procedure*> procedures;
   zetasql_base::AppendValuesFromMap(procedures_, &procedures);
   return procedures;
 }
 
 std::vector<std::string> SimpleCatalog::catalog_names() const {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   std::vector<std::string> catalog_names;
   zetasql_base::AppendKeysFromMap(catalogs_, &catalog_names);
   return catalog_names;
 }
 
 std::vector<Catalog*> SimpleCatalog::catalogs() const {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   std::vector<Catalog*> catalogs;
   zetasql_base::AppendValuesFromMap(catalogs_, &catalogs);
   return catalogs;
 }
 
 std::vector<std::string> SimpleCatalog::constant_names() const {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   std::vector<std::string> constant_names;
   zetasql_base::AppendKeysFromMap(constants_, &constant_names);
   return constant_names;
 }
 
 std::vector<const Constant*> SimpleCatalog::constants() const {
-  absl::MutexLock l(&mutex_);
+  absl::MutexLockMaybe l(lookup_mutex());
   std::vector<const Constant*> constants;
   zetasql_base::AppendValuesFromMap(constants_, &constants);
   return constants;
@@ -17,6 +17,7 @@
 #ifndef ZETASQL_PUBLIC_SIMPLE_CATALOG_H_
 #define ZETASQL_PUBLIC_SIMPLE_CATALOG_H_
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -59,7 +60,8 @@ class SimpleTableProto;
 // SimpleCatalog is a concrete implementation of the Catalog interface.
 // It acts as a simple container for objects in the Catalog.
 //
-// This class is thread-safe.
+// This class is thread-safe. Lookups take a mutex until the catalog is frozen
+// with Freeze(), after which they are lock-free.
 class SimpleCatalog : public EnumerableCatalog {
  public:
   // Construct a Catalog with catalog name <name>.
@@ -284,6 +286,16 @@ class SimpleCatalog : public EnumerableCatalog {
   void AddZetaSQLFunctions(const std::vector<const Function*>& functions)
       ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Same as AddZetaSQLFunctions(options), but references the immutable
+  // functions from the process-wide registry (see GetSharedZetaSQLFunctions()
+  // in builtin_function.h) rather than building and owning a copy. All
+  // catalogs with the same <options> share one copy of the functions, which
+  // makes creating many of them much cheaper. Only the first catalog for
+  // <options> in the process pays for building the functions.
+  void AddSharedZetaSQLFunctions(const ZetaSQLBuiltinFunctionOptions& options =
+                                       ZetaSQLBuiltinFunctionOptions())
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
   // Set the google::protobuf::DescriptorPool to use when resolving Types.
   // All message and enum types declared in <pool> will be resolvable with
   // FindType or GetType, treating the full name as one identifier.
@@ -341,6 +353,20 @@ class SimpleCatalog : public EnumerableCatalog {
   ABSL_DEPRECATED("Use RemoveTableFunctions")
   void ClearTableValuedFunctions() ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Makes this catalog immutable. Catalogs built once and then shared by many
+  // analyzer threads should be frozen: lookups in a frozen catalog read its
+  // maps without taking <mutex_>, so they do not contend with each other.
+  //
+  // Also freezes the SimpleCatalogs owned by this catalog, including the
+  // subcatalogs added by AddZetaSQLFunctions. Catalogs added with AddCatalog
+  // are not owned and are left unchanged.
+  //
+  // After Freeze(), any call that adds or removes objects, or sets the
+  // DescriptorPool, dies. Freeze() itself may be called more than once.
+  void Freeze() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  bool is_frozen() const { return frozen_.load(std::memory_order_acquire); }
+
   // Deserialize SimpleCatalog from proto. Types will be deserialized using
   // the TypeFactory owned by this catalog and given Descriptors from the
   // given DescriptorPools. The DescriptorPools should have been created by
@@ -418,6 +444,17 @@ class SimpleCatalog : public EnumerableCatalog {
                              bool ignore_recursive) const
       ABSL_LOCKS_EXCLUDED(mutex_);
 
+  // Dies if this catalog is frozen. Called by all the methods that modify it,
+  // while holding <mutex_>, which Freeze() takes to freeze the catalog, so
+  // that no modification can overlap with lock-free lookups.
+  void CheckNotFrozen() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Returns the mutex that lookups must hold: <mutex_>, or NULL if this
+  // catalog is frozen.
+  absl::Mutex* lookup_mutex() const {
+    return is_frozen() ? nullptr : &mutex_;
+  }
+
   // Helper methods for adding objects while holding <mutex_>.
   void AddCatalogLocked(const std::string& name, Catalog* catalog)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -448,6 +485,7 @@ class SimpleCatalog : public EnumerableCatalog {
                       std::vector<std::unique_ptr<const Function>>& removed)
       ABSL_LOCKS_EXCLUDED(mutex_) {
     absl::MutexLock l(&mutex_);
+    CheckNotFrozen();
     return RemoveFunctionsLocked(predicate, removed);
   }
   int RemoveFunctionsLocked(
@@ -463,6 +501,7 @@ class SimpleCatalog : public EnumerableCatalog {
       std::vector<std::unique_ptr<const TableValuedFunction>>& removed)
       ABSL_LOCKS_EXCLUDED(mutex_) {
     absl::MutexLock l(&mutex_);
+    CheckNotFrozen();
     return RemoveTableValuedFunctionsLocked(predicate, removed);
   }
   int RemoveTableValuedFunctionsLocked(
@@ -479,6 +518,10 @@ class SimpleCatalog : public EnumerableCatalog {
 
   mutable absl::Mutex mutex_;
 
+  // Set by Freeze(). Once set, the fields guarded by <mutex_> no longer change
+  // and can be read without holding it.
+  std::atomic<bool> frozen_{false};
+
   // The TypeFactory can be allocated lazily, so may be NULL.
   TypeFactory* type_factory_ ABSL_GUARDED_BY(mutex_);
   std::unique_ptr<TypeFactory> owned_type_factory_ ABSL_GUARDED_BY(mutex_);
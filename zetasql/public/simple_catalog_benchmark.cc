@@ -0,0 +1,50 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the cost of creating SimpleCatalogs with the built-in functions one
+// after another, either building the functions for each catalog or
+// referencing the process-wide shared functions. Each catalog is destroyed
+// before the next one is created.
+
+#include <memory>
+
+#include "zetasql/public/builtin_function_options.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/types/type_factory.h"
+#include "benchmark/benchmark.h"
+
+namespace zetasql {
+namespace {
+
+template <bool kShared>
+void BM_CreateCatalogWithBuiltinFunctions(benchmark::State& state) {
+  const ZetaSQLBuiltinFunctionOptions options;
+  for (auto s : state) {
+    TypeFactory type_factory;
+    auto catalog = std::make_unique<SimpleCatalog>("catalog", &type_factory);
+    if (kShared) {
+      catalog->AddSharedZetaSQLFunctions(options);
+    } else {
+      catalog->AddZetaSQLFunctions(options);
+    }
+    benchmark::DoNotOptimize(catalog.get());
+  }
+}
+BENCHMARK_TEMPLATE(BM_CreateCatalogWithBuiltinFunctions, false);
+BENCHMARK_TEMPLATE(BM_CreateCatalogWithBuiltinFunctions, true);
+
+}  // namespace
+}  // namespace zetasql
@@ -0,0 +1,82 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Measures the analysis throughput of threads sharing one SimpleCatalog, with
+// and without SimpleCatalog::Freeze(). Each analysis looks up the table and
+// every function it calls, so without Freeze() the threads contend on the
+// catalog mutex.
+
+#include <memory>
+#include <string>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/analyzer_options.h"
+#include "zetasql/public/analyzer_output.h"
+#include "zetasql/public/builtin_function_options.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/types/type_factory.h"
+#include "benchmark/benchmark.h"
+#include "zetasql/base/status.h"
+
+namespace zetasql {
+namespace {
+
+constexpr char kQuery[] =
+    "SELECT a + 1, ABS(a - b), CONCAT(s, 'x'), UPPER(s), LENGTH(s) * 2, "
+    "IF(a > b, a, b), COALESCE(s, 'none') "
+    "FROM Events WHERE a > 0 AND b < 100 AND STARTS_WITH(s, 'a')";
+
+// Returns a catalog shared by all the benchmark threads, built once like a
+// catalog built at server startup.
+SimpleCatalog* MakeSharedCatalog(bool freeze) {
+  SimpleCatalog* catalog = new SimpleCatalog("catalog");
+  TypeFactory* type_factory = catalog->type_factory();
+  catalog->AddOwnedTable(
+      new SimpleTable("Events", {{"a", type_factory->get_int64()},
+                                 {"b", type_factory->get_int64()},
+                                 {"s", type_factory->get_string()}}));
+  catalog->AddSharedZetaSQLFunctions(ZetaSQLBuiltinFunctionOptions());
+  if (freeze) {
+    catalog->Freeze();
+  }
+  return catalog;
+}
+
+template <bool kFrozen>
+void BM_AnalyzeWithSharedCatalog(benchmark::State& state) {
+  static SimpleCatalog* const catalog = MakeSharedCatalog(kFrozen);
+  const AnalyzerOptions options;
+  TypeFactory type_factory;
+  for (auto s : state) {
+    std::unique_ptr<const AnalyzerOutput> output;
+    ZETASQL_CHECK_OK(
+        AnalyzeStatement(kQuery, options, catalog, &type_factory, &output));
+    benchmark::DoNotOptimize(output);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_AnalyzeWithSharedCatalog, false)
+    ->Threads(1)
+    ->Threads(32)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_AnalyzeWithSharedCatalog, true)
+    ->Threads(1)
+    ->Threads(32)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace zetasql
@@ -0,0 +1,91 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/public/simple_catalog.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/builtin_function_options.h"
+#include "zetasql/public/catalog.h"
+#include "zetasql/public/function.h"
+#include "zetasql/public/types/type_factory.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace zetasql {
+
+using ::testing::IsNull;
+using ::testing::NotNull;
+
+TEST(SimpleCatalogFreezeTest, LookupsAfterFreeze) {
+  TypeFactory type_factory;
+  SimpleCatalog catalog("catalog", &type_factory);
+  catalog.AddOwnedTable(
+      new SimpleTable("Table1", {{"a", type_factory.get_int64()}}));
+  catalog.AddZetaSQLFunctions(ZetaSQLBuiltinFunctionOptions());
+  SimpleCatalog* nested = catalog.MakeOwnedSimpleCatalog("nested");
+  nested->AddOwnedTable(
+      new SimpleTable("Table2", {{"b", type_factory.get_string()}}));
+  SimpleCatalog unowned("unowned", &type_factory);
+  catalog.AddCatalog(&unowned);
+
+  EXPECT_FALSE(catalog.is_frozen());
+  catalog.Freeze();
+  EXPECT_TRUE(catalog.is_frozen());
+  EXPECT_TRUE(nested->is_frozen());
+  EXPECT_FALSE(unowned.is_frozen());
+  // Freezing again is allowed.
+  catalog.Freeze();
+
+  const Table* table;
+  ZETASQL_ASSERT_OK(catalog.FindTable({"TABLE1"}, &table));
+  EXPECT_EQ(table->Name(), "Table1");
+  ZETASQL_ASSERT_OK(catalog.FindTable({"nested", "table2"}, &table));
+  EXPECT_EQ(table->Name(), "Table2");
+  ZETASQL_ASSERT_OK(catalog.GetTable("table3", &table));
+  EXPECT_THAT(table, IsNull());
+
+  const Function* function;
+  ZETASQL_ASSERT_OK(catalog.FindFunction({"concat"}, &function));
+  EXPECT_THAT(function, NotNull());
+  EXPECT_EQ(catalog.type_factory(), &type_factory);
+  EXPECT_EQ(catalog.tables().size(), 1);
+}
+
+TEST(SimpleCatalogFreezeTest, FreezeAllocatesTypeFactory) {
+  SimpleCatalog catalog("catalog");
+  catalog.Freeze();
+  EXPECT_THAT(catalog.type_factory(), NotNull());
+}
+
+TEST(SimpleCatalogFreezeTest, ModifyingFrozenCatalogDies) {
+  TypeFactory type_factory;
+  SimpleCatalog catalog("catalog", &type_factory);
+  catalog.Freeze();
+  EXPECT_DEATH(catalog.AddOwnedTable(new SimpleTable(
+                   "Table1", {{"a", type_factory.get_int64()}})),
+               "cannot be modified after Freeze");
+  EXPECT_DEATH(catalog.AddZetaSQLFunctions(ZetaSQLBuiltinFunctionOptions()),
+               "cannot be modified after Freeze");
+  EXPECT_DEATH(
+      catalog.RemoveFunctions([](const Function*) { return true; }),
+      "cannot be modified after Freeze");
+}
+
+}  // namespace zetasql
@@ -27,12 +27,14 @@
 #include "zetasql/parser/parse_tree.h"
 #include "zetasql/parser/parse_tree_decls.h"
 #include "zetasql/parser/parse_tree_errors.h"
+#include "zetasql/parser/parser.h"
 #include "zetasql/public/analyzer.h"
 #include "zetasql/public/language_options.h"
 #include "zetasql/public/options.pb.h"
 #include "zetasql/resolved_ast/resolved_ast.h"
 #include "zetasql/resolved_ast/resolved_node_kind.pb.h"
 #include "zetasql/base/case.h"
+#include "absl/container/flat_hash_set.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -57,18 +59,33 @@ class TableNameResolver {
   // If 'type_factory' and 'catalog' are not null, their contents must
   // outlive the created TableNameResolver as well.
   //
+  // If 'query_nodes' is not null, it must hold all the ASTQuery nodes of the
+  // tree, e.g. as collected by the parser. Subtrees without queries are then
+  // skipped instead of searched.
   TableNameResolver(
       absl::string_view sql, const AnalyzerOptions* analyzer_options,
       TypeFactory* type_factory, Catalog* catalog, TableNamesSet* table_names,
-      TableResolutionTimeInfoMap* table_resolution_time_info_map)
+      TableResolutionTimeInfoMap* table_resolution_time_info_map,
+      const std::vector<const ASTNode*>* query_nodes = nullptr)
     : sql_(sql), analyzer_options_(analyzer_options),
       for_system_time_as_of_feature_enabled_(
           analyzer_options->language().LanguageFeatureEnabled(
               FEATURE_V_1_1_FOR_SYSTEM_TIME_AS_OF)),
       type_factory_(type_factory), catalog_(catalog),
       table_names_(table_names),
-      table_resolution_time_info_map_(table_resolution_time_info_map) {
+      table_resolution_time_info_map_(table_resolution_time_info_map),
+      has_query_ancestors_(query_nodes != nullptr) {
     ZETASQL_DCHECK(analyzer_options_->AllArenasAreInitialized());
+    if (query_nodes != nullptr) {
+      for (const ASTNode* query : *query_nodes) {
+        if (query->node_kind() != AST_QUERY) continue;
+        // Stops at the first ancestor marked for a previous query.
+        for (const ASTNode* node = query;
+             node != nullptr && query_ancestors_.insert(node).second;
+             node = node->parent()) {
+        }
+      }
+    }
   }
 
   TableNameResolver(const TableNameResolver&) = delete;
@@ -180,6 +197,14 @@ class TableNameResolver {
   absl::Status FindInOptionsListUnder(const ASTNode* root,
                                       const AliasSet& visible_aliases);
 
+  // Returns in <found_nodes> the nodes of kind <node_kind> in the subtree of
+  // <root>, without descending into them, like
+  // GetDescendantSubtreesWithKinds(). If <query_ancestors_> is set, only
+  // returns the nodes that contain a query, and only visits the subtrees
+  // that do.
+  void GetSubtreesWithKind(const ASTNode* root, ASTNodeKind node_kind,
+                           std::vector<const ASTNode*>* found_nodes) const;
+
   // Root level SQL statement we are extracting table names or temporal
   // references from.
   const absl::string_view sql_;
@@ -213,6 +238,11 @@ class TableNameResolver {
   // names should be treated similar to a WITH alias and not be considered an
   // external reference. In all other cases, this field is an empty vector.
   std::vector<std::string> recursive_view_name_;
+
+  // True if the caller provided all the ASTQuery nodes of the tree. Then
+  // <query_ancestors_> holds them and all their ancestors.
+  const bool has_query_ancestors_;
+  absl::flat_hash_set<const ASTNode*> query_ancestors_;
 };
 
 absl::Status TableNameResolver::FindTableNamesAndTemporalReferences(
@@ -1445,7 +1475,7 @@ absl::Status TableNameResolver::FindInExpressionsUnder(
   // which can be either ASTExpressionSubquery or ASTIn, both of which have
   // the subquery in an ASTQuery child.
   std::vector<const ASTNode*> subquery_nodes;
-  root->GetDescendantSubtreesWithKinds({AST_QUERY}, &subquery_nodes);
+  GetSubtreesWithKind(root, AST_QUERY, &subquery_nodes);
 
   for (const ASTNode* subquery_node : subquery_nodes) {
     ZETASQL_RETURN_IF_ERROR(FindInQuery(subquery_node->GetAs<ASTQuery>(),
@@ -1461,13 +1491,41 @@ absl::Status TableNameResolver::FindInOptionsListUnder(
   if (root == nullptr) return absl::OkStatus();
 
   std::vector<const ASTNode*> options_list_nodes;
-  root->GetDescendantSubtreesWithKinds({AST_OPTIONS_LIST}, &options_list_nodes);
+  GetSubtreesWithKind(root, AST_OPTIONS_LIST, &options_list_nodes);
 
   for (const ASTNode* options_list : options_list_nodes) {
     ZETASQL_RETURN_IF_ERROR(FindInExpressionsUnder(options_list, visible_aliases));
   }
   return absl::OkStatus();
 }
+
+void TableNameResolver::GetSubtreesWithKind(
+    const ASTNode* root, ASTNodeKind node_kind,
+    std::vector<const ASTNode*>* found_nodes) const {
+  if (!has_query_ancestors_) {
+    root->GetDescendantSubtreesWithKinds({node_kind}, found_nodes);
+    return;
+  }
+  // Nodes without a query below them can't lead to any table name, so there
+  // is no need to visit them. In most expressions, this skips everything.
+  found_nodes->clear();
+  if (!query_ancestors_.contains(root)) return;
+  std::vector<const ASTNode*> stack = {root};
+  while (!stack.empty()) {
+    const ASTNode* node = stack.back();
+    stack.pop_back();
+    if (node->node_kind() == node_kind) {
+      found_nodes->push_back(node);
+      continue;
+    }
+    // Pushes the children in reverse, to visit them in order.
+    for (int i = node->num_children() - 1; i >= 0; --i) {
+      if (query_ancestors_.contains(node->child(i))) {
+        stack.push_back(node->child(i));
+      }
+    }
+  }
+}
 }  // namespace
 
 absl::Status FindTableNamesAndResolutionTime(
@@ -1490,5 +1548,23 @@ absl::Status FindTableNamesInScript(absl::string_view sql,
       .FindTableNames(script);
 }
 
+absl::Status FindTablesInParserOutput(absl::string_view sql,
+                                      const ParserOutput& parser_output,
+                                      const AnalyzerOptions& analyzer_options,
+                                      TableNamesSet* table_names) {
+  TableNameResolver resolver(sql, &analyzer_options, /*type_factory=*/nullptr,
+                             /*catalog=*/nullptr, table_names,
+                             /*table_resolution_time_info_map=*/nullptr,
+                             &parser_output.collected_nodes());
+  const ASTNode* node = parser_output.node();
+  ZETASQL_RET_CHECK(node != nullptr);
+  if (node->node_kind() == AST_SCRIPT) {
+    return resolver.FindTableNames(*node->GetAsOrDie<ASTScript>());
+  }
+  ZETASQL_RET_CHECK(node->IsStatement());
+  return resolver.FindTableNamesAndTemporalReferences(
+      *node->GetAsOrDie<ASTStatement>());
+}
+
 }  // namespace table_name_resolver
 }  // namespace zetasql
@@ -18,6 +18,7 @@
 #define ZETASQL_PUBLIC_TABLE_NAME_RESOLVER_H_
 
 #include "zetasql/parser/parse_tree.h"
+#include "zetasql/parser/parser.h"
 #include "zetasql/public/analyzer.h"
 #include "zetasql/public/catalog.h"
 #include "zetasql/public/type.h"
@@ -64,6 +65,16 @@ absl::Status FindTableNamesInScript(absl::string_view sql,
                                     const AnalyzerOptions& analyzer_options,
                                     TableNamesSet* table_names);
 
+// Same as FindTables() or FindTableNamesInScript(), for the statement or script
+// in 'parser_output'. The parser must have been told to collect AST_QUERY nodes
+// with ParserOptions::set_node_kinds_to_collect(); this uses them to skip
+// expressions without subqueries instead of searching them, which makes
+// extracting table names from large queries much cheaper.
+absl::Status FindTablesInParserOutput(absl::string_view sql,
+                                      const ParserOutput& parser_output,
+                                      const AnalyzerOptions& analyzer_options,
+                                      TableNamesSet* table_names);
+
 inline absl::Status FindTables(absl::string_view sql,
                                const ASTStatement& statement,
                                const AnalyzerOptions& analyzer_options,
@@ -0,0 +1,98 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Compares extracting the table names of a query log by parsing each query
+// and searching its whole tree, with ExtractTableNamesFromStatement(), which
+// has the parser collect the queries so that only the subtrees containing them
+// are searched.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "zetasql/base/logging.h"
+#include "zetasql/parser/parser.h"
+#include "zetasql/public/analyzer.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "benchmark/benchmark.h"
+#include "zetasql/base/status.h"
+
+namespace zetasql {
+namespace {
+
+// Returns queries shaped like reporting queries: wide select lists of
+// expressions, a few joins, and the occasional expression subquery.
+std::vector<std::string> MakeQueryLog(int num_queries) {
+  std::vector<std::string> queries;
+  for (int q = 0; q < num_queries; ++q) {
+    std::vector<std::string> columns;
+    for (int c = 0; c < 50; ++c) {
+      columns.push_back(absl::StrCat("IF(a.c", c, " > ", q, ", SUM(b.c", c,
+                                     " * 2), MAX(CONCAT(a.s", c,
+                                     ", 'x'))) AS r", c));
+    }
+    if (q % 4 == 0) {
+      columns.push_back(
+          absl::StrCat("(SELECT MAX(v) FROM project.dataset.lookup_", q % 7,
+                       " WHERE k = a.k) AS looked_up"));
+    }
+    queries.push_back(absl::StrCat(
+        "SELECT ", absl::StrJoin(columns, ", "), " FROM project.dataset.facts_",
+        q % 13, " AS a JOIN project.dataset.dims_", q % 5,
+        " AS b USING (k) LEFT JOIN a.nested AS n ON n.id = b.id WHERE a.d "
+        "BETWEEN DATE '2020-01-01' AND DATE '2020-12-31' AND b.flag IN (1, 2, "
+        "3) GROUP BY a.k HAVING COUNT(*) > 10 ORDER BY 1 LIMIT 100"));
+  }
+  return queries;
+}
+
+void BM_ExtractTableNamesSearchingWholeTree(benchmark::State& state) {
+  const std::vector<std::string> queries = MakeQueryLog(100);
+  AnalyzerOptions options;
+  for (auto s : state) {
+    for (const std::string& sql : queries) {
+      AnalyzerOptions query_options = options;
+      query_options.CreateDefaultArenasIfNotSet();
+      std::unique_ptr<ParserOutput> parser_output;
+      ZETASQL_CHECK_OK(ParseStatement(sql, query_options.GetParserOptions(),
+                              &parser_output));
+      TableNamesSet table_names;
+      ZETASQL_CHECK_OK(ExtractTableNamesFromASTStatement(
+          *parser_output->statement(), query_options, sql, &table_names));
+      benchmark::DoNotOptimize(table_names);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK(BM_ExtractTableNamesSearchingWholeTree);
+
+void BM_ExtractTableNamesFromStatement(benchmark::State& state) {
+  const std::vector<std::string> queries = MakeQueryLog(100);
+  AnalyzerOptions options;
+  for (auto s : state) {
+    for (const std::string& sql : queries) {
+      TableNamesSet table_names;
+      ZETASQL_CHECK_OK(ExtractTableNamesFromStatement(sql, options, &table_names));
+      benchmark::DoNotOptimize(table_names);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+BENCHMARK(BM_ExtractTableNamesFromStatement);
+
+}  // namespace
+}  // namespace zetasql
@@ -14,6 +14,10 @@
 // limitations under the License.
 //
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "zetasql/base/testing/status_matchers.h"
 #include "zetasql/parser/parser.h"
 #include "zetasql/public/analyzer.h"
@@ -154,4 +158,40 @@ TEST(TableNameResolver, UnsupportedAssignmentStatements) {
   }
 }
 
+TEST(TableNameResolver, CollectedQueryNodesFindSameTables) {
+  // ExtractTableNamesFromStatement() only searches the subtrees that the
+  // parser saw queries in. It must find the same tables as searching the
+  // whole tree.
+  const std::vector<std::string> statements = {
+      "SELECT a, b + 1, f(c) FROM t1 WHERE a > 5 GROUP BY 1, 2, 3",
+      "SELECT (SELECT MAX(x) FROM t1), ARRAY(SELECT y FROM t2) FROM t3",
+      "SELECT * FROM t1 WHERE a IN (SELECT b FROM t2) AND "
+      "EXISTS(SELECT 1 FROM t3 WHERE t3.c = t1.c)",
+      "WITH w AS (SELECT * FROM t1) SELECT * FROM w, t2 AS a, a.arr "
+      "JOIN t3 ON t3.k = (SELECT k FROM t4)",
+      "SELECT * FROM t1 ORDER BY (SELECT COUNT(*) FROM t2)",
+      "INSERT INTO t1 SELECT * FROM t2 WHERE x = (SELECT y FROM t3)",
+      "UPDATE t1 SET a = (SELECT b FROM t2) WHERE c IN (SELECT d FROM t3)",
+      "DELETE FROM t1 WHERE a NOT IN (SELECT b FROM t2)",
+      "CREATE TABLE t1 OPTIONS (x = (SELECT 1 FROM t2)) AS SELECT * FROM t3",
+  };
+
+  AnalyzerOptions analyzer_options;
+  analyzer_options.CreateDefaultArenasIfNotSet();
+  analyzer_options.mutable_language()->SetSupportsAllStatementKinds();
+  for (const std::string& sql : statements) {
+    SCOPED_TRACE(sql);
+    TableNamesSet expected_tables;
+    std::unique_ptr<ParserOutput> parser_output;
+    ZETASQL_ASSERT_OK(ParseStatement(sql, ParserOptions(), &parser_output));
+    ZETASQL_ASSERT_OK(ExtractTableNamesFromASTStatement(
+        *parser_output->statement(), analyzer_options, sql, &expected_tables));
+
+    TableNamesSet tables;
+    ZETASQL_ASSERT_OK(ExtractTableNamesFromStatement(sql, analyzer_options, &tables));
+    EXPECT_EQ(expected_tables, tables);
+    EXPECT_FALSE(tables.empty());
+  }
+}
+
 }  // namespace zetasql
@@ -17,12 +17,16 @@
 // This file contains the code for evaluating aggregate functions.
 
 #include <cstdint>
+#include <cstdlib>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <string>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
+#include "zetasql/public/numeric_value.h"
 #include "zetasql/public/type.h"
 #include "zetasql/public/value.h"
 #include "zetasql/reference_impl/common.h"
@@ -145,6 +149,18 @@ class IntermediateAggregateAccumulator {
 
   virtual absl::StatusOr<Value> GetFinalResult(
       bool inputs_in_defined_order) = 0;
+
+  // Partial aggregation, as in AggregateAccumulator. Modifiers that need the
+  // input rows, like DISTINCT, ORDER BY, LIMIT and HAVING MAX/MIN, do not
+  // support it.
+  virtual absl::StatusOr<std::string> SerializeState() const {
+    return absl::UnimplementedError(
+        "Aggregate modifiers do not support partial aggregation");
+  }
+  virtual absl::Status MergeSerializedState(absl::string_view state) {
+    return absl::UnimplementedError(
+        "Aggregate modifiers do not support partial aggregation");
+  }
 };
 
 // Adapts AggregateAccumulator to IntermediateAggregateAccumulator.
@@ -193,6 +209,34 @@ class AggregateAccumulatorAdaptor : public IntermediateAggregateAccumulator {
     return status_or_value.value();
   }
 
+  // The state starts with whether an error was suppressed, in which case the
+  // merged result is NULL.
+  absl::StatusOr<std::string> SerializeState() const override {
+    std::string state(1, safe_result_.is_valid() ? '\1' : '\0');
+    if (!safe_result_.is_valid()) {
+      ZETASQL_ASSIGN_OR_RETURN(const std::string accumulator_state,
+                       accumulator_->SerializeState());
+      absl::StrAppend(&state, accumulator_state);
+    }
+    return state;
+  }
+
+  absl::Status MergeSerializedState(absl::string_view state) override {
+    ZETASQL_RET_CHECK(!state.empty());
+    if (state[0] != '\0') {
+      safe_result_ = Value::Null(output_type_);
+      return absl::OkStatus();
+    }
+    if (safe_result_.is_valid()) return absl::OkStatus();
+    const absl::Status status =
+        accumulator_->MergeSerializedState(state.substr(1));
+    if (!status.ok() && ShouldSuppressError(status, error_mode_)) {
+      safe_result_ = Value::Null(output_type_);
+      return absl::OkStatus();
+    }
+    return status;
+  }
+
  private:
   const Type* output_type_;
   const ResolvedFunctionCallBase::ErrorMode error_mode_;
@@ -523,6 +567,14 @@ class IgnoresNullAccumulator : public IntermediateAggregateAccumulator {
     return accumulator_->GetFinalResult(inputs_in_defined_order);
   }
 
+  absl::StatusOr<std::string> SerializeState() const override {
+    return accumulator_->SerializeState();
+  }
+
+  absl::Status MergeSerializedState(absl::string_view state) override {
+    return accumulator_->MergeSerializedState(state);
+  }
+
  private:
   const bool use_compound_values_;
   std::unique_ptr<IntermediateAggregateAccumulator> accumulator_;
@@ -712,6 +764,14 @@ class FilteredArgAccumulator : public IntermediateAggregateAccumulator {
     return accumulator_->GetFinalResult(inputs_in_defined_order);
   }
 
+  absl::StatusOr<std::string> SerializeState() const override {
+    return accumulator_->SerializeState();
+  }
+
+  absl::Status MergeSerializedState(absl::string_view state) override {
+    return accumulator_->MergeSerializedState(state);
+  }
+
  private:
   const std::vector<const TupleData*> params_;
 
@@ -884,6 +944,14 @@ class IntermediateAggregateAccumulatorAdaptor : public AggregateArgAccumulator {
     return accumulator_->GetFinalResult(inputs_in_defined_order);
   }
 
+  absl::StatusOr<std::string> SerializeState() const override {
+    return accumulator_->SerializeState();
+  }
+
+  absl::Status MergeSerializedState(absl::string_view state) override {
+    return accumulator_->MergeSerializedState(state);
+  }
+
  private:
   const std::vector<const TupleData*> params_;
   const std::vector<const ValueExpr*> value_exprs_;
@@ -1102,6 +1170,381 @@ absl::StatusOr<Value> AggregateArg::EvalAgg(
   return status_or_result.value();
 }
 
+namespace {
+
+// How EvalAggOverWindows() computes an aggregate over a sequence of windows.
+enum class WindowAggregation {
+  // Aggregates each window from scratch.
+  kPerWindow,
+  // Slides a single accumulation over the windows, adding the rows that enter
+  // a window and removing the rows that leave it. Requires an aggregate whose
+  // state can be updated exactly in both directions.
+  kInvertible,
+  // Answers each window from a segment tree over the partition, whose nodes
+  // hold the aggregate of their ranges. Requires an aggregate of the
+  // aggregates of two ranges to equal the aggregate of their union.
+  kSegmentTree,
+};
+
+WindowAggregation GetWindowAggregation(
+    const BuiltinAggregateFunction& function) {
+  if (!function.ignores_null() || function.num_input_fields() > 1) {
+    return WindowAggregation::kPerWindow;
+  }
+  const TypeKind input_kind = function.input_type()->kind();
+  switch (function.kind()) {
+    case FunctionKind::kCount:
+    case FunctionKind::kCountIf:
+      return WindowAggregation::kInvertible;
+    case FunctionKind::kSum:
+      // SUM(DOUBLE) is not included: its exact accumulator would make removals
+      // exact too, but grows with the range of the inputs.
+      return input_kind == TYPE_INT64 || input_kind == TYPE_UINT64 ||
+                     input_kind == TYPE_NUMERIC ||
+                     input_kind == TYPE_BIGNUMERIC
+                 ? WindowAggregation::kInvertible
+                 : WindowAggregation::kPerWindow;
+    case FunctionKind::kAvg:
+      // AVG of INT64, UINT64 and DOUBLE uses an iterative algorithm whose
+      // result depends on the order of the inputs.
+      return input_kind == TYPE_NUMERIC || input_kind == TYPE_BIGNUMERIC
+                 ? WindowAggregation::kInvertible
+                 : WindowAggregation::kPerWindow;
+    case FunctionKind::kMin:
+    case FunctionKind::kMax:
+      return input_kind == TYPE_ARRAY ? WindowAggregation::kPerWindow
+                                      : WindowAggregation::kSegmentTree;
+    case FunctionKind::kBitAnd:
+    case FunctionKind::kBitOr:
+    case FunctionKind::kBitXor:
+    case FunctionKind::kLogicalAnd:
+    case FunctionKind::kLogicalOr:
+      return WindowAggregation::kSegmentTree;
+    default:
+      return WindowAggregation::kPerWindow;
+  }
+}
+
+// Aggregate state for WindowAggregation::kInvertible. Mirrors the computation
+// of BuiltinAggregateAccumulator for the same functions, which is exact, so
+// that removing a value exactly undoes adding it.
+class InvertibleWindowAccumulator {
+ public:
+  InvertibleWindowAccumulator(FunctionKind kind, const Type* input_type,
+                              const Type* output_type)
+      : kind_(kind), input_type_(input_type), output_type_(output_type) {}
+
+  InvertibleWindowAccumulator(const InvertibleWindowAccumulator&) = delete;
+  InvertibleWindowAccumulator& operator=(const InvertibleWindowAccumulator&) =
+      delete;
+
+  void Reset() {
+    count_ = 0;
+    countif_ = 0;
+    int128_sum_ = 0;
+    uint128_sum_ = 0;
+    numeric_sum_ = NumericValue::SumAggregator();
+    bignumeric_sum_ = BigNumericValue::SumAggregator();
+  }
+
+  void Add(const Value& value) { Update(value, /*add=*/true); }
+  void Remove(const Value& value) { Update(value, /*add=*/false); }
+
+  // Returns the aggregate of the current window, or nullopt if computing it
+  // fails, e.g. on overflow. The caller then evaluates the window from scratch
+  // to get the error, or NULL in SAFE mode.
+  std::optional<Value> GetResult() const {
+    if (kind_ == FunctionKind::kCount) return Value::Int64(count_);
+    if (kind_ == FunctionKind::kCountIf) return Value::Int64(countif_);
+    if (count_ == 0) return Value::Null(output_type_);
+    switch (input_type_->kind()) {
+      case TYPE_INT64:
+        if (int128_sum_ > std::numeric_limits<int64_t>::max() ||
+            int128_sum_ < std::numeric_limits<int64_t>::min()) {
+          return std::nullopt;
+        }
+        return Value::Int64(static_cast<int64_t>(int128_sum_));
+      case TYPE_UINT64:
+        if (uint128_sum_ > std::numeric_limits<uint64_t>::max()) {
+          return std::nullopt;
+        }
+        return Value::Uint64(static_cast<uint64_t>(uint128_sum_));
+      case TYPE_NUMERIC: {
+        const absl::StatusOr<NumericValue> result =
+            kind_ == FunctionKind::kAvg ? numeric_sum_.GetAverage(count_)
+                                        : numeric_sum_.GetSum();
+        if (!result.ok()) return std::nullopt;
+        return Value::Numeric(*result);
+      }
+      case TYPE_BIGNUMERIC: {
+        const absl::StatusOr<BigNumericValue> result =
+            kind_ == FunctionKind::kAvg ? bignumeric_sum_.GetAverage(count_)
+                                        : bignumeric_sum_.GetSum();
+        if (!result.ok()) return std::nullopt;
+        return Value::BigNumeric(*result);
+      }
+      default:
+        return std::nullopt;
+    }
+  }
+
+ private:
+  void Update(const Value& value, bool add) {
+    if (value.is_null()) return;
+    const int sign = add ? 1 : -1;
+    count_ += sign;
+    if (kind_ == FunctionKind::kCount) return;
+    if (kind_ == FunctionKind::kCountIf) {
+      if (value.bool_value()) countif_ += sign;
+      return;
+    }
+    switch (input_type_->kind()) {
+      case TYPE_INT64:
+        int128_sum_ += add ? __int128{value.int64_value()}
+                           : -__int128{value.int64_value()};
+        break;
+      case TYPE_UINT64:
+        // Wraps around on removal, but the sum of the values in the window
+        // always fits.
+        uint128_sum_ += add ? static_cast<unsigned __int128>(
+                                  value.uint64_value())
+                            : -static_cast<unsigned __int128>(
+                                  value.uint64_value());
+        break;
+      case TYPE_NUMERIC:
+        if (add) {
+          numeric_sum_.Add(value.numeric_value());
+        } else {
+          numeric_sum_.Subtract(value.numeric_value());
+        }
+        break;
+      case TYPE_BIGNUMERIC:
+        if (add) {
+          bignumeric_sum_.Add(value.bignumeric_value());
+        } else {
+          bignumeric_sum_.Subtract(value.bignumeric_value());
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  const FunctionKind kind_;
+  const Type* input_type_;
+  const Type* output_type_;
+
+  int64_t count_ = 0;  // Number of non-NULL values.
+  int64_t countif_ = 0;
+  __int128 int128_sum_ = 0;
+  unsigned __int128 uint128_sum_ = 0;
+  NumericValue::SumAggregator numeric_sum_;
+  BigNumericValue::SumAggregator bignumeric_sum_;
+};
+
+// Aggregates the values in 'values' with 'accumulator', skipping NULLs like
+// IgnoresNullAccumulator does.
+absl::StatusOr<Value> AccumulateNonNullValues(
+    absl::Span<const Value* const> values, AggregateAccumulator* accumulator) {
+  ZETASQL_RETURN_IF_ERROR(accumulator->Reset());
+  bool stop_accumulation;
+  absl::Status status;
+  for (const Value* value : values) {
+    if (value->is_null()) continue;
+    if (!accumulator->Accumulate(*value, &stop_accumulation, &status)) {
+      return status;
+    }
+  }
+  return accumulator->GetFinalResult(/*inputs_in_defined_order=*/false);
+}
+
+// Segment tree for WindowAggregation::kSegmentTree. Node i covers the union of
+// the ranges of nodes 2i and 2i+1, and leaf n+i holds the input value of row i.
+class WindowSegmentTree {
+ public:
+  static absl::StatusOr<std::unique_ptr<WindowSegmentTree>> Create(
+      std::vector<Value> inputs,
+      std::unique_ptr<AggregateAccumulator> accumulator) {
+    auto tree = absl::WrapUnique(
+        new WindowSegmentTree(inputs.size(), std::move(accumulator)));
+    std::move(inputs.begin(), inputs.end(),
+              tree->nodes_.begin() + tree->num_leaves_);
+    for (int64_t i = tree->num_leaves_ - 1; i > 0; --i) {
+      ZETASQL_ASSIGN_OR_RETURN(tree->nodes_[i],
+                       AccumulateNonNullValues(
+                           {&tree->nodes_[2 * i], &tree->nodes_[2 * i + 1]},
+                           tree->accumulator_.get()));
+    }
+    return tree;
+  }
+
+  WindowSegmentTree(const WindowSegmentTree&) = delete;
+  WindowSegmentTree& operator=(const WindowSegmentTree&) = delete;
+
+  // Returns the aggregate of the rows in [start, end).
+  absl::StatusOr<Value> Query(int64_t start, int64_t end) {
+    covering_nodes_.clear();
+    for (int64_t lo = start + num_leaves_, hi = end + num_leaves_; lo < hi;
+         lo /= 2, hi /= 2) {
+      if (lo & 1) covering_nodes_.push_back(&nodes_[lo++]);
+      if (hi & 1) covering_nodes_.push_back(&nodes_[--hi]);
+    }
+    return AccumulateNonNullValues(covering_nodes_, accumulator_.get());
+  }
+
+ private:
+  WindowSegmentTree(int64_t num_leaves,
+                    std::unique_ptr<AggregateAccumulator> accumulator)
+      : num_leaves_(num_leaves),
+        nodes_(2 * num_leaves),
+        accumulator_(std::move(accumulator)) {}
+
+  const int64_t num_leaves_;
+  std::vector<Value> nodes_;
+  std::unique_ptr<AggregateAccumulator> accumulator_;
+  // Scratch space for Query().
+  std::vector<const Value*> covering_nodes_;
+};
+
+// Evaluates the aggregate of 'function' over each of 'windows' of
+// 'partition'. 'input_field' computes the aggregated value from a row, and is
+// null for COUNT(*). Leaves an invalid Value in 'values' for windows whose
+// aggregate must be evaluated from scratch.
+absl::Status EvalAggOverWindowsIncrementally(
+    const BuiltinAggregateFunction& function,
+    WindowAggregation window_aggregation, const ValueExpr* input_field,
+    absl::Span<const TupleData* const> partition,
+    absl::Span<const AnalyticWindow> windows,
+    absl::Span<const TupleData* const> params, EvaluationContext* context,
+    std::vector<Value>* values) {
+  // Only evaluate the aggregated value for rows that are in some window, like
+  // aggregating each window from scratch does.
+  std::vector<int> window_boundaries(partition.size() + 1, 0);
+  for (const AnalyticWindow& window : windows) {
+    ++window_boundaries[window.start_tuple_id];
+    --window_boundaries[window.start_tuple_id + window.num_tuples];
+  }
+  std::vector<Value> inputs;
+  inputs.reserve(partition.size());
+  int num_windows_containing_row = 0;
+  for (int i = 0; i < partition.size(); ++i) {
+    num_windows_containing_row += window_boundaries[i];
+    if (num_windows_containing_row == 0) {
+      inputs.push_back(Value::Null(function.input_type()));
+    } else if (input_field == nullptr) {
+      // COUNT(*) counts every row.
+      inputs.push_back(Value::Bool(true));
+    } else {
+      Value input;
+      std::shared_ptr<TupleSlot::SharedProtoState> shared_state;
+      VirtualTupleSlot slot(&input, &shared_state);
+      absl::Status status;
+      if (!input_field->Eval(ConcatSpans(params, {partition[i]}), context,
+                             &slot, &status)) {
+        return status;
+      }
+      inputs.push_back(std::move(input));
+    }
+  }
+
+  values->reserve(windows.size());
+  if (window_aggregation == WindowAggregation::kSegmentTree) {
+    ZETASQL_ASSIGN_OR_RETURN(
+        std::unique_ptr<AggregateAccumulator> accumulator,
+        function.CreateAccumulator(/*args=*/{}, /*collator_list=*/{}, context));
+    ZETASQL_ASSIGN_OR_RETURN(
+        std::unique_ptr<WindowSegmentTree> tree,
+        WindowSegmentTree::Create(std::move(inputs), std::move(accumulator)));
+    for (const AnalyticWindow& window : windows) {
+      ZETASQL_ASSIGN_OR_RETURN(
+          Value value,
+          tree->Query(window.start_tuple_id,
+                      window.start_tuple_id + window.num_tuples));
+      values->push_back(std::move(value));
+    }
+    return absl::OkStatus();
+  }
+
+  ZETASQL_RET_CHECK(window_aggregation == WindowAggregation::kInvertible);
+  InvertibleWindowAccumulator accumulator(
+      function.kind(), function.input_type(), function.output_type());
+  // The rows in the current window are [lo, hi).
+  int lo = 0;
+  int hi = 0;
+  for (const AnalyticWindow& window : windows) {
+    const int start = window.start_tuple_id;
+    const int end = window.start_tuple_id + window.num_tuples;
+    if (end - start <= std::abs(start - lo) + std::abs(end - hi)) {
+      // Accumulating the window from scratch is no more work than updating
+      // the current one, and is the only option if they do not overlap.
+      accumulator.Reset();
+      lo = hi = start;
+    }
+    // Extend before shrinking, so that the window never contains rows that
+    // are not in either the current or the next window.
+    for (; hi < end; ++hi) accumulator.Add(inputs[hi]);
+    for (; lo > start; --lo) accumulator.Add(inputs[lo - 1]);
+    for (; lo < start; ++lo) accumulator.Remove(inputs[lo]);
+    for (; hi > end; --hi) accumulator.Remove(inputs[hi - 1]);
+    values->push_back(accumulator.GetResult().value_or(Value()));
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace
+
+absl::Status AggregateArg::EvalAggOverWindows(
+    absl::Span<const TupleData* const> partition,
+    absl::Span<const AnalyticWindow> windows,
+    absl::Span<const TupleData* const> params, EvaluationContext* context,
+    std::vector<Value>* values) const {
+  ZETASQL_RET_CHECK(values->empty());
+  const BuiltinAggregateFunction* function =
+      dynamic_cast<const BuiltinAggregateFunction*>(
+          aggregate_function()->function());
+  WindowAggregation window_aggregation = WindowAggregation::kPerWindow;
+  // Incremental evaluation does not support the modifiers of the aggregate, or
+  // arguments other than the aggregated value.
+  if (function != nullptr && windows.size() > 1 && distinct() == kAll &&
+      having_expr() == nullptr && order_by_keys().empty() &&
+      limit() == nullptr && group_rows_subquery_ == nullptr &&
+      filter() == nullptr && collation_list().empty() &&
+      parameter_list_size() == 0) {
+    window_aggregation = GetWindowAggregation(*function);
+  }
+
+  if (window_aggregation != WindowAggregation::kPerWindow) {
+    const absl::Status status = EvalAggOverWindowsIncrementally(
+        *function, window_aggregation,
+        num_input_fields() == 0 ? nullptr : input_field(0), partition, windows,
+        params, context, values);
+    if (status.ok()) {
+      for (int i = 0; i < windows.size(); ++i) {
+        if ((*values)[i].is_valid()) continue;
+        const AnalyticWindow& window = windows[i];
+        ZETASQL_ASSIGN_OR_RETURN(
+            (*values)[i],
+            EvalAgg(partition.subspan(window.start_tuple_id, window.num_tuples),
+                    params, context));
+      }
+      return absl::OkStatus();
+    }
+    // Aggregate each window from scratch, which reports the same error, or
+    // produces the same NULLs in SAFE mode, as without incremental evaluation.
+    values->clear();
+  }
+
+  values->reserve(windows.size());
+  for (const AnalyticWindow& window : windows) {
+    ZETASQL_ASSIGN_OR_RETURN(
+        Value value,
+        EvalAgg(partition.subspan(window.start_tuple_id, window.num_tuples),
+                params, context));
+    values->push_back(std::move(value));
+  }
+  return absl::OkStatus();
+}
+
 std::string AggregateArg::DebugInternal(const std::string& indent,
                                         bool verbose) const {
   std::string result;
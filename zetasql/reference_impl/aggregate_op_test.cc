@@ -16,7 +16,10 @@
 
 // Tests of aggregate function code.
 
+#include <algorithm>
+#include <cmath>
 #include <cstdint>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -479,9 +482,163 @@ TEST_P(AggregateFunctionTemplateTest, AggregateFunctionTest) {
       << "Aggregate function: " << fct.debug_name();
 }
 
+// Accumulates <values> into a new accumulator for <agg>.
+static absl::StatusOr<std::unique_ptr<AggregateAccumulator>> Accumulate(
+    const AggregateFunctionBody& agg, absl::Span<const Value> values,
+    EvaluationContext* context, absl::Span<const Value> args = {}) {
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<AggregateAccumulator> accumulator,
+                   agg.CreateAccumulator(args, /*collator_list=*/{}, context));
+  bool stop_accumulation;
+  absl::Status status;
+  for (const Value& value : values) {
+    if (!accumulator->Accumulate(value, &stop_accumulation, &status)) {
+      return status;
+    }
+    if (stop_accumulation) break;
+  }
+  return accumulator;
+}
+
+// Evaluates an aggregation function by accumulating the first <split> values
+// and the others separately, and merging the partial states.
+static absl::StatusOr<Value> EvalAggWithMerge(
+    const AggregateFunctionBody& agg, absl::Span<const Value> values,
+    int split, EvaluationContext* context, absl::Span<const Value> args = {}) {
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<AggregateAccumulator> accumulator,
+                   Accumulate(agg, values.subspan(0, split), context, args));
+  ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<AggregateAccumulator> other,
+                   Accumulate(agg, values.subspan(split), context, args));
+  ZETASQL_RETURN_IF_ERROR(accumulator->Merge(*other));
+  return accumulator->GetFinalResult(/*inputs_in_defined_order=*/false);
+}
+
+TEST_P(AggregateFunctionTemplateTest, MergePartialStates) {
+  const AggregateFunctionTemplate& t = GetParam();
+  if (!t.is_deterministic) return;
+  BuiltinAggregateFunction fct(t.kind, t.result.type(), /*num_input_fields=*/1,
+                               t.argument_type());
+  EvaluationContext context((EvaluationOptions()));
+  for (int split = 0; split <= t.values.size(); ++split) {
+    const absl::StatusOr<Value> result =
+        EvalAggWithMerge(fct, t.values, split, &context);
+    if (absl::IsUnimplemented(result.status())) return;
+    EXPECT_THAT(result, IsOkAndHolds(t.result)) << "split at " << split;
+  }
+}
+
 INSTANTIATE_TEST_SUITE_P(AggregateFunction, AggregateFunctionTemplateTest,
                          ValuesIn(AggregateFunctionTemplates()));
 
+TEST(EvalAggTest, MergeDoubleStatistics) {
+  std::vector<Value> values;
+  std::vector<Value> pairs;
+  const StructType* pair_type;
+  TypeFactory type_factory;
+  ZETASQL_ASSERT_OK(type_factory.MakeStructType(
+      {{"y", DoubleType()}, {"x", DoubleType()}}, &pair_type));
+  for (int i = 0; i < 100; ++i) {
+    const double x = 1e9 + (i % 7) * 0.5 - i * 0.01;
+    values.push_back(i % 10 == 3 ? NullDouble() : Double(x));
+    pairs.push_back(Value::Struct(pair_type, {Double(2 * x - i), Double(x)}));
+  }
+
+  EvaluationContext context((EvaluationOptions()));
+  for (const FunctionKind kind :
+       {FunctionKind::kAvg, FunctionKind::kSum, FunctionKind::kVarPop,
+        FunctionKind::kStddevSamp}) {
+    BuiltinAggregateFunction fct(kind, DoubleType(), /*num_input_fields=*/1,
+                                 DoubleType());
+    ZETASQL_ASSERT_OK_AND_ASSIGN(const Value expected,
+                         EvalAgg(fct, values, &context));
+    for (const int split : {1, 37, 50, 99}) {
+      ZETASQL_ASSERT_OK_AND_ASSIGN(const Value merged,
+                           EvalAggWithMerge(fct, values, split, &context));
+      EXPECT_NEAR(merged.double_value(), expected.double_value(),
+                  1e-9 * std::abs(expected.double_value()))
+          << fct.debug_name() << ", split at " << split;
+    }
+  }
+
+  for (const FunctionKind kind :
+       {FunctionKind::kCovarSamp, FunctionKind::kCorr}) {
+    BinaryStatFunction fct(kind, DoubleType(), pair_type);
+    ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<AggregateAccumulator> accumulator,
+                         Accumulate(fct, pairs, &context));
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        const Value expected,
+        accumulator->GetFinalResult(/*inputs_in_defined_order=*/false));
+    for (const int split : {1, 37, 50, 99}) {
+      ZETASQL_ASSERT_OK_AND_ASSIGN(const Value merged,
+                           EvalAggWithMerge(fct, pairs, split, &context));
+      EXPECT_NEAR(merged.double_value(), expected.double_value(),
+                  1e-9 * std::abs(expected.double_value()))
+          << fct.debug_name() << ", split at " << split;
+    }
+  }
+}
+
+TEST(EvalAggTest, PercentileContWithSketch) {
+  std::vector<Value> values;
+  for (int i = 0; i < 100000; ++i) {
+    values.push_back(i % 100 == 0 ? NullDouble() : Double((i * 7919) % 100000));
+  }
+  BuiltinAggregateFunction fct(FunctionKind::kPercentileCont, DoubleType(),
+                               /*num_input_fields=*/1, DoubleType(),
+                               /*ignores_null=*/true);
+  EvaluationContext exact_context((EvaluationOptions()));
+  EvaluationOptions options;
+  options.percentile_sketch_size = 200;
+  EvaluationContext approximate_context(options);
+  for (const double percentile : {0.0, 0.1, 0.5, 0.99, 1.0}) {
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        const Value exact,
+        EvalAgg(fct, values, &exact_context, {Double(percentile)}));
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        const Value approximate,
+        EvalAgg(fct, values, &approximate_context, {Double(percentile)}));
+    // The values are spread evenly over [0, 100000), so a rank error of 2%
+    // is an error of 2000 in the result.
+    EXPECT_NEAR(approximate.double_value(), exact.double_value(), 2000)
+        << percentile;
+    if (percentile == 0.0 || percentile == 1.0) {
+      EXPECT_EQ(approximate, exact);
+    }
+    // The sketches of parts of the input can be merged, including into an
+    // empty one.
+    for (const int split : {0, 1, 50000}) {
+      ZETASQL_ASSERT_OK_AND_ASSIGN(const Value merged,
+                           EvalAggWithMerge(fct, values, split,
+                                            &approximate_context,
+                                            {Double(percentile)}));
+      EXPECT_NEAR(merged.double_value(), exact.double_value(), 2000)
+          << percentile << ", split at " << split;
+      if (percentile == 0.0 || percentile == 1.0) {
+        EXPECT_EQ(merged, exact) << "split at " << split;
+      }
+    }
+  }
+  // Without a sketch, the whole population would have to be serialized.
+  EXPECT_THAT(
+      EvalAggWithMerge(fct, values, 50000, &exact_context, {Double(0.5)}),
+      StatusIs(absl::StatusCode::kUnimplemented));
+}
+
+TEST(EvalAggTest, MergeStateOfOtherFunction) {
+  BuiltinAggregateFunction sum(FunctionKind::kSum, Int64Type(),
+                               /*num_input_fields=*/1, Int64Type());
+  BuiltinAggregateFunction max(FunctionKind::kMax, Int64Type(),
+                               /*num_input_fields=*/1, Int64Type());
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<AggregateAccumulator> accumulator,
+                       Accumulate(sum, {Int64(1)}, &context));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<AggregateAccumulator> other,
+                       Accumulate(max, {Int64(2)}, &context));
+  EXPECT_THAT(accumulator->Merge(*other),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+  EXPECT_THAT(accumulator->MergeSerializedState("garbage"),
+              StatusIs(absl::StatusCode::kInvalidArgument));
+}
+
 TEST(EvalAggTest, AnyDeterministic) {
   BuiltinAggregateFunction fct(FunctionKind::kAnyValue, Int64Type(),
                                /*num_input_fields=*/1, Int64Type());
@@ -521,6 +678,162 @@ TEST(EvalAggTest, SumNumericOverflow) {
   EXPECT_TRUE(context.IsDeterministicOutput());
 }
 
+// Windows over a partition of 'num_rows' rows of the shapes produced by
+// ROWS and RANGE frames, plus windows that move backwards.
+static std::vector<AnalyticWindow> TestWindows(int num_rows) {
+  std::vector<AnalyticWindow> windows;
+  auto add_window = [&windows](int start, int end) {
+    windows.push_back(start < end ? AnalyticWindow(start, end - start)
+                                  : AnalyticWindow());
+  };
+  for (int i = 0; i < num_rows; ++i) {
+    // ROWS BETWEEN 2 PRECEDING AND CURRENT ROW
+    add_window(std::max(0, i - 2), i + 1);
+  }
+  for (int i = 0; i < num_rows; ++i) {
+    // ROWS BETWEEN UNBOUNDED PRECEDING AND 1 PRECEDING
+    add_window(0, i);
+  }
+  for (int i = 0; i < num_rows; ++i) {
+    // ROWS BETWEEN CURRENT ROW AND UNBOUNDED FOLLOWING
+    add_window(i, num_rows);
+  }
+  for (int i = num_rows; i > 0; --i) {
+    add_window(i / 2, i);
+  }
+  return windows;
+}
+
+static void TestEvalAggOverWindows(
+    FunctionKind kind, const Type* output_type, const Type* input_type,
+    const std::vector<Value>& inputs,
+    ResolvedFunctionCallBase::ErrorMode error_mode =
+        ResolvedFunctionCallBase::DEFAULT_ERROR_MODE) {
+  const VariableId x("x");
+  std::vector<std::unique_ptr<ValueExpr>> args;
+  args.push_back(DerefExpr::Create(x, input_type).value());
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<AggregateArg> agg,
+      AggregateArg::Create(VariableId("agg"),
+                           std::make_unique<BuiltinAggregateFunction>(
+                               kind, output_type,
+                               /*num_input_fields=*/1, input_type),
+                           std::move(args), AggregateArg::kAll,
+                           /*having_expr=*/nullptr, AggregateArg::kHavingNone,
+                           /*order_by_keys=*/{}, /*limit=*/nullptr,
+                           /*group_rows_subquery=*/nullptr, error_mode));
+  ZETASQL_ASSERT_OK(agg->SetSchemasForEvaluation(TupleSchema({x}),
+                                         EmptyParamsSchemas()));
+  SCOPED_TRACE(agg->DebugString());
+
+  std::vector<std::vector<Value>> rows;
+  for (const Value& input : inputs) rows.push_back({input});
+  const std::vector<TupleData> tuples = CreateTestTupleDatas(rows);
+  std::vector<const TupleData*> partition;
+  for (const TupleData& tuple : tuples) partition.push_back(&tuple);
+  const std::vector<AnalyticWindow> windows = TestWindows(partition.size());
+
+  EvaluationContext context((EvaluationOptions()));
+  std::vector<Value> expected_values;
+  absl::Status expected_status;
+  for (const AnalyticWindow& window : windows) {
+    const absl::StatusOr<Value> value = agg->EvalAgg(
+        absl::MakeConstSpan(partition).subspan(window.start_tuple_id,
+                                               window.num_tuples),
+        EmptyParams(), &context);
+    if (!value.ok()) {
+      expected_status = value.status();
+      break;
+    }
+    expected_values.push_back(*value);
+  }
+
+  std::vector<Value> values;
+  const absl::Status status = agg->EvalAggOverWindows(
+      partition, windows, EmptyParams(), &context, &values);
+  if (!expected_status.ok()) {
+    EXPECT_EQ(status, expected_status);
+    return;
+  }
+  ZETASQL_ASSERT_OK(status);
+  ASSERT_EQ(values.size(), expected_values.size());
+  for (int i = 0; i < values.size(); ++i) {
+    EXPECT_EQ(values[i], expected_values[i])
+        << "window " << windows[i].start_tuple_id << ", "
+        << windows[i].num_tuples;
+  }
+  EXPECT_TRUE(context.IsDeterministicOutput());
+}
+
+TEST(EvalAggOverWindowsTest, MatchesEvalAggOnEachWindow) {
+  const std::vector<Value> int64_inputs = {
+      Int64(3), NullInt64(), Int64(-7), Int64(10), Int64(10), NullInt64(),
+      Int64(0), Int64(-1),   Int64(42), Int64(5),  Int64(-3)};
+  TestEvalAggOverWindows(FunctionKind::kCount, Int64Type(), Int64Type(),
+                         int64_inputs);
+  TestEvalAggOverWindows(FunctionKind::kSum, Int64Type(), Int64Type(),
+                         int64_inputs);
+  TestEvalAggOverWindows(FunctionKind::kMin, Int64Type(), Int64Type(),
+                         int64_inputs);
+  TestEvalAggOverWindows(FunctionKind::kMax, Int64Type(), Int64Type(),
+                         int64_inputs);
+  TestEvalAggOverWindows(FunctionKind::kBitXor, Int64Type(), Int64Type(),
+                         int64_inputs);
+  // AVG(INT64) is evaluated per window.
+  TestEvalAggOverWindows(FunctionKind::kAvg, DoubleType(), Int64Type(),
+                         int64_inputs);
+
+  TestEvalAggOverWindows(
+      FunctionKind::kSum, Uint64Type(), Uint64Type(),
+      {Uint64(1), Uint64(std::numeric_limits<uint64_t>::max() - 1),
+       NullUint64(), Uint64(7), Uint64(0)},
+      ResolvedFunctionCallBase::SAFE_ERROR_MODE);
+
+  // Some of the windows overflow, and produce NULL in SAFE mode.
+  const std::vector<Value> numeric_inputs = {
+      NumericFromDouble(1.5),           NullNumeric(),
+      NumericFromDouble(-0.25),         Numeric(NumericValue::MaxValue()),
+      Numeric(NumericValue::MinValue()), NumericFromDouble(3)};
+  TestEvalAggOverWindows(FunctionKind::kSum, NumericType(), NumericType(),
+                         numeric_inputs,
+                         ResolvedFunctionCallBase::SAFE_ERROR_MODE);
+  TestEvalAggOverWindows(FunctionKind::kAvg, NumericType(), NumericType(),
+                         numeric_inputs,
+                         ResolvedFunctionCallBase::SAFE_ERROR_MODE);
+
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  const std::vector<Value> double_inputs = {Double(1.5), NullDouble(),
+                                            Double(nan), Double(-2),
+                                            Double(0),   Double(7.25),
+                                            NullDouble()};
+  TestEvalAggOverWindows(FunctionKind::kMin, DoubleType(), DoubleType(),
+                         double_inputs);
+  TestEvalAggOverWindows(FunctionKind::kMax, DoubleType(), DoubleType(),
+                         double_inputs);
+
+  TestEvalAggOverWindows(
+      FunctionKind::kMax, StringType(), StringType(),
+      {String("b"), NullString(), String("a"), String("c"), String("")});
+
+  const std::vector<Value> bool_inputs = {True(), NullBool(), False(), True(),
+                                          True(), NullBool()};
+  TestEvalAggOverWindows(FunctionKind::kCountIf, Int64Type(), BoolType(),
+                         bool_inputs);
+  TestEvalAggOverWindows(FunctionKind::kLogicalAnd, BoolType(), BoolType(),
+                         bool_inputs);
+  TestEvalAggOverWindows(FunctionKind::kLogicalOr, BoolType(), BoolType(),
+                         bool_inputs);
+}
+
+TEST(EvalAggOverWindowsTest, Overflow) {
+  const std::vector<Value> inputs = {
+      Int64(std::numeric_limits<int64_t>::max()), Int64(1), Int64(-1),
+      Int64(std::numeric_limits<int64_t>::min()), Int64(-1)};
+  TestEvalAggOverWindows(FunctionKind::kSum, Int64Type(), Int64Type(), inputs);
+  TestEvalAggOverWindows(FunctionKind::kSum, Int64Type(), Int64Type(), inputs,
+                         ResolvedFunctionCallBase::SAFE_ERROR_MODE);
+}
+
 TEST(OrderPreservationTest, GroupByAggregate) {
   TypeFactory type_factory;
   VariableId a("a"), b("b"), c1("c1"), c2("c2"), k("k"), n("n"), d("d");
@@ -19,6 +19,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <limits>
 #include <memory>
@@ -27,6 +28,7 @@
 #include <vector>
 
 #include "zetasql/base/logging.h"
+#include "zetasql/base/thread_pool.h"
 #include "zetasql/public/numeric_value.h"
 #include "zetasql/public/options.pb.h"
 #include "zetasql/public/type.h"
@@ -1913,15 +1915,10 @@ absl::Status AggregateAnalyticArg::Eval(
       *partition_schema_, partition, order_keys, params, context, &windows,
       &window_frame_is_deterministic));
 
-  for (const AnalyticWindow& window : windows) {
-    // Call AggregateArg::EvalAgg to evaluate the argument expressions and
-    // compute the aggregate on each window.
-    const absl::Span<const TupleData* const> window_tuples =
-        partition.subspan(window.start_tuple_id, window.num_tuples);
-    ZETASQL_ASSIGN_OR_RETURN(const Value agg_value,
-                     aggregator_->EvalAgg(window_tuples, params, context));
-    values->emplace_back(agg_value);
-  }
+  // Evaluate the argument expressions and compute the aggregate on each
+  // window.
+  ZETASQL_RETURN_IF_ERROR(aggregator_->EvalAggOverWindows(partition, windows, params,
+                                                  context, values));
 
   // We conservatively treat aggregation results as non-deterministic
   // if the windows are not deterministic.
@@ -2127,10 +2124,23 @@ absl::Status AnalyticOp::SetSchemasForEvaluation(
 }
 
 namespace {
+// Returns the number of partitions AnalyticOp may evaluate concurrently with
+// 'context'. C++ values and proto field value maps stored in TupleSlots are
+// not safe to share across threads, so evaluation is sequential if either is
+// in use.
+int GetMaxPartitionParallelism(const EvaluationContext& context) {
+  if (context.has_cpp_values() ||
+      context.options().store_proto_field_value_maps) {
+    return 1;
+  }
+  return std::max(context.options().max_analytic_partition_parallelism, 1);
+}
+
 // Partitions the tuples from 'input_iter' (which must have
 // 'analytic_args.size()' extra slots by 'partition_keys'. Evaluates all of the
 // 'analytic_args' on each partition and adds corresponding values to the
-// tuples.
+// tuples. If 'max_parallelism' is greater than one, loads up to that many
+// partitions at a time and evaluates them concurrently.
 class AnalyticTupleIterator : public TupleIterator {
  public:
   AnalyticTupleIterator(absl::Span<const TupleData* const> params,
@@ -2140,7 +2150,7 @@ class AnalyticTupleIterator : public TupleIterator {
                         std::unique_ptr<TupleIterator> input_iter,
                         std::unique_ptr<TupleComparator> partition_comparator,
                         std::unique_ptr<TupleSchema> output_schema,
-                        EvaluationContext* context)
+                        int max_parallelism, EvaluationContext* context)
       : params_(params.begin(), params.end()),
         partition_keys_(partition_keys.begin(), partition_keys.end()),
         order_keys_(order_keys.begin(), order_keys.end()),
@@ -2148,7 +2158,9 @@ class AnalyticTupleIterator : public TupleIterator {
         input_iter_(std::move(input_iter)),
         partition_comparator_(std::move(partition_comparator)),
         output_schema_(std::move(output_schema)),
-        remaining_current_partition_(context->memory_accountant()),
+        max_parallelism_(max_parallelism),
+        remaining_current_partition_(
+            std::make_unique<TupleDataDeque>(context->memory_accountant())),
         context_(context) {}
 
   AnalyticTupleIterator(const AnalyticTupleIterator&) = delete;
@@ -2169,10 +2181,17 @@ class AnalyticTupleIterator : public TupleIterator {
     }
     ++num_next_calls_;
 
-    if (!remaining_current_partition_.IsEmpty()) {
+    if (remaining_current_partition_->IsEmpty() &&
+        !evaluated_partitions_.empty()) {
+      // Move on to the next partition evaluated by the last parallel load.
+      remaining_current_partition_ = std::move(evaluated_partitions_.front());
+      evaluated_partitions_.pop_front();
+    }
+
+    if (!remaining_current_partition_->IsEmpty()) {
       // We have loaded a partition and are consuming it.
       output_empty_ = false;
-      current_ = remaining_current_partition_.PopFront();
+      current_ = remaining_current_partition_->PopFront();
       return current_.get();
     }
 
@@ -2189,8 +2208,6 @@ class AnalyticTupleIterator : public TupleIterator {
       return nullptr;
     }
 
-    // Load a new partition.
-    std::unique_ptr<TupleData> first_tuple_in_current_partition;
     if (first_tuple_in_next_partition_ == nullptr) {
       // We are loading the first tuple of the first partition.
       const TupleData* input_data = input_iter_->Next();
@@ -2198,28 +2215,51 @@ class AnalyticTupleIterator : public TupleIterator {
         status_ = input_iter_->Status();
         return nullptr;
       }
-      first_tuple_in_current_partition =
-          std::make_unique<TupleData>(*input_data);
-    } else {
-      first_tuple_in_current_partition =
-          std::move(first_tuple_in_next_partition_);
+      first_tuple_in_next_partition_ = std::make_unique<TupleData>(*input_data);
     }
+
+    absl::Status status = max_parallelism_ > 1
+                              ? LoadAndEvaluatePartitionsInParallel()
+                              : LoadAndEvaluatePartition();
+    if (!status.ok()) {
+      status_ = status;
+      return nullptr;
+    }
+
+    output_empty_ = false;
+    current_ = remaining_current_partition_->PopFront();
+    return current_.get();
+  }
+
+  absl::Status Status() const override { return status_; }
+
+  std::string DebugString() const override {
+    return AnalyticOp::GetIteratorDebugString(input_iter_->DebugString());
+  }
+
+ private:
+  // Loads the partition starting with 'first_tuple_in_next_partition_' (which
+  // must be non-NULL) into 'partition'. Sets 'first_tuple_in_next_partition_'
+  // to the first tuple of the following partition, or sets
+  // 'is_last_partition_' if there is none.
+  absl::Status LoadPartition(TupleDataDeque* partition) {
+    std::unique_ptr<TupleData> first_tuple_in_current_partition =
+        std::move(first_tuple_in_next_partition_);
     TupleData* first_tuple_in_current_partition_ptr =
         first_tuple_in_current_partition.get();
-    if (!remaining_current_partition_.PushBack(
-            std::move(first_tuple_in_current_partition), &status_)) {
-      return nullptr;
+    absl::Status status;
+    if (!partition->PushBack(std::move(first_tuple_in_current_partition),
+                             &status)) {
+      return status;
     }
 
-    // We have determined the first tuple of the next partition. Now load the
-    // rest.
+    // We have determined the first tuple of the partition. Now load the rest.
     while (true) {
       const TupleData* input_data = input_iter_->Next();
       if (input_data == nullptr) {
-        status_ = input_iter_->Status();
-        if (!status_.ok()) return nullptr;
+        ZETASQL_RETURN_IF_ERROR(input_iter_->Status());
         is_last_partition_ = true;
-        break;
+        return absl::OkStatus();
       }
 
       const bool comparator_equals =
@@ -2228,54 +2268,121 @@ class AnalyticTupleIterator : public TupleIterator {
           !(*partition_comparator_)(*input_data,
                                     *first_tuple_in_current_partition_ptr);
       if (!comparator_equals) {
-        // We are done loading the current partition. 'input_data' belongs in
-        // the next partition.
+        // We are done loading the partition. 'input_data' belongs in the next
+        // partition.
         first_tuple_in_next_partition_ =
             std::make_unique<TupleData>(*input_data);
-        break;
+        return absl::OkStatus();
       }
-      // 'input_data' belongs in the current partition (which we are still
-      // loading).
-      if (!remaining_current_partition_.PushBack(
-              std::make_unique<TupleData>(*input_data), &status_)) {
-        return nullptr;
+      // 'input_data' belongs in the partition (which we are still loading).
+      if (!partition->PushBack(std::make_unique<TupleData>(*input_data),
+                               &status)) {
+        return status;
       }
     }
+  }
 
-    absl::Status status = PopulateAnalyticArgSlots();
+  // Loads the next partition into 'remaining_current_partition_' and
+  // evaluates the analytic arguments over it.
+  absl::Status LoadAndEvaluatePartition() {
+    ZETASQL_RETURN_IF_ERROR(LoadPartition(remaining_current_partition_.get()));
+    return PopulateAnalyticArgSlots(remaining_current_partition_.get(),
+                                    context_);
+  }
+
+  // Loads up to 'max_parallelism_' partitions and evaluates the analytic
+  // arguments over them concurrently on this thread and the default thread
+  // pool: the first partition with 'context_' and each of the others with its
+  // own worker context. The first partition goes to
+  // 'remaining_current_partition_' and the others to 'evaluated_partitions_',
+  // in order.
+  absl::Status LoadAndEvaluatePartitionsInParallel() {
+    ZETASQL_RETURN_IF_ERROR(LoadPartition(remaining_current_partition_.get()));
+    while (!is_last_partition_ &&
+           evaluated_partitions_.size() + 1 < max_parallelism_) {
+      evaluated_partitions_.push_back(
+          std::make_unique<TupleDataDeque>(context_->memory_accountant()));
+      ZETASQL_RETURN_IF_ERROR(LoadPartition(evaluated_partitions_.back().get()));
+    }
+    if (evaluated_partitions_.empty()) {
+      return PopulateAnalyticArgSlots(remaining_current_partition_.get(),
+                                      context_);
+    }
+
+    // MemoryAccountant is not thread-safe, so each worker context accounts for
+    // its partition and gets an equal share of the bytes that are still
+    // available. Those bytes are reserved in 'context_' until the workers are
+    // done, so that the batch stays within the budget of 'context_'.
+    MemoryAccountant* accountant = context_->memory_accountant();
+    const int64_t share =
+        accountant->remaining_bytes() / (evaluated_partitions_.size() + 1);
+    std::vector<int64_t> reserved_bytes;
+    reserved_bytes.reserve(evaluated_partitions_.size());
+    absl::Status status;
+    for (const std::unique_ptr<TupleDataDeque>& partition :
+         evaluated_partitions_) {
+      const int64_t worker_bytes = partition->GetByteSize() + share;
+      worker_contexts_.push_back(context_->CreateWorkerContext(worker_bytes));
+      ZETASQL_RET_CHECK(partition->SetMemoryAccountant(
+          worker_contexts_.back()->memory_accountant(), &status))
+          << status;
+      ZETASQL_RET_CHECK(accountant->RequestBytes(worker_bytes, &status))
+          << status;
+      reserved_bytes.push_back(worker_bytes);
+    }
+
+    std::vector<absl::Status> statuses(evaluated_partitions_.size() + 1);
+    zetasql_base::ThreadPool::DefaultPool()->ParallelFor(
+        statuses.size(), [this, &statuses](int i) {
+          statuses[i] =
+              i == 0 ? PopulateAnalyticArgSlots(
+                           remaining_current_partition_.get(), context_)
+                     : PopulateAnalyticArgSlots(
+                           evaluated_partitions_[i - 1].get(),
+                           worker_contexts_[i - 1].get());
+        });
+    for (const std::unique_ptr<EvaluationContext>& worker : worker_contexts_) {
+      context_->MergeWorkerContext(*worker);
+    }
+
+    // Report the error that sequential evaluation would have encountered
+    // first.
+    for (const absl::Status& partition_status : statuses) {
+      status.Update(partition_status);
+    }
+    // Move the partitions back to 'context_' so that the worker contexts can be
+    // released, and the next batch gets shares of the bytes available then.
+    // The partitions fit in the bytes reserved for them.
+    for (int i = 0; i < evaluated_partitions_.size(); ++i) {
+      accountant->ReturnBytes(reserved_bytes[i]);
+      if (status.ok()) {
+        evaluated_partitions_[i]->SetMemoryAccountant(accountant, &status);
+      }
+    }
     if (!status.ok()) {
-      status_ = status;
-      return nullptr;
+      evaluated_partitions_.clear();
     }
-
-    output_empty_ = false;
-    current_ = remaining_current_partition_.PopFront();
-    return current_.get();
-  }
-
-  absl::Status Status() const override { return status_; }
-
-  std::string DebugString() const override {
-    return AnalyticOp::GetIteratorDebugString(input_iter_->DebugString());
+    worker_contexts_.clear();
+    return status;
   }
 
- private:
   // For each AnalyticArg in 'analytic_args', populates the corresponding slot
-  // in all the rows in 'current_partition_'.
-  absl::Status PopulateAnalyticArgSlots() {
+  // in all the rows in 'partition'. Only uses 'context', so that partitions
+  // can be evaluated concurrently with different contexts.
+  absl::Status PopulateAnalyticArgSlots(TupleDataDeque* partition,
+                                        EvaluationContext* context) const {
     for (int arg_idx = 0; arg_idx < analytic_args_.size(); ++arg_idx) {
       const AnalyticArg* analytic_arg = analytic_args_[arg_idx];
 
-      std::vector<const TupleData*> current_partition_ptrs =
-          remaining_current_partition_.GetTuplePtrs();
+      std::vector<const TupleData*> partition_ptrs =
+          partition->GetTuplePtrs();
 
       std::vector<Value> values;
-      ZETASQL_RETURN_IF_ERROR(analytic_arg->Eval(current_partition_ptrs, order_keys_,
-                                         params_, context_, &values));
+      ZETASQL_RETURN_IF_ERROR(analytic_arg->Eval(partition_ptrs, order_keys_, params_,
+                                         context, &values));
 
       const int slot_idx = input_iter_->Schema().num_variables() + arg_idx;
-      ZETASQL_RETURN_IF_ERROR(
-          remaining_current_partition_.SetSlot(slot_idx, std::move(values)));
+      ZETASQL_RETURN_IF_ERROR(partition->SetSlot(slot_idx, std::move(values)));
     }
     return absl::OkStatus();
   }
@@ -2287,12 +2394,23 @@ class AnalyticTupleIterator : public TupleIterator {
   std::unique_ptr<TupleIterator> input_iter_;
   std::unique_ptr<TupleComparator> partition_comparator_;
   std::unique_ptr<TupleSchema> output_schema_;
+  const int max_parallelism_;
   // The last tuple returned. NULL if Next() has never been called.
   std::unique_ptr<TupleData> current_;
   // The partition we are currently consuming, augmented by the values
   // of the analytic arguments. Empty if Next() has never been called.
-  TupleDataDeque remaining_current_partition_;
-  // True if 'current_partition_' is the last one.
+  std::unique_ptr<TupleDataDeque> remaining_current_partition_;
+  // Contexts for evaluating 'evaluated_partitions_' concurrently with
+  // 'context_', one per partition. Only non-empty during a parallel
+  // evaluation, while the partitions are accounted by their memory
+  // accountants, so it is declared before 'evaluated_partitions_' to outlive
+  // them.
+  std::vector<std::unique_ptr<EvaluationContext>> worker_contexts_;
+  // The partitions following 'remaining_current_partition_' that have already
+  // been loaded and evaluated, in order. Only used if 'max_parallelism_' is
+  // greater than one.
+  std::deque<std::unique_ptr<TupleDataDeque>> evaluated_partitions_;
+  // True if the last partition has been loaded.
   bool is_last_partition_ = false;
   bool output_empty_ = true;
   // NULL if we haven't loaded any partitions yet or 'is_last_partition_' is
@@ -2330,7 +2448,8 @@ absl::StatusOr<std::unique_ptr<TupleIterator>> AnalyticOp::CreateIterator(
 
   iter = std::make_unique<AnalyticTupleIterator>(
       params, partition_keys(), order_keys(), analytic_args(), std::move(iter),
-      std::move(partition_comparator), CreateOutputSchema(), context);
+      std::move(partition_comparator), CreateOutputSchema(),
+      GetMaxPartitionParallelism(*context), context);
   if (is_order_preserving()) {
     return iter;
   } else {
@@ -3497,6 +3497,24 @@ TEST_P(AnalyticOpTest, AnalyticOpTest) {
     EXPECT_EQ(data[i].num_slots(), expected_output_schema.num_variables() + 1);
   }
 
+  // Evaluating the partitions in parallel gives the same output.
+  for (int parallelism : {2, 3}) {
+    EvaluationOptions parallel_options;
+    parallel_options.max_analytic_partition_parallelism = parallelism;
+    EvaluationContext parallel_context(parallel_options);
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        iter, analytic_op->CreateIterator(EmptyParams(),
+                                          /*num_extra_slots=*/1,
+                                          &parallel_context));
+    ZETASQL_ASSERT_OK_AND_ASSIGN(data, ReadFromTupleIterator(iter.get()));
+    ASSERT_EQ(data.size(), expected_tuples.size());
+    for (int i = 0; i < expected_tuples.size(); ++i) {
+      EXPECT_EQ(
+          Tuple(&expected_output_schema, &data[i]).DebugString(),
+          Tuple(&expected_output_schema, &expected_tuples[i]).DebugString());
+    }
+  }
+
   // Do it again with cancellation.
   context.ClearDeadlineAndCancellationState();
   ZETASQL_ASSERT_OK_AND_ASSIGN(
@@ -3537,5 +3555,109 @@ TEST_P(AnalyticOpTest, AnalyticOpTest) {
                        HasSubstr("Out of memory")));
 }
 
+// Evaluates SUM(b) OVER (PARTITION BY a ORDER BY b ROWS BETWEEN UNBOUNDED
+// PRECEDING AND CURRENT ROW) over partitions of different sizes, loading
+// several batches of partitions when evaluating in parallel.
+TEST(AnalyticOpParallelTest, MatchesSequentialEvaluation) {
+  VariableId a("a"), b("b"), sum("sum");
+  std::vector<std::vector<Value>> rows;
+  std::vector<Value> expected_sums;
+  for (int partition = 0; partition < 11; ++partition) {
+    int64_t running_sum = 0;
+    for (int row = 0; row < 1 + (partition * 7) % 5; ++row) {
+      running_sum += row;
+      rows.push_back({Int64(partition), Int64(row)});
+      expected_sums.push_back(Int64(running_sum));
+    }
+  }
+  const std::vector<TupleData> input_tuples = CreateTestTupleDatas(rows);
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_b, DerefExpr::Create(b, Int64Type()));
+  std::vector<std::unique_ptr<ValueExpr>> agg_args;
+  agg_args.push_back(std::move(deref_b));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto agg, AggregateArg::Create(sum,
+                                     std::make_unique<BuiltinAggregateFunction>(
+                                         FunctionKind::kSum, Int64Type(),
+                                         /*num_input_fields=*/1, Int64Type()),
+                                     std::move(agg_args)));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto analytic_arg,
+      AggregateAnalyticArg::Create(
+          AnalyticWindowTest::CreateWindowFrameFromParam(
+              AnalyticWindowTest::CreateUnboundedPrecedingCurrentRow(
+                  WindowFrameArg::kRows)),
+          std::move(agg), DEFAULT_ERROR_MODE));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_a, DerefExpr::Create(a, Int64Type()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(auto deref_order_b,
+                       DerefExpr::Create(b, Int64Type()));
+  std::vector<std::unique_ptr<KeyArg>> partition_keys;
+  partition_keys.push_back(
+      std::make_unique<KeyArg>(a, std::move(deref_a), KeyArg::kNotApplicable));
+  std::vector<std::unique_ptr<KeyArg>> order_keys;
+  order_keys.push_back(std::make_unique<KeyArg>(b, std::move(deref_order_b),
+                                                KeyArg::kAscending));
+  std::vector<std::unique_ptr<AnalyticArg>> analytic_args;
+  analytic_args.push_back(std::move(analytic_arg));
+
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      auto analytic_op,
+      AnalyticOp::Create(std::move(partition_keys), std::move(order_keys),
+                         std::move(analytic_args),
+                         std::make_unique<TestRelationalOp>(
+                             std::vector<VariableId>{a, b}, input_tuples,
+                             /*preserves_order=*/true),
+                         /*preserves_order=*/true));
+  ZETASQL_ASSERT_OK(analytic_op->SetSchemasForEvaluation(EmptyParamsSchemas()));
+
+  // The bytes remaining in the memory accountant of the context once the
+  // output has been read, with sequential evaluation.
+  int64_t sequential_remaining_bytes = -1;
+  for (int parallelism : {1, 2, 4, 16}) {
+    SCOPED_TRACE(parallelism);
+    EvaluationOptions options;
+    options.max_analytic_partition_parallelism = parallelism;
+    EvaluationContext context(options);
+    ZETASQL_ASSERT_OK_AND_ASSIGN(
+        std::unique_ptr<TupleIterator> iter,
+        analytic_op->CreateIterator(EmptyParams(), /*num_extra_slots=*/0,
+                                    &context));
+    ZETASQL_ASSERT_OK_AND_ASSIGN(std::vector<TupleData> data,
+                         ReadFromTupleIterator(iter.get()));
+    ASSERT_EQ(data.size(), input_tuples.size());
+    for (int i = 0; i < data.size(); ++i) {
+      EXPECT_EQ(data[i].slot(0).value(), input_tuples[i].slot(0).value());
+      EXPECT_EQ(data[i].slot(1).value(), input_tuples[i].slot(1).value());
+      EXPECT_EQ(data[i].slot(2).value(), expected_sums[i]);
+    }
+    EXPECT_TRUE(context.IsDeterministicOutput());
+    // The bytes reserved for the worker contexts have been returned.
+    if (parallelism == 1) {
+      sequential_remaining_bytes =
+          context.memory_accountant()->remaining_bytes();
+    } else {
+      EXPECT_EQ(context.memory_accountant()->remaining_bytes(),
+                sequential_remaining_bytes);
+    }
+  }
+}
+
+// Worker contexts see a cancellation of the context they were created from,
+// even if it happens after they were created.
+TEST(AnalyticOpParallelTest, WorkerContextObservesCancellation) {
+  EvaluationContext context((EvaluationOptions()));
+  std::unique_ptr<EvaluationContext> worker =
+      context.CreateWorkerContext(/*max_intermediate_byte_size=*/1000);
+  ZETASQL_EXPECT_OK(worker->VerifyNotAborted());
+
+  ZETASQL_ASSERT_OK(context.CancelStatement());
+  EXPECT_THAT(worker->VerifyNotAborted(),
+              StatusIs(absl::StatusCode::kCancelled, _));
+
+  context.ClearDeadlineAndCancellationState();
+  ZETASQL_EXPECT_OK(worker->VerifyNotAborted());
+}
+
 }  // namespace
 }  // namespace zetasql
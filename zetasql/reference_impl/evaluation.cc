@@ -17,6 +17,7 @@
 #include "zetasql/reference_impl/evaluation.h"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -106,8 +107,46 @@ absl::Status EvaluationContext::AddTableAsArray(
   return absl::OkStatus();
 }
 
+std::unique_ptr<EvaluationContext> EvaluationContext::CreateWorkerContext(
+    int64_t max_intermediate_byte_size) {
+  ZETASQL_DCHECK_GE(max_intermediate_byte_size, 0);
+  ZETASQL_DCHECK(!has_cpp_values());
+  // Initialize the lazily computed state here so that all of the contexts
+  // agree on it.
+  LazilyInitializeCurrentTimestamp();
+
+  EvaluationOptions worker_options = options_;
+  worker_options.max_intermediate_byte_size = max_intermediate_byte_size;
+  auto worker = std::make_unique<EvaluationContext>(worker_options);
+  worker->tables_ = tables_;
+  worker->active_group_rows_ = active_group_rows_;
+  worker->language_options_ = language_options_;
+  worker->statement_eval_deadline_ = statement_eval_deadline_;
+  worker->parent_cancelled_ =
+      parent_cancelled_ != nullptr ? parent_cancelled_ : &cancelled_;
+  worker->clock_ = clock_;
+  worker->default_timezone_ = default_timezone_;
+  worker->current_timestamp_ = current_timestamp_;
+  worker->current_date_in_default_timezone_ = current_date_in_default_timezone_;
+  worker->current_datetime_in_default_timezone_ =
+      current_datetime_in_default_timezone_;
+  worker->current_time_in_default_timezone_ =
+      current_time_in_default_timezone_;
+  return worker;
+}
+
+void EvaluationContext::MergeWorkerContext(const EvaluationContext& worker) {
+  if (!worker.deterministic_output_) {
+    deterministic_output_ = false;
+  }
+  num_proto_deserializations_ += worker.num_proto_deserializations_;
+  used_top_n_accumulator_ |= worker.used_top_n_accumulator_;
+}
+
 absl::Status EvaluationContext::VerifyNotAborted() const {
-  if (cancelled_) {
+  if (cancelled_.load(std::memory_order_relaxed) ||
+      (parent_cancelled_ != nullptr &&
+       parent_cancelled_->load(std::memory_order_relaxed))) {
     return zetasql_base::CancelledErrorBuilder() << "The statement has been cancelled";
   }
   if (clock_->TimeNow() > statement_eval_deadline_) {
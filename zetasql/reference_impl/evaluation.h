@@ -17,9 +17,11 @@
 #ifndef ZETASQL_REFERENCE_IMPL_EVALUATION_H_
 #define ZETASQL_REFERENCE_IMPL_EVALUATION_H_
 
+#include <atomic>
 #include <cstdint>
 #include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -103,6 +105,24 @@ struct EvaluationOptions {
   // Note that rows are considered modified even if the new row happens to be
   // the same as the old as long as they match the WHERE clause.
   bool return_all_rows_for_dml = true;
+
+  // If greater than one, AnalyticOp loads up to this many partitions at a time
+  // and evaluates the analytic functions over them concurrently, on the calling
+  // thread and the threads of zetasql_base::ThreadPool::DefaultPool(). All
+  // partitions but the first are evaluated with worker contexts (see
+  // EvaluationContext::CreateWorkerContext()). The output is the same as with
+  // sequential evaluation, except for non-deterministic functions such as
+  // RAND(): each worker context has its own random number generator, so their
+  // values are drawn in a different order. Such output is still reported by
+  // EvaluationContext::IsDeterministicOutput().
+  int max_analytic_partition_parallelism = 1;
+
+  // If positive, PERCENTILE_CONT aggregates over DOUBLE keep a
+  // PercentileSketch of this size (see functions/percentile_sketch.h) instead
+  // of all the input values, which bounds their memory per group but makes
+  // their results approximate. Not safe to use in compliance or random query
+  // tests.
+  int percentile_sketch_size = 0;
 };
 
 class ProtoFieldReader;
@@ -260,7 +280,7 @@ class EvaluationContext {
   // callbacks are just a way of notifying user code that the statement has been
   // cancelled if we are stuck in a user's EvaluatorTableIterator.
   absl::Status CancelStatement() {
-    cancelled_ = true;
+    cancelled_.store(true, std::memory_order_relaxed);
     // Call all the callbacks, returning the first non-OK error code.
     absl::Status ret = absl::OkStatus();
     for (const CancelCallback& cb : cancel_cbs_) {
@@ -276,7 +296,7 @@ class EvaluationContext {
   // cancellation callbacks.
   void ClearDeadlineAndCancellationState() {
     SetStatementEvaluationDeadline(absl::InfiniteFuture());
-    cancelled_ = false;
+    cancelled_.store(false, std::memory_order_relaxed);
     cancel_cbs_.clear();
   }
 
@@ -344,6 +364,27 @@ class EvaluationContext {
   // Deletes the C++ value associated with the given variable Id.
   void ClearCppValue(VariableId variable) { cpp_values_.erase(variable); }
 
+  // Returns true if any C++ values are associated with variables.
+  bool has_cpp_values() const { return !cpp_values_.empty(); }
+
+  // Returns a context that can be used to evaluate on another thread while
+  // this one is in use. It shares the tables, language options, clock,
+  // deadline, cancellation state and (initialized) default time zone and
+  // current timestamp of this context, which must outlive it. It has its own memory accountant, limited to
+  // 'max_intermediate_byte_size' bytes. Callers keep the total within the
+  // budget of this context by reserving those bytes from memory_accountant()
+  // while the worker context is in use. Must not be called if
+  // has_cpp_values() is true, since those are not shared. Evaluation state
+  // observed by the worker context is folded back into this one by
+  // MergeWorkerContext().
+  std::unique_ptr<EvaluationContext> CreateWorkerContext(
+      int64_t max_intermediate_byte_size);
+
+  // Merges the evaluation state recorded by 'worker' (e.g., whether the output
+  // is non-deterministic) into this context. 'worker' must have been returned
+  // by CreateWorkerContext() and must not be in use on another thread.
+  void MergeWorkerContext(const EvaluationContext& worker);
+
   const TupleDataDeque* active_group_rows() const { return active_group_rows_; }
   void set_active_group_rows(const TupleDataDeque* group_rows) {
     active_group_rows_ = group_rows;
@@ -377,7 +418,12 @@ class EvaluationContext {
   LanguageOptions language_options_;
   // Default is no deadline.
   absl::Time statement_eval_deadline_ = absl::InfiniteFuture();
-  bool cancelled_ = false;
+  // Atomic because worker contexts (see CreateWorkerContext()) read it from
+  // other threads.
+  std::atomic<bool> cancelled_{false};
+  // For worker contexts, the 'cancelled_' of the context they were created
+  // from. Not owned.
+  const std::atomic<bool>* parent_cancelled_ = nullptr;
   std::vector<CancelCallback> cancel_cbs_;
 
   // Used to obtain the current timestamp.
@@ -70,6 +70,7 @@
 #include "zetasql/public/functions/numeric.h"
 #include "zetasql/public/functions/parse_date_time.h"
 #include "zetasql/public/functions/percentile.h"
+#include "zetasql/public/functions/percentile_sketch.h"
 #include "zetasql/public/functions/regexp.h"
 #include "zetasql/public/functions/string.h"
 #include "zetasql/public/json_value.h"
@@ -88,6 +89,7 @@
 #include "zetasql/reference_impl/tuple_comparator.h"
 #include "zetasql/reference_impl/type_parameter_constraints.h"
 #include <cstdint>
+#include "absl/base/attributes.h"
 #include "absl/base/optimization.h"
 #include "absl/flags/flag.h"
 #include "absl/memory/memory.h"
@@ -1333,12 +1335,65 @@ absl::StatusOr<JSONValueConstRef> GetJSONValueConstRef(
   if (json.is_validated_json()) {
     return json.json_value();
   }
-  ZETASQL_ASSIGN_OR_RETURN(json_storage,
-                   JSONValue::ParseJSONString(json.json_value_unparsed(),
-                                              json_parsing_options));
+  // The parsed document is only read, so use the compact representation.
+  JSONParsingOptions options = json_parsing_options;
+  options.compact_representation = true;
+  ZETASQL_ASSIGN_OR_RETURN(json_storage, JSONValue::ParseJSONString(
+                                     json.json_value_unparsed(), options));
   return json_storage.GetConstRef();
 }
 
+// Returns the format string of a FORMAT_ or PARSE_ date/time function if it is
+// a non-NULL constant, or null otherwise.
+const Value* GetConstantDateTimeFormat(
+    const std::vector<std::unique_ptr<AlgebraArg>>& arguments) {
+  if (arguments.empty() || !arguments[0]->value_expr()->IsConstant()) {
+    return nullptr;
+  }
+  const Value& format =
+      static_cast<const ConstExpr*>(arguments[0]->value_expr())->value();
+  if (format.is_null() || !format.type()->IsString()) return nullptr;
+  return &format;
+}
+
+// Precompiles the constant format string of a FORMAT_ date/time function for
+// the type of the formatted argument; null if the format is not constant.
+std::unique_ptr<const functions::DateTimeFormatter>
+CreateConstDateTimeFormatter(
+    const std::vector<std::unique_ptr<AlgebraArg>>& arguments) {
+  const Value* format = GetConstantDateTimeFormat(arguments);
+  if (format == nullptr || arguments.size() < 2) return nullptr;
+  const TypeKind target_type =
+      arguments[1]->value_expr()->output_type()->kind();
+  switch (target_type) {
+    case TYPE_DATE:
+    case TYPE_DATETIME:
+    case TYPE_TIME:
+    case TYPE_TIMESTAMP:
+      break;
+    default:
+      return nullptr;
+  }
+  return std::make_unique<const functions::DateTimeFormatter>(
+      format->string_value(), target_type,
+      functions::FormatDateTimestampOptions{.expand_Q = true,
+                                            .expand_J = true});
+}
+
+// Precompiles the constant format string of a PARSE_ date/time function
+// producing <target_type>; null if the format is not constant or is invalid.
+std::unique_ptr<const functions::DateTimeParser> CreateConstDateTimeParser(
+    TypeKind target_type,
+    const std::vector<std::unique_ptr<AlgebraArg>>& arguments) {
+  const Value* format = GetConstantDateTimeFormat(arguments);
+  if (format == nullptr) return nullptr;
+  // Like for regexps, errors are left to Eval() so that SAFE variants work.
+  auto parser =
+      functions::DateTimeParser::Create(format->string_value(), target_type);
+  if (!parser.ok()) return nullptr;
+  return std::move(parser).value();
+}
+
 }  // namespace
 
 ABSL_CONST_INIT absl::Mutex BuiltinFunctionRegistry::mu_(absl::kConstInit);
@@ -1856,9 +1911,11 @@ BuiltinScalarFunction::CreateValidatedRaw(
     case FunctionKind::kFormatDate:
     case FunctionKind::kFormatDatetime:
     case FunctionKind::kFormatTimestamp:
-      return new FormatDateDatetimeTimestampFunction(kind, output_type);
+      return new FormatDateDatetimeTimestampFunction(
+          CreateConstDateTimeFormatter(arguments), kind, output_type);
     case FunctionKind::kFormatTime:
-      return new FormatTimeFunction(kind, output_type);
+      return new FormatTimeFunction(CreateConstDateTimeFormatter(arguments),
+                                    kind, output_type);
     case FunctionKind::kTimestamp:
       return new TimestampConversionFunction(kind, output_type);
     case FunctionKind::kDate:
@@ -1889,13 +1946,19 @@ BuiltinScalarFunction::CreateValidatedRaw(
     case FunctionKind::kEnumValueDescriptorProto:
       return new EnumValueDescriptorProtoFunction(kind, output_type);
     case FunctionKind::kParseDate:
-      return new ParseDateFunction(kind, output_type);
+      return new ParseDateFunction(
+          CreateConstDateTimeParser(TYPE_DATE, arguments), kind, output_type);
     case FunctionKind::kParseDatetime:
-      return new ParseDatetimeFunction(kind, output_type);
+      return new ParseDatetimeFunction(
+          CreateConstDateTimeParser(TYPE_DATETIME, arguments), kind,
+          output_type);
     case FunctionKind::kParseTime:
-      return new ParseTimeFunction(kind, output_type);
+      return new ParseTimeFunction(
+          CreateConstDateTimeParser(TYPE_TIME, arguments), kind, output_type);
     case FunctionKind::kParseTimestamp:
-      return new ParseTimestampFunction(kind, output_type);
+      return new ParseTimestampFunction(
+          CreateConstDateTimeParser(TYPE_TIMESTAMP, arguments), kind,
+          output_type);
     case FunctionKind::kIntervalCtor:
     case FunctionKind::kMakeInterval:
     case FunctionKind::kJustifyHours:
@@ -3515,6 +3578,226 @@ namespace {
 // does an OR of all input values including NULLs and returns false for empty
 // input.
 
+// Appends the fields of the state of an accumulator for SerializeState().
+// Integers are stored in 8 bytes in little endian order, and strings are
+// preceded by their length.
+class AccumulatorStateWriter {
+ public:
+  explicit AccumulatorStateWriter(std::string* state) : state_(state) {}
+
+  void AppendInt64(int64_t value) {
+    const uint64_t bits = static_cast<uint64_t>(value);
+    for (int i = 0; i < 8; ++i) {
+      state_->push_back(static_cast<char>(bits >> (8 * i)));
+    }
+  }
+
+  void AppendDouble(double value) {
+    AppendInt64(absl::bit_cast<int64_t>(value));
+  }
+
+  void AppendUint128(unsigned __int128 value) {
+    AppendInt64(static_cast<int64_t>(static_cast<uint64_t>(value)));
+    AppendInt64(static_cast<int64_t>(static_cast<uint64_t>(value >> 64)));
+  }
+
+  void AppendString(absl::string_view value) {
+    AppendInt64(value.size());
+    absl::StrAppend(state_, value);
+  }
+
+  // An ExactFloat can have thousands of bits, so it is stored as a sum of
+  // doubles scaled by powers of two, which neither overflow nor underflow.
+  // Each term takes 53 bits of the remainder.
+  void AppendExactFloat(const zetasql_base::ExactFloat& value) {
+    std::vector<std::pair<int, double>> terms;
+    if (value.is_zero() || !value.is_finite()) {
+      // Keeps the sign of zeros, and infinities and NaNs.
+      terms.emplace_back(0, value.ToDouble());
+    } else {
+      zetasql_base::ExactFloat remainder = value;
+      while (!remainder.is_zero()) {
+        int exponent;
+        const double mantissa = frexp(remainder, &exponent).ToDouble();
+        terms.emplace_back(exponent, mantissa);
+        remainder =
+            remainder - ldexp(zetasql_base::ExactFloat(mantissa), exponent);
+      }
+    }
+    AppendInt64(terms.size());
+    for (const auto& [exponent, mantissa] : terms) {
+      AppendInt64(exponent);
+      AppendDouble(mantissa);
+    }
+  }
+
+  void AppendPercentileSketch(const PercentileSketch<double>& sketch) {
+    AppendInt64(sketch.k());
+    AppendInt64(sketch.num_nans());
+    AppendDouble(sketch.min());
+    AppendDouble(sketch.max());
+    AppendInt64(sketch.levels().size());
+    for (const std::vector<double>& level : sketch.levels()) {
+      AppendInt64(level.size());
+      for (const double value : level) {
+        AppendDouble(value);
+      }
+    }
+  }
+
+ private:
+  std::string* state_;
+};
+
+// Reads the fields written by AccumulatorStateWriter.
+class AccumulatorStateReader {
+ public:
+  explicit AccumulatorStateReader(absl::string_view state) : state_(state) {}
+
+  absl::Status ReadInt64(int64_t* value) {
+    if (state_.size() < 8) return InvalidStateError();
+    uint64_t bits = 0;
+    for (int i = 0; i < 8; ++i) {
+      bits |= static_cast<uint64_t>(static_cast<uint8_t>(state_[i])) << (8 * i);
+    }
+    state_.remove_prefix(8);
+    *value = static_cast<int64_t>(bits);
+    return absl::OkStatus();
+  }
+
+  absl::Status ReadDouble(double* value) {
+    int64_t bits;
+    ZETASQL_RETURN_IF_ERROR(ReadInt64(&bits));
+    *value = absl::bit_cast<double>(bits);
+    return absl::OkStatus();
+  }
+
+  absl::Status ReadUint128(unsigned __int128* value) {
+    int64_t low, high;
+    ZETASQL_RETURN_IF_ERROR(ReadInt64(&low));
+    ZETASQL_RETURN_IF_ERROR(ReadInt64(&high));
+    *value = static_cast<unsigned __int128>(static_cast<uint64_t>(high)) << 64 |
+             static_cast<uint64_t>(low);
+    return absl::OkStatus();
+  }
+
+  absl::Status ReadString(absl::string_view* value) {
+    int64_t size;
+    ZETASQL_RETURN_IF_ERROR(ReadInt64(&size));
+    if (size < 0 || size > state_.size()) return InvalidStateError();
+    *value = state_.substr(0, size);
+    state_.remove_prefix(size);
+    return absl::OkStatus();
+  }
+
+  absl::Status ReadExactFloat(zetasql_base::ExactFloat* value) {
+    int64_t num_terms;
+    ZETASQL_RETURN_IF_ERROR(ReadInt64(&num_terms));
+    if (num_terms <= 0) return InvalidStateError();
+    for (int64_t i = 0; i < num_terms; ++i) {
+      int64_t exponent;
+      double mantissa;
+      ZETASQL_RETURN_IF_ERROR(ReadInt64(&exponent));
+      ZETASQL_RETURN_IF_ERROR(ReadDouble(&mantissa));
+      const zetasql_base::ExactFloat term =
+          ldexp(zetasql_base::ExactFloat(mantissa), static_cast<int>(exponent));
+      *value = i == 0 ? term : *value + term;
+    }
+    return absl::OkStatus();
+  }
+
+  absl::Status ReadPercentileSketch(PercentileSketch<double>* sketch) {
+    int64_t k, num_nans, num_levels;
+    double min, max;
+    ZETASQL_RETURN_IF_ERROR(ReadInt64(&k));
+    ZETASQL_RETURN_IF_ERROR(ReadInt64(&num_nans));
+    ZETASQL_RETURN_IF_ERROR(ReadDouble(&min));
+    ZETASQL_RETURN_IF_ERROR(ReadDouble(&max));
+    ZETASQL_RETURN_IF_ERROR(ReadInt64(&num_levels));
+    // Sizes are checked against the remaining state before allocating.
+    if (num_levels < 0 || num_levels > state_.size() / 8) {
+      return InvalidStateError();
+    }
+    std::vector<std::vector<double>> levels(num_levels);
+    for (std::vector<double>& level : levels) {
+      int64_t size;
+      ZETASQL_RETURN_IF_ERROR(ReadInt64(&size));
+      if (size < 0 || size > state_.size() / 8) return InvalidStateError();
+      level.resize(size);
+      for (double& value : level) {
+        ZETASQL_RETURN_IF_ERROR(ReadDouble(&value));
+      }
+    }
+    if (k > std::numeric_limits<int>::max() ||
+        !PercentileSketch<double>::FromFields(static_cast<int>(k), num_nans,
+                                              min, max, std::move(levels),
+                                              sketch)) {
+      return InvalidStateError();
+    }
+    return absl::OkStatus();
+  }
+
+  // Reads a state serialized by NumericValue::SumAggregator or one of the
+  // other aggregators of numeric_value.h and interval_value.h.
+  template <typename Aggregator>
+  absl::Status ReadAggregator(Aggregator* aggregator) {
+    absl::string_view bytes;
+    ZETASQL_RETURN_IF_ERROR(ReadString(&bytes));
+    ZETASQL_ASSIGN_OR_RETURN(*aggregator, Aggregator::DeserializeFromProtoBytes(bytes));
+    return absl::OkStatus();
+  }
+
+  // Returns an error if some of the state was not read.
+  absl::Status Finish() const {
+    return state_.empty() ? absl::OkStatus() : InvalidStateError();
+  }
+
+ private:
+  static absl::Status InvalidStateError() {
+    return ::zetasql_base::InvalidArgumentErrorBuilder()
+           << "Invalid serialized aggregate state";
+  }
+
+  absl::string_view state_;
+};
+
+// Merges the mean and population variance of <other_count> values into the
+// <mean> and <variance> of the values merged into, using the pairwise update
+// of Chan et al. <count> is the total count after merging.
+absl::Status MergeMeanAndVariance(double other_mean, double other_variance,
+                                  double other_count, double count,
+                                  double* mean, double* variance) {
+  if (!std::isfinite(*variance)) {
+    // See UpdateMeanAndVariance().
+    return absl::OkStatus();
+  }
+  if (!std::isfinite(other_variance)) {
+    *variance = std::numeric_limits<double>::quiet_NaN();
+    return absl::OkStatus();
+  }
+
+  // frac = other_count / count
+  // delta = other_mean - mean
+  // mean += delta * frac
+  // variance += frac * ((other_variance - variance) +
+  //                     (1.0 - frac) * delta ^ 2)
+  absl::Status error;
+  const double frac = other_count / count;
+  double delta, tmp, tmp2;
+  if (!functions::Subtract(other_mean, *mean, &delta, &error) ||
+      !functions::Multiply(delta, frac, &tmp, &error) ||
+      !functions::Add(*mean, tmp, mean, &error) ||
+      !functions::Multiply(1 - frac, delta, &tmp, &error) ||
+      !functions::Multiply(tmp, delta, &tmp, &error) ||
+      !functions::Subtract(other_variance, *variance, &tmp2, &error) ||
+      !functions::Add(tmp, tmp2, &tmp, &error) ||
+      !functions::Multiply(frac, tmp, &tmp, &error) ||
+      !functions::Add(*variance, tmp, variance, &error)) {
+    return error;
+  }
+  return absl::OkStatus();
+}
+
 // Accumulator implementation for BuiltinAggregateFunction.
 class BuiltinAggregateAccumulator : public AggregateAccumulator {
  public:
@@ -3548,6 +3831,14 @@ class BuiltinAggregateAccumulator : public AggregateAccumulator {
 
   absl::StatusOr<Value> GetFinalResult(bool inputs_in_defined_order) override;
 
+  // Supported for COUNT, COUNTIF, SUM, AVG, the variance and standard
+  // deviation functions, MIN and MAX of scalar types other than DATETIME and
+  // INTERVAL, the logical and bitwise aggregates, and PERCENTILE_CONT of
+  // doubles when EvaluationOptions::percentile_sketch_size is set.
+  absl::StatusOr<std::string> SerializeState() const override;
+
+  absl::Status MergeSerializedState(absl::string_view state) override;
+
  private:
 
   BuiltinAggregateAccumulator(const BuiltinAggregateFunction* function,
@@ -3613,6 +3904,9 @@ class BuiltinAggregateAccumulator : public AggregateAccumulator {
   // Percentile.
   Value percentile_;
   std::vector<Value> percentile_population_;
+  // Replaces <percentile_population_> if
+  // EvaluationOptions::percentile_sketch_size is set.
+  std::unique_ptr<PercentileSketch<double>> percentile_sketch_;
   // Used for ANON_* functions from (broken link).
   std::unique_ptr<::differential_privacy::Algorithm<double>> anon_double_;
   std::unique_ptr<::differential_privacy::Algorithm<int64_t>> anon_int64_;
@@ -3918,6 +4212,10 @@ absl::Status BuiltinAggregateAccumulator::Reset() {
       ZETASQL_RET_CHECK_EQ(args_.size(), 1);
       ZETASQL_RET_CHECK(args_[0].type()->IsDouble());
       percentile_ = args_[0];
+      if (context_->options().percentile_sketch_size > 0) {
+        percentile_sketch_ = std::make_unique<PercentileSketch<double>>(
+            context_->options().percentile_sketch_size);
+      }
       break;
     case FCT(FunctionKind::kPercentileCont, TYPE_NUMERIC):
       ZETASQL_RET_CHECK_EQ(args_.size(), 1);
@@ -4411,6 +4709,12 @@ bool BuiltinAggregateAccumulator::Accumulate(const Value& value,
       break;
     }
     case FCT(FunctionKind::kPercentileCont, TYPE_DOUBLE):
+      if (percentile_sketch_ != nullptr) {
+        percentile_sketch_->Add(value.double_value());
+        break;
+      }
+      percentile_population_.push_back(value);
+      break;
     case FCT(FunctionKind::kPercentileCont, TYPE_NUMERIC):
     case FCT(FunctionKind::kPercentileCont, TYPE_BIGNUMERIC):
       percentile_population_.push_back(value);
@@ -4450,6 +4754,482 @@ bool BuiltinAggregateAccumulator::Accumulate(const Value& value,
   return true;
 }  // NOLINT(readability/fn_size)
 
+absl::StatusOr<std::string> BuiltinAggregateAccumulator::SerializeState()
+    const {
+  const uint64_t function_type = FCT(function_->kind(), input_type_->kind());
+  std::string state;
+  AccumulatorStateWriter writer(&state);
+  writer.AppendInt64(function_type);
+  writer.AppendInt64(count_);
+  writer.AppendInt64(has_null_);
+
+  switch (function_->kind()) {
+    case FunctionKind::kCount:
+      return state;
+    case FunctionKind::kOrAgg:
+    case FunctionKind::kLogicalOr:
+      writer.AppendInt64(has_true_);
+      return state;
+    case FunctionKind::kAndAgg:
+    case FunctionKind::kLogicalAnd:
+      writer.AppendInt64(has_false_);
+      return state;
+    default:
+      break;
+  }
+
+  switch (function_type) {
+    case FCT(FunctionKind::kCountIf, TYPE_BOOL):
+      writer.AppendInt64(countif_);
+      break;
+
+    // Avg and Sum
+    case FCT(FunctionKind::kAvg, TYPE_INT64):
+    case FCT(FunctionKind::kAvg, TYPE_UINT64):
+    case FCT(FunctionKind::kAvg, TYPE_DOUBLE):
+      writer.AppendDouble(out_double_);
+      break;
+    case FCT(FunctionKind::kAvg, TYPE_NUMERIC):
+    case FCT(FunctionKind::kSum, TYPE_NUMERIC):
+      writer.AppendString(numeric_aggregator_.SerializeAsProtoBytes());
+      break;
+    case FCT(FunctionKind::kAvg, TYPE_BIGNUMERIC):
+    case FCT(FunctionKind::kSum, TYPE_BIGNUMERIC):
+      writer.AppendString(bignumeric_aggregator_.SerializeAsProtoBytes());
+      break;
+    case FCT(FunctionKind::kAvg, TYPE_INTERVAL):
+    case FCT(FunctionKind::kSum, TYPE_INTERVAL):
+      writer.AppendString(interval_aggregator_.SerializeAsProtoBytes());
+      break;
+    case FCT(FunctionKind::kSum, TYPE_DOUBLE):
+      writer.AppendExactFloat(out_exact_float_);
+      break;
+    case FCT(FunctionKind::kSum, TYPE_INT64):
+      writer.AppendUint128(static_cast<unsigned __int128>(out_int128_));
+      break;
+    case FCT(FunctionKind::kSum, TYPE_UINT64):
+      writer.AppendUint128(out_uint128_);
+      break;
+
+    // Variance and standard deviation.
+    case FCT(FunctionKind::kStddevPop, TYPE_DOUBLE):
+    case FCT(FunctionKind::kStddevSamp, TYPE_DOUBLE):
+    case FCT(FunctionKind::kVarPop, TYPE_DOUBLE):
+    case FCT(FunctionKind::kVarSamp, TYPE_DOUBLE):
+      writer.AppendDouble(avg_);
+      writer.AppendDouble(variance_);
+      break;
+    case FCT(FunctionKind::kStddevPop, TYPE_NUMERIC):
+    case FCT(FunctionKind::kStddevSamp, TYPE_NUMERIC):
+    case FCT(FunctionKind::kVarPop, TYPE_NUMERIC):
+    case FCT(FunctionKind::kVarSamp, TYPE_NUMERIC):
+      writer.AppendString(numeric_variance_aggregator_.SerializeAsProtoBytes());
+      break;
+    case FCT(FunctionKind::kStddevPop, TYPE_BIGNUMERIC):
+    case FCT(FunctionKind::kStddevSamp, TYPE_BIGNUMERIC):
+    case FCT(FunctionKind::kVarPop, TYPE_BIGNUMERIC):
+    case FCT(FunctionKind::kVarSamp, TYPE_BIGNUMERIC):
+      writer.AppendString(
+          bignumeric_variance_aggregator_.SerializeAsProtoBytes());
+      break;
+
+    // Bitwise aggregates.
+    case FCT(FunctionKind::kBitAnd, TYPE_INT32):
+    case FCT(FunctionKind::kBitOr, TYPE_INT32):
+    case FCT(FunctionKind::kBitXor, TYPE_INT32):
+      writer.AppendInt64(bit_int32_);
+      break;
+    case FCT(FunctionKind::kBitAnd, TYPE_INT64):
+    case FCT(FunctionKind::kBitOr, TYPE_INT64):
+    case FCT(FunctionKind::kBitXor, TYPE_INT64):
+      writer.AppendInt64(bit_int64_);
+      break;
+    case FCT(FunctionKind::kBitAnd, TYPE_UINT32):
+    case FCT(FunctionKind::kBitOr, TYPE_UINT32):
+    case FCT(FunctionKind::kBitXor, TYPE_UINT32):
+      writer.AppendInt64(bit_uint32_);
+      break;
+    case FCT(FunctionKind::kBitAnd, TYPE_UINT64):
+    case FCT(FunctionKind::kBitOr, TYPE_UINT64):
+    case FCT(FunctionKind::kBitXor, TYPE_UINT64):
+      writer.AppendInt64(static_cast<int64_t>(bit_uint64_));
+      break;
+
+    // Max and Min
+    case FCT(FunctionKind::kMax, TYPE_FLOAT):
+    case FCT(FunctionKind::kMax, TYPE_DOUBLE):
+    case FCT(FunctionKind::kMin, TYPE_FLOAT):
+    case FCT(FunctionKind::kMin, TYPE_DOUBLE):
+      writer.AppendDouble(out_double_);
+      break;
+    case FCT(FunctionKind::kMax, TYPE_INT32):
+    case FCT(FunctionKind::kMax, TYPE_INT64):
+    case FCT(FunctionKind::kMax, TYPE_UINT32):
+    case FCT(FunctionKind::kMax, TYPE_DATE):
+    case FCT(FunctionKind::kMax, TYPE_BOOL):
+    case FCT(FunctionKind::kMax, TYPE_ENUM):
+    case FCT(FunctionKind::kMax, TYPE_TIMESTAMP):
+    case FCT(FunctionKind::kMax, TYPE_TIME):
+    case FCT(FunctionKind::kMin, TYPE_INT32):
+    case FCT(FunctionKind::kMin, TYPE_INT64):
+    case FCT(FunctionKind::kMin, TYPE_UINT32):
+    case FCT(FunctionKind::kMin, TYPE_DATE):
+    case FCT(FunctionKind::kMin, TYPE_BOOL):
+    case FCT(FunctionKind::kMin, TYPE_ENUM):
+    case FCT(FunctionKind::kMin, TYPE_TIMESTAMP):
+    case FCT(FunctionKind::kMin, TYPE_TIME):
+      writer.AppendInt64(out_int64_);
+      break;
+    case FCT(FunctionKind::kMax, TYPE_UINT64):
+    case FCT(FunctionKind::kMin, TYPE_UINT64):
+      writer.AppendInt64(static_cast<int64_t>(out_uint64_));
+      break;
+    case FCT(FunctionKind::kMax, TYPE_NUMERIC):
+    case FCT(FunctionKind::kMin, TYPE_NUMERIC):
+      writer.AppendString(out_numeric_.SerializeAsProtoBytes());
+      break;
+    case FCT(FunctionKind::kMax, TYPE_BIGNUMERIC):
+    case FCT(FunctionKind::kMin, TYPE_BIGNUMERIC):
+      writer.AppendString(out_bignumeric_.SerializeAsProtoBytes());
+      break;
+    case FCT(FunctionKind::kMax, TYPE_STRING):
+    case FCT(FunctionKind::kMax, TYPE_BYTES):
+    case FCT(FunctionKind::kMin, TYPE_STRING):
+    case FCT(FunctionKind::kMin, TYPE_BYTES):
+      writer.AppendString(out_string_);
+      break;
+
+    // Percentiles can only be merged when they are approximated by sketches.
+    case FCT(FunctionKind::kPercentileCont, TYPE_DOUBLE):
+      if (percentile_sketch_ != nullptr) {
+        writer.AppendPercentileSketch(*percentile_sketch_);
+        break;
+      }
+      ABSL_FALLTHROUGH_INTENDED;
+    default:
+      return ::zetasql_base::UnimplementedErrorBuilder()
+             << "Partial aggregation is not supported for "
+             << function_->debug_name() << " of "
+             << input_type_->DebugString();
+  }
+  return state;
+}
+
+absl::Status BuiltinAggregateAccumulator::MergeSerializedState(
+    absl::string_view state) {
+  const uint64_t function_type = FCT(function_->kind(), input_type_->kind());
+  AccumulatorStateReader reader(state);
+  int64_t other_function_type;
+  int64_t other_count;
+  int64_t other_has_null;
+  ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&other_function_type));
+  ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&other_count));
+  ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&other_has_null));
+  if (static_cast<uint64_t>(other_function_type) != function_type) {
+    return ::zetasql_base::InvalidArgumentErrorBuilder()
+           << "Cannot merge the state of a different aggregate into "
+           << function_->debug_name();
+  }
+  // The total count, for the functions that need it. <count_> is updated at
+  // the end.
+  const int64_t merged_count = count_ + other_count;
+
+  int64_t bytes_to_return = 0;
+  int64_t additional_bytes_to_request = 0;
+  int64_t value = 0;
+  switch (function_->kind()) {
+    case FunctionKind::kCount:
+      break;
+    case FunctionKind::kOrAgg:
+    case FunctionKind::kLogicalOr:
+      ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+      has_true_ = has_true_ || value != 0;
+      break;
+    case FunctionKind::kAndAgg:
+    case FunctionKind::kLogicalAnd:
+      ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+      has_false_ = has_false_ || value != 0;
+      break;
+    default:
+      switch (function_type) {
+        case FCT(FunctionKind::kCountIf, TYPE_BOOL):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          countif_ += value;
+          break;
+
+        // Avg and Sum
+        case FCT(FunctionKind::kAvg, TYPE_INT64):
+        case FCT(FunctionKind::kAvg, TYPE_UINT64):
+        case FCT(FunctionKind::kAvg, TYPE_DOUBLE): {
+          double other_mean;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadDouble(&other_mean));
+          if (other_count == 0) break;
+          // out_double += (other_mean - out_double) * other_count / count
+          absl::Status error;
+          double delta;
+          if (!functions::Subtract(other_mean, out_double_, &delta, &error) ||
+              !functions::Multiply(
+                  delta, static_cast<double>(other_count) / merged_count,
+                  &delta, &error) ||
+              !functions::Add(out_double_, delta, &out_double_, &error)) {
+            return error;
+          }
+          break;
+        }
+        case FCT(FunctionKind::kAvg, TYPE_NUMERIC):
+        case FCT(FunctionKind::kSum, TYPE_NUMERIC): {
+          NumericValue::SumAggregator other;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadAggregator(&other));
+          numeric_aggregator_.MergeWith(other);
+          break;
+        }
+        case FCT(FunctionKind::kAvg, TYPE_BIGNUMERIC):
+        case FCT(FunctionKind::kSum, TYPE_BIGNUMERIC): {
+          BigNumericValue::SumAggregator other;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadAggregator(&other));
+          bignumeric_aggregator_.MergeWith(other);
+          break;
+        }
+        case FCT(FunctionKind::kAvg, TYPE_INTERVAL):
+        case FCT(FunctionKind::kSum, TYPE_INTERVAL): {
+          IntervalValue::SumAggregator other;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadAggregator(&other));
+          interval_aggregator_.MergeWith(other);
+          break;
+        }
+        case FCT(FunctionKind::kSum, TYPE_DOUBLE): {
+          zetasql_base::ExactFloat other;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadExactFloat(&other));
+          out_exact_float_ = out_exact_float_ + other;
+          break;
+        }
+        case FCT(FunctionKind::kSum, TYPE_INT64): {
+          unsigned __int128 other;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadUint128(&other));
+          out_int128_ += static_cast<__int128>(other);
+          break;
+        }
+        case FCT(FunctionKind::kSum, TYPE_UINT64): {
+          unsigned __int128 other;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadUint128(&other));
+          out_uint128_ += other;
+          break;
+        }
+
+        // Variance and standard deviation.
+        case FCT(FunctionKind::kStddevPop, TYPE_DOUBLE):
+        case FCT(FunctionKind::kStddevSamp, TYPE_DOUBLE):
+        case FCT(FunctionKind::kVarPop, TYPE_DOUBLE):
+        case FCT(FunctionKind::kVarSamp, TYPE_DOUBLE): {
+          double other_avg, other_variance;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadDouble(&other_avg));
+          ZETASQL_RETURN_IF_ERROR(reader.ReadDouble(&other_variance));
+          if (other_count == 0) break;
+          ZETASQL_RETURN_IF_ERROR(MergeMeanAndVariance(other_avg, other_variance,
+                                               other_count, merged_count,
+                                               &avg_, &variance_));
+          break;
+        }
+        case FCT(FunctionKind::kStddevPop, TYPE_NUMERIC):
+        case FCT(FunctionKind::kStddevSamp, TYPE_NUMERIC):
+        case FCT(FunctionKind::kVarPop, TYPE_NUMERIC):
+        case FCT(FunctionKind::kVarSamp, TYPE_NUMERIC): {
+          NumericValue::VarianceAggregator other;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadAggregator(&other));
+          numeric_variance_aggregator_.MergeWith(other);
+          break;
+        }
+        case FCT(FunctionKind::kStddevPop, TYPE_BIGNUMERIC):
+        case FCT(FunctionKind::kStddevSamp, TYPE_BIGNUMERIC):
+        case FCT(FunctionKind::kVarPop, TYPE_BIGNUMERIC):
+        case FCT(FunctionKind::kVarSamp, TYPE_BIGNUMERIC): {
+          BigNumericValue::VarianceAggregator other;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadAggregator(&other));
+          bignumeric_variance_aggregator_.MergeWith(other);
+          break;
+        }
+
+        // Bitwise aggregates. The initial values are the identities of the
+        // operations, so empty states can be merged too.
+        case FCT(FunctionKind::kBitAnd, TYPE_INT32):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          bit_int32_ &= static_cast<int32_t>(value);
+          break;
+        case FCT(FunctionKind::kBitAnd, TYPE_INT64):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          bit_int64_ &= value;
+          break;
+        case FCT(FunctionKind::kBitAnd, TYPE_UINT32):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          bit_uint32_ &= static_cast<uint32_t>(value);
+          break;
+        case FCT(FunctionKind::kBitAnd, TYPE_UINT64):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          bit_uint64_ &= static_cast<uint64_t>(value);
+          break;
+        case FCT(FunctionKind::kBitOr, TYPE_INT32):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          bit_int32_ |= static_cast<int32_t>(value);
+          break;
+        case FCT(FunctionKind::kBitOr, TYPE_INT64):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          bit_int64_ |= value;
+          break;
+        case FCT(FunctionKind::kBitOr, TYPE_UINT32):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          bit_uint32_ |= static_cast<uint32_t>(value);
+          break;
+        case FCT(FunctionKind::kBitOr, TYPE_UINT64):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          bit_uint64_ |= static_cast<uint64_t>(value);
+          break;
+        case FCT(FunctionKind::kBitXor, TYPE_INT32):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          bit_int32_ ^= static_cast<int32_t>(value);
+          break;
+        case FCT(FunctionKind::kBitXor, TYPE_INT64):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          bit_int64_ ^= value;
+          break;
+        case FCT(FunctionKind::kBitXor, TYPE_UINT32):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          bit_uint32_ ^= static_cast<uint32_t>(value);
+          break;
+        case FCT(FunctionKind::kBitXor, TYPE_UINT64):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          bit_uint64_ ^= static_cast<uint64_t>(value);
+          break;
+
+        // Max and Min. The initial values are the identities of max() and
+        // min(), so empty states can be merged too, except for strings.
+        case FCT(FunctionKind::kMax, TYPE_FLOAT):
+        case FCT(FunctionKind::kMax, TYPE_DOUBLE):
+        case FCT(FunctionKind::kMin, TYPE_FLOAT):
+        case FCT(FunctionKind::kMin, TYPE_DOUBLE): {
+          double other;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadDouble(&other));
+          if (std::isnan(other) || std::isnan(out_double_)) {
+            out_double_ = std::numeric_limits<double>::quiet_NaN();
+          } else if (function_->kind() == FunctionKind::kMax) {
+            out_double_ = std::max(out_double_, other);
+          } else {
+            out_double_ = std::min(out_double_, other);
+          }
+          break;
+        }
+        case FCT(FunctionKind::kMax, TYPE_INT32):
+        case FCT(FunctionKind::kMax, TYPE_INT64):
+        case FCT(FunctionKind::kMax, TYPE_UINT32):
+        case FCT(FunctionKind::kMax, TYPE_DATE):
+        case FCT(FunctionKind::kMax, TYPE_BOOL):
+        case FCT(FunctionKind::kMax, TYPE_ENUM):
+        case FCT(FunctionKind::kMax, TYPE_TIMESTAMP):
+        case FCT(FunctionKind::kMax, TYPE_TIME):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          out_int64_ = std::max(out_int64_, value);
+          break;
+        case FCT(FunctionKind::kMin, TYPE_INT32):
+        case FCT(FunctionKind::kMin, TYPE_INT64):
+        case FCT(FunctionKind::kMin, TYPE_UINT32):
+        case FCT(FunctionKind::kMin, TYPE_DATE):
+        case FCT(FunctionKind::kMin, TYPE_BOOL):
+        case FCT(FunctionKind::kMin, TYPE_ENUM):
+        case FCT(FunctionKind::kMin, TYPE_TIMESTAMP):
+        case FCT(FunctionKind::kMin, TYPE_TIME):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          out_int64_ = std::min(out_int64_, value);
+          break;
+        case FCT(FunctionKind::kMax, TYPE_UINT64):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          out_uint64_ = std::max(out_uint64_, static_cast<uint64_t>(value));
+          break;
+        case FCT(FunctionKind::kMin, TYPE_UINT64):
+          ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&value));
+          out_uint64_ = std::min(out_uint64_, static_cast<uint64_t>(value));
+          break;
+        case FCT(FunctionKind::kMax, TYPE_NUMERIC):
+        case FCT(FunctionKind::kMin, TYPE_NUMERIC): {
+          absl::string_view bytes;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadString(&bytes));
+          ZETASQL_ASSIGN_OR_RETURN(const NumericValue other,
+                           NumericValue::DeserializeFromProtoBytes(bytes));
+          out_numeric_ = function_->kind() == FunctionKind::kMax
+                             ? std::max(out_numeric_, other)
+                             : std::min(out_numeric_, other);
+          break;
+        }
+        case FCT(FunctionKind::kMax, TYPE_BIGNUMERIC):
+        case FCT(FunctionKind::kMin, TYPE_BIGNUMERIC): {
+          absl::string_view bytes;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadString(&bytes));
+          ZETASQL_ASSIGN_OR_RETURN(const BigNumericValue other,
+                           BigNumericValue::DeserializeFromProtoBytes(bytes));
+          out_bignumeric_ = function_->kind() == FunctionKind::kMax
+                                ? std::max(out_bignumeric_, other)
+                                : std::min(out_bignumeric_, other);
+          break;
+        }
+        case FCT(FunctionKind::kMax, TYPE_STRING):
+        case FCT(FunctionKind::kMax, TYPE_BYTES):
+        case FCT(FunctionKind::kMin, TYPE_STRING):
+        case FCT(FunctionKind::kMin, TYPE_BYTES): {
+          absl::string_view other;
+          ZETASQL_RETURN_IF_ERROR(reader.ReadString(&other));
+          if (other_count == 0) break;
+          int64_t result;
+          if (count_ == 0) {
+            result = function_->kind() == FunctionKind::kMax ? 1 : -1;
+          } else if (input_type_->IsString() && !collator_list_.empty()) {
+            absl::Status status;
+            result = collator_list_[0]->CompareUtf8(other, out_string_,
+                                                    &status);
+            ZETASQL_RETURN_IF_ERROR(status);
+          } else {
+            result = other.compare(out_string_);
+          }
+          if (function_->kind() == FunctionKind::kMax ? result > 0
+                                                      : result < 0) {
+            bytes_to_return = out_string_.size();
+            out_string_ = std::string(other);
+            additional_bytes_to_request = out_string_.size();
+          }
+          break;
+        }
+
+        case FCT(FunctionKind::kPercentileCont, TYPE_DOUBLE):
+          if (percentile_sketch_ != nullptr) {
+            PercentileSketch<double> other;
+            ZETASQL_RETURN_IF_ERROR(reader.ReadPercentileSketch(&other));
+            if (other.k() != percentile_sketch_->k()) {
+              return ::zetasql_base::InvalidArgumentErrorBuilder()
+                     << "Cannot merge percentile sketches of different sizes";
+            }
+            percentile_sketch_->Merge(other);
+            break;
+          }
+          ABSL_FALLTHROUGH_INTENDED;
+        default:
+          return ::zetasql_base::UnimplementedErrorBuilder()
+                 << "Partial aggregation is not supported for "
+                 << function_->debug_name() << " of "
+                 << input_type_->DebugString();
+      }
+  }
+  ZETASQL_RETURN_IF_ERROR(reader.Finish());
+
+  count_ = merged_count;
+  has_null_ = has_null_ || other_has_null != 0;
+
+  accountant()->ReturnBytes(bytes_to_return);
+  requested_bytes_ -= bytes_to_return;
+  absl::Status status;
+  if (!accountant()->RequestBytes(additional_bytes_to_request, &status)) {
+    return status;
+  }
+  requested_bytes_ += additional_bytes_to_request;
+  return absl::OkStatus();
+}
+
 absl::StatusOr<Value> BuiltinAggregateAccumulator::GetFinalResult(
     bool inputs_in_defined_order) {
   ZETASQL_ASSIGN_OR_RETURN(const Value result,
@@ -4493,6 +5273,19 @@ absl::StatusOr<Value> ComputePercentileCont(
                             : Value::MakeNull<T>();
 }
 
+// Like ComputePercentileCont(), but from a sketch of the non-NULL values.
+absl::StatusOr<Value> ComputeApproximatePercentileCont(
+    const PercentileSketch<double>& sketch, double percentile) {
+  ZETASQL_ASSIGN_OR_RETURN(PercentileEvaluator<double> percentile_evalutor,
+                   PercentileEvaluator<double>::Create(percentile));
+  const PercentileSketch<double>::SortedView values = sketch.GetSortedView();
+  double result_value;
+  return percentile_evalutor.ComputePercentileCont</*sorted=*/true>(
+             values.begin(), values.end(), /*num_nulls=*/0, &result_value)
+             ? Value::Double(result_value)
+             : Value::NullDouble();
+}
+
 template <typename T, typename PercentileType, typename V = T,
           typename ValueCreationFn = Value (*)(T)>
 Value ComputePercentileDisc(
@@ -4901,6 +5694,10 @@ absl::StatusOr<Value> BuiltinAggregateAccumulator::GetFinalResultInternal(
     case FCT(FunctionKind::kBitXor, TYPE_UINT64):
       return count_ > 0 ? Value::Uint64(bit_uint64_) : Value::NullUint64();
     case FCT(FunctionKind::kPercentileCont, TYPE_DOUBLE):
+      if (percentile_sketch_ != nullptr) {
+        return ComputeApproximatePercentileCont(*percentile_sketch_,
+                                                percentile_.double_value());
+      }
       return ComputePercentileCont<>(percentile_population_,
                                      percentile_.double_value(),
                                      function_->ignores_null());
@@ -4997,6 +5794,10 @@ class BinaryStatAccumulator : public AggregateAccumulator {
 
   absl::StatusOr<Value> GetFinalResult(bool inputs_in_defined_order) override;
 
+  absl::StatusOr<std::string> SerializeState() const override;
+
+  absl::Status MergeSerializedState(absl::string_view state) override;
+
  private:
   BinaryStatAccumulator(const BinaryStatFunction* function,
                         const Type* input_type, EvaluationContext* context)
@@ -5145,6 +5946,149 @@ bool BinaryStatAccumulator::Accumulate(const Value& value,
   return status->ok();
 }
 
+absl::StatusOr<std::string> BinaryStatAccumulator::SerializeState() const {
+  const uint64_t function_type =
+      FCT2(function_->kind(), input_type_->AsStruct()->field(0).type->kind(),
+           input_type_->AsStruct()->field(1).type->kind());
+  std::string state;
+  AccumulatorStateWriter writer(&state);
+  writer.AppendInt64(function_type);
+  writer.AppendInt64(pair_count_);
+  switch (function_type) {
+    case FCT2(FunctionKind::kCovarPop, TYPE_NUMERIC, TYPE_NUMERIC):
+    case FCT2(FunctionKind::kCovarSamp, TYPE_NUMERIC, TYPE_NUMERIC):
+      writer.AppendString(
+          numeric_covariance_aggregator_.SerializeAsProtoBytes());
+      break;
+    case FCT2(FunctionKind::kCorr, TYPE_NUMERIC, TYPE_NUMERIC):
+      writer.AppendString(
+          numeric_correlation_aggregator_.SerializeAsProtoBytes());
+      break;
+    case FCT2(FunctionKind::kCovarPop, TYPE_BIGNUMERIC, TYPE_BIGNUMERIC):
+    case FCT2(FunctionKind::kCovarSamp, TYPE_BIGNUMERIC, TYPE_BIGNUMERIC):
+      writer.AppendString(
+          bignumeric_covariance_aggregator_.SerializeAsProtoBytes());
+      break;
+    case FCT2(FunctionKind::kCorr, TYPE_BIGNUMERIC, TYPE_BIGNUMERIC):
+      writer.AppendString(
+          bignumeric_correlation_aggregator_.SerializeAsProtoBytes());
+      break;
+    case FCT2(FunctionKind::kCovarPop, TYPE_DOUBLE, TYPE_DOUBLE):
+    case FCT2(FunctionKind::kCovarSamp, TYPE_DOUBLE, TYPE_DOUBLE):
+    case FCT2(FunctionKind::kCorr, TYPE_DOUBLE, TYPE_DOUBLE):
+      writer.AppendInt64(input_has_nan_or_inf_);
+      writer.AppendDouble(mean_x_);
+      writer.AppendDouble(variance_x_);
+      writer.AppendDouble(mean_y_);
+      writer.AppendDouble(variance_y_);
+      writer.AppendDouble(covar_);
+      break;
+    default:
+      return ::zetasql_base::UnimplementedErrorBuilder()
+             << "Partial aggregation is not supported for "
+             << function_->debug_name() << "(" << input_type_->DebugString()
+             << ")";
+  }
+  return state;
+}
+
+absl::Status BinaryStatAccumulator::MergeSerializedState(
+    absl::string_view state) {
+  const uint64_t function_type =
+      FCT2(function_->kind(), input_type_->AsStruct()->field(0).type->kind(),
+           input_type_->AsStruct()->field(1).type->kind());
+  AccumulatorStateReader reader(state);
+  int64_t other_function_type;
+  int64_t other_pair_count;
+  ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&other_function_type));
+  ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&other_pair_count));
+  if (static_cast<uint64_t>(other_function_type) != function_type) {
+    return ::zetasql_base::InvalidArgumentErrorBuilder()
+           << "Cannot merge the state of a different aggregate into "
+           << function_->debug_name();
+  }
+  const int64_t merged_pair_count = pair_count_ + other_pair_count;
+
+  switch (function_type) {
+    case FCT2(FunctionKind::kCovarPop, TYPE_NUMERIC, TYPE_NUMERIC):
+    case FCT2(FunctionKind::kCovarSamp, TYPE_NUMERIC, TYPE_NUMERIC): {
+      NumericValue::CovarianceAggregator other;
+      ZETASQL_RETURN_IF_ERROR(reader.ReadAggregator(&other));
+      numeric_covariance_aggregator_.MergeWith(other);
+      break;
+    }
+    case FCT2(FunctionKind::kCorr, TYPE_NUMERIC, TYPE_NUMERIC): {
+      NumericValue::CorrelationAggregator other;
+      ZETASQL_RETURN_IF_ERROR(reader.ReadAggregator(&other));
+      numeric_correlation_aggregator_.MergeWith(other);
+      break;
+    }
+    case FCT2(FunctionKind::kCovarPop, TYPE_BIGNUMERIC, TYPE_BIGNUMERIC):
+    case FCT2(FunctionKind::kCovarSamp, TYPE_BIGNUMERIC, TYPE_BIGNUMERIC): {
+      BigNumericValue::CovarianceAggregator other;
+      ZETASQL_RETURN_IF_ERROR(reader.ReadAggregator(&other));
+      bignumeric_covariance_aggregator_.MergeWith(other);
+      break;
+    }
+    case FCT2(FunctionKind::kCorr, TYPE_BIGNUMERIC, TYPE_BIGNUMERIC): {
+      BigNumericValue::CorrelationAggregator other;
+      ZETASQL_RETURN_IF_ERROR(reader.ReadAggregator(&other));
+      bignumeric_correlation_aggregator_.MergeWith(other);
+      break;
+    }
+    case FCT2(FunctionKind::kCovarPop, TYPE_DOUBLE, TYPE_DOUBLE):
+    case FCT2(FunctionKind::kCovarSamp, TYPE_DOUBLE, TYPE_DOUBLE):
+    case FCT2(FunctionKind::kCorr, TYPE_DOUBLE, TYPE_DOUBLE): {
+      int64_t other_has_nan_or_inf;
+      double other_mean_x, other_variance_x, other_mean_y, other_variance_y,
+          other_covar;
+      ZETASQL_RETURN_IF_ERROR(reader.ReadInt64(&other_has_nan_or_inf));
+      ZETASQL_RETURN_IF_ERROR(reader.ReadDouble(&other_mean_x));
+      ZETASQL_RETURN_IF_ERROR(reader.ReadDouble(&other_variance_x));
+      ZETASQL_RETURN_IF_ERROR(reader.ReadDouble(&other_mean_y));
+      ZETASQL_RETURN_IF_ERROR(reader.ReadDouble(&other_variance_y));
+      ZETASQL_RETURN_IF_ERROR(reader.ReadDouble(&other_covar));
+      if (other_has_nan_or_inf != 0) input_has_nan_or_inf_ = true;
+      if (input_has_nan_or_inf_ || other_pair_count == 0) break;
+
+      // Pairwise covariance merge, with the population covariances:
+      // frac = other_pair_count / merged_pair_count
+      // covar += frac * ((other_covar - covar) +
+      //                  (1.0 - frac) * (other_mean_x - mean_x) *
+      //                  (other_mean_y - mean_y))
+      absl::Status error;
+      const double frac =
+          static_cast<double>(other_pair_count) / merged_pair_count;
+      double delta_x, delta_y, tmp, tmp2;
+      if (!functions::Subtract(other_mean_x, mean_x_, &delta_x, &error) ||
+          !functions::Subtract(other_mean_y, mean_y_, &delta_y, &error) ||
+          !functions::Multiply(1 - frac, delta_x, &tmp, &error) ||
+          !functions::Multiply(tmp, delta_y, &tmp, &error) ||
+          !functions::Subtract(other_covar, covar_, &tmp2, &error) ||
+          !functions::Add(tmp, tmp2, &tmp, &error) ||
+          !functions::Multiply(frac, tmp, &tmp, &error) ||
+          !functions::Add(covar_, tmp, &covar_, &error)) {
+        return error;
+      }
+      ZETASQL_RETURN_IF_ERROR(MergeMeanAndVariance(other_mean_x, other_variance_x,
+                                           other_pair_count, merged_pair_count,
+                                           &mean_x_, &variance_x_));
+      ZETASQL_RETURN_IF_ERROR(MergeMeanAndVariance(other_mean_y, other_variance_y,
+                                           other_pair_count, merged_pair_count,
+                                           &mean_y_, &variance_y_));
+      break;
+    }
+    default:
+      return ::zetasql_base::UnimplementedErrorBuilder()
+             << "Partial aggregation is not supported for "
+             << function_->debug_name() << "(" << input_type_->DebugString()
+             << ")";
+  }
+  ZETASQL_RETURN_IF_ERROR(reader.Finish());
+  pair_count_ = merged_pair_count;
+  return absl::OkStatus();
+}
+
 absl::StatusOr<Value> BinaryStatAccumulator::GetFinalResult(
     bool /* inputs_in_defined_order */) {
   if (pair_count_ < min_required_pair_count_) {
@@ -6620,6 +7564,37 @@ absl::StatusOr<Value> FormatDateDatetimeTimestampFunction::Eval(
   ZETASQL_DCHECK_LE(args.size(), 3);
   if (HasNulls(args)) return Value::Null(output_type());
   std::string result_string;
+  if (const_formatter_ != nullptr) {
+    switch (args[1].type_kind()) {
+      case TYPE_DATE:
+        ZETASQL_RETURN_IF_ERROR(
+            const_formatter_->FormatDate(args[1].date_value(), &result_string));
+        break;
+      case TYPE_DATETIME:
+        ZETASQL_RETURN_IF_ERROR(const_formatter_->FormatDatetime(
+            args[1].datetime_value(), &result_string));
+        break;
+      case TYPE_TIMESTAMP: {
+        absl::TimeZone timezone = context->GetDefaultTimeZone();
+        if (args.size() == 3) {
+          ZETASQL_RETURN_IF_ERROR(
+              functions::MakeTimeZone(args[2].string_value(), &timezone));
+        }
+        ZETASQL_RETURN_IF_ERROR(const_formatter_->FormatTimestamp(
+            context->GetLanguageOptions().LanguageFeatureEnabled(
+                FEATURE_TIMESTAMP_NANOS)
+                ? args[1].ToTime()
+                : absl::FromUnixMicros(args[1].ToUnixMicros()),
+            timezone, &result_string));
+        break;
+      }
+      default:
+        return ::zetasql_base::UnimplementedErrorBuilder()
+               << "Unsupported type " << args[1].type()->DebugString()
+               << " in function " << debug_name();
+    }
+    return Value::String(result_string);
+  }
   switch (args[1].type_kind()) {
     case TYPE_DATE:
       ZETASQL_RETURN_IF_ERROR(functions::FormatDateToString(
@@ -6667,8 +7642,13 @@ absl::StatusOr<Value> FormatTimeFunction::Eval(
   ZETASQL_DCHECK_EQ(args.size(), 2);
   if (HasNulls(args)) return Value::Null(output_type());
   std::string result_string;
-  ZETASQL_RETURN_IF_ERROR(functions::FormatTimeToString(
-      args[0].string_value(), args[1].time_value(), &result_string));
+  if (const_formatter_ != nullptr) {
+    ZETASQL_RETURN_IF_ERROR(
+        const_formatter_->FormatTime(args[1].time_value(), &result_string));
+  } else {
+    ZETASQL_RETURN_IF_ERROR(functions::FormatTimeToString(
+        args[0].string_value(), args[1].time_value(), &result_string));
+  }
   return Value::String(result_string);
 }
 
@@ -7020,9 +8000,14 @@ absl::StatusOr<Value> ParseDateFunction::Eval(
   ZETASQL_DCHECK_EQ(args.size(), 2);
   if (HasNulls(args)) return Value::Null(output_type());
   int32_t date;
-  ZETASQL_RETURN_IF_ERROR(functions::ParseStringToDate(args[0].string_value(),
-                                               args[1].string_value(),
-                                               /*parse_version2=*/true, &date));
+  if (const_parser_ != nullptr) {
+    ZETASQL_RETURN_IF_ERROR(const_parser_->ParseDate(args[1].string_value(),
+                                             /*parse_version2=*/true, &date));
+  } else {
+    ZETASQL_RETURN_IF_ERROR(functions::ParseStringToDate(
+        args[0].string_value(), args[1].string_value(),
+        /*parse_version2=*/true, &date));
+  }
   return Value::Date(date);
 }
 
@@ -7032,10 +8017,17 @@ absl::StatusOr<Value> ParseDatetimeFunction::Eval(
   ZETASQL_DCHECK_EQ(args.size(), 2);
   if (HasNulls(args)) return Value::Null(output_type());
   DatetimeValue datetime;
-  ZETASQL_RETURN_IF_ERROR(functions::ParseStringToDatetime(
-      args[0].string_value(), args[1].string_value(),
-      GetTimestampScale(context->GetLanguageOptions()), /*parse_version2=*/true,
-      &datetime));
+  if (const_parser_ != nullptr) {
+    ZETASQL_RETURN_IF_ERROR(const_parser_->ParseDatetime(
+        args[1].string_value(),
+        GetTimestampScale(context->GetLanguageOptions()),
+        /*parse_version2=*/true, &datetime));
+  } else {
+    ZETASQL_RETURN_IF_ERROR(functions::ParseStringToDatetime(
+        args[0].string_value(), args[1].string_value(),
+        GetTimestampScale(context->GetLanguageOptions()),
+        /*parse_version2=*/true, &datetime));
+  }
   return Value::Datetime(datetime);
 }
 
@@ -7045,9 +8037,15 @@ absl::StatusOr<Value> ParseTimeFunction::Eval(
   ZETASQL_DCHECK_EQ(args.size(), 2);
   if (HasNulls(args)) return Value::Null(output_type());
   TimeValue time;
-  ZETASQL_RETURN_IF_ERROR(functions::ParseStringToTime(
-      args[0].string_value(), args[1].string_value(),
-      GetTimestampScale(context->GetLanguageOptions()), &time));
+  if (const_parser_ != nullptr) {
+    ZETASQL_RETURN_IF_ERROR(const_parser_->ParseTime(
+        args[1].string_value(),
+        GetTimestampScale(context->GetLanguageOptions()), &time));
+  } else {
+    ZETASQL_RETURN_IF_ERROR(functions::ParseStringToTime(
+        args[0].string_value(), args[1].string_value(),
+        GetTimestampScale(context->GetLanguageOptions()), &time));
+  }
   return Value::Time(time);
 }
 
@@ -7056,6 +8054,25 @@ absl::StatusOr<Value> ParseTimestampFunction::Eval(
     EvaluationContext* context) const {
   ZETASQL_RET_CHECK(args.size() == 2 || args.size() == 3);
   if (HasNulls(args)) return Value::Null(output_type());
+  if (const_parser_ != nullptr) {
+    absl::TimeZone timezone = context->GetDefaultTimeZone();
+    if (args.size() == 3) {
+      ZETASQL_RETURN_IF_ERROR(
+          functions::MakeTimeZone(args[2].string_value(), &timezone));
+    }
+    if (context->GetLanguageOptions().LanguageFeatureEnabled(
+            FEATURE_TIMESTAMP_NANOS)) {
+      absl::Time timestamp;
+      ZETASQL_RETURN_IF_ERROR(const_parser_->ParseTimestamp(
+          args[1].string_value(), timezone, /*parse_version2=*/true,
+          &timestamp));
+      return Value::Timestamp(timestamp);
+    }
+    int64_t timestamp;
+    ZETASQL_RETURN_IF_ERROR(const_parser_->ParseTimestamp(
+        args[1].string_value(), timezone, /*parse_version2=*/true, &timestamp));
+    return Value::TimestampFromUnixMicros(timestamp);
+  }
   if (context->GetLanguageOptions().LanguageFeatureEnabled(
           FEATURE_TIMESTAMP_NANOS)) {
     absl::Time timestamp;
@@ -29,6 +29,8 @@
 #include "zetasql/public/cast.h"
 #include "google/protobuf/descriptor.h"
 #include "zetasql/public/function.h"
+#include "zetasql/public/functions/date_time_util.h"
+#include "zetasql/public/functions/parse_date_time.h"
 #include "zetasql/public/functions/regexp.h"
 #include "zetasql/public/language_options.h"
 #include "zetasql/public/proto/type_annotation.pb.h"
@@ -1220,18 +1222,50 @@ class DateTimeUnaryFunction : public SimpleBuiltinScalarFunction {
 
 class FormatDateDatetimeTimestampFunction : public SimpleBuiltinScalarFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  // <const_formatter> may be null, in which case the format is interpreted on
+  // every call.
+  FormatDateDatetimeTimestampFunction(
+      std::unique_ptr<const functions::DateTimeFormatter> const_formatter,
+      FunctionKind kind, const Type* output_type)
+      : SimpleBuiltinScalarFunction(kind, output_type),
+        const_formatter_(std::move(const_formatter)) {}
+
+  FormatDateDatetimeTimestampFunction(
+      const FormatDateDatetimeTimestampFunction&) = delete;
+  FormatDateDatetimeTimestampFunction& operator=(
+      const FormatDateDatetimeTimestampFunction&) = delete;
+
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
+
+ private:
+  // Format string precompiled at prepare time; null if the format is not
+  // constant.
+  const std::unique_ptr<const functions::DateTimeFormatter> const_formatter_;
 };
 
 class FormatTimeFunction : public SimpleBuiltinScalarFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  // <const_formatter> may be null, in which case the format is interpreted on
+  // every call.
+  FormatTimeFunction(
+      std::unique_ptr<const functions::DateTimeFormatter> const_formatter,
+      FunctionKind kind, const Type* output_type)
+      : SimpleBuiltinScalarFunction(kind, output_type),
+        const_formatter_(std::move(const_formatter)) {}
+
+  FormatTimeFunction(const FormatTimeFunction&) = delete;
+  FormatTimeFunction& operator=(const FormatTimeFunction&) = delete;
+
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
+
+ private:
+  // Format string precompiled at prepare time; null if the format is not
+  // constant.
+  const std::unique_ptr<const functions::DateTimeFormatter> const_formatter_;
 };
 
 class TimestampFromIntFunction : public SimpleBuiltinScalarFunction {
@@ -1284,34 +1318,94 @@ class EnumValueDescriptorProtoFunction : public SimpleBuiltinScalarFunction {
 
 class ParseDateFunction : public SimpleBuiltinScalarFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  // <const_parser> may be null, in which case the format is interpreted on
+  // every call.
+  ParseDateFunction(
+      std::unique_ptr<const functions::DateTimeParser> const_parser,
+      FunctionKind kind, const Type* output_type)
+      : SimpleBuiltinScalarFunction(kind, output_type),
+        const_parser_(std::move(const_parser)) {}
+
+  ParseDateFunction(const ParseDateFunction&) = delete;
+  ParseDateFunction& operator=(const ParseDateFunction&) = delete;
+
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
+
+ private:
+  // Format string precompiled at prepare time; null if the format is not
+  // constant or cannot be precompiled.
+  const std::unique_ptr<const functions::DateTimeParser> const_parser_;
 };
 
 class ParseDatetimeFunction : public SimpleBuiltinScalarFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  // <const_parser> may be null, in which case the format is interpreted on
+  // every call.
+  ParseDatetimeFunction(
+      std::unique_ptr<const functions::DateTimeParser> const_parser,
+      FunctionKind kind, const Type* output_type)
+      : SimpleBuiltinScalarFunction(kind, output_type),
+        const_parser_(std::move(const_parser)) {}
+
+  ParseDatetimeFunction(const ParseDatetimeFunction&) = delete;
+  ParseDatetimeFunction& operator=(const ParseDatetimeFunction&) = delete;
+
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
+
+ private:
+  // Format string precompiled at prepare time; null if the format is not
+  // constant or cannot be precompiled.
+  const std::unique_ptr<const functions::DateTimeParser> const_parser_;
 };
 
 class ParseTimeFunction : public SimpleBuiltinScalarFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  // <const_parser> may be null, in which case the format is interpreted on
+  // every call.
+  ParseTimeFunction(
+      std::unique_ptr<const functions::DateTimeParser> const_parser,
+      FunctionKind kind, const Type* output_type)
+      : SimpleBuiltinScalarFunction(kind, output_type),
+        const_parser_(std::move(const_parser)) {}
+
+  ParseTimeFunction(const ParseTimeFunction&) = delete;
+  ParseTimeFunction& operator=(const ParseTimeFunction&) = delete;
+
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
+
+ private:
+  // Format string precompiled at prepare time; null if the format is not
+  // constant or cannot be precompiled.
+  const std::unique_ptr<const functions::DateTimeParser> const_parser_;
 };
 
 class ParseTimestampFunction : public SimpleBuiltinScalarFunction {
  public:
-  using SimpleBuiltinScalarFunction::SimpleBuiltinScalarFunction;
+  // <const_parser> may be null, in which case the format is interpreted on
+  // every call.
+  ParseTimestampFunction(
+      std::unique_ptr<const functions::DateTimeParser> const_parser,
+      FunctionKind kind, const Type* output_type)
+      : SimpleBuiltinScalarFunction(kind, output_type),
+        const_parser_(std::move(const_parser)) {}
+
+  ParseTimestampFunction(const ParseTimestampFunction&) = delete;
+  ParseTimestampFunction& operator=(const ParseTimestampFunction&) = delete;
+
   absl::StatusOr<Value> Eval(absl::Span<const TupleData* const> params,
                              absl::Span<const Value> args,
                              EvaluationContext* context) const override;
+
+ private:
+  // Format string precompiled at prepare time; null if the format is not
+  // constant or cannot be precompiled.
+  const std::unique_ptr<const functions::DateTimeParser> const_parser_;
 };
 
 class DateTimeDiffFunction : public SimpleBuiltinScalarFunction {
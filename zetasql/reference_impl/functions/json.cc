@@ -143,6 +143,8 @@ absl::StatusOr<Value> JsonExtractString(
 absl::StatusOr<Value> JsonExtractJson(
     const functions::JsonPathEvaluator& evaluator, const Value& json,
     const Type* output_type, bool scalar, JSONParsingOptions parsing_options) {
+  // The input document is only read, so use the compact representation.
+  parsing_options.compact_representation = true;
   if (scalar) {
     std::optional<std::string> output_string_or;
     if (json.is_validated_json()) {
@@ -196,7 +198,8 @@ absl::StatusOr<Value> JsonSubscriptFunction::Eval(
                     FEATURE_JSON_LEGACY_PARSE),
                 .strict_number_parsing =
                     language_options.LanguageFeatureEnabled(
-                        FEATURE_JSON_STRICT_NUMBER_PARSING)}));
+                        FEATURE_JSON_STRICT_NUMBER_PARSING),
+                .compact_representation = true}));
     json_value_const_ref = input_json.GetConstRef();
   }
   ZETASQL_RET_CHECK(json_value_const_ref.has_value());
@@ -300,6 +303,8 @@ absl::StatusOr<Value> JsonExtractArrayString(
 absl::StatusOr<Value> JsonExtractStringArrayJson(
     const functions::JsonPathEvaluator& evaluator, const Value& json,
     JSONParsingOptions parsing_options) {
+  // The input document is only read, so use the compact representation.
+  parsing_options.compact_representation = true;
   std::optional<std::vector<std::optional<std::string>>> output;
   if (json.is_validated_json()) {
     output = evaluator.ExtractStringArray(json.json_value());
@@ -330,6 +335,8 @@ absl::StatusOr<Value> JsonExtractStringArrayJson(
 absl::StatusOr<Value> JsonExtractArrayJson(
     const functions::JsonPathEvaluator& evaluator, const Value& json,
     JSONParsingOptions parsing_options) {
+  // The input document is only read, so use the compact representation.
+  parsing_options.compact_representation = true;
   std::optional<std::vector<JSONValueConstRef>> output;
   JSONValue input_json;
   if (json.is_validated_json()) {
@@ -449,7 +456,8 @@ absl::StatusOr<Value> ParseJsonFunction::Eval(
   JSONParsingOptions options{
       .legacy_mode = context->GetLanguageOptions().LanguageFeatureEnabled(
           FEATURE_JSON_LEGACY_PARSE),
-      .strict_number_parsing = (args[1].string_value() == "exact")};
+      .strict_number_parsing = (args[1].string_value() == "exact"),
+      .compact_representation = true};
   auto result = JSONValue::ParseJSONString(args[0].string_value(), options);
   if (!result.ok()) {
     return MakeEvalError() << "Invalid input to PARSE_JSON: "
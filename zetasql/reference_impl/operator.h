@@ -647,6 +647,21 @@ class AggregateArgAccumulator {
   // only important if we are doing compliance or random query testing.
   virtual absl::StatusOr<Value> GetFinalResult(
       bool inputs_in_defined_order) = 0;
+
+  // Partial aggregation. See the corresponding methods of AggregateAccumulator.
+  virtual absl::StatusOr<std::string> SerializeState() const {
+    return absl::UnimplementedError(
+        "Aggregate does not support serializing its state");
+  }
+  virtual absl::Status MergeSerializedState(absl::string_view state) {
+    return absl::UnimplementedError(
+        "Aggregate does not support merging partial states");
+  }
+  virtual absl::Status Merge(const AggregateArgAccumulator& other) {
+    const absl::StatusOr<std::string> state = other.SerializeState();
+    if (!state.ok()) return state.status();
+    return MergeSerializedState(*state);
+  }
 };
 
 // Operator argument class used by AggregateOp for aggregated arguments.
@@ -690,6 +705,17 @@ class AggregateArg final : public ExprArg {
                                 absl::Span<const TupleData* const> params,
                                 EvaluationContext* context) const;
 
+  // Populates 'values' with the result of EvalAgg() on each of 'windows' of
+  // 'partition'. For some aggregate functions without modifiers, reuses work
+  // across overlapping windows: COUNT, COUNTIF and SUM and AVG of exact types
+  // slide over the windows adding and removing rows, and MIN, MAX and the
+  // bitwise and logical aggregates use a segment tree over 'partition'.
+  absl::Status EvalAggOverWindows(absl::Span<const TupleData* const> partition,
+                                  absl::Span<const AnalyticWindow> windows,
+                                  absl::Span<const TupleData* const> params,
+                                  EvaluationContext* context,
+                                  std::vector<Value>* values) const;
+
   std::string DebugInternal(const std::string& indent,
                             bool verbose) const override;
 
@@ -2805,6 +2831,34 @@ class AggregateAccumulator {
   // only important if we are doing compliance or random query testing.
   virtual absl::StatusOr<Value> GetFinalResult(
       bool inputs_in_defined_order) = 0;
+
+  // Returns the state of the accumulation in a compact encoding, which
+  // MergeSerializedState() accepts on any accumulator created by the same
+  // AggregateFunctionBody with the same arguments. This lets parallel or
+  // sharded evaluation aggregate parts of the input separately and combine
+  // the partial results without reprocessing the input. Returns an
+  // UNIMPLEMENTED error if the function does not support partial aggregation.
+  virtual absl::StatusOr<std::string> SerializeState() const {
+    return absl::UnimplementedError(
+        "Aggregate does not support serializing its state");
+  }
+
+  // Merges 'state', returned by SerializeState(), into this accumulation.
+  // The result is the same as if the values accumulated into 'state' had
+  // been passed to Accumulate(), up to floating point rounding for DOUBLE
+  // averages, variances and covariances.
+  virtual absl::Status MergeSerializedState(absl::string_view state) {
+    return absl::UnimplementedError(
+        "Aggregate does not support merging partial states");
+  }
+
+  // Merges the accumulation of 'other', which must have been created by the
+  // same AggregateFunctionBody with the same arguments, into this one.
+  virtual absl::Status Merge(const AggregateAccumulator& other) {
+    const absl::StatusOr<std::string> state = other.SerializeState();
+    if (!state.ok()) return state.status();
+    return MergeSerializedState(*state);
+  }
 };
 
 // Defines an executable aggregate function.
@@ -18,18 +18,49 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include "zetasql/base/logging.h"
+#include "zetasql/base/arena.h"
 #include "zetasql/public/value.h"
+#include "absl/base/call_once.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
 #include "zetasql/base/map_util.h"
+#include "zetasql/base/status_macros.h"
 
 namespace zetasql {
 
+// -------------------------------------------------------
+// ProtoFieldRegistry
+// -------------------------------------------------------
+
+absl::StatusOr<const ProtoFieldReadPlan*> ProtoFieldRegistry::GetReadPlan()
+    const {
+  absl::call_once(read_plan_once_, [this] {
+    read_plan_field_infos_.reserve(registered_access_infos_.size());
+    for (const ProtoFieldAccessInfo* access_info : registered_access_infos_) {
+      read_plan_field_infos_.push_back(&access_info->field_info);
+    }
+    absl::StatusOr<std::unique_ptr<const ProtoFieldReadPlan>> read_plan =
+        ProtoFieldReadPlan::Create(read_plan_field_infos_);
+    if (read_plan.ok()) {
+      read_plan_ = std::move(read_plan).value();
+    } else {
+      read_plan_status_ = read_plan.status();
+    }
+  });
+  ZETASQL_RETURN_IF_ERROR(read_plan_status_);
+  return read_plan_.get();
+}
+
 // -------------------------------------------------------
 // TupleSchema
 // -------------------------------------------------------
@@ -160,6 +191,39 @@ absl::Status TupleDataDeque::SetSlot(int slot_idx, std::vector<Value> values) {
 
 void TupleDataDeque::Sort(const TupleComparator& comparator,
                           bool use_stable_sort) {
+  if (comparator.has_collated_keys() && datas_.size() > 1) {
+    // Comparing collated strings is much more expensive than comparing their
+    // sort keys, and each tuple is compared O(log n) times, so compute the
+    // sort keys once per tuple.
+    std::vector<const TupleData*> tuples = GetTuplePtrs();
+    zetasql_base::UnsafeArena arena(/*block_size=*/64 * 1024);
+    std::vector<absl::string_view> sort_keys;
+    if (comparator.ComputeCollationSortKeys(tuples, &arena, &sort_keys).ok()) {
+      const int num_keys = comparator.keys().size();
+      std::vector<int64_t> order(datas_.size());
+      for (int64_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+      }
+      auto index_comparator = [&](int64_t index1, int64_t index2) {
+        return comparator.LessThanUsingSortKeys(
+            *tuples[index1], &sort_keys[index1 * num_keys], *tuples[index2],
+            &sort_keys[index2 * num_keys]);
+      };
+      if (use_stable_sort) {
+        std::stable_sort(order.begin(), order.end(), index_comparator);
+      } else {
+        std::sort(order.begin(), order.end(), index_comparator);
+      }
+      std::deque<Entry> sorted;
+      for (int64_t index : order) {
+        sorted.push_back(std::move(datas_[index]));
+      }
+      datas_ = std::move(sorted);
+      return;
+    }
+    // If a sort key cannot be computed, compare with the collators, which
+    // ignore errors.
+  }
   auto entry_comparator = [&comparator](const Entry& entry1,
                                         const Entry& entry2) {
     return comparator(entry1.second, entry2.second);
@@ -36,6 +36,7 @@
 #include "zetasql/reference_impl/tuple_comparator.h"
 #include "zetasql/reference_impl/variable_id.h"
 #include <cstdint>
+#include "absl/base/call_once.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/status/statusor.h"
@@ -125,6 +126,7 @@ class ProtoFieldRegistry {
   // SharedProtoState if EvaluationOptions::store_proto_field_value_maps is
   // true.
   int RegisterField(const ProtoFieldAccessInfo* access_info) {
+    ZETASQL_DCHECK(read_plan_ == nullptr) << "Registry already in use";
     const int index = registered_access_infos_.size();
     registered_access_infos_.push_back(access_info);
     return index;
@@ -134,6 +136,11 @@ class ProtoFieldRegistry {
     return registered_access_infos_;
   }
 
+  // Returns the plan for reading all of the registered fields from a proto,
+  // which is compiled on the first call. No fields may be registered after
+  // that. Thread-safe.
+  absl::StatusOr<const ProtoFieldReadPlan*> GetReadPlan() const;
+
   int id() const { return id_; }
 
  private:
@@ -141,6 +148,13 @@ class ProtoFieldRegistry {
 
   // This is the set of fields that GetProtoFieldExprs care about. Not owned.
   std::vector<const ProtoFieldAccessInfo*> registered_access_infos_;
+
+  // Lazily initialized by GetReadPlan(). 'read_plan_field_infos_' holds the
+  // ProtoFieldInfos of 'registered_access_infos_' for 'read_plan_'.
+  mutable absl::once_flag read_plan_once_;
+  mutable std::vector<const ProtoFieldInfo*> read_plan_field_infos_;
+  mutable std::unique_ptr<const ProtoFieldReadPlan> read_plan_;
+  mutable absl::Status read_plan_status_;
 };
 
 // Key type for ProtoFieldValueMap (defined below). An entry in that map
@@ -704,6 +718,32 @@ class TupleDataDeque {
     }
   }
 
+  // Returns the number of bytes requested from the memory accountant for the
+  // owned tuples.
+  int64_t GetByteSize() const {
+    int64_t byte_size = 0;
+    for (const Entry& entry : datas_) {
+      byte_size += entry.first;
+    }
+    return byte_size;
+  }
+
+  // Moves the bytes of the owned tuples from the current memory accountant to
+  // 'accountant', which must outlive this object. Returns true on success. On
+  // failure, returns false, populates 'status' and keeps the current memory
+  // accountant.
+  bool SetMemoryAccountant(MemoryAccountant* accountant,
+                           absl::Status* status) {
+    if (accountant == accountant_) return true;
+    const int64_t byte_size = GetByteSize();
+    if (!accountant->RequestBytes(byte_size, status)) {
+      return false;
+    }
+    accountant_->ReturnBytes(byte_size);
+    accountant_ = accountant;
+    return true;
+  }
+
   // Returns a vector of pointers to the owned tuples.
   std::vector<const TupleData*> GetTuplePtrs() const {
     std::vector<const TupleData*> ptrs;
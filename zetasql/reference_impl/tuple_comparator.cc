@@ -17,6 +17,7 @@
 #include "zetasql/reference_impl/tuple_comparator.h"
 
 #include <cstdint>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <vector>
@@ -34,6 +35,7 @@
 #include <cstdint>
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
 #include "zetasql/base/source_location.h"
 #include "zetasql/base/ret_check.h"
@@ -100,8 +102,43 @@ absl::StatusOr<std::unique_ptr<TupleComparator>> TupleComparator::Create(
   return absl::WrapUnique(new TupleComparator(keys, slots_for_keys, collators));
 }
 
-bool TupleComparator::operator()(const TupleData& t1,
-                                 const TupleData& t2) const {
+absl::Status TupleComparator::ComputeCollationSortKeys(
+    absl::Span<const TupleData* const> tuples,
+    zetasql_base::UnsafeArena* arena,
+    std::vector<absl::string_view>* sort_keys) const {
+  const int num_keys = keys_.size();
+  sort_keys->assign(tuples.size() * num_keys, absl::string_view());
+  absl::Cord sort_key;
+  for (int i = 0; i < num_keys; ++i) {
+    const ZetaSqlCollator* collator = (*collators_)[i].get();
+    if (collator == nullptr) continue;
+    for (int t = 0; t < tuples.size(); ++t) {
+      const Value& value = tuples[t]->slot(slots_for_keys_[i]).value();
+      if (value.is_null()) continue;
+      absl::string_view& output = (*sort_keys)[t * num_keys + i];
+      if (collator->IsBinaryComparison()) {
+        output = value.string_value();
+        continue;
+      }
+      sort_key.Clear();
+      ZETASQL_RETURN_IF_ERROR(
+          collator->GetSortKeyUtf8(value.string_value(), &sort_key));
+      char* bytes = arena->Alloc(sort_key.size());
+      char* next = bytes;
+      for (absl::string_view chunk : sort_key.Chunks()) {
+        memcpy(next, chunk.data(), chunk.size());
+        next += chunk.size();
+      }
+      output = absl::string_view(bytes, sort_key.size());
+    }
+  }
+  return absl::OkStatus();
+}
+
+bool TupleComparator::LessThan(const TupleData& t1,
+                               const absl::string_view* sort_keys1,
+                               const TupleData& t2,
+                               const absl::string_view* sort_keys2) const {
   for (int i = 0; i < keys_.size(); ++i) {
     const KeyArg* key = keys_[i];
     const ZetaSqlCollator* collator = (*collators_)[i].get();
@@ -130,10 +167,16 @@ bool TupleComparator::operator()(const TupleData& t1,
     if (collator != nullptr) {
       ZETASQL_DCHECK(v1.type()->IsString());
       ZETASQL_DCHECK(v2.type()->IsString());
-      absl::Status status;
-      int64_t result =
-          collator->CompareUtf8(v1.string_value(), v2.string_value(), &status);
-      ZETASQL_DCHECK_OK(status);
+      int64_t result;
+      if (sort_keys1 != nullptr) {
+        // Sort keys compare like memcmp().
+        result = sort_keys1[i].compare(sort_keys2[i]);
+      } else {
+        absl::Status status;
+        result = collator->CompareUtf8(v1.string_value(), v2.string_value(),
+                                       &status);
+        ZETASQL_DCHECK_OK(status);
+      }
       if (result != 0) {  // v1 != v2
         if (key->is_descending()) {
           return result > 0;  // v1 > v2
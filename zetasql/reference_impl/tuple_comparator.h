@@ -20,9 +20,11 @@
 #include <memory>
 #include <vector>
 
+#include "zetasql/base/arena.h"
 #include "zetasql/common/internal_value.h"
 #include "zetasql/public/collator.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "absl/types/span.h"
 #include "zetasql/base/status.h"
 
@@ -44,7 +46,9 @@ class TupleComparator {
       absl::Span<const TupleData* const> params, EvaluationContext* context);
 
   // Returns true if t1 is less than t2.
-  bool operator()(const TupleData& t1, const TupleData& t2) const;
+  bool operator()(const TupleData& t1, const TupleData& t2) const {
+    return LessThan(t1, /*sort_keys1=*/nullptr, t2, /*sort_keys2=*/nullptr);
+  }
 
   // t1 and t2  must not be NULL.
   bool operator()(const TupleData* t1, const TupleData* t2) const {
@@ -67,6 +71,31 @@ class TupleComparator {
 
   const std::vector<const KeyArg*>& keys() const { return keys_; }
 
+  // Returns true if some keys are compared with a collator that does not
+  // just compare bytes. Comparing their values is then much more expensive
+  // than comparing their sort keys, so callers comparing each tuple many
+  // times, e.g. to sort, should use ComputeCollationSortKeys() first.
+  bool has_collated_keys() const { return has_collated_keys_; }
+
+  // Returns in <sort_keys> keys().size() entries for each of <tuples>. For
+  // keys with a collator, these are the collation sort keys of the non-NULL
+  // values, allocated in <arena> unless the collator just compares bytes. The
+  // other entries are empty.
+  absl::Status ComputeCollationSortKeys(
+      absl::Span<const TupleData* const> tuples,
+      zetasql_base::UnsafeArena* arena,
+      std::vector<absl::string_view>* sort_keys) const;
+
+  // Same as operator(), but compares the collated keys of <t1> and <t2>
+  // using their sort keys, which start at <sort_keys1> and <sort_keys2> in
+  // the output of ComputeCollationSortKeys().
+  bool LessThanUsingSortKeys(const TupleData& t1,
+                             const absl::string_view* sort_keys1,
+                             const TupleData& t2,
+                             const absl::string_view* sort_keys2) const {
+    return LessThan(t1, sort_keys1, t2, sort_keys2);
+  }
+
  private:
   using Collators = std::vector<std::unique_ptr<const ZetaSqlCollator>>;
 
@@ -75,7 +104,20 @@ class TupleComparator {
                   std::shared_ptr<const Collators> collators)
       : keys_(keys.begin(), keys.end()),
         slots_for_keys_(slots_for_keys.begin(), slots_for_keys.end()),
-        collators_(collators) {}
+        collators_(collators) {
+    for (const std::unique_ptr<const ZetaSqlCollator>& collator :
+         *collators_) {
+      if (collator != nullptr && !collator->IsBinaryComparison()) {
+        has_collated_keys_ = true;
+      }
+    }
+  }
+
+  // Implements operator() and LessThanUsingSortKeys(). <sort_keys1> and
+  // <sort_keys2> are both nullptr or both set.
+  bool LessThan(const TupleData& t1, const absl::string_view* sort_keys1,
+                const TupleData& t2,
+                const absl::string_view* sort_keys2) const;
 
   const std::vector<const KeyArg*> keys_;
   const std::vector<int> slots_for_keys_;
@@ -85,6 +127,7 @@ class TupleComparator {
   // compared based on their UTF-8 encoding.
   // We use std::shared_ptr<const ...> to allow the comparator to be copied.
   const std::shared_ptr<const Collators> collators_;
+  bool has_collated_keys_ = false;
 };
 
 }  // namespace zetasql
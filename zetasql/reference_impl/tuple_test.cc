@@ -18,6 +18,7 @@
 
 #include <cstdint>
 #include <utility>
+#include <vector>
 
 #include "google/protobuf/descriptor.h"
 #include "zetasql/base/testing/status_matchers.h"
@@ -413,6 +414,49 @@ TEST(TupleDataDeque, SetSlotTest) {
   }
 }
 
+TEST(TupleDataDeque, SortWithCollationTest) {
+  VariableId k1("k1"), k2("k2"), k3("k3"), k4("k4");
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ValueExpr> key1,
+                       DerefExpr::Create(k1, StringType()));
+  KeyArg key_arg1(k3, std::move(key1), KeyArg::kAscending);
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ValueExpr> collation,
+                       ConstExpr::Create(String("und:ci")));
+  key_arg1.set_collation(std::move(collation));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ValueExpr> key2,
+                       DerefExpr::Create(k2, Int64Type()));
+  KeyArg key_arg2(k4, std::move(key2), KeyArg::kDescending);
+
+  EvaluationContext context((EvaluationOptions()));
+  ZETASQL_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<TupleComparator> comparator,
+      TupleComparator::Create({&key_arg1, &key_arg2},
+                              /*slots_for_keys=*/{0, 1},
+                              /*params=*/{}, &context));
+  ASSERT_TRUE(comparator->has_collated_keys());
+
+  MemoryAccountant accountant(/*total_num_bytes=*/10000);
+  TupleDataDeque deque(&accountant);
+  const std::vector<std::pair<Value, int64_t>> rows = {
+      {String("b"), 1}, {String("A"), 2}, {NullString(), 3},
+      {String("a"), 4}, {String("B"), 5}, {String("a"), 6}};
+  for (const auto& [value, tag] : rows) {
+    absl::Status status;
+    ASSERT_TRUE(deque.PushBack(
+        std::make_unique<TupleData>(
+            CreateTupleDataFromValues({value, Int64(tag)})),
+        &status))
+        << status;
+  }
+
+  // Case-insensitive equal strings are ordered by the second key.
+  deque.Sort(*comparator, /*use_stable_sort=*/false);
+  std::vector<int64_t> tags;
+  for (const TupleData* data : deque.GetTuplePtrs()) {
+    tags.push_back(data->slot(1).value().int64_value());
+  }
+  EXPECT_THAT(tags, ElementsAre(3, 6, 4, 2, 5, 1));
+}
+
 TEST(TupleDataOrderedQueue, InsertAndPopTest) {
   VariableId k1("k1"), k2("k2");
   TupleSchema schema({k1});
@@ -60,6 +60,7 @@
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/node_hash_map.h"
+#include "absl/flags/flag.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -603,18 +604,28 @@ bool ProtoFieldReader::GetFieldValue(const TupleSlot& proto_slot,
     context->set_num_proto_deserializations(
         context->num_proto_deserializations() + 1);
 
-    std::vector<const ProtoFieldInfo*> field_infos;
-    field_infos.reserve(registry_->GetRegisteredFields().size());
-    for (const ProtoFieldAccessInfo* access_info :
-         registry_->GetRegisteredFields()) {
-      field_infos.push_back(&access_info->field_info);
-    }
-
     value_list_owner = std::make_unique<ProtoFieldValueList>();
     value_list = value_list_owner.get();
 
-    const absl::Status read_status = ReadProtoFields(
-        field_infos, proto_value.ToCord(), value_list_owner.get());
+    absl::Status read_status;
+    const std::vector<const ProtoFieldAccessInfo*>& registered_fields =
+        registry_->GetRegisteredFields();
+    if (registered_fields.size() == 1 &&
+        absl::GetFlag(FLAGS_zetasql_read_proto_field_optimized_path)) {
+      // ReadProtoFields() has a faster path for a single field than the plan.
+      read_status = ReadProtoFields({&registered_fields[0]->field_info},
+                                    proto_value.ToCord(),
+                                    value_list_owner.get());
+    } else {
+      const absl::StatusOr<const ProtoFieldReadPlan*> read_plan =
+          registry_->GetReadPlan();
+      if (!read_plan.ok()) {
+        *status = read_plan.status();
+        return false;
+      }
+      read_status =
+          (*read_plan)->Read(proto_value.ToCord(), value_list_owner.get());
+    }
     if (!read_status.ok()) {
       *status = read_status;
       return false;
@@ -65,6 +65,7 @@
 #include "gtest/gtest.h"
 #include <cstdint>
 #include "absl/container/flat_hash_map.h"
+#include "absl/flags/flag.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -2606,6 +2607,26 @@ TEST_F(ProtoEvalTest, GetProtoFieldExprPrimitiveProtoFields) {
   EXPECT_EQ(Value::Bool(true), HasProtoFieldOrDie(&p, "sint64_val"));
 }
 
+// Reading a single field has its own path in ProtoFieldReader, which
+// --zetasql_read_proto_field_optimized_path=false turns off.
+TEST_F(ProtoEvalTest, GetProtoFieldExprWithoutSingleFieldOptimizedPath) {
+  absl::SetFlag(&FLAGS_zetasql_read_proto_field_optimized_path, false);
+  zetasql_test__::KitchenSinkPB p;
+
+  EXPECT_EQ(Value::Int32(77), GetProtoFieldOrDie(&p, "int32_val"));
+  EXPECT_EQ(Value::Bool(false), HasProtoFieldOrDie(&p, "int32_val"));
+  p.set_int32_val(123);
+  EXPECT_EQ(Value::Int32(123), GetProtoFieldOrDie(&p, "int32_val"));
+  EXPECT_EQ(Value::Bool(true), HasProtoFieldOrDie(&p, "int32_val"));
+
+  p.add_repeated_int32_val(140);
+  p.add_repeated_int32_val(141);
+  EXPECT_EQ(Int32Array({140, 141}),
+            GetProtoFieldOrDie(&p, "repeated_int32_val"));
+
+  absl::SetFlag(&FLAGS_zetasql_read_proto_field_optimized_path, true);
+}
+
 TEST_F(ProtoEvalTest, GetProtoFieldExprRepeatedProtoFields) {
   zetasql_test__::KitchenSinkPB p;
 
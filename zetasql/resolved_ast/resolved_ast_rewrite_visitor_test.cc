@@ -0,0 +1,227 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include "zetasql/resolved_ast/resolved_ast_rewrite_visitor.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/base/testing/status_matchers.h"
+#include "zetasql/public/analyzer.h"
+#include "zetasql/public/analyzer_output.h"
+#include "zetasql/public/simple_catalog.h"
+#include "zetasql/public/type.h"
+#include "zetasql/public/value.h"
+#include "zetasql/resolved_ast/resolved_ast.h"
+#include "zetasql/resolved_ast/resolved_ast_builder.h"
+#include "zetasql/resolved_ast/resolved_ast_deep_copy_visitor.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+
+namespace zetasql {
+
+using ::testing::HasSubstr;
+using ::zetasql_base::testing::StatusIs;
+
+namespace {
+
+// Wraps the filter expression of every filter scan in a CAST to its own type.
+class CastFilterExpr : public ResolvedASTRewriteVisitor {
+ private:
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  PostVisitResolvedFilterScan(
+      std::unique_ptr<const ResolvedFilterScan> node) override {
+    ResolvedFilterScanBuilder builder = ToBuilder(std::move(node));
+    std::unique_ptr<const ResolvedExpr> filter_expr =
+        builder.release_filter_expr();
+    const Type* type = filter_expr->type();
+    return std::move(builder)
+        .set_filter_expr(ResolvedCastBuilder()
+                             .set_type(type)
+                             .set_expr(std::move(filter_expr))
+                             .set_return_null_on_error(false))
+        .Build();
+  }
+};
+
+// Replaces every literal with an integer literal of the same value plus one.
+class IncrementLiterals : public ResolvedASTRewriteVisitor {
+ public:
+  int num_literals() const { return num_literals_; }
+
+ private:
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> PostVisitResolvedLiteral(
+      std::unique_ptr<const ResolvedLiteral> node) override {
+    ++num_literals_;
+    return MakeResolvedLiteral(types::Int64Type(),
+                               Value::Int64(node->value().int64_value() + 1));
+  }
+
+  int num_literals_ = 0;
+};
+
+// Like IncrementLiterals, but leaves filter expressions alone: filter scans
+// are visited by an override that only rewrites their input.
+class IncrementLiteralsOutsideFilters : public IncrementLiterals {
+ private:
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>> VisitResolvedFilterScan(
+      std::unique_ptr<const ResolvedFilterScan> node) override {
+    ResolvedFilterScanBuilder builder = ToBuilder(std::move(node));
+    ZETASQL_ASSIGN_OR_RETURN(std::unique_ptr<const ResolvedScan> input_scan,
+                     ProcessNode(builder.release_input_scan()));
+    return std::move(builder).set_input_scan(std::move(input_scan)).Build();
+  }
+};
+
+// Replaces table scans with a node that cannot take their place.
+class ReplaceTableScanWithLiteral : public ResolvedASTRewriteVisitor {
+ private:
+  absl::StatusOr<std::unique_ptr<const ResolvedNode>>
+  PostVisitResolvedTableScan(
+      std::unique_ptr<const ResolvedTableScan> node) override {
+    return MakeResolvedLiteral(types::Int64Type(), Value::Int64(1));
+  }
+};
+
+class ResolvedASTRewriteVisitorTest : public ::testing::Test {
+ protected:
+  ResolvedASTRewriteVisitorTest() : catalog_("Test catalog", nullptr) {}
+
+  void SetUp() override {
+    catalog_.AddZetaSQLFunctions();
+    catalog_.AddOwnedTable(new SimpleTable(
+        "T", {{"a", type_factory_.get_int64()},
+              {"b", type_factory_.get_bool()}}));
+  }
+
+  // Analyzes <query> and returns a copy of its resolved statement, which the
+  // test owns and can rewrite.
+  std::unique_ptr<const ResolvedStatement> AnalyzeAndCopy(
+      const std::string& query) {
+    std::unique_ptr<const AnalyzerOutput> output;
+    ZETASQL_EXPECT_OK(AnalyzeStatement(query, options_, &catalog_, &type_factory_,
+                               &output));
+    ResolvedASTDeepCopyVisitor copier;
+    ZETASQL_EXPECT_OK(output->resolved_statement()->Accept(&copier));
+    absl::StatusOr<std::unique_ptr<ResolvedStatement>> copy =
+        copier.ConsumeRootNode<ResolvedStatement>();
+    ZETASQL_EXPECT_OK(copy);
+    analyzer_outputs_.push_back(std::move(output));
+    return std::move(copy).value();
+  }
+
+  // Returns the table scans of <node>, in pre-order.
+  static std::vector<const ResolvedNode*> TableScans(const ResolvedNode* node) {
+    std::vector<const ResolvedNode*> scans;
+    node->GetDescendantsWithKinds({RESOLVED_TABLE_SCAN}, &scans);
+    return scans;
+  }
+
+  // Keeps the column names and types used by the copies alive.
+  std::vector<std::unique_ptr<const AnalyzerOutput>> analyzer_outputs_;
+
+  AnalyzerOptions options_;
+  SimpleCatalog catalog_;
+  TypeFactory type_factory_;
+};
+
+TEST_F(ResolvedASTRewriteVisitorTest, NoChangeReusesEveryNode) {
+  std::unique_ptr<const ResolvedStatement> stmt =
+      AnalyzeAndCopy("SELECT a + 1 FROM T WHERE b");
+  const std::string debug_string = stmt->DebugString();
+  const ResolvedStatement* root = stmt.get();
+  const std::vector<const ResolvedNode*> scans = TableScans(root);
+  ASSERT_EQ(scans.size(), 1);
+
+  ResolvedASTRewriteVisitor visitor;
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<const ResolvedStatement> result,
+                       visitor.VisitAll(std::move(stmt)));
+  EXPECT_EQ(result.get(), root);
+  EXPECT_EQ(TableScans(result.get()), scans);
+  EXPECT_EQ(result->DebugString(), debug_string);
+}
+
+TEST_F(ResolvedASTRewriteVisitorTest, ReplacesOnlyTheChangedSpine) {
+  std::unique_ptr<const ResolvedStatement> stmt = AnalyzeAndCopy(
+      "SELECT x FROM (SELECT a AS x FROM T), (SELECT b FROM T WHERE b)");
+  const ResolvedStatement* root = stmt.get();
+  const std::vector<const ResolvedNode*> scans = TableScans(root);
+  ASSERT_EQ(scans.size(), 2);
+
+  CastFilterExpr visitor;
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<const ResolvedStatement> result,
+                       visitor.VisitAll(std::move(stmt)));
+  // The filter scan is rebuilt around its original input, and its ancestors
+  // keep their identity.
+  EXPECT_EQ(result.get(), root);
+  EXPECT_EQ(TableScans(result.get()), scans);
+
+  std::vector<const ResolvedNode*> filter_scans;
+  result->GetDescendantsWithKinds({RESOLVED_FILTER_SCAN}, &filter_scans);
+  ASSERT_EQ(filter_scans.size(), 1);
+  const ResolvedFilterScan* filter_scan =
+      filter_scans[0]->GetAs<ResolvedFilterScan>();
+  EXPECT_EQ(filter_scan->input_scan(), scans[1]);
+  EXPECT_EQ(filter_scan->filter_expr()->node_kind(), RESOLVED_CAST);
+}
+
+TEST_F(ResolvedASTRewriteVisitorTest, ReplacesLeaves) {
+  std::unique_ptr<const ResolvedStatement> stmt =
+      AnalyzeAndCopy("SELECT 1 + 2, a FROM T");
+
+  IncrementLiterals visitor;
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<const ResolvedStatement> result,
+                       visitor.VisitAll(std::move(stmt)));
+  EXPECT_EQ(visitor.num_literals(), 2);
+  EXPECT_THAT(result->DebugString(), HasSubstr("Literal(type=INT64, value=2)"));
+  EXPECT_THAT(result->DebugString(), HasSubstr("Literal(type=INT64, value=3)"));
+}
+
+TEST_F(ResolvedASTRewriteVisitorTest, OverriddenVisitControlsRecursion) {
+  std::unique_ptr<const ResolvedStatement> stmt =
+      AnalyzeAndCopy("SELECT 1 FROM T WHERE a = 5");
+
+  IncrementLiteralsOutsideFilters visitor;
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<const ResolvedStatement> result,
+                       visitor.VisitAll(std::move(stmt)));
+  EXPECT_EQ(visitor.num_literals(), 1);
+  EXPECT_THAT(result->DebugString(), HasSubstr("Literal(type=INT64, value=2)"));
+  EXPECT_THAT(result->DebugString(), HasSubstr("Literal(type=INT64, value=5)"));
+}
+
+TEST_F(ResolvedASTRewriteVisitorTest, ReplacementOfWrongKindIsAnError) {
+  std::unique_ptr<const ResolvedStatement> stmt =
+      AnalyzeAndCopy("SELECT a FROM T");
+
+  ReplaceTableScanWithLiteral visitor;
+  EXPECT_THAT(visitor.VisitAll(std::move(stmt)),
+              StatusIs(absl::StatusCode::kInternal,
+                       HasSubstr("node of an unexpected kind")));
+}
+
+TEST_F(ResolvedASTRewriteVisitorTest, NullInput) {
+  ResolvedASTRewriteVisitor visitor;
+  ZETASQL_ASSERT_OK_AND_ASSIGN(std::unique_ptr<const ResolvedNode> result,
+                       visitor.VisitAll(std::unique_ptr<const ResolvedNode>()));
+  EXPECT_EQ(result, nullptr);
+}
+
+}  // namespace
+}  // namespace zetasql
@@ -0,0 +1,101 @@
+//
+// Copyright 2019 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// Tool for fingerprinting a query log, with one statement per line, using all
+// cores. For each input line, prints the fingerprint of the statement in hex
+// and its normalized SQL, separated by a tab, or "ERROR" and the error.
+// Empty lines are skipped.
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "zetasql/public/language_options.h"
+#include "zetasql/public/query_fingerprint.h"
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+
+ABSL_FLAG(int, num_threads, 0,
+          "Number of threads to use, or 0 to use one per CPU.");
+ABSL_FLAG(int, batch_size, 100000,
+          "Number of statements read into memory and processed at once.");
+
+namespace zetasql {
+namespace {
+
+void FingerprintBatch(const std::vector<std::string>& queries,
+                      const LanguageOptions& language_options) {
+  const std::vector<absl::StatusOr<QueryFingerprint>> results =
+      FingerprintQueries(queries, language_options,
+                         absl::GetFlag(FLAGS_num_threads));
+  for (const absl::StatusOr<QueryFingerprint>& result : results) {
+    if (result.ok()) {
+      std::cout << absl::StrFormat("%016x\t%s\n", result->fingerprint,
+                                   result->normalized_sql);
+    } else {
+      std::cout << "ERROR\t" << result.status().message() << "\n";
+    }
+  }
+}
+
+void FingerprintQueryLog(std::istream& input) {
+  LanguageOptions language_options;
+  // Query logs come from many clients, so accept everything that parses.
+  language_options.EnableMaximumLanguageFeaturesForDevelopment();
+  language_options.SetSupportsAllStatementKinds();
+
+  const int batch_size = std::max(1, absl::GetFlag(FLAGS_batch_size));
+  std::vector<std::string> queries;
+  std::string line;
+  while (std::getline(input, line)) {
+    if (line.empty()) continue;
+    queries.push_back(std::move(line));
+    if (static_cast<int>(queries.size()) == batch_size) {
+      FingerprintBatch(queries, language_options);
+      queries.clear();
+    }
+  }
+  FingerprintBatch(queries, language_options);
+}
+
+}  // namespace
+}  // namespace zetasql
+
+int main(int argc, char* argv[]) {
+  const char kUsage[] =
+      "Usage: query_fingerprint [--num_threads=<n>] [<query log file>]\n";
+  std::vector<char*> args = absl::ParseCommandLine(argc, argv);
+  if (args.size() > 2) {
+    std::cerr << kUsage;
+    return 1;
+  }
+  if (args.size() == 1) {
+    zetasql::FingerprintQueryLog(std::cin);
+    return 0;
+  }
+  std::ifstream file(args[1]);
+  if (!file) {
+    std::cerr << "ERROR: Cannot open " << args[1] << "\n";
+    return 1;
+  }
+  zetasql::FingerprintQueryLog(file);
+  return 0;
+}